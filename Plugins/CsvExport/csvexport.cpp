@@ -1,7 +1,6 @@
 #include "csvexport.h"
 #include "common/unused.h"
 #include "services/exportmanager.h"
-#include "csvserializer.h"
 
 CsvExport::CsvExport()
 {
@@ -65,7 +64,7 @@ bool CsvExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
         for (QueryExecutor::ResultColumnPtr resCol : columns)
             cols << resCol->displayName;
 
-        writeln(CsvSerializer::serialize(cols, format));
+        writeRow(cols);
     }
     return true;
 }
@@ -103,22 +102,40 @@ bool CsvExport::exportTable(const QStringList& columnNames)
 
     defineCsvFormat();
     if (cfg.CsvExport.ColumnsInFirstRow.get())
-        writeln(CsvSerializer::serialize(columnNames, format));
+        writeRow(columnNames);
 
     return true;
 }
 
 bool CsvExport::exportTableRow(SqlResultsRowPtr data)
 {
-    QStringList valList;
-    QString nl = cfg.CsvExport.NullValueString.get();
+    bool first = true;
     for (const QVariant& val : data->valueList())
-        valList << (val.isNull() ? nl : val.toString());
+    {
+        if (!first)
+            outputBuffer.write(format.columnSeparator);
 
-    writeln(CsvSerializer::serialize(valList, format));
+        outputBuffer.writeCsvField(val.isNull() ? nullValueString : val.toString(), format.columnSeparator, format.rowSeparator);
+        first = false;
+    }
+    outputBuffer.write(QChar('\n'));
     return true;
 }
 
+void CsvExport::writeRow(const QStringList& values)
+{
+    bool first = true;
+    for (const QString& value : values)
+    {
+        if (!first)
+            outputBuffer.write(format.columnSeparator);
+
+        outputBuffer.writeCsvField(value, format.columnSeparator, format.rowSeparator);
+        first = false;
+    }
+    outputBuffer.write(QChar('\n'));
+}
+
 bool CsvExport::beforeExportDatabase(const QString& database)
 {
     UNUSED(database);
@@ -162,6 +179,7 @@ void CsvExport::defineCsvFormat()
 {
     format = CsvFormat();
     format.rowSeparator = '\n';
+    nullValueString = cfg.CsvExport.NullValueString.get();
 
     switch (cfg.CsvExport.Separator.get())
     {
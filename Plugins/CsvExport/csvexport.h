@@ -48,9 +48,11 @@ class CSVEXPORTSHARED_EXPORT CsvExport : public GenericExportPlugin
     private:
         bool exportTable(const QStringList& columnNames);
         void defineCsvFormat();
+        void writeRow(const QStringList& values);
 
         CFG_LOCAL_PERSISTABLE(CsvExportConfig, cfg)
         CsvFormat format;
+        QString nullValueString;
 };
 
 #endif // CSVEXPORT_H
@@ -23,7 +23,8 @@ SOURCES += dbandroid.cpp \
     dbandroidjsonconnection.cpp \
     dbandroidshellconnection.cpp \
     dbandroidconnection.cpp \
-    dbandroidconnectionfactory.cpp
+    dbandroidconnectionfactory.cpp \
+    dbandroidshellsession.cpp
 
 HEADERS += dbandroid.h\
         dbandroid_global.h \
@@ -37,7 +38,8 @@ HEADERS += dbandroid.h\
     sqlresultrowandroid.h \
     dbandroidjsonconnection.h \
     dbandroidshellconnection.h \
-    dbandroidconnectionfactory.h
+    dbandroidconnectionfactory.h \
+    dbandroidshellsession.h
 
 win32: {
     LIBS += -lcoreSQLiteStudio -lguiSQLiteStudio
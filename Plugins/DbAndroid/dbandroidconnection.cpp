@@ -12,3 +12,14 @@ QByteArray DbAndroidConnection::convertBlob(const QString& value)
     return QByteArray::fromHex(value.mid(2, value.length() - 3).toLatin1());
 }
 
+bool DbAndroidConnection::fetchMore(DbAndroidConnection::ExecutionResult& results)
+{
+    results.hasMore = false;
+    return false;
+}
+
+void DbAndroidConnection::closeCursor(DbAndroidConnection::ExecutionResult& results)
+{
+    results.hasMore = false;
+    results.cursorId = -1;
+}
@@ -19,6 +19,8 @@ class DbAndroidConnection : public QObject
             QStringList resultColumns;
             QList<QVariantHash> resultDataMap;
             QList<QVariantList> resultDataList;
+            int cursorId = -1;      /**< Server side cursor of a paged result, or -1 if there is none. */
+            bool hasMore = false;   /**< There are more rows to get with fetchMore(). */
         };
 
         DbAndroidConnection(QObject* parent = 0) : QObject(parent) {}
@@ -34,6 +36,23 @@ class DbAndroidConnection : public QObject
         virtual bool deleteDatabase(const QString& dbName) = 0;
         virtual ExecutionResult executeQuery(const QString& query) = 0;
 
+        /**
+         * @brief Gets next page of rows for the paged result.
+         * @param results Results of executeQuery() or of previous fetchMore() call.
+         * @return true on success, false on failure.
+         *
+         * Rows of the next page replace rows in the \p results (columns stay the same),
+         * so only one page at the time is kept in the memory.
+         * Default implementation does nothing, as connections that don't support paging return all rows at once.
+         */
+        virtual bool fetchMore(ExecutionResult& results);
+
+        /**
+         * @brief Releases the paged result before all of its rows were read.
+         * @param results Results with an open cursor.
+         */
+        virtual void closeCursor(ExecutionResult& results);
+
     protected:
         static QByteArray convertBlob(const QString& value);
 
@@ -75,6 +75,18 @@ bool DbAndroidInstance::loadExtension(const QString& filePath, const QString& in
     return false;
 }
 
+QIODevice* DbAndroidInstance::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(writable);
+    errorCode = 1;
+    errorText = tr("Android SQLite driver does not support incremental BLOB access.");
+    return nullptr;
+}
+
 bool DbAndroidInstance::isComplete(const QString& sql) const
 {
     return DbSqlite3::complete(sql);
@@ -12,7 +12,6 @@ DbAndroidJsonConnection::DbAndroidJsonConnection(DbAndroid* plugin, QObject *par
     DbAndroidConnection(parent), plugin(plugin)
 {
     socket = new BlockingSocket(this);
-    adbManager = plugin->getAdbManager();
     connect(socket, SIGNAL(disconnected()), this, SLOT(handlePossibleDisconnection()));
 }
 
@@ -140,6 +139,19 @@ qint32 DbAndroidJsonConnection::bytesToSize(const QByteArray& bytes)
 
 QVariant DbAndroidJsonConnection::convertJsonValue(const QJsonValue& value)
 {
+    if (value.isObject())
+    {
+        // BLOB of paged result
+        QJsonObject blobContainer = value.toObject();
+        if (!blobContainer.contains("blob"))
+        {
+            qCritical() << "Invalid blob value from Android - missing 'blob' member.";
+            return QByteArray();
+        }
+
+        return QByteArray::fromBase64(blobContainer["blob"].toString().toLatin1());
+    }
+
     if (value.isArray())
     {
         // BLOB
@@ -304,48 +316,150 @@ DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQuery(const
 
     QJsonDocument json = wrapQueryInJson(query);
     QByteArray responseBytes = send(json.toJson(QJsonDocument::Compact));
+    handleQueryResult(responseBytes, executionResults);
+    return executionResults;
+}
+
+bool DbAndroidJsonConnection::fetchMore(DbAndroidConnection::ExecutionResult& results)
+{
+    results.resultDataMap.clear();
+    results.resultDataList.clear();
+    if (!results.hasMore || results.cursorId < 0)
+    {
+        results.hasMore = false;
+        return false;
+    }
+
+    if (!isConnected())
+    {
+        results.hasMore = false;
+        results.wasError = true;
+        results.errorMsg = tr("Unable to read further results from Android device (connection was closed).");
+        return false;
+    }
+
+    QJsonDocument json = wrapCursorCmdInJson("FETCH", results.cursorId);
+    QByteArray responseBytes = send(json.toJson(QJsonDocument::Compact));
+    return handleQueryResult(responseBytes, results);
+}
+
+void DbAndroidJsonConnection::closeCursor(DbAndroidConnection::ExecutionResult& results)
+{
+    if (results.hasMore && results.cursorId >= 0 && isConnected())
+    {
+        QJsonDocument json = wrapCursorCmdInJson("CLOSE", results.cursorId);
+        QByteArray responseBytes = send(json.toJson(QJsonDocument::Compact));
+        if (!handleStdResult(responseBytes))
+            qWarning() << "Could not close result cursor" << results.cursorId << "on Android device.";
+    }
+
+    DbAndroidConnection::closeCursor(results);
+}
+
+bool DbAndroidJsonConnection::handleQueryResult(const QByteArray& responseBytes, DbAndroidConnection::ExecutionResult& results)
+{
+    results.hasMore = false;
 
     QJsonParseError jsonError;
     QJsonDocument jsonResponse = QJsonDocument::fromJson(responseBytes, &jsonError);
     if (jsonError.error != QJsonParseError::NoError)
     {
-        executionResults.wasError = true;
-        executionResults.errorMsg = tr("Error while parsing response from Android: %1").arg(jsonError.errorString());
-        return executionResults;
+        results.wasError = true;
+        results.errorMsg = tr("Error while parsing response from Android: %1").arg(jsonError.errorString());
+        return false;
     }
 
     QJsonObject responseObject = jsonResponse.object();
     if (responseObject.contains("generic_error"))
     {
-        executionResults.wasError = true;
-        executionResults.errorMsg = tr("Generic error from Android: %1").arg(responseObject["generic_error"].toInt());
-        return executionResults;
+        results.wasError = true;
+        results.errorMsg = tr("Generic error from Android: %1").arg(responseObject["generic_error"].toInt());
+        return false;
     }
 
     if (responseObject.contains("error_code"))
     {
-        executionResults.errorCode = responseObject["error_code"].toInt();
-        executionResults.errorMsg = responseObject["error_message"].toString();
-        return executionResults;
+        results.errorCode = responseObject["error_code"].toInt();
+        results.errorMsg = responseObject["error_message"].toString();
+        return false;
     }
 
-    if (!responseObject.contains("columns"))
+    if (responseObject.contains("columns"))
     {
-        executionResults.wasError = true;
-        executionResults.errorMsg = tr("Missing 'columns' in response from Android.");
-        return executionResults;
+        results.resultColumns.clear();
+        for (const QVariant& col : responseObject["columns"].toArray().toVariantList())
+            results.resultColumns << col.toString();
+    }
+    else if (results.cursorId < 0)
+    {
+        results.wasError = true;
+        results.errorMsg = tr("Missing 'columns' in response from Android.");
+        return false;
     }
 
-    if (!responseObject.contains("data"))
+    if (responseObject.contains("rows"))
+        return readPagedRows(responseObject, results);
+
+    if (responseObject.contains("data"))
+        return readLegacyRows(responseObject, results);
+
+    results.wasError = true;
+    results.errorMsg = tr("Missing 'data' in response from Android.");
+    return false;
+}
+
+bool DbAndroidJsonConnection::readPagedRows(const QJsonObject& responseObject, DbAndroidConnection::ExecutionResult& results)
+{
+    results.hasMore = responseObject["more"].toBool();
+    results.cursorId = results.hasMore ? responseObject["cursor"].toInt(-1) : -1;
+    if (results.hasMore && results.cursorId < 0)
     {
-        executionResults.wasError = true;
-        executionResults.errorMsg = tr("Missing 'columns' in response from Android.");
-        return executionResults;
+        results.hasMore = false;
+        results.wasError = true;
+        results.errorMsg = tr("Missing 'cursor' in response from Android.");
+        return false;
+    }
+
+    QJsonArray jsonRows = responseObject["rows"].toArray();
+    int colCount = results.resultColumns.size();
+    results.resultDataMap.reserve(jsonRows.size());
+    results.resultDataList.reserve(jsonRows.size());
+
+    QJsonArray jsonRow;
+    QVariantHash rowAsMap;
+    QVariantList rowAsList;
+    QVariant cellValue;
+    for (int i = 0, total = jsonRows.size(); i < total; ++i)
+    {
+        jsonRow = jsonRows[i].toArray();
+        if (jsonRow.size() != colCount)
+        {
+            results.wasError = true;
+            results.errorMsg = tr("Response from Android has %1 values in row %2, while %3 columns were expected.")
+                    .arg(QString::number(jsonRow.size()), QString::number(i+1), QString::number(colCount));
+            return false;
+        }
+
+        rowAsList.reserve(colCount);
+        for (int col = 0; col < colCount; ++col)
+        {
+            cellValue = convertJsonValue(jsonRow[col]);
+            rowAsMap[results.resultColumns[col]] = cellValue;
+            rowAsList << cellValue;
+        }
+
+        results.resultDataMap << rowAsMap;
+        results.resultDataList << rowAsList;
+
+        rowAsMap.clear();
+        rowAsList.clear();
     }
 
-    for (const QVariant& col : responseObject["columns"].toArray().toVariantList())
-        executionResults.resultColumns << col.toString();
+    return true;
+}
 
+bool DbAndroidJsonConnection::readLegacyRows(const QJsonObject& responseObject, DbAndroidConnection::ExecutionResult& results)
+{
     QJsonArray jsonRows = responseObject["data"].toArray();
     QJsonObject jsonRow;
     QJsonValue jsonValue;
@@ -355,13 +469,13 @@ DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQuery(const
     for (int i = 0, total = jsonRows.size(); i < total; ++i)
     {
         jsonRow = jsonRows[i].toObject();
-        for (const QString& colName : executionResults.resultColumns)
+        for (const QString& colName : results.resultColumns)
         {
             if (!jsonRow.contains(colName))
             {
-                executionResults.wasError = true;
-                executionResults.errorMsg = tr("Response from Android has missing data for column '%1' in row %2.").arg(colName, QString::number(i+1));
-                return executionResults;
+                results.wasError = true;
+                results.errorMsg = tr("Response from Android has missing data for column '%1' in row %2.").arg(colName, QString::number(i+1));
+                return false;
             }
 
             jsonValue = jsonRow[colName];
@@ -370,14 +484,14 @@ DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQuery(const
             rowAsList << cellValue;
         }
 
-        executionResults.resultDataMap << rowAsMap;
-        executionResults.resultDataList << rowAsList;
+        results.resultDataMap << rowAsMap;
+        results.resultDataList << rowAsList;
 
         rowAsMap.clear();
         rowAsList.clear();
     }
 
-    return executionResults;
+    return true;
 }
 
 QJsonDocument DbAndroidJsonConnection::wrapQueryInJson(const QString& query)
@@ -388,6 +502,19 @@ QJsonDocument DbAndroidJsonConnection::wrapQueryInJson(const QString& query)
     rootObj["cmd"] = "QUERY";
     rootObj["db"] = dbUrl.getDbName();
     rootObj["query"] = query;
+    rootObj["batch"] = PAGE_SIZE;
+
+    doc.setObject(rootObj);
+    return doc;
+}
+
+QJsonDocument DbAndroidJsonConnection::wrapCursorCmdInJson(const QString& cmd, int cursorId)
+{
+    QJsonDocument doc;
+
+    QJsonObject rootObj;
+    rootObj["cmd"] = cmd;
+    rootObj["cursor"] = cursorId;
 
     doc.setObject(rootObj);
     return doc;
@@ -8,9 +8,21 @@
 #include <QObject>
 
 class DbAndroid;
-class AdbManager;
 class BlockingSocket;
 
+/**
+ * @brief Connection to the SQLiteStudioRemote service running on the Android device.
+ *
+ * Each message (in both directions) is a JSON document preceded by its size, as 4 bytes in little endian order.
+ *
+ * Queries are sent with a requested page size ("batch"). A service supporting paged results replies with columns,
+ * first page of rows (as arrays of values, in order of columns), a cursor identifier and a "more" flag.
+ * Following pages are requested with FETCH command for the cursor, until the "more" flag is false.
+ * A cursor that is not needed anymore is released with CLOSE command. BLOB values of paged results
+ * are sent as objects with base64 encoded "blob" member, which keeps them compact and binary-safe.
+ * Older services ignore the "batch" and reply with all rows at once (as objects keyed by column names),
+ * which is still supported.
+ */
 class DbAndroidJsonConnection : public DbAndroidConnection
 {
         Q_OBJECT
@@ -29,9 +41,14 @@ class DbAndroidJsonConnection : public DbAndroidConnection
         bool isAppOkay() const;
         bool deleteDatabase(const QString& dbName);
         ExecutionResult executeQuery(const QString& query);
+        bool fetchMore(ExecutionResult& results);
+        void closeCursor(ExecutionResult& results);
+
+        static const int PAGE_SIZE = 1000;
 
     private:
         QJsonDocument wrapQueryInJson(const QString& query);
+        QJsonDocument wrapCursorCmdInJson(const QString& cmd, int cursorId);
         bool connectToNetwork();
         bool connectToDevice();
         bool connectToTcp(const QString& ip, int port);
@@ -41,13 +58,15 @@ class DbAndroidJsonConnection : public DbAndroidConnection
         void handleConnectionFailed();
         QStringList handleDbListResult(const QByteArray& results);
         bool handleStdResult(const QByteArray& results);
+        bool handleQueryResult(const QByteArray& responseBytes, ExecutionResult& results);
+        bool readPagedRows(const QJsonObject& responseObject, ExecutionResult& results);
+        bool readLegacyRows(const QJsonObject& responseObject, ExecutionResult& results);
 
         static QByteArray sizeToBytes(qint32 size);
         static qint32 bytesToSize(const QByteArray& bytes);
         static QVariant convertJsonValue(const QJsonValue& value);
 
         DbAndroid* plugin = nullptr;
-        AdbManager* adbManager = nullptr;
         BlockingSocket* socket = nullptr;
         DbAndroidUrl dbUrl;
         DbAndroidMode mode = DbAndroidMode::NETWORK;
@@ -1,5 +1,6 @@
 #include "dbandroidshellconnection.h"
 #include "adbmanager.h"
+#include "dbandroidshellsession.h"
 #include "dbandroid.h"
 #include "services/notifymanager.h"
 #include "common/utils_sql.h"
@@ -13,6 +14,7 @@ DbAndroidShellConnection::DbAndroidShellConnection(DbAndroid* plugin, const QStr
 {
     this->adbManager = plugin->getAdbManager();
     this->creationDeviceName = deviceName;
+    session = new DbAndroidShellSession(this);
     connect(adbManager, SIGNAL(deviceListChanged(QStringList)), this, SLOT(checkForDisconnection(QStringList)));
 }
 
@@ -82,6 +84,7 @@ bool DbAndroidShellConnection::connectToAndroid(const DbAndroidUrl& url)
     // Try to connect to target database.
     connectionUrl = url;
     connected = true;
+    startSession();
 
     ExecutionResult response = executeQuery("select sqlite_version()");
     if (response.wasError)
@@ -97,6 +100,7 @@ bool DbAndroidShellConnection::connectToAndroid(const DbAndroidUrl& url)
 
 void DbAndroidShellConnection::disconnectFromAndroid()
 {
+    session->stop();
     connectionUrl = DbAndroidUrl();
     connected = false;
 }
@@ -170,15 +174,52 @@ bool DbAndroidShellConnection::deleteDatabase(const QString& dbName)
     return adbManager->exec(QStringList({"-s", connectionUrl.getDevice(), "shell", "run-as", connectionUrl.getApplication(), "rm", "-f", "databases/" + dbName, "databases/" + dbName + "-journal"}));
 }
 
-DbAndroidConnection::ExecutionResult DbAndroidShellConnection::executeQuery(const QString& query)
+void DbAndroidShellConnection::startSession()
 {
-    const static QStringList stdArguments = QStringList({"-s", connectionUrl.getDevice(), "shell", "run-as", "", "sqlite3", "-csv", "-separator", ",", "-batch", "-header"});
+    // Errors are redirected on the device, so they come in order with results.
+    QStringList args = QStringList({"-s", connectionUrl.getDevice(), "shell", "run-as", connectionUrl.getApplication(),
+                                    "sqlite3", "-csv", "-separator", ",", "-batch", "-header",
+                                    "databases/" + connectionUrl.getDbName(), "2>&1"});
+
+    if (!session->start(plugin->getCurrentAdb(), args))
+        qDebug() << "Persistent sqlite3 session is not available for" << connectionUrl.getDevice() << "/" << connectionUrl.getApplication()
+                 << "- every query will be executed with separate sqlite3 process.";
+}
+
+bool DbAndroidShellConnection::execSql(const QStringList& args, const QString& query, QByteArray* stdOut, QByteArray* stdErr)
+{
+    // Separate process gets the whole input at once, so it reports incomplete query as an error, instead of waiting for more.
+    if (session->isRunning() && DbAndroidShellSession::isComplete(query))
+    {
+        QByteArray output;
+        bool sqlError = false;
+        if (session->execute(query, output, sqlError))
+        {
+            if (sqlError)
+            {
+                *stdErr = output;
+                return false;
+            }
+
+            *stdOut = output;
+            return true;
+        }
 
-    // Prepare usual arguments
-    QStringList args = stdArguments;
-    args.replace(4, connectionUrl.getApplication());
+        qWarning() << "Persistent sqlite3 session on Android device is broken. Falling back to separate sqlite3 process for every query.";
+    }
+
+    QStringList fullArgs = args;
+    fullArgs << AdbManager::encode(query);
+    return adbManager->execBytes(fullArgs, stdOut, stdErr, true);
+}
+
+DbAndroidConnection::ExecutionResult DbAndroidShellConnection::executeQuery(const QString& query)
+{
+    // Prepare usual arguments (used if there is no persistent session)
+    QStringList args = QStringList({"-s", connectionUrl.getDevice(), "shell", "run-as", connectionUrl.getApplication(),
+                                    "sqlite3", "-csv", "-separator", ",", "-batch", "-header"});
     args << "databases/" + connectionUrl.getDbName();
-    args << AdbManager::encode(query);
+    QString finalQuery = query;
 
     // In case of SELECT we want to union typeof() for all columns first, then original query
     bool isSelect = false;
@@ -191,8 +232,7 @@ DbAndroidConnection::ExecutionResult DbAndroidShellConnection::executeQuery(cons
         if (columnNames.size() > 0)
         {
             firstHalfForTypes = true;
-            args.removeLast();
-            args << AdbManager::encode(appendTypeQueryPart(query, columnNames));
+            finalQuery = appendTypeQueryPart(query, columnNames);
         }
     }
 
@@ -200,7 +240,7 @@ DbAndroidConnection::ExecutionResult DbAndroidShellConnection::executeQuery(cons
     DbAndroidConnection::ExecutionResult results;
     QByteArray out;
     QByteArray err;
-    bool res = adbManager->execBytes(args, &out, &err, true);
+    bool res = execSql(args, finalQuery, &out, &err);
     if (!res)
     {
         results.wasError = true;
@@ -228,26 +268,22 @@ QStringList DbAndroidShellConnection::findColumns(const QStringList& originalArg
 {
     static_qstring(colQueryTpl, "SELECT * FROM (%1) LIMIT 1");
 
-    QStringList tmpArgs = originalArgs;
     QString tmpQuery = query.trimmed();
     if (tmpQuery.endsWith(";"))
         tmpQuery.chop(1);
 
     tmpQuery = colQueryTpl.arg(tmpQuery);
 
-    tmpArgs.removeLast();
-    tmpArgs << tmpQuery;
-
-    QString out;
-    QString err;
-    bool res = adbManager->exec(tmpArgs, &out, &err, true);
+    QByteArray out;
+    QByteArray err;
+    bool res = execSql(originalArgs, tmpQuery, &out, &err);
     if (!res)
     {
         qCritical() << "Error querying columns in DbAndroidShellConnection::findColumns(): " << out << "\n" << err;
         return QStringList();
     }
 
-    QList<QStringList> deserialized = CsvSerializer::deserialize(out, CSV_FORMAT);
+    QList<QStringList> deserialized = CsvSerializer::deserialize(AdbManager::decode(out), CSV_FORMAT);
     if (deserialized.size() < 1)
     {
         // There will be no results.
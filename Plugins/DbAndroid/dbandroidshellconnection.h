@@ -8,6 +8,7 @@
 
 class DbAndroid;
 class AdbManager;
+class DbAndroidShellSession;
 
 class DbAndroidShellConnection : public DbAndroidConnection
 {
@@ -38,6 +39,8 @@ class DbAndroidShellConnection : public DbAndroidConnection
             BLOB = 4
         };
 
+        void startSession();
+        bool execSql(const QStringList& args, const QString& query, QByteArray* stdOut, QByteArray* stdErr);
         QStringList findColumns(const QStringList& originalArgs, const QString& query);
         QString appendTypeQueryPart(const QString& query, const QStringList& columnNames);
         void extractResultData(const QList<QList<QByteArray> >& deserialized, bool firstHalfForTypes, ExecutionResult& results);
@@ -45,6 +48,7 @@ class DbAndroidShellConnection : public DbAndroidConnection
 
         DbAndroid* plugin = nullptr;
         AdbManager* adbManager = nullptr;
+        DbAndroidShellSession* session = nullptr;
         bool connected = false;
         DbAndroidUrl connectionUrl;
         bool appOkay = false;
@@ -0,0 +1,270 @@
+#include "dbandroidshellsession.h"
+#include "adbmanager.h"
+#include "common/global.h"
+#include "common/utils_sql.h"
+#include "parser/lexer.h"
+#include <QThread>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QDebug>
+
+DbAndroidShellSession::DbAndroidShellSession(QObject* parent) :
+    QObject(parent)
+{
+    sessionThread = new QThread;
+    session = new DbAndroidShellSessionPrivate;
+    session->moveToThread(sessionThread);
+
+    connect(sessionThread, &QThread::finished, session, &QObject::deleteLater);
+    connect(sessionThread, &QThread::finished, sessionThread, &QObject::deleteLater);
+    connect(this, SIGNAL(callForStart(QString,QStringList,bool&)), session, SLOT(handleStartCall(QString,QStringList,bool&)), Qt::BlockingQueuedConnection);
+    connect(this, SIGNAL(callForStop()), session, SLOT(handleStopCall()), Qt::BlockingQueuedConnection);
+    connect(this, SIGNAL(callForIsRunning(bool&)), session, SLOT(handleIsRunningCall(bool&)), Qt::BlockingQueuedConnection);
+    connect(this, SIGNAL(callForExecute(QString,QByteArray&,bool&,bool&)), session, SLOT(handleExecuteCall(QString,QByteArray&,bool&,bool&)), Qt::BlockingQueuedConnection);
+
+    sessionThread->start();
+}
+
+DbAndroidShellSession::~DbAndroidShellSession()
+{
+    QMutexLocker lock(&sessionOperationMutex);
+    emit callForStop();
+    sessionThread->quit();
+}
+
+bool DbAndroidShellSession::start(const QString& program, const QStringList& arguments)
+{
+    QMutexLocker lock(&sessionOperationMutex);
+    bool res = false;
+    emit callForStart(program, arguments, res);
+    return res;
+}
+
+void DbAndroidShellSession::stop()
+{
+    QMutexLocker lock(&sessionOperationMutex);
+    emit callForStop();
+}
+
+bool DbAndroidShellSession::isRunning()
+{
+    QMutexLocker lock(&sessionOperationMutex);
+    bool res = false;
+    emit callForIsRunning(res);
+    return res;
+}
+
+bool DbAndroidShellSession::isComplete(const QString& query)
+{
+    // The query is followed by a semicolon in a separate line (see DbAndroidShellSessionPrivate::execute()),
+    // so it's enough that nothing swallows that semicolon.
+    TokenList tokens = Lexer::tokenize(query.trimmed() + "\n;", Dialect::Sqlite3);
+    for (const TokenPtr& token : tokens)
+    {
+        if (token->type == Token::INVALID) // unterminated string or quoted name
+            return false;
+
+        if (token->type == Token::COMMENT && token->value.startsWith("/*") && (token->value.length() < 4 || !token->value.endsWith("*/")))
+            return false;
+    }
+
+    bool complete = false;
+    splitQueries(tokens, &complete);
+    return complete;
+}
+
+bool DbAndroidShellSession::execute(const QString& query, QByteArray& output, bool& sqlError)
+{
+    QMutexLocker lock(&sessionOperationMutex);
+    bool res = false;
+    emit callForExecute(query, output, sqlError, res);
+    return res;
+}
+
+DbAndroidShellSessionPrivate::DbAndroidShellSessionPrivate(QObject* parent) :
+    QObject(parent)
+{
+}
+
+void DbAndroidShellSessionPrivate::handleStartCall(const QString& program, const QStringList& arguments, bool& result)
+{
+    cleanUp();
+
+    process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    process->start(program, arguments);
+    if (!process->waitForStarted(START_TIMEOUT))
+    {
+        qWarning() << "Could not start sqlite3 session on Android device:" << process->errorString();
+        cleanUp();
+        result = false;
+        return;
+    }
+
+    // Empty query makes just the marker printed. Anything else (like a terminal echoing the input,
+    // or a run-as error) means that output of this session cannot be trusted.
+    QByteArray output;
+    bool sqlError = false;
+    result = execute(QString(), output, sqlError, START_TIMEOUT) && !sqlError && output.trimmed().isEmpty();
+    if (!result)
+    {
+        qWarning() << "The sqlite3 session on Android device did not respond as expected:" << AdbManager::decode(output).trimmed();
+        cleanUp();
+    }
+}
+
+void DbAndroidShellSessionPrivate::handleStopCall()
+{
+    cleanUp();
+}
+
+void DbAndroidShellSessionPrivate::handleIsRunningCall(bool& result)
+{
+    result = process && process->state() == QProcess::Running;
+}
+
+void DbAndroidShellSessionPrivate::handleExecuteCall(const QString& query, QByteArray& output, bool& sqlError, bool& result)
+{
+    result = execute(query, output, sqlError, EXECUTE_TIMEOUT);
+    if (!result)
+        cleanUp();
+}
+
+bool DbAndroidShellSessionPrivate::execute(const QString& query, QByteArray& output, bool& sqlError, int timeout)
+{
+    static_qstring(markerTpl, "--SQLiteStudio-end-of-results-%1--");
+
+    output.clear();
+    sqlError = false;
+    if (!process || process->state() != QProcess::Running)
+        return false;
+
+    QByteArray marker = markerTpl.arg(++markerCounter).toLatin1();
+    QByteArray input;
+    if (!query.trimmed().isEmpty())
+    {
+        // Semicolon in separate line, so it's not swallowed by the trailing comment of the query.
+        input = AdbManager::encode(query.trimmed());
+        input.append("\n;\n");
+    }
+    int firstQueryLine = inputLines + 1;
+    int lastQueryLine = inputLines + input.count('\n');
+    input.append(".print ").append(marker).append("\n");
+
+    if (process->write(input) != input.size())
+    {
+        qWarning() << "Could not write query to sqlite3 session on Android device:" << process->errorString();
+        return false;
+    }
+    inputLines += input.count('\n');
+
+    if (!readUntilMarker(marker, output, timeout))
+        return false;
+
+    sqlError = findError(output, firstQueryLine, lastQueryLine);
+    return true;
+}
+
+bool DbAndroidShellSessionPrivate::findError(QByteArray& output, int firstLine, int lastLine)
+{
+    // Older sqlite3 reports "Error: near line N: ...", newer ones distinguish "Parse error" and "Runtime error".
+    // Runtime error may come after some rows were already printed.
+    static const QRegularExpression errorRe("^(?:Error:|Parse error|Runtime error) near line (\\d+):",
+                                            QRegularExpression::MultilineOption);
+
+    if (firstLine > lastLine)
+        return false;
+
+    QString text = AdbManager::decode(output);
+    QRegularExpressionMatchIterator it = errorRe.globalMatch(text);
+    QRegularExpressionMatch match;
+    int line;
+    while (it.hasNext())
+    {
+        match = it.next();
+        line = match.captured(1).toInt();
+        if (line < firstLine || line > lastLine)
+            continue;
+
+        output = AdbManager::encode(text.mid(match.capturedStart()));
+        return true;
+    }
+    return false;
+}
+
+bool DbAndroidShellSessionPrivate::readUntilMarker(const QByteArray& marker, QByteArray& output, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int searchFrom = 0;
+    int markerPos;
+    int lineEnd;
+    while (true)
+    {
+        markerPos = buffer.indexOf(marker, searchFrom);
+        while (markerPos > 0 && buffer[markerPos - 1] != '\n')
+            markerPos = buffer.indexOf(marker, markerPos + 1);
+
+        if (markerPos > -1)
+        {
+            lineEnd = buffer.indexOf('\n', markerPos);
+            if (lineEnd > -1)
+            {
+                output = buffer.left(markerPos);
+                buffer.remove(0, lineEnd + 1);
+                return true;
+            }
+
+            searchFrom = markerPos;
+        }
+        else
+        {
+            // Marker can be split between reads, so the search is repeated for the last bit of the buffer.
+            searchFrom = qMax(0, buffer.size() - marker.size() - 1);
+        }
+
+        if (process->state() != QProcess::Running)
+        {
+            qWarning() << "The sqlite3 session on Android device has finished unexpectedly.";
+            return false;
+        }
+
+        // Timeout applies to the time without any output, so long results are read completely.
+        if (process->waitForReadyRead(READ_INTERVAL))
+        {
+            buffer.append(process->readAll());
+            timer.restart();
+            continue;
+        }
+
+        if (timeout > -1 && timer.hasExpired(timeout))
+        {
+            qWarning() << "The sqlite3 session on Android device did not respond in" << timeout << "ms.";
+            return false;
+        }
+    }
+}
+
+void DbAndroidShellSessionPrivate::cleanUp()
+{
+    buffer.clear();
+    inputLines = 0;
+    if (!process)
+        return;
+
+    if (process->state() != QProcess::NotRunning)
+    {
+        process->closeWriteChannel();
+        if (!process->waitForFinished(1000))
+        {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+
+    delete process;
+    process = nullptr;
+}
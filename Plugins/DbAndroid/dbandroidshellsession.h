@@ -0,0 +1,120 @@
+#ifndef DBANDROIDSHELLSESSION_H
+#define DBANDROIDSHELLSESSION_H
+
+#include <QObject>
+#include <QMutex>
+#include <QStringList>
+
+class QThread;
+class QProcess;
+class DbAndroidShellSessionPrivate;
+
+/**
+ * @brief Long running sqlite3 process on the Android device, used for executing many queries.
+ *
+ * The process is started once per connection (through "adb shell") and queries are written to its standard input.
+ * After each query a ".print" command with unique marker is written, so the end of query output is known
+ * without waiting for the process to finish. Error messages are redirected to the standard output on the device,
+ * so they are read in order with results. The sqlite3 runs in batch mode, so it reports the input line of the failed
+ * statement with each error. The session counts lines it writes, so an error is recognized only when it points to
+ * lines of the executed query, and result values that just look like error messages are not mistaken for them.
+ *
+ * The process lives in its own thread (just like BlockingSocket), so the session can be used from any thread.
+ * Calls are serialized.
+ */
+class DbAndroidShellSession : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit DbAndroidShellSession(QObject* parent = nullptr);
+        ~DbAndroidShellSession();
+
+        /**
+         * @brief Starts the sqlite3 process and verifies that it responds as expected.
+         * @param program ADB executable.
+         * @param arguments ADB arguments, up to the database file of the sqlite3 command.
+         * @return true if the session is ready for queries.
+         */
+        bool start(const QString& program, const QStringList& arguments);
+        void stop();
+        bool isRunning();
+
+        /**
+         * @brief Tells if the query can be executed in the session.
+         * @param query Query to check.
+         * @return true if sqlite3 will execute the query as soon as it's written.
+         *
+         * The sqlite3 waits for the rest of an incomplete input (like an unterminated string or comment,
+         * or a trigger without its END), so the end-of-results marker would never be printed.
+         * Such queries have to be executed with a separate sqlite3 process.
+         */
+        static bool isComplete(const QString& query);
+
+        /**
+         * @brief Executes query in the session.
+         * @param query Query to execute. It has to be complete (see isComplete()).
+         * @param output CSV output of the query, or the error message.
+         * @param sqlError Set to true when sqlite3 reported an error for the query.
+         * @return false if the session was broken (process died, or it didn't respond in EXECUTE_TIMEOUT). It's stopped in that case.
+         */
+        bool execute(const QString& query, QByteArray& output, bool& sqlError);
+
+    private:
+        QThread* sessionThread = nullptr;
+        DbAndroidShellSessionPrivate* session = nullptr;
+        QMutex sessionOperationMutex;
+
+    signals:
+        void callForStart(const QString& program, const QStringList& arguments, bool& result);
+        void callForStop();
+        void callForIsRunning(bool& result);
+        void callForExecute(const QString& query, QByteArray& output, bool& sqlError, bool& result);
+};
+
+class DbAndroidShellSessionPrivate : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit DbAndroidShellSessionPrivate(QObject* parent = nullptr);
+
+    private:
+        bool execute(const QString& query, QByteArray& output, bool& sqlError, int timeout);
+        bool readUntilMarker(const QByteArray& marker, QByteArray& output, int timeout);
+        void cleanUp();
+
+        /**
+         * @brief Looks for the sqlite3 error message reported for given lines of the input.
+         * @param output Output of the query. It's replaced with the error message, if one was found.
+         * @param firstLine First line of the query in the session input (counting from 1).
+         * @param lastLine Last line of the query in the session input.
+         * @return true if the error was found.
+         */
+        static bool findError(QByteArray& output, int firstLine, int lastLine);
+
+        QProcess* process = nullptr;
+        QByteArray buffer;
+        int markerCounter = 0;
+
+        /**
+         * @brief Number of lines written to the sqlite3 process so far.
+         */
+        int inputLines = 0;
+
+        static const int START_TIMEOUT = 10000;
+
+        /**
+         * @brief Time (in milliseconds) that sqlite3 may not print anything while executing a query.
+         */
+        static const int EXECUTE_TIMEOUT = 60000;
+        static const int READ_INTERVAL = 1000;
+
+    public slots:
+        void handleStartCall(const QString& program, const QStringList& arguments, bool& result);
+        void handleStopCall();
+        void handleIsRunningCall(bool& result);
+        void handleExecuteCall(const QString& query, QByteArray& output, bool& sqlError, bool& result);
+};
+
+#endif // DBANDROIDSHELLSESSION_H
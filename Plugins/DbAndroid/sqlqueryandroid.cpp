@@ -16,6 +16,7 @@ SqlQueryAndroid::SqlQueryAndroid(DbAndroidInstance* db, DbAndroidConnection* con
 
 SqlQueryAndroid::~SqlQueryAndroid()
 {
+    closeCursor();
 }
 
 QString SqlQueryAndroid::getErrorText()
@@ -40,12 +41,24 @@ int SqlQueryAndroid::columnCount()
 
 void SqlQueryAndroid::rewind()
 {
-    currentRow = -1;
+    if (pageOffset == 0)
+    {
+        currentRow = -1;
+        return;
+    }
+
+    // Earlier pages are gone already, so the query has to be executed again.
+    QString query = executedQuery;
+    resetResponse();
+    executeAndHandleResponse(query);
 }
 
 SqlResultsRowPtr SqlQueryAndroid::nextInternal()
 {
-    if (resultDataList.size() == 0)
+    if (currentRow + 1 >= resultDataList.size() && hasMore)
+        fetchNextPage();
+
+    if (currentRow + 1 >= resultDataList.size())
         return SqlResultsRowPtr();
 
     currentRow++;
@@ -55,6 +68,9 @@ SqlResultsRowPtr SqlQueryAndroid::nextInternal()
 
 bool SqlQueryAndroid::hasNextInternal()
 {
+    if (currentRow + 1 >= resultDataList.size() && hasMore)
+        fetchNextPage();
+
     return (currentRow + 1 < resultDataList.size());
 }
 
@@ -135,6 +151,7 @@ QString SqlQueryAndroid::convertArg(const QVariant& value)
 
 bool SqlQueryAndroid::executeAndHandleResponse(const QString& query)
 {
+    executedQuery = query;
     DbAndroidConnection::ExecutionResult results = connection->executeQuery(query);
     if (results.wasError)
     {
@@ -146,15 +163,57 @@ bool SqlQueryAndroid::executeAndHandleResponse(const QString& query)
     resultColumns = results.resultColumns;
     resultDataMap = results.resultDataMap;
     resultDataList = results.resultDataList;
+    cursorId = results.cursorId;
+    hasMore = results.hasMore;
     return true;
 }
 
+bool SqlQueryAndroid::fetchNextPage()
+{
+    DbAndroidConnection::ExecutionResult results;
+    results.resultColumns = resultColumns;
+    results.cursorId = cursorId;
+    results.hasMore = hasMore;
+    if (!connection->fetchMore(results) || results.wasError)
+    {
+        errorCode = (results.errorCode != 0) ? results.errorCode : SqlErrorCode::OTHER_EXECUTION_ERROR;
+        errorText = results.errorMsg;
+        cursorId = -1;
+        hasMore = false;
+        return false;
+    }
+
+    // Rows of previous page were consumed already, only the current page is kept in the memory.
+    pageOffset += resultDataList.size();
+    resultDataMap = results.resultDataMap;
+    resultDataList = results.resultDataList;
+    cursorId = results.cursorId;
+    hasMore = results.hasMore;
+    currentRow = -1;
+    return true;
+}
+
+void SqlQueryAndroid::closeCursor()
+{
+    if (!hasMore || cursorId < 0)
+        return;
+
+    DbAndroidConnection::ExecutionResult results;
+    results.cursorId = cursorId;
+    results.hasMore = hasMore;
+    connection->closeCursor(results);
+    cursorId = -1;
+    hasMore = false;
+}
+
 void SqlQueryAndroid::resetResponse()
 {
+    closeCursor();
     resultColumns.clear();
     resultDataMap.clear();
     resultDataList.clear();
     currentRow = -1;
+    pageOffset = 0;
     errorCode = 0;
     errorText = QString();
 }
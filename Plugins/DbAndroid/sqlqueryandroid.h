@@ -28,6 +28,8 @@ class SqlQueryAndroid : public SqlQuery
 
     private:
         bool executeAndHandleResponse(const QString& query);
+        bool fetchNextPage();
+        void closeCursor();
         void resetResponse();
 
         static QString convertArg(const QVariant& value);
@@ -42,6 +44,10 @@ class SqlQueryAndroid : public SqlQuery
         QList<QVariantHash> resultDataMap;
         QList<QVariantList> resultDataList;
         int currentRow = -1;
+        int cursorId = -1;
+        bool hasMore = false;
+        int pageOffset = 0;
+        QString executedQuery;
 };
 
 #endif // SQLQUERYANDROID_H
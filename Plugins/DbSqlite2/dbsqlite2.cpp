@@ -41,3 +41,18 @@ bool DbSqlite2::checkIfDbServedByPlugin(Db* db) const
 {
     return (db && dynamic_cast<DbSqlite2Instance*>(db));
 }
+
+bool DbSqlite2::isFileFormatSupported(DbFileProber::Format format) const
+{
+    switch (format)
+    {
+        case DbFileProber::Format::SQLITE2:
+        case DbFileProber::Format::EMPTY:
+        case DbFileProber::Format::UNREADABLE:
+            return true;
+        case DbFileProber::Format::SQLITE3:
+        case DbFileProber::Format::UNKNOWN:
+            break;
+    }
+    return false;
+}
@@ -17,6 +17,7 @@ class DBSQLITE2SHARED_EXPORT DbSqlite2 : public GenericPlugin, public DbPluginSt
 
         QString getLabel() const;
         bool checkIfDbServedByPlugin(Db* db) const;
+        bool isFileFormatSupported(DbFileProber::Format format) const;
         QList<DbPluginOption> getOptionsList() const;
         bool init();
         void deinit();
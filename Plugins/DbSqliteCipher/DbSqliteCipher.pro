@@ -14,7 +14,8 @@ TEMPLATE = lib
 DEFINES += DBSQLITECIPHER_LIBRARY
 
 SOURCES += dbsqlitecipher.cpp \
-    dbsqlitecipherinstance.cpp
+    dbsqlitecipherinstance.cpp \
+    dbsqlitecipherconverter.cpp
 
 !unix|isEmpty(SQLCIPHER_LIB): {
     SOURCES += sqlcipher.c
@@ -22,7 +23,8 @@ SOURCES += dbsqlitecipher.cpp \
 
 HEADERS += dbsqlitecipher.h \
     dbsqlitecipher_global.h \
-    dbsqlitecipherinstance.h
+    dbsqlitecipherinstance.h \
+    dbsqlitecipherconverter.h
     sqlcipher.h
 
 !macx: {
@@ -34,7 +36,7 @@ win32: {
     LIBS += -leay32 -lcoreSQLiteStudio
 }
 
-!win32:isEmpty(SQLCIPHER_LIB) {
+!win32: {
     LIBS += -lcrypto
 }
 
@@ -0,0 +1,566 @@
+#include "dbsqlitecipherconverter.h"
+#include "dbsqlitecipher.h"
+#include "dbsqlitecipherinstance.h"
+#include "common/global.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <cstring>
+
+#ifdef SQLCIPHER_SYSTEM_LIB
+#  define SQLCIPHER_API(Name) Name
+#else
+#  define SQLCIPHER_API(Name) sqlcipher_##Name
+#endif
+
+typedef SQLCIPHER_API(sqlite3_file) SqlCipherFile;
+
+DbSqliteCipherConverter::Settings::Settings() :
+    cipher(DbSqliteCipher::DEF_CIPHER), kdfIter(DbSqliteCipher::DEF_KDF_ITER), pageSize(DbSqliteCipher::DEF_CIPHER_PAGE_SIZE), useHmac(true)
+{
+}
+
+DbSqliteCipherConverter::Settings DbSqliteCipherConverter::Settings::fromConnectionOptions(const QHash<QString, QVariant>& options)
+{
+    Settings settings;
+    settings.password = options[DbSqliteCipher::PASSWORD_OPT].toString();
+
+    QString cipher = options[DbSqliteCipher::CIPHER_OPT].toString();
+    if (!cipher.isEmpty())
+        settings.cipher = cipher;
+
+    if (options.contains(DbSqliteCipher::KDF_ITER_OPT) && options[DbSqliteCipher::KDF_ITER_OPT].toInt() >= 0)
+        settings.kdfIter = options[DbSqliteCipher::KDF_ITER_OPT].toInt();
+
+    if (options.contains(DbSqliteCipher::CIPHER_PAGE_SIZE_OPT) && options[DbSqliteCipher::CIPHER_PAGE_SIZE_OPT].toInt() > 0)
+        settings.pageSize = options[DbSqliteCipher::CIPHER_PAGE_SIZE_OPT].toInt();
+
+    settings.useHmac = !options[DbSqliteCipher::CIPHER_1_1_OPT].toBool();
+    return settings;
+}
+
+DbSqliteCipherConverter::DbSqliteCipherConverter(const Settings& source, const Settings& target) :
+    source(source), target(target)
+{
+    threads = QThread::idealThreadCount();
+    pool = new QThreadPool();
+    pool->setMaxThreadCount(threads);
+}
+
+DbSqliteCipherConverter::~DbSqliteCipherConverter()
+{
+    closeSource();
+    safe_delete(pool);
+}
+
+QString DbSqliteCipherConverter::getErrorText() const
+{
+    return errorText;
+}
+
+qint64 DbSqliteCipherConverter::getPageCount() const
+{
+    return pageCount;
+}
+
+void DbSqliteCipherConverter::setThreads(int value)
+{
+    threads = qMax(1, value);
+    pool->setMaxThreadCount(threads);
+}
+
+void DbSqliteCipherConverter::setChunkPages(int value)
+{
+    chunkPages = qMax(1, value);
+}
+
+bool DbSqliteCipherConverter::convert(const QString& inputPath, const QString& outputPath)
+{
+    errorText.clear();
+    pageCount = 0;
+
+    if (QFileInfo(inputPath).canonicalFilePath() == QFileInfo(outputPath).canonicalFilePath())
+    {
+        errorText = QObject::tr("Database cannot be converted into itself.");
+        return false;
+    }
+
+    if (!prepareCipher())
+        return false;
+
+    bool success = openSource(inputPath) && convertPages(inputPath, outputPath);
+    closeSource();
+    return success;
+}
+
+bool DbSqliteCipherConverter::convertPages(const QString& inputPath, const QString& outputPath)
+{
+    // Checked with the read transaction open, so no new changes can get to the WAL file, nor be checkpointed.
+    if (QFileInfo(inputPath + "-wal").size() > 0)
+    {
+        errorText = QObject::tr("Database has changes that are not checkpointed from the WAL file yet.");
+        return false;
+    }
+
+    if (sourceSize == 0 || sourceSize % source.pageSize != 0)
+    {
+        errorText = QObject::tr("Size of file %1 is not a multiple of the cipher page size (%2).").arg(inputPath, QString::number(source.pageSize));
+        return false;
+    }
+
+    pageCount = sourceSize / source.pageSize;
+    QByteArray firstPage(source.pageSize, '\0');
+    if (!readSource(firstPage.data(), source.pageSize, 0))
+        return false;
+
+    salt = firstPage.left(SALT_SIZE);
+
+    // Both key derivations are slow by design and don't depend on each other.
+    QFuture<Keys> sourceFuture = QtConcurrent::run(pool, &DbSqliteCipherConverter::deriveKeys, source.password, salt,
+                                                   source.kdfIter, keySize, source.useHmac);
+    if (!target.password.isEmpty())
+        targetKeys = deriveKeys(target.password, salt, target.kdfIter, keySize, target.useHmac);
+
+    sourceKeys = sourceFuture.result();
+
+    if (!checkFirstPage(firstPage))
+        return false;
+
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        errorText = QObject::tr("Could not open file %1 for writing: %2").arg(outputPath, output.errorString());
+        return false;
+    }
+
+    QByteArray inBuffer(chunkPages * source.pageSize, '\0');
+    QByteArray outBuffer(chunkPages * source.pageSize, '\0');
+    QByteArray randomBuffer;
+    bool encrypt = !target.password.isEmpty();
+    if (encrypt)
+        randomBuffer.resize(chunkPages * reserveSize);
+
+    Chunk chunk;
+    bool success = true;
+    for (qint64 firstPgno = 1; firstPgno <= pageCount && success; firstPgno += chunkPages)
+    {
+        chunk.firstPage = firstPgno;
+        chunk.pages = static_cast<int>(qMin<qint64>(chunkPages, pageCount - firstPgno + 1));
+        if (!readSource(inBuffer.data(), static_cast<qint64>(chunk.pages) * source.pageSize, (firstPgno - 1) * source.pageSize))
+        {
+            success = false;
+            break;
+        }
+
+        // Random bytes are drawn in order of pages, so the output doesn't depend on how pages are split between threads.
+        if (encrypt && RAND_bytes(reinterpret_cast<unsigned char*>(randomBuffer.data()), chunk.pages * reserveSize) != 1)
+        {
+            errorText = QObject::tr("Could not generate random bytes for encryption.");
+            success = false;
+            break;
+        }
+
+        chunk.input = inBuffer.constData();
+        chunk.output = outBuffer.data();
+        chunk.random = reinterpret_cast<const unsigned char*>(randomBuffer.constData());
+        success = processChunk(chunk) && writeAll(output, chunk.output, static_cast<qint64>(chunk.pages) * source.pageSize);
+    }
+
+    output.close();
+    if (!success)
+        QFile::remove(outputPath);
+
+    return success;
+}
+
+bool DbSqliteCipherConverter::openSource(const QString& inputPath)
+{
+    SqlCipher::handle* handle = nullptr;
+    int res = SqlCipher::open_v2(inputPath.toUtf8().constData(), &handle, SqlCipher::OPEN_READWRITE, nullptr);
+    sourceHandle = handle;
+    if (res != SqlCipher::OK)
+    {
+        errorText = QObject::tr("Could not open file %1 for reading: %2").arg(inputPath, QString::fromUtf8(SqlCipher::errmsg(handle)));
+        return false;
+    }
+
+    // Reading the schema verifies the key and starts the read transaction, which keeps the file unchanged.
+    QStringList queries = {
+        DbSqliteCipherInstance::getKeyPragma(source.password),
+        QString("PRAGMA cipher = '%1';").arg(source.cipher),
+        QString("PRAGMA kdf_iter = %1;").arg(source.kdfIter),
+        QString("PRAGMA cipher_page_size = %1;").arg(source.pageSize),
+        QString("PRAGMA cipher_use_hmac = %1;").arg(source.useHmac ? "ON" : "OFF"),
+        "BEGIN;",
+        "SELECT count(*) FROM sqlite_master;"
+    };
+
+    for (const QString& query : queries)
+    {
+        if (!execSource(query))
+            return false;
+    }
+
+    SqlCipherFile* file = nullptr;
+    if (SQLCIPHER_API(sqlite3_file_control)(handle, "main", SQLITE_FCNTL_FILE_POINTER, &file) != SqlCipher::OK || !file || !file->pMethods)
+    {
+        errorText = QObject::tr("Could not access file %1 of the open database.").arg(inputPath);
+        return false;
+    }
+    sourceFile = file;
+
+    SqlCipher::int64 size = 0;
+    if (file->pMethods->xFileSize(file, &size) != SqlCipher::OK)
+    {
+        errorText = QObject::tr("Could not read size of file %1.").arg(inputPath);
+        return false;
+    }
+    sourceSize = size;
+    return true;
+}
+
+void DbSqliteCipherConverter::closeSource()
+{
+    if (!sourceHandle)
+        return;
+
+    // Closing the connection ends the read transaction.
+    SqlCipher::close(static_cast<SqlCipher::handle*>(sourceHandle));
+    sourceHandle = nullptr;
+    sourceFile = nullptr;
+    sourceSize = 0;
+}
+
+bool DbSqliteCipherConverter::execSource(const QString& sql)
+{
+    SqlCipher::handle* handle = static_cast<SqlCipher::handle*>(sourceHandle);
+    SqlCipher::stmt* stmt = nullptr;
+    QByteArray sqlBytes = sql.toUtf8();
+    int res = SqlCipher::prepare_v2(handle, sqlBytes.constData(), sqlBytes.size(), &stmt, nullptr);
+    if (res == SqlCipher::OK)
+    {
+        while ((res = SqlCipher::step(stmt)) == SqlCipher::ROW)
+            continue;
+    }
+
+    if (res != SqlCipher::OK && res != SqlCipher::DONE)
+    {
+        errorText = QObject::tr("Could not read the source database. The key or cipher settings may be invalid. Details: %1")
+                .arg(QString::fromUtf8(SqlCipher::errmsg(handle)));
+    }
+
+    SqlCipher::finalize(stmt);
+    return res == SqlCipher::OK || res == SqlCipher::DONE;
+}
+
+bool DbSqliteCipherConverter::readSource(char* data, qint64 size, qint64 offset)
+{
+    SqlCipherFile* file = static_cast<SqlCipherFile*>(sourceFile);
+    if (file->pMethods->xRead(file, data, static_cast<int>(size), offset) != SqlCipher::OK)
+    {
+        errorText = QObject::tr("Could not read %1 bytes at offset %2 of the source database.").arg(size).arg(offset);
+        return false;
+    }
+    return true;
+}
+
+bool DbSqliteCipherConverter::prepareCipher()
+{
+    if (source.password.isEmpty())
+    {
+        errorText = QObject::tr("Source database is not encrypted. Use sqlcipher_export() to encrypt it.");
+        return false;
+    }
+
+    if (source.cipher != target.cipher || source.pageSize != target.pageSize || (!target.password.isEmpty() && source.useHmac != target.useHmac))
+    {
+        errorText = QObject::tr("Cipher, page size and HMAC usage cannot be changed by page conversion. Use sqlcipher_export() instead.");
+        return false;
+    }
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    OpenSSL_add_all_ciphers();
+#endif
+
+    evpCipher = EVP_get_cipherbyname(source.cipher.toLatin1().constData());
+    if (!evpCipher)
+    {
+        errorText = QObject::tr("Unknown cipher: %1").arg(source.cipher);
+        return false;
+    }
+
+    // Same rules as in SQLCipher: reserved space holds IV and HMAC, rounded up to the cipher block size.
+    keySize = EVP_CIPHER_key_length(evpCipher);
+    ivSize = EVP_CIPHER_iv_length(evpCipher);
+    hmacSize = EVP_MD_size(EVP_sha1());
+    int blockSize = EVP_CIPHER_block_size(evpCipher);
+    reserveSize = MAX_IV_SIZE + (source.useHmac ? hmacSize : 0);
+    if (reserveSize % blockSize != 0)
+        reserveSize = (reserveSize / blockSize + 1) * blockSize;
+
+    if (reserveSize >= source.pageSize / 2)
+    {
+        errorText = QObject::tr("Cipher page size %1 is too small.").arg(source.pageSize);
+        return false;
+    }
+
+    return checkRawKey(source.password) && checkRawKey(target.password);
+}
+
+bool DbSqliteCipherConverter::checkRawKey(const QString& password)
+{
+    if (!isRawKey(password) || !decodeRawKey(password, keySize).isEmpty())
+        return true;
+
+    // SQLCipher would treat it as a passphrase, or take the salt from it, which would not match pages of the file.
+    errorText = QObject::tr("Raw key must consist of exactly %1 hexadecimal digits, given as x'...'. Raw key with explicit salt "
+                            "is not supported by page conversion.").arg(keySize * 2);
+    return false;
+}
+
+bool DbSqliteCipherConverter::checkFirstPage(const QByteArray& firstPage)
+{
+    // Wrong key is detected by HMAC, but without HMAC the decrypted header is the only hint.
+    QByteArray plain(source.pageSize, '\0');
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    QString pageError;
+    bool res = decryptPage(1, reinterpret_cast<const unsigned char*>(firstPage.constData()), reinterpret_cast<unsigned char*>(plain.data()), ctx, pageError);
+    EVP_CIPHER_CTX_free(ctx);
+    if (!res)
+    {
+        errorText = pageError;
+        return false;
+    }
+
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(plain.constData());
+    int pageSizeInHeader = (header[16] << 8) | header[17];
+    if (pageSizeInHeader == 1)
+        pageSizeInHeader = 65536;
+
+    if (pageSizeInHeader != source.pageSize || header[20] != reserveSize)
+    {
+        errorText = QObject::tr("Could not decrypt the database. The key or cipher settings are invalid.");
+        return false;
+    }
+
+    return true;
+}
+
+bool DbSqliteCipherConverter::processChunk(const Chunk& chunk)
+{
+    int workers = qMin(threads, chunk.pages);
+    if (workers <= 1)
+        return processPages(chunk, 0, chunk.pages, errorText);
+
+    QList<QFuture<bool>> futures;
+    QVector<QString> errors(workers);
+    int perWorker = chunk.pages / workers;
+    int extra = chunk.pages % workers;
+    int from = 0;
+    int to;
+    for (int i = 0; i < workers; i++)
+    {
+        to = from + perWorker + (i < extra ? 1 : 0);
+        futures << QtConcurrent::run(pool, [this, &chunk, &errors, from, to, i]() -> bool
+        {
+            return processPages(chunk, from, to, errors[i]);
+        });
+        from = to;
+    }
+
+    bool success = true;
+    for (int i = 0; i < workers; i++)
+    {
+        if (!futures[i].result() && success)
+        {
+            errorText = errors[i];
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+bool DbSqliteCipherConverter::processPages(const Chunk& chunk, int from, int to, QString& pageError) const
+{
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    bool encrypt = !target.password.isEmpty();
+    QByteArray plainBuffer(source.pageSize, '\0');
+    unsigned char* plain = reinterpret_cast<unsigned char*>(plainBuffer.data());
+    const unsigned char* in;
+    unsigned char* out;
+    qint64 pgno;
+    bool success = true;
+    for (int i = from; i < to && success; i++)
+    {
+        pgno = chunk.firstPage + i;
+        in = reinterpret_cast<const unsigned char*>(chunk.input) + static_cast<qint64>(i) * source.pageSize;
+        out = reinterpret_cast<unsigned char*>(chunk.output) + static_cast<qint64>(i) * source.pageSize;
+        if (!encrypt)
+        {
+            success = decryptPage(pgno, in, out, ctx, pageError);
+            continue;
+        }
+
+        success = decryptPage(pgno, in, plain, ctx, pageError);
+        if (success)
+            encryptPage(pgno, plain, chunk.random + static_cast<qint64>(i) * reserveSize, out, ctx);
+    }
+
+    EVP_CIPHER_CTX_free(ctx);
+    return success;
+}
+
+bool DbSqliteCipherConverter::decryptPage(qint64 pgno, const unsigned char* in, unsigned char* plain, void* cipherCtx, QString& pageError) const
+{
+    static const char sqliteHeader[] = "SQLite format 3";
+
+    int offset = (pgno == 1) ? SALT_SIZE : 0;
+    int size = source.pageSize - offset - reserveSize;
+    const unsigned char* src = in + offset;
+    if (source.useHmac)
+    {
+        QByteArray hmac = pageHmac(sourceKeys.hmacKey, pgno, src, size + ivSize);
+        if (memcmp(hmac.constData(), src + size + ivSize, hmacSize) != 0)
+        {
+            // Zeroed page (not written yet), SQLCipher also accepts these.
+            bool allZeros = true;
+            for (int i = 0, total = source.pageSize - offset; i < total && allZeros; i++)
+                allZeros = (src[i] == 0);
+
+            if (!allZeros)
+            {
+                pageError = QObject::tr("HMAC check failed for page %1. The key is invalid or the page is corrupted.").arg(pgno);
+                return false;
+            }
+
+            memset(plain, 0, source.pageSize);
+            return true;
+        }
+    }
+
+    EVP_CIPHER_CTX* ctx = static_cast<EVP_CIPHER_CTX*>(cipherCtx);
+    int outLength = 0;
+    int finalLength = 0;
+    EVP_CipherInit_ex(ctx, evpCipher, nullptr, nullptr, nullptr, 0);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+    EVP_CipherInit_ex(ctx, nullptr, nullptr, reinterpret_cast<const unsigned char*>(sourceKeys.key.constData()), src + size, 0);
+    EVP_CipherUpdate(ctx, plain + offset, &outLength, src, size);
+    EVP_CipherFinal_ex(ctx, plain + offset + outLength, &finalLength);
+
+    memset(plain + offset + size, 0, reserveSize);
+    if (pgno == 1)
+        memcpy(plain, sqliteHeader, SALT_SIZE); // including terminating zero
+
+    return true;
+}
+
+void DbSqliteCipherConverter::encryptPage(qint64 pgno, const unsigned char* plain, const unsigned char* random, unsigned char* out, void* cipherCtx) const
+{
+    int offset = (pgno == 1) ? SALT_SIZE : 0;
+    int size = target.pageSize - offset - reserveSize;
+    unsigned char* dst = out + offset;
+
+    // Reserved space starts with IV, then HMAC, the rest stays random, just like SQLCipher does it.
+    memcpy(dst + size, random, reserveSize);
+
+    EVP_CIPHER_CTX* ctx = static_cast<EVP_CIPHER_CTX*>(cipherCtx);
+    int outLength = 0;
+    int finalLength = 0;
+    EVP_CipherInit_ex(ctx, evpCipher, nullptr, nullptr, nullptr, 1);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+    EVP_CipherInit_ex(ctx, nullptr, nullptr, reinterpret_cast<const unsigned char*>(targetKeys.key.constData()), dst + size, 1);
+    EVP_CipherUpdate(ctx, dst, &outLength, plain + offset, size);
+    EVP_CipherFinal_ex(ctx, dst + outLength, &finalLength);
+
+    if (target.useHmac)
+    {
+        QByteArray hmac = pageHmac(targetKeys.hmacKey, pgno, dst, size + ivSize);
+        memcpy(dst + size + ivSize, hmac.constData(), hmacSize);
+    }
+
+    if (pgno == 1)
+        memcpy(out, salt.constData(), SALT_SIZE);
+}
+
+bool DbSqliteCipherConverter::writeAll(QFile& file, const char* data, qint64 size)
+{
+    if (file.write(data, size) != size)
+    {
+        errorText = QObject::tr("Could not write file %1: %2").arg(file.fileName(), file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool DbSqliteCipherConverter::isRawKey(const QString& password)
+{
+    return password.size() > 2 && password.toLower().startsWith("x'") && password.endsWith("'");
+}
+
+QByteArray DbSqliteCipherConverter::decodeRawKey(const QString& password, int keySize)
+{
+    static const QRegularExpression hexRe("^[0-9a-fA-F]*$");
+
+    QString hex = password.mid(2, password.size() - 3);
+    if (!isRawKey(password) || hex.size() != keySize * 2 || !hexRe.match(hex).hasMatch())
+        return QByteArray();
+
+    return QByteArray::fromHex(hex.toLatin1());
+}
+
+DbSqliteCipherConverter::Keys DbSqliteCipherConverter::deriveKeys(const QString& password, const QByteArray& salt, int kdfIter, int keySize, bool useHmac)
+{
+    Keys keys;
+    keys.key.resize(keySize);
+
+    // Raw key given as x'...' hex literal is used directly, without the KDF. Invalid raw keys are rejected by checkRawKey().
+    if (isRawKey(password))
+    {
+        keys.key = decodeRawKey(password, keySize);
+    }
+    else
+    {
+        QByteArray passwordBytes = password.toUtf8();
+        PKCS5_PBKDF2_HMAC_SHA1(passwordBytes.constData(), passwordBytes.size(), reinterpret_cast<const unsigned char*>(salt.constData()), salt.size(),
+                               kdfIter, keySize, reinterpret_cast<unsigned char*>(keys.key.data()));
+    }
+
+    if (!useHmac)
+        return keys;
+
+    QByteArray hmacSalt = salt;
+    for (int i = 0; i < hmacSalt.size(); i++)
+        hmacSalt[i] = hmacSalt[i] ^ HMAC_SALT_MASK;
+
+    keys.hmacKey.resize(keySize);
+    PKCS5_PBKDF2_HMAC_SHA1(keys.key.constData(), keySize, reinterpret_cast<const unsigned char*>(hmacSalt.constData()), hmacSalt.size(),
+                           FAST_KDF_ITER, keySize, reinterpret_cast<unsigned char*>(keys.hmacKey.data()));
+    return keys;
+}
+
+QByteArray DbSqliteCipherConverter::pageHmac(const QByteArray& hmacKey, qint64 pgno, const unsigned char* data, int size)
+{
+    // Page number is appended in little endian order (SQLCipher's default).
+    QByteArray input(reinterpret_cast<const char*>(data), size);
+    quint32 pgno32 = static_cast<quint32>(pgno);
+    for (int i = 0; i < 4; i++)
+        input.append(static_cast<char>((pgno32 >> (8*i)) & 0xff));
+
+    QByteArray hmac(EVP_MAX_MD_SIZE, '\0');
+    unsigned int hmacLength = 0;
+    HMAC(EVP_sha1(), hmacKey.constData(), hmacKey.size(), reinterpret_cast<const unsigned char*>(input.constData()), input.size(),
+         reinterpret_cast<unsigned char*>(hmac.data()), &hmacLength);
+
+    hmac.resize(static_cast<int>(hmacLength));
+    return hmac;
+}
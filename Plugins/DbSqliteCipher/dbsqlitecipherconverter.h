@@ -0,0 +1,125 @@
+#ifndef DBSQLITECIPHERCONVERTER_H
+#define DBSQLITECIPHERCONVERTER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QVariant>
+
+class QFile;
+class QThreadPool;
+typedef struct evp_cipher_st EVP_CIPHER;
+
+/**
+ * @brief Changes the key of SQLCipher database file, or decrypts it, page by page.
+ *
+ * This is an alternative to PRAGMA rekey and sqlcipher_export() for big databases. Instead of passing every page
+ * through the SQLCipher codec in a single thread, the file is read in chunks of pages and pages of a chunk
+ * are decrypted and encrypted again by several threads. Chunks are written in order.
+ * Both key derivations (for old and new key) are also done in parallel.
+ *
+ * Random bytes needed for encrypted pages (initialization vectors and the rest of the reserved space)
+ * are drawn in order of pages, before the chunk is passed to the threads. Therefore the output doesn't depend
+ * on the number of threads - with the same random bytes it's byte-identical to the serial conversion (single thread).
+ * The decrypted output is always byte-identical.
+ *
+ * The page layout is not changed, so the cipher, page size and HMAC usage of the target must be the same
+ * as in the source. The salt is kept, just like PRAGMA rekey does. The decrypted database keeps reserved space
+ * at the end of each page (filled with zeros), which is valid for SQLite.
+ *
+ * The source file is read through its own SQLCipher connection, which holds a read transaction for the whole
+ * conversion, so the database cannot be modified in the meantime. Pages are read with the file handle of that
+ * connection, so no other handle to the file is opened (closing it would release SQLite locks on POSIX systems).
+ * The source file must not have uncheckpointed changes in the WAL file.
+ *
+ * Users run the conversion with the sqlcipher_convert() SQL function of SQLCipher connections,
+ * see DbSqliteCipherInstance::CONVERT_FUNCTION.
+ */
+class DbSqliteCipherConverter
+{
+    public:
+        struct Settings
+        {
+            QString password;           /**< Empty password means plain (not encrypted) database. Raw key is given as x'...' with hex digits of the key. */
+            QString cipher;
+            int kdfIter;
+            int pageSize;
+            bool useHmac;
+
+            Settings();
+
+            static Settings fromConnectionOptions(const QHash<QString, QVariant>& options);
+        };
+
+        DbSqliteCipherConverter(const Settings& source, const Settings& target);
+        ~DbSqliteCipherConverter();
+
+        bool convert(const QString& inputPath, const QString& outputPath);
+        QString getErrorText() const;
+        qint64 getPageCount() const;
+
+        void setThreads(int value);
+        void setChunkPages(int value);
+
+    private:
+        struct Keys
+        {
+            QByteArray key;
+            QByteArray hmacKey;
+        };
+
+        struct Chunk
+        {
+            qint64 firstPage;           /**< Page number (1-based) of the first page in the chunk. */
+            int pages;
+            const char* input;
+            char* output;
+            const unsigned char* random;
+        };
+
+        bool prepareCipher();
+        bool convertPages(const QString& inputPath, const QString& outputPath);
+        bool openSource(const QString& inputPath);
+        void closeSource();
+        bool execSource(const QString& sql);
+        bool readSource(char* data, qint64 size, qint64 offset);
+        bool checkFirstPage(const QByteArray& firstPage);
+        bool checkRawKey(const QString& password);
+        bool processPages(const Chunk& chunk, int from, int to, QString& errorText) const;
+        bool decryptPage(qint64 pgno, const unsigned char* in, unsigned char* plain, void* cipherCtx, QString& errorText) const;
+        void encryptPage(qint64 pgno, const unsigned char* plain, const unsigned char* random, unsigned char* out, void* cipherCtx) const;
+        bool processChunk(const Chunk& chunk);
+        bool writeAll(QFile& file, const char* data, qint64 size);
+
+        static bool isRawKey(const QString& password);
+        static QByteArray decodeRawKey(const QString& password, int keySize);
+        static Keys deriveKeys(const QString& password, const QByteArray& salt, int kdfIter, int keySize, bool useHmac);
+        static QByteArray pageHmac(const QByteArray& hmacKey, qint64 pgno, const unsigned char* data, int size);
+
+        Settings source;
+        Settings target;
+        QThreadPool* pool = nullptr;
+        int threads;
+        int chunkPages = 1024;
+        qint64 pageCount = 0;
+        QString errorText;
+        void* sourceHandle = nullptr;
+        void* sourceFile = nullptr;
+        qint64 sourceSize = 0;
+
+        const EVP_CIPHER* evpCipher = nullptr;
+        int keySize = 0;
+        int ivSize = 0;
+        int hmacSize = 0;
+        int reserveSize = 0;
+        QByteArray salt;
+        Keys sourceKeys;
+        Keys targetKeys;
+
+        static const int SALT_SIZE = 16;
+        static const int HMAC_SALT_MASK = 0x3a;
+        static const int FAST_KDF_ITER = 2;
+        static const int MAX_IV_SIZE = 16;
+};
+
+#endif // DBSQLITECIPHERCONVERTER_H
@@ -1,5 +1,6 @@
 #include "dbsqlitecipherinstance.h"
 #include "dbsqlitecipher.h"
+#include "dbsqlitecipherconverter.h"
 #include <QDebug>
 
 DbSqliteCipherInstance::DbSqliteCipherInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& connOptions) :
@@ -14,7 +15,7 @@ void DbSqliteCipherInstance::initAfterOpen()
     QString key = connOptions[DbSqliteCipher::PASSWORD_OPT].toString();
     if (!key.isEmpty())
     {
-        res = exec(QString("PRAGMA key = '%1';").arg(key), Flag::NO_LOCK);
+        res = exec(getKeyPragma(key), Flag::NO_LOCK);
         if (res->isError())
             qWarning() << "Error while defining SQLCipher key:" << res->getErrorText();
     }
@@ -58,6 +59,49 @@ void DbSqliteCipherInstance::initAfterOpen()
     }
 
     AbstractDb3<SqlCipher>::initAfterOpen();
+    registerConvertFunction();
+}
+
+QString DbSqliteCipherInstance::getKeyPragma(const QString& key)
+{
+    if (key.toLower().startsWith("x'") && key.endsWith("'") && key.size() > 2)
+        return QString("PRAGMA key = \"%1\";").arg(key);
+
+    return QString("PRAGMA key = '%1';").arg(QString(key).replace("'", "''"));
+}
+
+void DbSqliteCipherInstance::registerConvertFunction()
+{
+    int res = SqlCipher::create_function_v2(getHandle(), CONVERT_FUNCTION, 2, SqlCipher::UTF8, this,
+                                            &DbSqliteCipherInstance::evaluateConvert, nullptr, nullptr, nullptr);
+    if (res != SqlCipher::OK)
+        qWarning() << "Could not register" << CONVERT_FUNCTION << "function:" << SqlCipher::errmsg(getHandle());
+}
+
+void DbSqliteCipherInstance::evaluateConvert(SqlCipher::context* context, int argCount, SqlCipher::value** args)
+{
+    DbSqliteCipherInstance* db = static_cast<DbSqliteCipherInstance*>(SqlCipher::user_data(context));
+    QList<QVariant> argList = getArgs(argCount, args);
+    QString outputPath = argList[0].toString();
+    if (outputPath.isEmpty())
+    {
+        storeResult(context, QObject::tr("Output file path is required by %1().").arg(CONVERT_FUNCTION), false);
+        return;
+    }
+
+    // The copy keeps all cipher settings of this connection, only the key is changed.
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(db->connOptions);
+    DbSqliteCipherConverter::Settings target = source;
+    target.password = argList[1].toString();
+
+    DbSqliteCipherConverter converter(source, target);
+    if (!converter.convert(db->getPath(), outputPath))
+    {
+        storeResult(context, converter.getErrorText(), false);
+        return;
+    }
+
+    storeResult(context, converter.getPageCount(), true);
 }
 
 QString DbSqliteCipherInstance::getAttachSql(Db* otherDb, const QString& generatedAttachName)
@@ -22,9 +22,33 @@ class DbSqliteCipherInstance : public AbstractDb3<SqlCipher>
     public:
         DbSqliteCipherInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& connOptions);
 
+        /**
+         * @brief Builds PRAGMA key statement for given password.
+         * @param key Password, or raw key given as x'...' hex literal.
+         * @return PRAGMA statement to execute.
+         *
+         * Raw key is given in double quotes, just like SQLCipher documentation says. Any other password
+         * is an SQL string literal.
+         */
+        static QString getKeyPragma(const QString& key);
+
+        /**
+         * @brief Name of SQL function that copies the database file with another key, or decrypted.
+         *
+         * The function is available only in SQLCipher connections. It takes the output file path and the new key
+         * (empty or NULL to decrypt) and returns the number of copied pages. It's implemented by DbSqliteCipherConverter,
+         * so the cipher settings of the copy are the same as of this connection.
+         */
+        static_char* CONVERT_FUNCTION = "sqlcipher_convert";
+
     protected:
         void initAfterOpen();
         QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
+
+    private:
+        void registerConvertFunction();
+
+        static void evaluateConvert(SqlCipher::context* context, int argCount, SqlCipher::value** args);
 };
 
 #endif // DBSQLITECIPHERINSTANCE_H
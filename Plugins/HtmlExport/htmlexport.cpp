@@ -576,7 +576,10 @@ void HtmlExport::writeln(const QString& str)
     }
     else
     {
-        newStr = indentStr + str + newLineStr;
+        outputBuffer.write(indentStr);
+        outputBuffer.write(str);
+        outputBuffer.write(newLineStr);
+        return;
     }
     GenericExportPlugin::write(newStr);
 }
@@ -586,7 +589,7 @@ QString HtmlExport::escape(const QString& str)
     if (cfg.HtmlExport.DontEscapeHtml.get())
         return str;
 
-    return str.toHtmlEscaped();
+    return ExportOutputBuffer::escapeHtml(str);
 }
 
 QString HtmlExport::compressCss(QString css)
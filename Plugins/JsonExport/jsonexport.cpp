@@ -317,43 +317,13 @@ void JsonExport::incrElementCount()
 
 void JsonExport::write(const QString& str)
 {
-    GenericExportPlugin::write(indentStr + str);
+    outputBuffer.write(indentStr);
+    outputBuffer.write(str);
 }
 
 QString JsonExport::escapeString(const QString& str)
 {
-    QString copy = str;
-    return "\"" +
-            copy.replace("\\", "\\\\")
-                .replace("\"", "\\\"")
-                .replace("/", "\\/")
-                .replace("\b", "\\b")
-                .replace("\f", "\\f")
-                .replace("\n", "\\n")
-                .replace("\r", "\\r")
-                .replace("\t", "\\t")
-            + "\"";
-}
-
-QString JsonExport::formatValue(const QVariant& val)
-{
-    if (val.isNull())
-        return "null";
-
-    switch (val.type())
-    {
-        case QVariant::Int:
-        case QVariant::UInt:
-        case QVariant::LongLong:
-        case QVariant::ULongLong:
-        case QVariant::Double:
-        case QVariant::Bool:
-            return val.toString();
-        default:
-            break;
-    }
-
-    return escapeString(val.toString());
+    return ExportOutputBuffer::escapeJson(str);
 }
 
 void JsonExport::beginObject()
@@ -419,35 +389,63 @@ void JsonExport::endArray()
 void JsonExport::writeValue(const QVariant& value)
 {
     writePrefixBeforeNextElement();
-    write(formatValue(value));
+    outputBuffer.write(indentStr);
+    writeFormattedValue(value);
     incrElementCount();
 }
 
 void JsonExport::writeValue(const QString& key, const QVariant& value)
 {
-    static const QString formatted = QStringLiteral("%1: %2");
-    static const QString compact = QStringLiteral("%1:%2");
-
-    QString escaped = escapeString(key);
-    QString val = formatValue(value);
-
     writePrefixBeforeNextElement();
-    write(indent ? formatted.arg(escaped, val) : compact.arg(escaped, val));
+    outputBuffer.write(indentStr);
+    outputBuffer.writeJsonString(key);
+    if (indent)
+        outputBuffer.writeAscii(": ", 2);
+    else
+        outputBuffer.writeAscii(":", 1);
+
+    writeFormattedValue(value);
     incrElementCount();
 }
 
+void JsonExport::writeFormattedValue(const QVariant& value)
+{
+    if (value.isNull())
+    {
+        outputBuffer.writeAscii("null", 4);
+        return;
+    }
+
+    switch (value.type())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Double:
+        case QVariant::Bool:
+            outputBuffer.write(value.toString());
+            return;
+        default:
+            break;
+    }
+
+    outputBuffer.writeJsonString(value.toString());
+}
+
 void JsonExport::writePrefixBeforeEnd()
 {
     if (indent && elementCounter.top() > 0)
-        GenericExportPlugin::write("\n");
+        outputBuffer.write(QChar('\n'));
 }
 
 void JsonExport::writePrefixBeforeNextElement()
 {
     if (elementCounter.top() > 0)
     {
-        GenericExportPlugin::write(",");
         if (indent)
-            GenericExportPlugin::write("\n");
+            outputBuffer.writeAscii(",\n", 2);
+        else
+            outputBuffer.writeAscii(",", 1);
     }
 }
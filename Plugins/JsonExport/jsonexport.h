@@ -54,7 +54,7 @@ class JSONEXPORTSHARED_EXPORT JsonExport : public GenericExportPlugin
         void incrElementCount();
         void write(const QString& str);
         QString escapeString(const QString& str);
-        QString formatValue(const QVariant& val);
+        void writeFormattedValue(const QVariant& value);
         void beginObject();
         void beginObject(const QString& key);
         void endObject();
@@ -42,6 +42,10 @@ ExportManager::StandardConfigFlags PdfExport::standardOptionsToEnable() const
 
 ExportManager::ExportProviderFlags PdfExport::getProviderFlags() const
 {
+    // With sampled column widths there is no need for ExportWorker to scan the whole data to find maximum lengths.
+    if (isSamplingColumnWidths())
+        return ExportManager::ROW_COUNT;
+
     return ExportManager::DATA_LENGTHS|ExportManager::ROW_COUNT;
 }
 
@@ -69,9 +73,7 @@ bool PdfExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
 
     clearDataHeaders();
     exportDataColumnsHeader(columnNames);
-
-    QList<int> columnDataLengths = getColumnDataLengths(columnNames.size(), providedData);
-    calculateDataColumnWidths(columnNames, columnDataLengths);
+    prepareDataColumnWidths(columnNames, providedData);
     return true;
 }
 
@@ -159,9 +161,52 @@ void PdfExport::prepareTableDataExport(const QString& table, const QStringList&
         exportDataHeader(tr("Table: %1").arg(table));
 
     exportDataColumnsHeader(columnNames);
+    prepareDataColumnWidths(columnNames, providedData);
+}
+
+void PdfExport::prepareDataColumnWidths(const QStringList& columnNames, const QHash<ExportManager::ExportProviderFlag, QVariant> providedData)
+{
+    sampledColumnNames.clear();
+    sampledColumnLengths.clear();
+    columnWidthsPending = false;
 
-    QList<int> columnDataLengths = getColumnDataLengths(columnNames.size(), providedData);
-    calculateDataColumnWidths(columnNames, columnDataLengths);
+    if (providedData.contains(ExportManager::DATA_LENGTHS) || !isSamplingColumnWidths())
+    {
+        QList<int> columnDataLengths = getColumnDataLengths(columnNames.size(), providedData);
+        calculateDataColumnWidths(columnNames, columnDataLengths);
+        return;
+    }
+
+    // Column widths will be calculated once enough rows are buffered (see calculateSampledDataColumnWidths()),
+    // so the data doesn't need to be scanned twice.
+    sampledColumnNames = columnNames;
+    for (int i = 0, total = columnNames.size(); i < total; ++i)
+        sampledColumnLengths << 0;
+
+    columnWidthsPending = true;
+}
+
+void PdfExport::calculateSampledDataColumnWidths()
+{
+    if (!columnWidthsPending)
+        return;
+
+    for (int& val : sampledColumnLengths)
+    {
+        if (val > cellDataLimit)
+            val = cellDataLimit;
+    }
+
+    calculateDataColumnWidths(sampledColumnNames, sampledColumnLengths);
+    columnWidthsPending = false;
+    sampledColumnNames.clear();
+    sampledColumnLengths.clear();
+}
+
+bool PdfExport::isSamplingColumnWidths() const
+{
+    // Typed CfgEntry::get() is not const, so the base, variant getter is used here.
+    return static_cast<const CfgEntry&>(cfg.PdfExport.SampleColWidths).get().toBool();
 }
 
 QList<int> PdfExport::getColumnDataLengths(int columnCount, const QHash<ExportManager::ExportProviderFlag, QVariant> providedData)
@@ -200,12 +245,14 @@ bool PdfExport::afterExport()
 
 bool PdfExport::afterExportTable()
 {
+    calculateSampledDataColumnWidths();
     flushDataPages(true);
     return true;
 }
 
 bool PdfExport::afterExportQueryResults()
 {
+    calculateSampledDataColumnWidths();
     flushDataPages(true);
     return true;
 }
@@ -368,6 +415,7 @@ void PdfExport::setupConfig()
     rowsToPrebuffer = (int)qCeil((double)pageHeight / minRowHeight);
 
     cellDataLimit = cfg.PdfExport.MaxCellBytes.get();
+    columnWidthSampleRows = qMax(cfg.PdfExport.WidthSampleRows.get(), 1);
     printRowNum = cfg.PdfExport.PrintRowNum.get();
     printPageNumbers = cfg.PdfExport.PrintPageNumbers.get();
 
@@ -408,6 +456,9 @@ void PdfExport::resetDataTable()
 {
     clearDataHeaders();
     bufferedDataRows.clear();
+    sampledColumnNames.clear();
+    sampledColumnLengths.clear();
+    columnWidthsPending = false;
     rowNum = 0;
 }
 
@@ -416,6 +467,7 @@ void PdfExport::exportDataRow(const QList<QVariant>& data)
     DataCell cell;
     DataRow row;
 
+    int col = 0;
     for (const QVariant& value : data)
     {
         switch (value.type())
@@ -440,10 +492,19 @@ void PdfExport::exportDataRow(const QList<QVariant>& data)
         }
         else
         {
+            // Only cellDataLimit characters are ever rendered, so there is no point in keeping more of the value in buffered rows.
             cell.isNull = false;
-            cell.contents = value.toString();
+            if (value.type() == QVariant::ByteArray)
+                cell.contents = QString::fromUtf8(value.toByteArray().left(cellDataLimit * 4)).left(cellDataLimit);
+            else
+                cell.contents = value.toString().left(cellDataLimit);
         }
+
+        if (columnWidthsPending && col < sampledColumnLengths.size())
+            sampledColumnLengths[col] = qMax(sampledColumnLengths[col], cell.contents.length());
+
         row.cells << cell;
+        col++;
     }
 
     bufferedDataRows << row;
@@ -591,6 +652,14 @@ int PdfExport::calculateBulletPrefixWidth()
 
 void PdfExport::checkForDataRender()
 {
+    if (columnWidthsPending)
+    {
+        if (bufferedDataRows.size() < columnWidthSampleRows)
+            return;
+
+        calculateSampledDataColumnWidths();
+    }
+
     if (bufferedDataRows.size() >= rowsToPrebuffer)
         flushDataPages();
 }
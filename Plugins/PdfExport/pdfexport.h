@@ -31,6 +31,8 @@ CFG_CATEGORIES(PdfExportConfig,
         CFG_ENTRY(int,         BottomMargin,     20)
         CFG_ENTRY(int,         LeftMargin,       20)
         CFG_ENTRY(int,         MaxCellBytes,     100)
+        CFG_ENTRY(bool,        SampleColWidths,  false)
+        CFG_ENTRY(int,         WidthSampleRows,  1000)
         CFG_ENTRY(QFont,       Font,             Cfg::getPdfExportDefaultFont())
         CFG_ENTRY(int,         FontSize,         10)
         CFG_ENTRY(QColor,      HeaderBgColor,    QColor(Qt::lightGray))
@@ -131,6 +133,9 @@ class PDFEXPORTSHARED_EXPORT PdfExport : public GenericExportPlugin
 
         void prepareTableDataExport(const QString& table, const QStringList& columnNames, const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         QList<int> getColumnDataLengths(int columnCount, const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
+        void prepareDataColumnWidths(const QStringList& columnNames, const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
+        void calculateSampledDataColumnWidths();
+        bool isSamplingColumnWidths() const;
         bool beginDoc(const QString& title);
         void endDoc();
         void setupConfig();
@@ -196,6 +201,10 @@ class PDFEXPORTSHARED_EXPORT PdfExport : public GenericExportPlugin
         QList<int> calculatedObjectColumnWidths; // object column widths calculated basing on header column widths and columns from other object rows
         QList<int> calculatedDataColumnWidths; // data column widths calculated basing on header column widths and data column widths
         QList<int> columnsPerPage; // number of columns that will fit on each page
+        QStringList sampledColumnNames; // data column names, kept until column widths are calculated from sampled rows
+        QList<int> sampledColumnLengths; // maximum data lengths found in sampled rows, used when column widths are not provided by ExportWorker
+        bool columnWidthsPending = false; // true while rows are still being sampled to calculate data column widths
+        int columnWidthSampleRows = 0;
         QScopedPointer<DataRow> headerRow; // Top level header (object name)
         QScopedPointer<DataRow> columnsHeaderRow; // columns header for data tables
         int rowNumColumnWidth = 0;
@@ -13,10 +13,12 @@ TEMPLATE = lib
 
 DEFINES += REGEXPIMPORT_LIBRARY
 
-SOURCES += regexpimport.cpp
+SOURCES += regexpimport.cpp \
+    regexpscanner.cpp
 
 HEADERS += regexpimport.h\
-        regexpimport_global.h
+        regexpimport_global.h \
+    regexpscanner.h
 
 OTHER_FILES += \
     regexpimport.json
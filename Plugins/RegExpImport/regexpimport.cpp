@@ -1,4 +1,5 @@
 #include "regexpimport.h"
+#include "regexpscanner.h"
 #include "services/notifymanager.h"
 #include "common/utils.h"
 #include "services/importmanager.h"
@@ -6,6 +7,8 @@
 #include <QRegularExpression>
 #include <QFile>
 #include <QTextStream>
+#include <QTextCodec>
+#include <QTextDecoder>
 
 RegExpImport::RegExpImport()
 {
@@ -39,14 +42,9 @@ QString RegExpImport::getFileFilter() const
 
 bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& config)
 {
-    safe_delete(re);
-    safe_delete(file);
-    safe_delete(stream);
-    groups.clear();
-    buffer.clear();
+    reset();
     columns.clear();
 
-
     file = new QFile(config.inputFileName);
     if (!file->open(QFile::ReadOnly) || !file->isReadable())
     {
@@ -55,12 +53,16 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
         return false;
     }
 
-    stream = new QTextStream(file);
-    stream->setCodec(config.codec.toLatin1().data());
-
+    if (!openMapped(config.codec))
+    {
+        stream = new QTextStream(file);
+        stream->setCodec(config.codec.toLatin1().data());
+    }
 
     static const QString intColTemplate = QStringLiteral("column%1");
     re = new QRegularExpression(cfg.RegExpImport.Pattern.get());
+    re->optimize();
+    scanner = new RegExpScanner(*re);
     QString colName;
     if (cfg.RegExpImport.GroupsMode.get() == "all")
     {
@@ -97,13 +99,97 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
 
 void RegExpImport::afterImport()
 {
+    reset();
+}
+
+void RegExpImport::reset()
+{
+    if (file && mappedData)
+        file->unmap(mappedData);
+
+    safe_delete(scanner);
     safe_delete(re);
-    safe_delete(file);
     safe_delete(stream);
-    buffer.clear();
+    safe_delete(file);
+    safe_delete(decoder);
+    mappedData = nullptr;
+    mappedSize = 0;
+    mappedPos = 0;
+    decoded.clear();
+    decodedPos = 0;
     groups.clear();
 }
 
+bool RegExpImport::openMapped(const QString& codecName)
+{
+    mappedSize = file->size();
+    if (mappedSize <= 0)
+        return false;
+
+    mappedData = file->map(0, mappedSize);
+    if (!mappedData)
+        return false;
+
+    // Same as the QTextStream does: byte order mark wins over the configured encoding.
+    QTextCodec* codec = QTextCodec::codecForName(codecName.toLatin1());
+    if (!codec)
+        codec = QTextCodec::codecForLocale();
+
+    int headerSize = static_cast<int>(qMin<qint64>(mappedSize, 4));
+    codec = QTextCodec::codecForUtfText(QByteArray::fromRawData(reinterpret_cast<const char*>(mappedData), headerSize), codec);
+    decoder = codec->makeDecoder();
+    return true;
+}
+
+bool RegExpImport::appendNextLine()
+{
+    if (stream)
+    {
+        QString line = stream->readLine();
+        if (line.isNull())
+            return false;
+
+        scanner->append(line);
+        return true;
+    }
+
+    int newLine;
+    while ((newLine = decoded.indexOf('\n', decodedPos)) < 0 && mappedPos < mappedSize)
+        decodeNextChunk();
+
+    if (newLine < 0)
+    {
+        // Last line, without the terminator
+        if (decodedPos >= decoded.length())
+            return false;
+
+        scanner->append(decoded.midRef(decodedPos));
+        decodedPos = decoded.length();
+        return true;
+    }
+
+    int end = newLine;
+    if (end > decodedPos && decoded[end - 1] == '\r')
+        end--;
+
+    scanner->append(decoded.midRef(decodedPos, end - decodedPos));
+    decodedPos = newLine + 1;
+    return true;
+}
+
+void RegExpImport::decodeNextChunk()
+{
+    if (decodedPos > 0)
+    {
+        decoded.remove(0, decodedPos);
+        decodedPos = 0;
+    }
+
+    int size = static_cast<int>(qMin<qint64>(MAPPED_CHUNK_SIZE, mappedSize - mappedPos));
+    decoded += decoder->toUnicode(reinterpret_cast<const char*>(mappedData + mappedPos), size);
+    mappedPos += size;
+}
+
 QList<ImportPlugin::ColumnDefinition> RegExpImport::getColumns() const
 {
     QList<ImportPlugin::ColumnDefinition> columnList;
@@ -115,17 +201,15 @@ QList<ImportPlugin::ColumnDefinition> RegExpImport::getColumns() const
 
 QList<QVariant> RegExpImport::next()
 {
-    QRegularExpressionMatch match = re->match(buffer);
-    QString line;
-    while (!match.hasMatch() && !(line = stream->readLine()).isNull())
+    // Scanner is asked after every line, so a match ending at the end of the line (or using the $ anchor)
+    // is found just like before.
+    QRegularExpressionMatch match;
+    while (!scanner->next(match))
     {
-        buffer += line;
-        match = re->match(buffer);
+        if (!appendNextLine())
+            return QList<QVariant>();
     }
 
-    if (!match.hasMatch())
-        return QList<QVariant>();
-
     QList<QVariant> values;
     for (const QVariant& group : groups)
     {
@@ -135,8 +219,6 @@ QList<QVariant> RegExpImport::next()
             values << match.captured(group.toString());
     }
 
-    buffer = buffer.mid(match.capturedEnd());
-
     return values;
 }
 
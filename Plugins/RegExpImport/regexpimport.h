@@ -7,8 +7,10 @@
 #include "config_builder.h"
 
 class QRegularExpression;
+class RegExpScanner;
 class QFile;
 class QTextStream;
+class QTextDecoder;
 
 CFG_CATEGORIES(RegExpImportConfig,
      CFG_CATEGORY(RegExpImport,
@@ -40,13 +42,36 @@ class REGEXPIMPORTSHARED_EXPORT RegExpImport : public GenericPlugin, public Impo
         bool validateOptions();
 
     private:
+        void reset();
+        bool openMapped(const QString& codecName);
+        bool appendNextLine();
+        void decodeNextChunk();
+
+        /**
+         * @brief Number of bytes of memory mapped file to decode at once.
+         */
+        static const int MAPPED_CHUNK_SIZE = 1024 * 1024;
+
         CFG_LOCAL_PERSISTABLE(RegExpImportConfig, cfg)
         QRegularExpression* re = nullptr;
         QList<QVariant> groups;
         QStringList columns;
         QFile* file = nullptr;
         QTextStream* stream = nullptr;
-        QString buffer;
+
+        /**
+         * @brief Finds matches in lines of the file.
+         *
+         * Lines are appended without line terminators, just like the import always worked.
+         */
+        RegExpScanner* scanner = nullptr;
+
+        uchar* mappedData = nullptr;
+        qint64 mappedSize = 0;
+        qint64 mappedPos = 0;
+        QTextDecoder* decoder = nullptr;
+        QString decoded;
+        int decodedPos = 0;
 };
 
 #endif // REGEXPIMPORT_H
@@ -0,0 +1,79 @@
+#include "regexpscanner.h"
+
+RegExpScanner::RegExpScanner(const QRegularExpression& re) :
+    re(re)
+{
+}
+
+void RegExpScanner::append(const QString& text)
+{
+    buffer += text;
+}
+
+void RegExpScanner::append(const QStringRef& text)
+{
+    buffer.append(text);
+}
+
+bool RegExpScanner::next(QRegularExpressionMatch& match)
+{
+    if (consumed > 0)
+    {
+        buffer.remove(0, consumed);
+        consumed = 0;
+        offset = 0;
+    }
+
+    QRegularExpressionMatch partialMatch;
+    int start;
+    while (offset < buffer.length())
+    {
+        match = re.match(buffer, offset);
+        if (match.hasMatch() && match.capturedLength() > 0)
+        {
+            consumed = match.capturedEnd();
+            return true;
+        }
+
+        // Partial match tells where the match may begin once more text comes. With no partial match at all,
+        // none of the remaining positions can start a match.
+        partialMatch = re.match(buffer, offset, QRegularExpression::PartialPreferFirstMatch);
+        if (partialMatch.hasPartialMatch())
+        {
+            offset = partialMatch.capturedStart();
+            break;
+        }
+
+        start = match.capturedStart();
+        if (!match.hasMatch() || start >= buffer.length())
+        {
+            offset = buffer.length();
+            break;
+        }
+
+        // Empty match in the middle of the text. Other matches may still start at next characters.
+        offset = start + 1;
+        if (buffer[start].isHighSurrogate() && offset < buffer.length() && buffer[offset].isLowSurrogate())
+            offset++;
+    }
+
+    compact();
+    return false;
+}
+
+void RegExpScanner::clear()
+{
+    buffer.clear();
+    offset = 0;
+    consumed = 0;
+}
+
+void RegExpScanner::compact()
+{
+    if (offset < COMPACT_THRESHOLD)
+        return;
+
+    int toDrop = offset - LOOKBEHIND_KEEP;
+    buffer.remove(0, toDrop);
+    offset -= toDrop;
+}
@@ -0,0 +1,79 @@
+#ifndef REGEXPSCANNER_H
+#define REGEXPSCANNER_H
+
+#include <QRegularExpression>
+#include <QString>
+
+/**
+ * @brief Finds consecutive matches of the regular expression in text that comes in pieces.
+ *
+ * Text is appended in pieces (lines of the file, in case of the import) and matched after each of them,
+ * so a match ending at the end of the piece (or using the $ anchor) is found as soon as the piece is appended.
+ * Text that can never start a match is skipped for good, so sparse matches in a huge input don't cause
+ * the same text to be scanned over and over again.
+ *
+ * Empty matches are not reported. After an empty match the scanning goes on from the next character.
+ */
+class RegExpScanner
+{
+    public:
+        /**
+         * @brief Creates scanner.
+         * @param re Regular expression to look for. It should be optimized already.
+         */
+        explicit RegExpScanner(const QRegularExpression& re);
+
+        void append(const QString& text);
+        void append(const QStringRef& text);
+
+        /**
+         * @brief Finds next match in the text appended so far.
+         * @param match Output match. It's valid only when true was returned.
+         * @return true if the non-empty match was found, or false if more text is needed to find one.
+         *
+         * Text up to the end of the returned match is dropped on the next call.
+         */
+        bool next(QRegularExpressionMatch& match);
+
+        void clear();
+
+    private:
+        void compact();
+
+        /**
+         * @brief Number of characters of scanned buffer that makes it worth to drop them.
+         */
+        static const int COMPACT_THRESHOLD = 64 * 1024;
+
+        /**
+         * @brief Number of dropped characters kept in front of the scanning offset.
+         *
+         * They're visible for lookbehind assertions, and they make sure that the ^ anchor
+         * doesn't match at the scanning offset.
+         */
+        static const int LOOKBEHIND_KEEP = 256;
+
+        QRegularExpression re;
+
+        /**
+         * @brief Text not consumed by matches yet.
+         *
+         * The buffer begins right after the previous match (or at the input beginning), unless it was compacted.
+         */
+        QString buffer;
+
+        /**
+         * @brief Position in the buffer from which a match can still start.
+         *
+         * Everything before it was proven to never start a match, no matter what text comes next,
+         * so it's never scanned again.
+         */
+        int offset = 0;
+
+        /**
+         * @brief End of the match returned recently. Text up to this position is dropped on the next call to next().
+         */
+        int consumed = 0;
+};
+
+#endif // REGEXPSCANNER_H
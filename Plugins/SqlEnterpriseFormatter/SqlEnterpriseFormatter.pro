@@ -50,7 +50,8 @@ SOURCES += sqlenterpriseformatter.cpp \
     formatsavepoint.cpp \
     formatvacuum.cpp \
     formatorderby.cpp \
-    formatupsert.cpp
+    formatupsert.cpp \
+    formatsimpleinsert.cpp
 
 HEADERS += sqlenterpriseformatter.h\
         sqlenterpriseformatter_global.h \
@@ -90,7 +91,8 @@ HEADERS += sqlenterpriseformatter.h\
     formatsavepoint.h \
     formatvacuum.h \
     formatorderby.h \
-    formatupsert.h
+    formatupsert.h \
+    formatsimpleinsert.h
 
 OTHER_FILES += \
     sqlenterpriseformatter.json
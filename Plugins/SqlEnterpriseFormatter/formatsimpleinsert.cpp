@@ -0,0 +1,223 @@
+#include "formatsimpleinsert.h"
+
+FormatSimpleInsert::FormatSimpleInsert()
+{
+}
+
+FormatSimpleInsert* FormatSimpleInsert::forTokens(const TokenList& tokens)
+{
+    FormatSimpleInsert* formatStmt = new FormatSimpleInsert();
+    if (!formatStmt->parse(tokens))
+    {
+        delete formatStmt;
+        return nullptr;
+    }
+
+    formatStmt->dialect = Dialect::Sqlite3;
+    return formatStmt;
+}
+
+void FormatSimpleInsert::formatInternal()
+{
+    // Same tokens as produced by FormatInsert, FormatSelect, FormatSelectCore and FormatSelectCoreResultColumn
+    // for the parsed statement, except for the keyword line-up marks, which are never used in the VALUES mode.
+    if (replaceKw)
+    {
+        withKeyword("REPLACE");
+    }
+    else
+    {
+        withKeyword("INSERT");
+        if (onConflict != SqliteConflictAlgo::null)
+            withKeyword("OR").withKeyword(sqliteConflictAlgo(onConflict));
+    }
+
+    withKeyword("INTO").withId(table);
+
+    markAndKeepIndent("insertCols");
+    if (columnNames.size() > 0)
+        withParDefLeft().withIdList(columnNames).withParDefRight();
+
+    bool firstRow = true;
+    bool firstValue;
+    for (const QList<QVariant>& row : rows)
+    {
+        if (firstRow)
+            withKeyword("VALUES");
+        else
+            withListComma(FormatToken::Flag::NO_NEWLINE_BEFORE);
+
+        withParDefLeft();
+        firstValue = true;
+        for (const QVariant& value : row)
+        {
+            if (!firstValue)
+                withListComma();
+
+            markAndKeepIndent("column");
+            if (value.isNull())
+                withKeyword("NULL");
+            else
+                withLiteral(value);
+
+            withDecrIndent();
+            firstValue = false;
+        }
+        withParDefRight();
+        firstRow = false;
+    }
+
+    withDecrIndent();
+    withSemicolon();
+}
+
+bool FormatSimpleInsert::parse(const TokenList& tokens)
+{
+    TokenList realTokens;
+    for (const TokenPtr& token : tokens)
+    {
+        if (token->type == Token::COMMENT)
+            return false;
+
+        if (token->type != Token::SPACE)
+            realTokens << token;
+    }
+
+    int i = 0;
+    int total = realTokens.size();
+    auto isType = [&realTokens, &i, total](Token::Type type) -> bool
+    {
+        return i < total && realTokens[i]->type == type;
+    };
+    auto isKeyword = [&realTokens, &i, total](const char* keyword) -> bool
+    {
+        return i < total && realTokens[i]->type == Token::KEYWORD && realTokens[i]->value.compare(keyword, Qt::CaseInsensitive) == 0;
+    };
+    auto isOperator = [&realTokens, &i, total](const char* oper) -> bool
+    {
+        return i < total && realTokens[i]->type == Token::OPERATOR && realTokens[i]->value == oper;
+    };
+
+    if (isKeyword("REPLACE"))
+    {
+        replaceKw = true;
+        i++;
+    }
+    else if (isKeyword("INSERT"))
+    {
+        i++;
+        if (isKeyword("OR"))
+        {
+            i++;
+            if (!isType(Token::KEYWORD))
+                return false;
+
+            onConflict = sqliteConflictAlgo(realTokens[i++]->value);
+            if (onConflict == SqliteConflictAlgo::null)
+                return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    if (!isKeyword("INTO"))
+        return false;
+
+    i++;
+
+    // Qualified names are left for the parser
+    if (!isType(Token::OTHER))
+        return false;
+
+    table = stripObjName(realTokens[i++]->value, Dialect::Sqlite3);
+
+    if (isType(Token::PAR_LEFT))
+    {
+        do
+        {
+            i++;
+            if (!isType(Token::OTHER))
+                return false;
+
+            columnNames << stripObjName(realTokens[i++]->value, Dialect::Sqlite3);
+        }
+        while (isOperator(","));
+
+        if (!isType(Token::PAR_RIGHT))
+            return false;
+
+        i++;
+    }
+
+    if (!isKeyword("VALUES"))
+        return false;
+
+    bool ok;
+    QList<QVariant> row;
+    do
+    {
+        i++;
+        if (!isType(Token::PAR_LEFT))
+            return false;
+
+        row.clear();
+        do
+        {
+            i++;
+            if (i >= total)
+                return false;
+
+            row << literalValue(realTokens[i++], &ok);
+            if (!ok)
+                return false;
+        }
+        while (isOperator(","));
+
+        if (!isType(Token::PAR_RIGHT))
+            return false;
+
+        i++;
+        rows << row;
+    }
+    while (isOperator(","));
+
+    if (isOperator(";"))
+        i++;
+
+    return i == total;
+}
+
+QVariant FormatSimpleInsert::literalValue(const TokenPtr& token, bool* ok) const
+{
+    // Values are converted the same way as the parser does it for the literal terms
+    *ok = true;
+    switch (token->type)
+    {
+        case Token::INTEGER:
+        {
+            if (token->value.startsWith("0x", Qt::CaseInsensitive) || token->value == "9223372036854775808")
+                break;
+
+            return QVariant(QVariant(token->value).toLongLong());
+        }
+        case Token::FLOAT:
+            return QVariant(QVariant(token->value).toDouble());
+        case Token::STRING:
+        case Token::BLOB:
+            return QVariant(token->value);
+        case Token::KEYWORD:
+        {
+            if (token->value.compare("NULL", Qt::CaseInsensitive) == 0)
+                return QVariant();
+
+            break;
+        }
+        default:
+            break;
+    }
+
+    *ok = false;
+    return QVariant();
+}
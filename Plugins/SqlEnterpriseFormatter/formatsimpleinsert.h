@@ -0,0 +1,44 @@
+#ifndef FORMATSIMPLEINSERT_H
+#define FORMATSIMPLEINSERT_H
+
+#include "formatstatement.h"
+#include "parser/token.h"
+
+/**
+ * @brief Formats plain INSERT ... VALUES statement directly from its tokens.
+ *
+ * Large scripts (like database dumps) consist mostly of INSERT statements with literal values only.
+ * Building full syntax tree for each of them is the most expensive part of formatting such script,
+ * so this class recognizes these statements on the token level and produces exactly the same output,
+ * as the FormatInsert would produce for the parsed statement.
+ *
+ * Recognized syntax is: INSERT [OR conflict-algo] | REPLACE INTO table [(col, ...)] VALUES (literal, ...) [, (literal, ...)] [;],
+ * where literals are numbers, strings, blobs or NULLs. Anything else (comments included) has to go through the parser.
+ */
+class FormatSimpleInsert : public FormatStatement
+{
+    public:
+        /**
+         * @brief Creates formatter for given statement tokens.
+         * @param tokens Tokens of a single statement.
+         * @return Formatter or null if the statement is not a simple INSERT.
+         */
+        static FormatSimpleInsert* forTokens(const TokenList& tokens);
+
+    protected:
+        void formatInternal();
+
+    private:
+        FormatSimpleInsert();
+
+        bool parse(const TokenList& tokens);
+        QVariant literalValue(const TokenPtr& token, bool* ok) const;
+
+        bool replaceKw = false;
+        SqliteConflictAlgo onConflict = SqliteConflictAlgo::null;
+        QString table;
+        QStringList columnNames;
+        QList<QList<QVariant>> rows;
+};
+
+#endif // FORMATSIMPLEINSERT_H
@@ -71,14 +71,14 @@
 
 const QString FormatStatement::SPACE = " ";
 const QString FormatStatement::NEWLINE = "\n";
-qint64 FormatStatement::nameSeq = 0;
+QAtomicInteger<qint64> FormatStatement::nameSeq(0);
 
 FormatStatement::FormatStatement()
 {
     static_qstring(nameTpl, "statement_%1");
 
     indents.push(0);
-    statementName = nameTpl.arg(QString::number(nameSeq++));
+    statementName = nameTpl.arg(QString::number(nameSeq.fetchAndAddRelaxed(1)));
 }
 
 FormatStatement::~FormatStatement()
@@ -509,8 +509,9 @@ FormatStatement::FormatToken* FormatStatement::withToken(FormatStatement::Format
 void FormatStatement::cleanup()
 {
     kwLineUpPosition.clear();
-    line = "";
-    lines.clear();
+    output.clear();
+    lineStarts.clear();
+    lineStarts << 0;
     namedIndents.clear();
     resetIndents();
     if (deleteTokens)
@@ -534,8 +535,9 @@ QString FormatStatement::detokenize()
 {
     bool uppercaseKeywords = cfg->SqlEnterpriseFormatter.UppercaseKeywords.get();
 
-    for (FormatToken* token : tokens)
+    for (int tokenIdx = 0, total = tokens.size(); tokenIdx < total; tokenIdx++)
     {
+        FormatToken* token = tokens[tokenIdx];
         applySpace(token->type);
         switch (token->type)
         {
@@ -549,9 +551,9 @@ QString FormatStatement::detokenize()
 
                     int indentLength = lineUpValue - kw.length();
                     if (indentLength > 0)
-                        line += SPACE.repeated(indentLength);
+                        appendSpaces(indentLength);
 
-                    line += uppercaseKeywords ? kw.toUpper() : kw.toLower();
+                    output += uppercaseKeywords ? kw.toUpper() : kw.toLower();
 
                     break;
                 }
@@ -563,14 +565,14 @@ QString FormatStatement::detokenize()
             case FormatToken::KEYWORD:
             {
                 applyIndent();
-                line += uppercaseKeywords ? token->value.toString().toUpper() : token->value.toString().toLower();
+                output += uppercaseKeywords ? token->value.toString().toUpper() : token->value.toString().toLower();
                 break;
             }
             case FormatToken::FUNC_ID:
             case FormatToken::DATA_TYPE:
             {
                 applyIndent();
-                line += wrapObjIfNeeded(token->value.toString(), dialect, wrapper);
+                output += wrapObjIfNeeded(token->value.toString(), dialect, wrapper);
                 break;
             }
             case FormatToken::ID:
@@ -586,7 +588,7 @@ QString FormatStatement::detokenize()
                 if (val.contains("\""))
                     formatId(token->value.toString());
                 else
-                    line += wrapObjName(token->value.toString(), NameWrapper::DOUBLE_QUOTE);
+                    output += wrapObjName(token->value.toString(), NameWrapper::DOUBLE_QUOTE);
 
                 break;
             }
@@ -597,24 +599,24 @@ QString FormatStatement::detokenize()
             case FormatToken::STRING:
             {
                 applyIndent();
-                line += token->value.toString();
+                output += token->value.toString();
                 break;
             }
             case FormatToken::FLOAT:
             {
                 applyIndent();
-                line += doubleToString(token->value);
+                output += doubleToString(token->value);
                 break;
             }
             case FormatToken::OPERATOR:
             {
                 bool spaceAdded = endsWithSpace() || applyIndent();
                 if (cfg->SqlEnterpriseFormatter.SpaceBeforeMathOp.get() && !spaceAdded && !token->flags.testFlag(FormatToken::Flag::NO_SPACE_BEFORE))
-                    line += SPACE;
+                    output += SPACE;
 
-                line += token->value.toString();
+                output += token->value.toString();
                 if (cfg->SqlEnterpriseFormatter.SpaceAfterMathOp.get() && !token->flags.testFlag(FormatToken::Flag::NO_SPACE_AFTER))
-                    line += SPACE;
+                    output += SPACE;
 
                 break;
             }
@@ -622,11 +624,11 @@ QString FormatStatement::detokenize()
             {
                 bool spaceAdded = endsWithSpace() || applyIndent();
                 if (cfg->SqlEnterpriseFormatter.SpaceBeforeDot.get() && !spaceAdded && !token->flags.testFlag(FormatToken::Flag::NO_SPACE_BEFORE))
-                    line += SPACE;
+                    output += SPACE;
 
-                line += token->value.toString();
+                output += token->value.toString();
                 if (cfg->SqlEnterpriseFormatter.SpaceAfterDot.get() && !token->flags.testFlag(FormatToken::Flag::NO_SPACE_AFTER))
-                    line += SPACE;
+                    output += SPACE;
 
                 break;
             }
@@ -694,14 +696,14 @@ QString FormatStatement::detokenize()
                 {
                     bool spaceAdded = endsWithSpace() || applyIndent();
                     if (cfg->SqlEnterpriseFormatter.SpaceBeforeMathOp.get() && !spaceAdded)
-                        line += SPACE;
+                        output += SPACE;
                 }
 
-                line += token->value.toString();
+                output += token->value.toString();
                 if (cfg->SqlEnterpriseFormatter.NlAfterSemicolon.get())
                     newLine();
                 else if (cfg->SqlEnterpriseFormatter.SpaceAfterMathOp.get())
-                    line += SPACE;
+                    output += SPACE;
 
                 break;
             }
@@ -715,14 +717,14 @@ QString FormatStatement::detokenize()
                 {
                     bool spaceAdded = endsWithSpace() || applyIndent();
                     if (cfg->SqlEnterpriseFormatter.SpaceBeforeCommaInList.get() && !spaceAdded)
-                        line += SPACE;
+                        output += SPACE;
                 }
 
-                line += token->value.toString();
+                output += token->value.toString();
                 if (cfg->SqlEnterpriseFormatter.NlAfterComma.get() && !token->flags.testFlag(FormatToken::Flag::NO_NEWLINE_AFTER))
                     newLine();
                 else if (cfg->SqlEnterpriseFormatter.SpaceAfterCommaInList.get())
-                    line += SPACE;
+                    output += SPACE;
 
                 break;
             }
@@ -736,14 +738,14 @@ QString FormatStatement::detokenize()
                 {
                     bool spaceAdded = endsWithSpace() || applyIndent();
                     if (cfg->SqlEnterpriseFormatter.SpaceBeforeCommaInList.get() && !spaceAdded)
-                        line += SPACE;
+                        output += SPACE;
                 }
 
-                line += token->value.toString();
+                output += token->value.toString();
                 if (cfg->SqlEnterpriseFormatter.NlAfterCommaInExpr.get() && !token->flags.testFlag(FormatToken::Flag::NO_NEWLINE_AFTER))
                     newLine();
                 else if (cfg->SqlEnterpriseFormatter.SpaceAfterCommaInList.get())
-                    line += SPACE;
+                    output += SPACE;
 
                 break;
             }
@@ -755,7 +757,7 @@ QString FormatStatement::detokenize()
             case FormatToken::INDENT_MARKER:
             {
                 QString indentName = token->value.toString();
-                namedIndents[indentName] = predictCurrentIndent(token);
+                namedIndents[indentName] = predictCurrentIndent(tokenIdx);
                 break;
             }
             case FormatToken::INCR_INDENT:
@@ -780,7 +782,7 @@ QString FormatStatement::detokenize()
             case FormatToken::MARK_KEYWORD_LINEUP:
             {
                 QString lineUpName = token->value.toString();
-                int lineUpLength = predictCurrentIndent(token) + token->additionalValue.toInt();
+                int lineUpLength = predictCurrentIndent(tokenIdx) + token->additionalValue.toInt();
                 if (!kwLineUpPosition.contains(lineUpName) || lineUpLength > kwLineUpPosition[lineUpName])
                     kwLineUpPosition[lineUpName] = lineUpLength;
 
@@ -790,23 +792,43 @@ QString FormatStatement::detokenize()
         updateLastToken(token);
     }
     newLine();
-    return lines.join(NEWLINE);
+
+    // Drop the new-line character that ended the last line
+    if (lineStarts.size() > 1)
+        output.chop(1);
+
+    return output;
 }
 
 bool FormatStatement::applyIndent()
 {
-    int indentToAdd = indents.top() - line.length();
+    int indentToAdd = indents.top() - lineLength();
     if (indentToAdd <= 0)
         return false;
 
-    line += SPACE.repeated(indentToAdd);
+    appendSpaces(indentToAdd);
     return true;
 }
 
+void FormatStatement::appendSpaces(int count)
+{
+    static const QString spaces(INDENT_SPACES_CACHE, ' ');
+
+    for (; count > INDENT_SPACES_CACHE; count -= INDENT_SPACES_CACHE)
+        output += spaces;
+
+    output.append(spaces.constData(), count);
+}
+
+int FormatStatement::lineLength() const
+{
+    return output.length() - lineStarts.last();
+}
+
 void FormatStatement::applySpace(FormatToken::Type type)
 {
     if (lastToken && isSpaceExpectingType(type) && isSpaceExpectingType(lastToken->type) && !endsWithSpace())
-        line += SPACE;
+        output += SPACE;
 }
 
 bool FormatStatement::isSpaceExpectingType(FormatStatement::FormatToken::Type type)
@@ -889,11 +911,11 @@ bool FormatStatement::isMetaType(FormatStatement::FormatToken::Type type)
 
 void FormatStatement::newLine()
 {
-    if (line.length() == 0) // prevents double new-line when for example "))" occurs and it has new-line before and after
+    if (lineLength() == 0) // prevents double new-line when for example "))" occurs and it has new-line before and after
         return;
 
-    lines << line;
-    line = "";
+    output += NEWLINE;
+    lineStarts << output.length();
 }
 
 void FormatStatement::incrIndent(const QString& name)
@@ -929,7 +951,7 @@ void FormatStatement::setIndent(int newIndent)
 
 bool FormatStatement::endsWithSpace()
 {
-    return line.length() == 0 || line[line.length() - 1].isSpace();
+    return lineLength() == 0 || output[output.length() - 1].isSpace();
 }
 
 FormatStatement::FormatToken* FormatStatement::getLastRealToken(bool skipNewLines)
@@ -958,9 +980,9 @@ void FormatStatement::detokenizeLeftPar(FormatToken* token, bool spaceBefore, bo
 
     spaceAdded |= applyIndent();
     if (spaceBefore && !spaceAdded)
-        line += SPACE;
+        output += SPACE;
 
-    line += token->value.toString();
+    output += token->value.toString();
     if (nlAfter)
     {
         newLine();
@@ -968,7 +990,7 @@ void FormatStatement::detokenizeLeftPar(FormatToken* token, bool spaceBefore, bo
             incrIndent();
     }
     else if (spaceAfter)
-        line += SPACE;
+        output += SPACE;
 }
 
 void FormatStatement::detokenizeRightPar(FormatStatement::FormatToken* token, bool spaceBefore, bool spaceAfter, bool nlBefore, bool nlAfter)
@@ -984,13 +1006,13 @@ void FormatStatement::detokenizeRightPar(FormatStatement::FormatToken* token, bo
 
     spaceAdded |= applyIndent();
     if (spaceBefore && !spaceAdded)
-        line += SPACE;
+        output += SPACE;
 
-    line += token->value.toString();
+    output += token->value.toString();
     if (nlAfter)
         newLine();
     else if (spaceAfter)
-        line += SPACE;
+        output += SPACE;
 }
 
 void FormatStatement::resetIndents()
@@ -1002,20 +1024,22 @@ void FormatStatement::resetIndents()
 void FormatStatement::removeAllSpaces()
 {
     removeAllSpacesFromLine();
-    while (endsWithSpace() && lines.size() > 0)
+    while (endsWithSpace() && lineStarts.size() > 1)
     {
-        line = lines.takeLast();
+        // Current line is empty, so go back to the previous one, removing the new-line character
+        lineStarts.removeLast();
+        output.chop(1);
         removeAllSpacesFromLine();
 
-        if (lines.size() == 0)
+        if (lineStarts.size() == 1)
             break;
     }
 }
 
 void FormatStatement::removeAllSpacesFromLine()
 {
-    while (endsWithSpace() && line.length() > 0)
-        line.chop(1);
+    while (endsWithSpace() && lineLength() > 0)
+        output.chop(1);
 }
 
 void FormatStatement::updateLastToken(FormatStatement::FormatToken* token)
@@ -1033,9 +1057,9 @@ QString FormatStatement::getFinalLineUpName(const QString& lineUpName)
     return finalName;
 }
 
-int FormatStatement::predictCurrentIndent(FormatToken* currentMetaToken)
+int FormatStatement::predictCurrentIndent(int tokenIdx)
 {
-    QString lineBackup = line;
+    int outputLengthBackup = output.length();
     bool isSpace = applyIndent() || endsWithSpace();
 
     if (!isSpace)
@@ -1044,13 +1068,12 @@ int FormatStatement::predictCurrentIndent(FormatToken* currentMetaToken)
         // We need to predict if next real (printable) token will require space to be added.
         // If yes, we add it virtually here, so we know the indent required afterwards.
         // First we need to find next real token:
-        int tokenIdx = tokens.indexOf(currentMetaToken);
         FormatToken* nextRealToken = nullptr;
-        for (FormatToken* tk : tokens.mid(tokenIdx + 1))
+        for (int i = tokenIdx + 1, total = tokens.size(); i < total; i++)
         {
-            if (!isMetaType(tk->type))
+            if (!isMetaType(tokens[i]->type))
             {
-                nextRealToken = tk;
+                nextRealToken = tokens[i];
                 break;
             }
         }
@@ -1059,12 +1082,12 @@ int FormatStatement::predictCurrentIndent(FormatToken* currentMetaToken)
         if ((nextRealToken && isSpaceExpectingType(lastToken->type) && isSpaceExpectingType(nextRealToken->type)) || willStartWithNewLine(nextRealToken))
         {
             // Next real token does not start with new line, but it does require additional space:
-            line += SPACE;
+            output += SPACE;
         }
     }
 
-    int result = line.length();
-    line = lineBackup;
+    int result = lineLength();
+    output.truncate(outputLengthBackup);
     return result;
 }
 
@@ -1082,9 +1105,9 @@ bool FormatStatement::willStartWithNewLine(FormatStatement::FormatToken* token)
 void FormatStatement::formatId(const QString& value)
 {
     if (cfg->SqlEnterpriseFormatter.AlwaysUseNameWrapping.get())
-        line += wrapObjName(value, dialect, true, wrapper);
+        output += wrapObjName(value, dialect, true, wrapper);
     else
-        line += wrapObjIfNeeded(value, dialect, true, wrapper);
+        output += wrapObjIfNeeded(value, dialect, true, wrapper);
 }
 
 FormatStatement* FormatStatement::forQuery(SqliteStatement* query, Dialect dialect, NameWrapper wrapper, Cfg::SqlEnterpriseFormatterConfig* cfg)
@@ -11,6 +11,8 @@
 #include <QHash>
 #include <QStack>
 #include <QVariant>
+#include <QVector>
+#include <QAtomicInteger>
 #include <functional>
 
 class FormatStatement
@@ -180,6 +182,8 @@ class FormatStatement
         bool isSpaceExpectingType(FormatToken::Type type);
         bool isMetaType(FormatToken::Type type);
         void newLine();
+        void appendSpaces(int count);
+        int lineLength() const;
         void incrIndent(const QString& name = QString());
         void decrIndent();
         void setIndent(int newIndent);
@@ -194,7 +198,7 @@ class FormatStatement
         void removeAllSpacesFromLine();
         void updateLastToken(FormatToken* token);
         QString getFinalLineUpName(const QString& lineUpName);
-        int predictCurrentIndent(FormatToken* currentMetaToken);
+        int predictCurrentIndent(int tokenIdx);
         bool willStartWithNewLine(FormatToken* token);
         void formatId(const QString& value);
         int getLineUpValue(const QString& lineUpName);
@@ -206,13 +210,14 @@ class FormatStatement
         QStack<int> indents;
         QList<FormatToken*> tokens;
         bool deleteTokens = true;
-        QStringList lines;
-        QString line;
+        QString output;
+        QVector<int> lineStarts = {0};  // positions in output where each line starts, the last one is the current line
         FormatToken* lastToken = nullptr;
         QString statementName;
         FormatStatement* parentFormatStatement = nullptr;
 
-        static qint64 nameSeq;
+        static QAtomicInteger<qint64> nameSeq;
+        static const int INDENT_SPACES_CACHE = 128;
         static const QString SPACE;
         static const QString NEWLINE;
 };
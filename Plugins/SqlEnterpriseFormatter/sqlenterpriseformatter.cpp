@@ -1,8 +1,11 @@
 #include "sqlenterpriseformatter.h"
 #include "formatstatement.h"
+#include "formatsimpleinsert.h"
 #include "common/unused.h"
 #include "common/global.h"
 #include <QDebug>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 #include <parser/lexer.h>
 #include <parser/parser.h>
 
@@ -10,13 +13,65 @@ SqlEnterpriseFormatter::SqlEnterpriseFormatter()
 {
 }
 
+QString SqlEnterpriseFormatter::format(const QString& code, Db* contextDb)
+{
+    // Queries are formatted independently from each other, so big scripts are split into chunks formatted in parallel.
+    QList<TokenList> queries = splitScript(code);
+    NameWrapper wrapper = getSelectedWrapper();
+    QStringList formattedQueries;
+    if (queries.size() < PARALLEL_FORMATTING_THRESHOLD)
+    {
+        // Not worth the threads, but plain INSERTs still skip the parser
+        if (!formatQueries(queries, wrapper, formattedQueries))
+            return SqlFormatterPlugin::format(code, contextDb); // parses whole script again, so the error is reported as usual
+
+        return formattedQueries.join("\n");
+    }
+
+    // Config entries are loaded on first use, which must not happen concurrently
+    for (CfgEntry* entry : cfg.SqlEnterpriseFormatter.getEntries())
+        entry->get();
+
+    int chunkCount = qMax(1, QThread::idealThreadCount());
+    int chunkSize = (queries.size() + chunkCount - 1) / chunkCount;
+    QList<ScriptChunk> chunks;
+    for (int i = 0, total = queries.size(); i < total; i += chunkSize)
+    {
+        ScriptChunk chunk;
+        chunk.queries = queries.mid(i, chunkSize);
+        chunks << chunk;
+    }
+
+    QtConcurrent::blockingMap(chunks, [this, wrapper](ScriptChunk& chunk)
+    {
+        chunk.success = formatQueries(chunk.queries, wrapper, chunk.formatted);
+    });
+
+    for (const ScriptChunk& chunk : chunks)
+    {
+        if (!chunk.success)
+            return SqlFormatterPlugin::format(code, contextDb); // parses whole script again, so the error is reported as usual
+
+        formattedQueries += chunk.formatted;
+    }
+
+    return formattedQueries.join("\n");
+}
+
 QString SqlEnterpriseFormatter::format(SqliteQueryPtr query)
 {
-    QList<Comment*> comments = collectComments(query->tokens);
+    return formatQuery(query, getSelectedWrapper());
+}
 
+NameWrapper SqlEnterpriseFormatter::getSelectedWrapper()
+{
     int wrapperIdx = cfg.SqlEnterpriseFormatter.Wrappers.get().indexOf(cfg.SqlEnterpriseFormatter.PrefferedWrapper.get());
+    return getAllNameWrappers()[wrapperIdx];
+}
 
-    NameWrapper wrapper = getAllNameWrappers()[wrapperIdx];
+QString SqlEnterpriseFormatter::formatQuery(SqliteQueryPtr query, NameWrapper wrapper)
+{
+    QList<Comment*> comments = collectComments(query->tokens);
 
     FormatStatement *formatStmt = FormatStatement::forQuery(query.data());
     if (!formatStmt)
@@ -34,6 +89,56 @@ QString SqlEnterpriseFormatter::format(SqliteQueryPtr query)
     return formattedWithComments;
 }
 
+bool SqlEnterpriseFormatter::formatQueries(const QList<TokenList>& queries, NameWrapper wrapper, QStringList& results)
+{
+    Parser parser(Dialect::Sqlite3);
+    FormatStatement* formatStmt = nullptr;
+    for (const TokenList& queryTokens : queries)
+    {
+        // Plain INSERTs with values (which make most of data dumps) don't need the syntax tree
+        formatStmt = FormatSimpleInsert::forTokens(queryTokens);
+        if (formatStmt)
+        {
+            formatStmt->setSelectedWrapper(wrapper);
+            formatStmt->setConfig(&cfg);
+            results << formatStmt->format();
+            delete formatStmt;
+            continue;
+        }
+
+        if (!parser.parse(queryTokens.detokenize()))
+            return false;
+
+        for (SqliteQueryPtr query : parser.getQueries())
+            results << formatQuery(query, wrapper);
+    }
+    return true;
+}
+
+QList<TokenList> SqlEnterpriseFormatter::splitScript(const QString& code)
+{
+    // The parser attaches whitespaces and comments to the preceding query, so they are moved
+    // to the previous chunk, to get the same queries as when parsing the whole script at once.
+    QList<TokenList> queries;
+    int realTokenIdx;
+    for (const TokenList& queryTokens : splitQueries(Lexer::tokenize(code, Dialect::Sqlite3)))
+    {
+        if (queries.isEmpty())
+        {
+            queries << queryTokens;
+            continue;
+        }
+
+        realTokenIdx = 0;
+        while (realTokenIdx < queryTokens.size() && queryTokens[realTokenIdx]->isWhitespace())
+            queries.last() << queryTokens[realTokenIdx++];
+
+        if (realTokenIdx < queryTokens.size())
+            queries << queryTokens.mid(realTokenIdx);
+    }
+    return queries;
+}
+
 bool SqlEnterpriseFormatter::init()
 {
     Q_INIT_RESOURCE(sqlenterpriseformatter);
@@ -68,6 +68,7 @@ class SQLENTERPRISEFORMATTERSHARED_EXPORT SqlEnterpriseFormatter : public Generi
     public:
         SqlEnterpriseFormatter();
 
+        QString format(const QString& code, Db* contextDb);
         QString format(SqliteQueryPtr query);
         bool init();
         void deinit();
@@ -86,6 +87,20 @@ class SQLENTERPRISEFORMATTERSHARED_EXPORT SqlEnterpriseFormatter : public Generi
             bool multiline = false;
         };
 
+        /**
+         * @brief Range of queries of a script, that is formatted by a single thread.
+         */
+        struct ScriptChunk
+        {
+            QList<TokenList> queries;
+            QStringList formatted;
+            bool success = false;
+        };
+
+        NameWrapper getSelectedWrapper();
+        QString formatQuery(SqliteQueryPtr query, NameWrapper wrapper);
+        bool formatQueries(const QList<TokenList>& queries, NameWrapper wrapper, QStringList& results);
+        QList<TokenList> splitScript(const QString& code);
         QList<Comment*> collectComments(const TokenList& tokens);
         QString applyComments(const QString& formatted, QList<Comment *> comments, Dialect dialect);
         QList<TokenList> tokensByLines(const TokenList& tokens, bool includeSpaces = false);
@@ -96,6 +111,8 @@ class SQLENTERPRISEFORMATTERSHARED_EXPORT SqlEnterpriseFormatter : public Generi
         void indentMultiLineComments(const TokenList& inputTokens);
         void wrapComment(const TokenPtr& token, bool isAtLineEnd);
 
+        static const int PARALLEL_FORMATTING_THRESHOLD = 64;
+
         QList<SqliteQueryPtr> previewQueries;
         CFG_LOCAL_PERSISTABLE(SqlEnterpriseFormatterConfig, cfg)
 
@@ -97,12 +97,32 @@ bool XmlExport::exportQueryResultsRow(SqlResultsRowPtr row)
     incrIndent();
 
     int i = 0;
+    QString strValue;
     for (const QVariant& value : row->valueList())
     {
         if (value.isNull())
+        {
             writeln(nullTpl.arg(i));
+        }
         else
-            writeln(rowTpl.arg(i).arg(escape(value.toString())));
+        {
+            strValue = value.toString();
+            if (strValue.contains('\n'))
+            {
+                // Multi-line values go through writeln(), which indents every line
+                writeln(rowTpl.arg(i).arg(escape(strValue)));
+            }
+            else
+            {
+                outputBuffer.write(indentStr);
+                outputBuffer.writeAscii("<value column=\"", 15);
+                outputBuffer.write(QString::number(i));
+                outputBuffer.writeAscii("\">", 2);
+                writeEscaped(strValue);
+                outputBuffer.writeAscii("</value>", 8);
+                outputBuffer.write(newLineStr);
+            }
+        }
 
         i++;
     }
@@ -416,7 +436,10 @@ void XmlExport::writeln(const QString& str)
     }
     else
     {
-        newStr = indentStr + str + newLineStr;
+        outputBuffer.write(indentStr);
+        outputBuffer.write(str);
+        outputBuffer.write(newLineStr);
+        return;
     }
     GenericExportPlugin::write(newStr);
 }
@@ -442,7 +465,7 @@ QString XmlExport::escape(const QString& str)
 
 QString XmlExport::escapeCdata(const QString& str)
 {
-    if (str.contains('"') || str.contains('&') || str.contains('<') || str.contains('>'))
+    if (ExportOutputBuffer::hasXmlSpecialChars(str))
         return "<![CDATA[" + str + "]]>";
 
     return str;
@@ -450,7 +473,27 @@ QString XmlExport::escapeCdata(const QString& str)
 
 QString XmlExport::escapeAmpersand(const QString& str)
 {
-    return str.toHtmlEscaped();
+    return ExportOutputBuffer::escapeXml(str);
+}
+
+void XmlExport::writeEscaped(const QString& str)
+{
+    if (useCdata && (!useAmpersand || str.length() >= minLenghtForCdata))
+    {
+        if (ExportOutputBuffer::hasXmlSpecialChars(str))
+        {
+            outputBuffer.writeAscii("<![CDATA[", 9);
+            outputBuffer.write(str);
+            outputBuffer.writeAscii("]]>", 3);
+        }
+        else
+        {
+            outputBuffer.write(str);
+        }
+        return;
+    }
+
+    outputBuffer.writeXmlEscaped(str);
 }
 
 QString XmlExport::toString(bool value)
@@ -55,6 +55,7 @@ class XMLEXPORTSHARED_EXPORT XmlExport : public GenericExportPlugin
         QString escape(const QString& str);
         QString escapeCdata(const QString& str);
         QString escapeAmpersand(const QString& str);
+        void writeEscaped(const QString& str);
 
         static QString toString(bool value);
 
@@ -0,0 +1,15 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_benchmarks
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_benchmarks.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,386 @@
+#include "sqlitestudio.h"
+#include "parser/lexer.h"
+#include "parser/parser.h"
+#include "schemaresolver.h"
+#include "csvserializer.h"
+#include "csvformat.h"
+#include "db/dbsqlite3.h"
+#include "db/queryexecutor.h"
+#include "services/exportmanager.h"
+#include "services/pluginmanager.h"
+#include "plugins/exportplugin.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QProcess>
+#include <QSignalSpy>
+
+/**
+ * Performance benchmarks of core components, working on synthetic schemas and datasets generated in a temporary directory.
+ *
+ * By default datasets are small enough to run the whole suite in about a minute. Set SQLITESTUDIO_BENCH_SCALE=full
+ * to run it with 10k-table schema, 1 GB CSV file and 10M-row table.
+ *
+ * Unless -o option is given, results are written to the standard output and as CSV to the file pointed
+ * by SQLITESTUDIO_BENCH_OUTPUT (benchmarks.csv in the working directory by default), so they can be compared
+ * between commits.
+ */
+class BenchmarksTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        BenchmarksTest();
+
+    private:
+        QString generateSchemaDdl(int tables);
+        void createDb(Db*& db, const QString& name);
+        void generateCsvFile(const QString& path, qint64 size);
+        QString getCliPath();
+        void runCli(const QString& homeDir);
+
+        QTemporaryDir tempDir;
+        QTemporaryDir homeDir;
+        bool fullScale = false;
+        int schemaTables = 1000;
+        qint64 csvFileSize = 32 * 1024 * 1024;
+        qint64 dataRows = 200000;
+        QString schemaDdl;
+        Db* schemaDb = nullptr;
+        Db* dataDb = nullptr;
+        QString csvPath;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void benchmarkLexer();
+        void benchmarkParser();
+        void benchmarkParserClone();
+        void benchmarkSchemaResolverCold();
+        void benchmarkSchemaResolverWarm();
+        void benchmarkQueryExecutor();
+        void benchmarkCsvSerialize();
+        void benchmarkCsvDeserialize();
+        void benchmarkExport_data();
+        void benchmarkExport();
+        void benchmarkStartupCold();
+        void benchmarkStartupWarm();
+};
+
+BenchmarksTest::BenchmarksTest()
+{
+}
+
+QString BenchmarksTest::generateSchemaDdl(int tables)
+{
+    QStringList ddls;
+    for (int i = 0; i < tables; i++)
+    {
+        ddls << QString("CREATE TABLE tab_%1 (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL COLLATE NOCASE, "
+                        "value REAL DEFAULT 0 CHECK (value >= 0), created TEXT DEFAULT CURRENT_TIMESTAMP, "
+                        "parent_id INTEGER REFERENCES tab_%2 (id) ON DELETE CASCADE, data BLOB, UNIQUE (name, parent_id));").arg(i).arg(i > 0 ? i - 1 : 0);
+
+        ddls << QString("CREATE INDEX idx_tab_%1_value ON tab_%1 (value DESC, created);").arg(i);
+        if (i % 10 == 0)
+        {
+            ddls << QString("CREATE TRIGGER trig_tab_%1 AFTER UPDATE OF value ON tab_%1 WHEN new.value > old.value "
+                            "BEGIN UPDATE tab_%1 SET created = datetime('now') WHERE id = new.id; END;").arg(i);
+            ddls << QString("CREATE VIEW view_tab_%1 AS SELECT t.id, t.name, sum(t.value) AS total FROM tab_%1 t "
+                            "LEFT JOIN tab_%1 p ON p.id = t.parent_id WHERE t.value > 0 GROUP BY t.id, t.name;").arg(i);
+        }
+    }
+    return ddls.join("\n");
+}
+
+void BenchmarksTest::createDb(Db*& db, const QString& name)
+{
+    db = new DbSqlite3(name, tempDir.path() + "/" + name + ".db", QHash<QString,QVariant>());
+    QVERIFY(db->open());
+}
+
+void BenchmarksTest::generateCsvFile(const QString& path, qint64 size)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    QByteArray chunk;
+    int row = 0;
+    while (file.size() < size)
+    {
+        chunk.clear();
+        for (int i = 0; i < 1000; i++, row++)
+        {
+            chunk += QByteArray::number(row) + ",name " + QByteArray::number(row) + "," + QByteArray::number(row * 0.37, 'f', 2) +
+                     ",\"quoted, \"\"text\"\"\nin two lines\",2026-10-16 12:00:00\r\n";
+        }
+        file.write(chunk);
+    }
+    file.close();
+}
+
+QString BenchmarksTest::getCliPath()
+{
+#ifdef Q_OS_WIN
+    return QCoreApplication::applicationDirPath() + "/sqlitestudiocli.exe";
+#else
+    return QCoreApplication::applicationDirPath() + "/sqlitestudiocli";
+#endif
+}
+
+void BenchmarksTest::runCli(const QString& homeDir)
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("HOME", homeDir);
+    env.insert("APPDATA", homeDir);
+    env.insert("XDG_CONFIG_HOME", homeDir + "/.config");
+
+    QProcess process;
+    process.setProcessEnvironment(env);
+    process.start(getCliPath(), {"--list-plugins"});
+    QVERIFY(process.waitForFinished(60000));
+    QCOMPARE(process.exitCode(), 0);
+}
+
+void BenchmarksTest::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    QVERIFY(homeDir.isValid());
+
+    fullScale = (qgetenv("SQLITESTUDIO_BENCH_SCALE") == "full");
+    if (fullScale)
+    {
+        schemaTables = 10000;
+        csvFileSize = 1024 * 1024 * 1024;
+        dataRows = 10000000;
+    }
+
+    // The in-process application gets its own configuration, so benchmarks don't depend on the user's one.
+    qputenv("HOME", homeDir.path().toLocal8Bit());
+    qputenv("APPDATA", homeDir.path().toLocal8Bit());
+    qputenv("XDG_CONFIG_HOME", (homeDir.path() + "/.config").toLocal8Bit());
+    SQLITESTUDIO->init(qApp->arguments(), false);
+    SQLITESTUDIO->initPlugins();
+
+    schemaDdl = generateSchemaDdl(schemaTables);
+
+    createDb(schemaDb, "schema");
+    QVERIFY(schemaDb->begin());
+    for (const QString& ddl : schemaDdl.split("\n"))
+        QVERIFY(!schemaDb->exec(ddl)->isError());
+
+    QVERIFY(schemaDb->commit());
+
+    createDb(dataDb, "data");
+    QVERIFY(!dataDb->exec("CREATE TABLE data (id INTEGER PRIMARY KEY, name TEXT, value REAL, created TEXT, description TEXT)")->isError());
+    SqlQueryPtr results = dataDb->exec(
+                "WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < ?) "
+                "INSERT INTO data (id, name, value, created, description) "
+                "SELECT x, 'name ' || x, x * 0.37, datetime(1790000000 + x, 'unixepoch'), printf('row %d with some longer text', x) FROM seq",
+                QVariant(dataRows));
+    QVERIFY(!results->isError());
+
+    csvPath = tempDir.path() + "/data.csv";
+    generateCsvFile(csvPath, csvFileSize);
+}
+
+void BenchmarksTest::cleanupTestCase()
+{
+    if (schemaDb)
+        schemaDb->close();
+
+    if (dataDb)
+        dataDb->close();
+
+    safe_delete(schemaDb);
+    safe_delete(dataDb);
+    SQLITESTUDIO->cleanUp();
+}
+
+void BenchmarksTest::benchmarkLexer()
+{
+    TokenList tokens;
+    QBENCHMARK {
+        tokens = Lexer::tokenize(schemaDdl, Dialect::Sqlite3);
+    }
+    QVERIFY(tokens.size() > schemaTables);
+}
+
+void BenchmarksTest::benchmarkParser()
+{
+    Parser parser(Dialect::Sqlite3);
+    bool res = false;
+    QBENCHMARK {
+        res = parser.parse(schemaDdl);
+    }
+    QVERIFY(res);
+    QCOMPARE(parser.getQueries().size(), schemaTables * 2 + (schemaTables + 9) / 10 * 2);
+}
+
+void BenchmarksTest::benchmarkParserClone()
+{
+    Parser parser(Dialect::Sqlite3);
+    QVERIFY(parser.parse(schemaDdl));
+
+    QList<SqliteQueryPtr> copies;
+    QBENCHMARK {
+        copies.clear();
+        for (const SqliteQueryPtr& query : parser.getQueries())
+            copies << SqliteQueryPtr(dynamic_cast<SqliteQuery*>(query->clone()));
+    }
+    QCOMPARE(copies.size(), parser.getQueries().size());
+}
+
+void BenchmarksTest::benchmarkSchemaResolverCold()
+{
+    // First use of the resolver in this process, so caches of parsed DDLs are empty.
+    StrHash<SqliteQueryPtr> objects;
+    QBENCHMARK_ONCE {
+        SchemaResolver resolver(schemaDb);
+        resolver.setIgnoreSystemObjects(true);
+        objects = resolver.getAllParsedObjects();
+    }
+    QCOMPARE(objects.size(), schemaTables * 2 + (schemaTables + 9) / 10 * 2);
+}
+
+void BenchmarksTest::benchmarkSchemaResolverWarm()
+{
+    StrHash<SqliteQueryPtr> objects;
+    QBENCHMARK {
+        SchemaResolver resolver(schemaDb);
+        resolver.setIgnoreSystemObjects(true);
+        objects = resolver.getAllParsedObjects();
+    }
+    QCOMPARE(objects.size(), schemaTables * 2 + (schemaTables + 9) / 10 * 2);
+}
+
+void BenchmarksTest::benchmarkQueryExecutor()
+{
+    QueryExecutor executor(dataDb);
+    executor.setAsyncMode(false);
+    QSignalSpy finishedSpy(&executor, SIGNAL(executionFinished(SqlQueryPtr)));
+    QSignalSpy failedSpy(&executor, SIGNAL(executionFailed(int,QString)));
+
+    QBENCHMARK {
+        finishedSpy.clear();
+        executor.exec("SELECT * FROM data WHERE value > 10 ORDER BY name");
+        if (finishedSpy.isEmpty() && failedSpy.isEmpty())
+            finishedSpy.wait(600000);
+    }
+    QVERIFY(failedSpy.isEmpty());
+    QVERIFY(!finishedSpy.isEmpty());
+}
+
+void BenchmarksTest::benchmarkCsvSerialize()
+{
+    SqlQueryPtr results = dataDb->exec("SELECT * FROM data LIMIT 1000000");
+    QList<QStringList> rows;
+    QStringList row;
+    while (results->hasNext())
+    {
+        row.clear();
+        for (const QVariant& value : results->next()->valueList())
+            row << value.toString();
+
+        rows << row;
+    }
+
+    QString output;
+    QBENCHMARK {
+        output = CsvSerializer::serialize(rows, CsvFormat::DEFAULT);
+    }
+    QVERIFY(output.length() > rows.size());
+}
+
+void BenchmarksTest::benchmarkCsvDeserialize()
+{
+    qint64 rowCount = 0;
+    QBENCHMARK {
+        QFile file(csvPath);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QTextStream stream(&file);
+        rowCount = 0;
+        while (!stream.atEnd())
+        {
+            CsvSerializer::deserializeOneEntry(stream, CsvFormat::DEFAULT);
+            rowCount++;
+        }
+    }
+    QVERIFY(rowCount > 0);
+}
+
+void BenchmarksTest::benchmarkExport_data()
+{
+    QTest::addColumn<QString>("format");
+
+    // Every loaded export plugin that can export a table gets its own result row
+    for (ExportPlugin* plugin : PLUGINS->getLoadedPlugins<ExportPlugin>())
+    {
+        if (plugin->getSupportedModes().testFlag(ExportManager::TABLE))
+            QTest::newRow(plugin->getFormatName().toUtf8().constData()) << plugin->getFormatName();
+    }
+}
+
+void BenchmarksTest::benchmarkExport()
+{
+    QFETCH(QString, format);
+
+    ExportManager::StandardExportConfig config;
+    config.codec = "UTF-8";
+    config.outputFileName = tempDir.path() + "/export." + format.toLower();
+    QSignalSpy successSpy(EXPORT_MANAGER, SIGNAL(exportSuccessful()));
+
+    QBENCHMARK {
+        EXPORT_MANAGER->configure(format, config);
+        EXPORT_MANAGER->exportTable(dataDb, "main", "data", false);
+    }
+    QVERIFY(!successSpy.isEmpty());
+    QVERIFY(QFileInfo(config.outputFileName).size() > 0);
+}
+
+void BenchmarksTest::benchmarkStartupCold()
+{
+    if (!QFileInfo(getCliPath()).exists())
+        QSKIP("The sqlitestudiocli executable is not available next to benchmarks.");
+
+    // Every start gets a fresh configuration, so every plugin file has to be read for its metadata.
+    // The CLI quits with --list-plugins before its event loop starts, so plugins deferred at startup are never loaded.
+    QBENCHMARK {
+        QTemporaryDir startupHome;
+        runCli(startupHome.path());
+    }
+}
+
+void BenchmarksTest::benchmarkStartupWarm()
+{
+    if (!QFileInfo(getCliPath()).exists())
+        QSKIP("The sqlitestudiocli executable is not available next to benchmarks.");
+
+    // The first start fills the plugin metadata index. Measured starts take metadata from the index
+    // and read only files of plugins that are loaded at startup (not deferred ones), so the difference
+    // to benchmarkStartupCold() is the cost of reading metadata of the deferred plugins.
+    QTemporaryDir startupHome;
+    runCli(startupHome.path());
+    QBENCHMARK {
+        runCli(startupHome.path());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    BenchmarksTest test;
+
+    QStringList args = app.arguments();
+    if (!args.contains("-o"))
+    {
+        QString outputFile = QString::fromLocal8Bit(qgetenv("SQLITESTUDIO_BENCH_OUTPUT"));
+        if (outputFile.isEmpty())
+            outputFile = "benchmarks.csv";
+
+        args << "-o" << "-,txt" << "-o" << (outputFile + ",csv");
+    }
+
+    return QTest::qExec(&test, args);
+}
+
+#include "tst_benchmarks.moc"
@@ -0,0 +1,183 @@
+#include "db/columnprofiler.h"
+#include "db/db.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class ColumnProfilerTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        ColumnProfilerTest();
+
+    private:
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testBasicStats();
+        void testMixedTypesOrder();
+        void testDistinctEstimate();
+        void testTopValues();
+        void testProfileTable();
+        void testProfileSampled();
+};
+
+ColumnProfilerTest::ColumnProfilerTest()
+{
+}
+
+void ColumnProfilerTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, score REAL, data BLOB);");
+    db->exec("WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < 5000) "
+             "INSERT INTO test (id, name, score, data) "
+             "SELECT x, CASE WHEN x % 10 = 0 THEN NULL ELSE 'name' || (x % 100) END, x / 2.0, randomblob(x % 8 + 1) FROM cnt;");
+}
+
+void ColumnProfilerTest::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void ColumnProfilerTest::testBasicStats()
+{
+    ColumnProfiler::Accumulator acc;
+    acc.add("text", "abc");
+    acc.add("null", QVariant());
+    acc.add("text", "a");
+    acc.add("text", "abcde");
+    acc.add("text", "abc");
+
+    ColumnProfiler::ColumnProfile profile = acc.getProfile("col");
+    QCOMPARE(profile.column, QString("col"));
+    QCOMPARE(profile.rows, 5LL);
+    QCOMPARE(profile.nulls, 1LL);
+    QCOMPARE(profile.distinct, 3LL);
+    QCOMPARE(profile.min.toString(), QString("a"));
+    QCOMPARE(profile.max.toString(), QString("abcde"));
+    QCOMPARE(profile.types["text"], 4LL);
+    QCOMPARE(profile.types["null"], 1LL);
+    QCOMPARE(profile.lengthValues, 4LL);
+    QCOMPARE(profile.minLength, 1LL);
+    QCOMPARE(profile.maxLength, 5LL);
+    QCOMPARE(profile.avgLength, 3.0);
+    QVERIFY(!profile.topValues.isEmpty());
+    QCOMPARE(profile.topValues.first().value.toString(), QString("abc"));
+    QCOMPARE(profile.topValues.first().count, 2LL);
+}
+
+void ColumnProfilerTest::testMixedTypesOrder()
+{
+    ColumnProfiler::Accumulator acc;
+    acc.add("blob", QByteArray("\x01\x02", 2));
+    acc.add("text", "10");
+    acc.add("integer", 100LL);
+    acc.add("real", 2.5);
+    acc.add("integer", 7LL);
+
+    ColumnProfiler::ColumnProfile profile = acc.getProfile("col");
+    QCOMPARE(profile.min.toDouble(), 2.5);
+    QCOMPARE(profile.max.toByteArray(), QByteArray("\x01\x02", 2));
+    QCOMPARE(profile.types.size(), 4);
+    QCOMPARE(profile.distinct, 5LL);
+
+    // Same text of different types is not the same value
+    ColumnProfiler::Accumulator acc2;
+    acc2.add("integer", 1LL);
+    acc2.add("text", "1");
+    QCOMPARE(acc2.getProfile("col").distinct, 2LL);
+}
+
+void ColumnProfilerTest::testDistinctEstimate()
+{
+    ColumnProfiler::Accumulator acc;
+    for (qint64 i = 0; i < 100000; i++)
+        acc.add("integer", i % 50000);
+
+    qint64 distinct = acc.getProfile("col").distinct;
+    QVERIFY2(qAbs(distinct - 50000) < 2500, qPrintable(QString::number(distinct)));
+}
+
+void ColumnProfilerTest::testTopValues()
+{
+    // Frequent values are mixed with many unique ones, which should not push them out
+    ColumnProfiler::Accumulator acc(3);
+    for (int i = 0; i < 20000; i++)
+    {
+        acc.add("integer", static_cast<qint64>(1000000 + i));
+        if (i % 10 == 0)
+            acc.add("text", "frequent");
+
+        if (i % 20 == 0)
+            acc.add("text", "less frequent");
+    }
+
+    QList<ColumnProfiler::ValueCount> top = acc.getProfile("col").topValues;
+    QCOMPARE(top.size(), 3);
+    QCOMPARE(top[0].value.toString(), QString("frequent"));
+    QCOMPARE(top[1].value.toString(), QString("less frequent"));
+    QVERIFY(top[0].count >= 2000);
+    QVERIFY(top[0].count - top[0].error <= 2000);
+    QVERIFY(top[1].count >= 1000);
+}
+
+void ColumnProfilerTest::testProfileTable()
+{
+    ColumnProfiler::Report report = ColumnProfiler::profile(db, QString(), "test");
+    QVERIFY(report.isValid());
+    QVERIFY(!report.sampled);
+    QCOMPARE(report.totalRows, 5000LL);
+    QCOMPARE(report.scannedRows, 5000LL);
+    QCOMPARE(report.columns.size(), 4);
+
+    const ColumnProfiler::ColumnProfile& id = report.columns[0];
+    QCOMPARE(id.column, QString("id"));
+    QCOMPARE(id.nulls, 0LL);
+    QCOMPARE(id.min.toLongLong(), 1LL);
+    QCOMPARE(id.max.toLongLong(), 5000LL);
+    QVERIFY(qAbs(id.distinct - 5000) < 250);
+
+    const ColumnProfiler::ColumnProfile& name = report.columns[1];
+    QCOMPARE(name.nulls, 500LL);
+    QCOMPARE(name.types["text"], 4500LL);
+    QVERIFY(qAbs(name.distinct - 90) <= 2);
+
+    const ColumnProfiler::ColumnProfile& score = report.columns[2];
+    QCOMPARE(score.types["real"], 5000LL);
+    QCOMPARE(score.max.toDouble(), 2500.0);
+
+    const ColumnProfiler::ColumnProfile& data = report.columns[3];
+    QCOMPARE(data.types["blob"], 5000LL);
+    QCOMPARE(data.minLength, 1LL);
+    QCOMPARE(data.maxLength, 8LL);
+}
+
+void ColumnProfilerTest::testProfileSampled()
+{
+    ColumnProfiler::Report report = ColumnProfiler::profile(db, QString(), "test", {"name"}, 500);
+    QVERIFY(report.isValid());
+    QVERIFY(report.sampled);
+    QCOMPARE(report.totalRows, 5000LL);
+    QVERIFY(report.scannedRows > 0);
+    QVERIFY(report.scannedRows < 5000);
+    QCOMPARE(report.columns.size(), 1);
+    QCOMPARE(report.columns[0].rows, report.scannedRows);
+}
+
+QTEST_APPLESS_MAIN(ColumnProfilerTest)
+
+#include "tst_columnprofilertest.moc"
@@ -1,9 +1,11 @@
 #include "completionhelper.h"
+#include "completionindex.h"
 #include "expectedtoken.h"
 #include "dbsqlite3mock.h"
 #include "parser/lexer.h"
 #include "parser/token.h"
 #include "parser/keywords.h"
+#include "parser/parser.h"
 #include "sqlitestudio.h"
 #include "mocks.h"
 #include <QString>
@@ -52,6 +54,9 @@ class CompletionHelperTest : public QObject
         void testFromKw();
         void testUpdateTable();
         void testUpdateCols1();
+        void testIndexedSchema();
+        void testIndexedSchemaIfNotExists();
+        void testIndexedSchemaRollback();
         void initTestCase();
         void cleanupTestCase();
 };
@@ -372,6 +377,79 @@ void CompletionHelperTest::testUpdateCols1()
     //QVERIFY(!contains(tokens, ExpectedToken::COLUMN, "id", QString::null, "abc")); // TODO
 }
 
+void CompletionHelperTest::testIndexedSchema()
+{
+    COMPLETION_INDEX->build(db);
+    COMPLETION_INDEX->waitForReady(db);
+    QVERIFY(COMPLETION_INDEX->isReady(db));
+
+    QList<ExpectedTokenPtr> tokens = CompletionHelper("select * FROM ", db).getExpectedTokens().filtered();
+    QVERIFY(contains(tokens, ExpectedToken::TABLE, "test"));
+    QVERIFY(contains(tokens, ExpectedToken::TABLE, "abc"));
+
+    // Table created by executed DDL is visible without reloading the schema.
+    QString ddl = "CREATE TABLE idx_test (col1 int, col2 text);";
+    Parser parser(db->getDialect());
+    QVERIFY(parser.parse(ddl));
+    db->exec(ddl);
+    COMPLETION_INDEX->handleDdl(db, parser.getQueries());
+
+    tokens = CompletionHelper("select idx_test.", db).getExpectedTokens().filtered();
+    QVERIFY(contains(tokens, ExpectedToken::COLUMN, "col1"));
+    QVERIFY(contains(tokens, ExpectedToken::COLUMN, "col2"));
+
+    COMPLETION_INDEX->remove(db);
+    QVERIFY(!COMPLETION_INDEX->isReady(db));
+}
+
+void CompletionHelperTest::testIndexedSchemaIfNotExists()
+{
+    COMPLETION_INDEX->build(db);
+    COMPLETION_INDEX->waitForReady(db);
+
+    // The table already exists, so the columns from the DDL must not replace the real ones.
+    QString ddl = "CREATE TABLE IF NOT EXISTS test (other_col int);";
+    Parser parser(db->getDialect());
+    QVERIFY(parser.parse(ddl));
+    db->exec(ddl);
+    COMPLETION_INDEX->handleDdl(db, parser.getQueries());
+
+    QList<ExpectedTokenPtr> tokens = CompletionHelper("select test.", db).getExpectedTokens().filtered();
+    QVERIFY(contains(tokens, ExpectedToken::COLUMN, "val"));
+    QVERIFY(!contains(tokens, ExpectedToken::COLUMN, "other_col"));
+
+    COMPLETION_INDEX->remove(db);
+}
+
+void CompletionHelperTest::testIndexedSchemaRollback()
+{
+    COMPLETION_INDEX->build(db);
+    COMPLETION_INDEX->waitForReady(db);
+
+    QStringList sqls = {
+        "BEGIN;",
+        "CREATE TABLE rolled_back (col1 int);",
+        "ROLLBACK;",
+        "BEGIN;",
+        "CREATE TABLE committed (col2 int);",
+        "COMMIT;"
+    };
+    Parser parser(db->getDialect());
+    for (const QString& sql : sqls)
+    {
+        QVERIFY(parser.parse(sql));
+        db->exec(sql);
+        COMPLETION_INDEX->handleDdl(db, parser.getQueries());
+    }
+
+    QList<ExpectedTokenPtr> tokens = CompletionHelper("select * FROM ", db).getExpectedTokens().filtered();
+    QVERIFY(!contains(tokens, ExpectedToken::TABLE, "rolled_back"));
+    QVERIFY(contains(tokens, ExpectedToken::TABLE, "committed"));
+
+    db->exec("DROP TABLE committed;");
+    COMPLETION_INDEX->remove(db);
+}
+
 void CompletionHelperTest::initTestCase()
 {
     initKeywords();
@@ -387,6 +465,7 @@ void CompletionHelperTest::initTestCase()
 
 void CompletionHelperTest::cleanupTestCase()
 {
+    CompletionIndex::destroy();
     db->close();
     delete db;
     db = nullptr;
@@ -0,0 +1,34 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib network
+
+QT       -= gui
+
+TARGET = tst_dbandroidtest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DB_ANDROID_DIR = $$PWD/../../../Plugins/DbAndroid
+INCLUDEPATH += $$DB_ANDROID_DIR
+DEPENDPATH += $$DB_ANDROID_DIR
+
+# Plugin classes are compiled into the test, so they're not imported from the plugin library.
+DEFINES += DBANDROID_LIBRARY
+
+SOURCES += tst_dbandroidtest.cpp \
+    dbandroidmockserver.cpp \
+    dbandroidstubs.cpp \
+    $$DB_ANDROID_DIR/dbandroidjsonconnection.cpp \
+    $$DB_ANDROID_DIR/dbandroidconnection.cpp \
+    $$DB_ANDROID_DIR/dbandroidurl.cpp \
+    $$DB_ANDROID_DIR/dbandroidshellsession.cpp
+
+HEADERS += dbandroidmockserver.h \
+    $$DB_ANDROID_DIR/dbandroidjsonconnection.h \
+    $$DB_ANDROID_DIR/dbandroidconnection.h \
+    $$DB_ANDROID_DIR/dbandroidurl.h \
+    $$DB_ANDROID_DIR/dbandroidshellsession.h
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
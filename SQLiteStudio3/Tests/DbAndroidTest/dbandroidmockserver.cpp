@@ -0,0 +1,359 @@
+#include "dbandroidmockserver.h"
+#include "db/dbsqlite3.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+
+DbAndroidMockServer::DbAndroidMockServer(QObject* parent) :
+    QObject(parent)
+{
+    server = new QTcpServer(this);
+    connect(server, SIGNAL(newConnection()), this, SLOT(handleNewConnection()));
+}
+
+DbAndroidMockServer::~DbAndroidMockServer()
+{
+    stop();
+}
+
+bool DbAndroidMockServer::start(const QString& directory, int port, const QString& password)
+{
+    if (!QDir(directory).exists())
+    {
+        qWarning() << "Directory for Android mock server doesn't exist:" << directory;
+        return false;
+    }
+
+    this->directory = directory;
+    this->password = password;
+    if (!server->listen(QHostAddress::LocalHost, port))
+    {
+        qWarning() << "Could not start Android mock server on port" << port << ":" << server->errorString();
+        return false;
+    }
+
+    qDebug() << "Android mock server serves databases from" << directory << "on port" << server->serverPort();
+    return true;
+}
+
+void DbAndroidMockServer::stop()
+{
+    server->close();
+    for (QTcpSocket* socket : clients.keys())
+        socket->disconnectFromHost();
+
+    clients.clear();
+    cursors.clear();
+    for (Db* db : databases)
+    {
+        db->closeQuiet();
+        delete db;
+    }
+    databases.clear();
+}
+
+int DbAndroidMockServer::getPort() const
+{
+    return server->serverPort();
+}
+
+void DbAndroidMockServer::handleNewConnection()
+{
+    QTcpSocket* socket = nullptr;
+    while ((socket = server->nextPendingConnection()))
+    {
+        clients[socket].authorized = password.isEmpty();
+        connect(socket, SIGNAL(readyRead()), this, SLOT(handleReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(handleDisconnected()));
+    }
+}
+
+void DbAndroidMockServer::handleReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !clients.contains(socket))
+        return;
+
+    QByteArray& buffer = clients[socket].buffer;
+    buffer.append(socket->readAll());
+
+    qint32 size;
+    while (buffer.size() >= 4)
+    {
+        size = (((unsigned char)buffer[3]) << 24) |
+                (((unsigned char)buffer[2]) << 16) |
+                (((unsigned char)buffer[1]) << 8) |
+                ((unsigned char)buffer[0]);
+
+        if (buffer.size() < size + 4)
+            break;
+
+        QByteArray message = buffer.mid(4, size);
+        buffer.remove(0, size + 4);
+        handleMessage(socket, message);
+    }
+}
+
+void DbAndroidMockServer::handleDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket)
+        return;
+
+    clients.remove(socket);
+    socket->deleteLater();
+}
+
+void DbAndroidMockServer::handleMessage(QTcpSocket* socket, const QByteArray& message)
+{
+    QJsonObject request = parseMessage(message);
+    if (request.isEmpty())
+    {
+        sendMessage(socket, genericError(1));
+        return;
+    }
+
+    Client& client = clients[socket];
+    if (request.contains("auth"))
+    {
+        client.authorized = (request["auth"].toString() == password);
+        sendMessage(socket, client.authorized ? stdResult("ok") : genericError(2));
+        return;
+    }
+
+    if (!client.authorized)
+    {
+        sendMessage(socket, genericError(2));
+        return;
+    }
+
+    QString cmd = request["cmd"].toString();
+    if (cmd == "QUERY")
+        sendMessage(socket, handleQuery(request));
+    else if (cmd == "FETCH")
+        sendMessage(socket, handleFetch(request));
+    else if (cmd == "CLOSE")
+        sendMessage(socket, handleClose(request));
+    else if (cmd == "LIST")
+        sendMessage(socket, handleList());
+    else if (cmd == "DELETE_DB")
+        sendMessage(socket, handleDeleteDb(request));
+    else
+        sendMessage(socket, genericError(3));
+}
+
+QJsonObject DbAndroidMockServer::handleQuery(const QJsonObject& request)
+{
+    Db* db = getDb(request["db"].toString());
+    if (!db)
+        return genericError(4);
+
+    SqlQueryPtr results = db->exec(request["query"].toString(), Db::Flag::NO_LOCK);
+    if (results->isError())
+    {
+        QJsonObject response;
+        response["error_code"] = results->getErrorCode();
+        response["error_message"] = results->getErrorText();
+        return response;
+    }
+
+    QJsonObject response;
+    QStringList columns = results->getColumnNames();
+    response["columns"] = QJsonArray::fromStringList(columns);
+
+    int batch = request["batch"].toInt(0);
+    if (batch > 0)
+    {
+        int cursorId = nextCursorId++;
+        QJsonObject page = readPage(cursorId, batch, results);
+        for (auto it = page.begin(); it != page.end(); ++it)
+            response[it.key()] = it.value();
+
+        return response;
+    }
+
+    // Legacy format - all rows at once, as objects
+    QJsonArray data;
+    SqlResultsRowPtr row;
+    QJsonObject jsonRow;
+    while (results->hasNext())
+    {
+        row = results->next();
+        for (int i = 0, total = columns.size(); i < total; ++i)
+            jsonRow[columns[i]] = toJsonValue(row->value(i), false);
+
+        data << jsonRow;
+        jsonRow = QJsonObject();
+    }
+    response["data"] = data;
+    return response;
+}
+
+QJsonObject DbAndroidMockServer::handleFetch(const QJsonObject& request)
+{
+    int cursorId = request["cursor"].toInt(-1);
+    if (!cursors.contains(cursorId))
+        return genericError(5);
+
+    QPair<SqlQueryPtr, int> cursor = cursors.take(cursorId);
+    return readPage(cursorId, cursor.second, cursor.first);
+}
+
+QJsonObject DbAndroidMockServer::handleClose(const QJsonObject& request)
+{
+    cursors.remove(request["cursor"].toInt(-1));
+    return stdResult("ok");
+}
+
+QJsonObject DbAndroidMockServer::readPage(int cursorId, int batch, const SqlQueryPtr& results)
+{
+    QJsonArray rows;
+    QJsonArray jsonRow;
+    SqlResultsRowPtr row;
+    for (int i = 0; i < batch && results->hasNext(); ++i)
+    {
+        row = results->next();
+        for (const QVariant& value : row->valueList())
+            jsonRow << toJsonValue(value, true);
+
+        rows << jsonRow;
+        jsonRow = QJsonArray();
+    }
+
+    QJsonObject response;
+    response["rows"] = rows;
+    response["more"] = results->hasNext();
+    if (results->hasNext())
+    {
+        response["cursor"] = cursorId;
+        cursors[cursorId] = QPair<SqlQueryPtr, int>(results, batch);
+    }
+
+    return response;
+}
+
+QJsonObject DbAndroidMockServer::handleList()
+{
+    QJsonObject response;
+    QStringList names = QDir(directory).entryList(QDir::Files, QDir::Name).filter(QRegularExpression("^(?!.*-journal$)(?!.*-wal$)(?!.*-shm$)"));
+    response["list"] = QJsonArray::fromStringList(names);
+    return response;
+}
+
+QJsonObject DbAndroidMockServer::handleDeleteDb(const QJsonObject& request)
+{
+    QString name = request["db"].toString();
+    if (databases.contains(name))
+    {
+        Db* db = databases.take(name);
+        db->closeQuiet();
+        delete db;
+    }
+
+    QString path = QDir(directory).absoluteFilePath(name);
+    QFile::remove(path + "-journal");
+    return stdResult(QFile::remove(path) ? "ok" : "failed");
+}
+
+Db* DbAndroidMockServer::getDb(const QString& name)
+{
+    if (name.isEmpty() || name.contains('/') || name.contains('\\'))
+        return nullptr;
+
+    if (databases.contains(name))
+        return databases[name];
+
+    Db* db = new DbSqlite3("Android mock: " + name, QDir(directory).absoluteFilePath(name), {{DB_PURE_INIT, true}});
+    if (!db->openQuiet())
+    {
+        qWarning() << "Android mock server could not open database" << name << ":" << db->getErrorText();
+        delete db;
+        return nullptr;
+    }
+
+    databases[name] = db;
+    return db;
+}
+
+void DbAndroidMockServer::sendMessage(QTcpSocket* socket, const QJsonObject& response)
+{
+    QByteArray data = QJsonDocument(response).toJson(QJsonDocument::Compact);
+    QByteArray bytes;
+    for (int i = 0; i < 4; i++)
+        bytes.append((data.size() >> (8*i)) & 0xff);
+
+    bytes.append(data);
+    socket->write(bytes);
+}
+
+QJsonObject DbAndroidMockServer::parseMessage(const QByteArray& message)
+{
+    QJsonParseError jsonError;
+    QJsonDocument doc = QJsonDocument::fromJson(message, &jsonError);
+    if (jsonError.error == QJsonParseError::NoError)
+        return doc.object();
+
+    // Some commands are sent with unquoted keys, which the real service accepts.
+    static const QRegularExpression bareKeyRe("([{,]\\s*)([A-Za-z_][A-Za-z0-9_]*)(\\s*:)");
+    QString fixed = QString::fromUtf8(message).replace(bareKeyRe, "\\1\"\\2\"\\3");
+    doc = QJsonDocument::fromJson(fixed.toUtf8(), &jsonError);
+    if (jsonError.error != QJsonParseError::NoError)
+    {
+        qWarning() << "Android mock server received invalid message:" << message;
+        return QJsonObject();
+    }
+
+    return doc.object();
+}
+
+QJsonValue DbAndroidMockServer::toJsonValue(const QVariant& value, bool paged)
+{
+    if (value.isNull() || !value.isValid())
+        return QJsonValue();
+
+    switch (value.type())
+    {
+        case QVariant::ByteArray:
+        {
+            if (paged)
+            {
+                QJsonObject blob;
+                blob["blob"] = QString::fromLatin1(value.toByteArray().toBase64());
+                return blob;
+            }
+
+            QJsonArray blob;
+            blob << ("X'" + QString::fromLatin1(value.toByteArray().toHex()) + "'");
+            return blob;
+        }
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Double:
+            return value.toDouble();
+        default:
+            break;
+    }
+
+    return value.toString();
+}
+
+QJsonObject DbAndroidMockServer::stdResult(const QString& value)
+{
+    QJsonObject response;
+    response["result"] = value;
+    return response;
+}
+
+QJsonObject DbAndroidMockServer::genericError(int code)
+{
+    QJsonObject response;
+    response["generic_error"] = code;
+    return response;
+}
@@ -0,0 +1,76 @@
+#ifndef DBANDROIDMOCKSERVER_H
+#define DBANDROIDMOCKSERVER_H
+
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+
+class QTcpServer;
+class QTcpSocket;
+class Db;
+
+/**
+ * @brief Local imitation of the SQLiteStudioRemote service, for testing the plugin without Android device.
+ *
+ * It serves SQLite files from given directory over the same protocol that is used by DbAndroidJsonConnection,
+ * including paged results. Connection calls block until the response comes, so the server has to live
+ * in another thread than the connection. That's why start() and stop() are invokable.
+ */
+class DbAndroidMockServer : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit DbAndroidMockServer(QObject* parent = nullptr);
+        ~DbAndroidMockServer();
+
+        /**
+         * @brief Starts listening on the local host.
+         * @param directory Directory with database files to serve.
+         * @param port Port to listen on, or 0 to pick any free port (see getPort()).
+         * @param password Password required from clients, or empty string for no authentication.
+         * @return true on success.
+         */
+        Q_INVOKABLE bool start(const QString& directory, int port, const QString& password = QString());
+        Q_INVOKABLE void stop();
+        int getPort() const;
+
+    private:
+        struct Client
+        {
+            QByteArray buffer;
+            bool authorized = false;
+        };
+
+        void handleMessage(QTcpSocket* socket, const QByteArray& message);
+        QJsonObject handleQuery(const QJsonObject& request);
+        QJsonObject handleFetch(const QJsonObject& request);
+        QJsonObject handleClose(const QJsonObject& request);
+        QJsonObject handleList();
+        QJsonObject handleDeleteDb(const QJsonObject& request);
+        QJsonObject readPage(int cursorId, int batch, const SqlQueryPtr& results);
+        Db* getDb(const QString& name);
+        void sendMessage(QTcpSocket* socket, const QJsonObject& response);
+
+        static QJsonObject parseMessage(const QByteArray& message);
+        static QJsonValue toJsonValue(const QVariant& value, bool paged);
+        static QJsonObject stdResult(const QString& value);
+        static QJsonObject genericError(int code);
+
+        QTcpServer* server = nullptr;
+        QString directory;
+        QString password;
+        QHash<QTcpSocket*, Client> clients;
+        QHash<QString, Db*> databases;
+        QHash<int, QPair<SqlQueryPtr, int>> cursors;
+        int nextCursorId = 0;
+
+    private slots:
+        void handleNewConnection();
+        void handleReadyRead();
+        void handleDisconnected();
+};
+
+#endif // DBANDROIDMOCKSERVER_H
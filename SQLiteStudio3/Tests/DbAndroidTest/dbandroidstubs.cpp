@@ -0,0 +1,40 @@
+#include "dbandroid.h"
+#include "adbmanager.h"
+#include "common/unused.h"
+
+// DbAndroidJsonConnection is tested in the network mode only. The USB mode needs the plugin and the ADB,
+// so these are just enough for the connection (and the shell session) to link.
+
+AdbManager* DbAndroid::getAdbManager() const
+{
+    return nullptr;
+}
+
+bool DbAndroid::isAdbValid() const
+{
+    return false;
+}
+
+const QStringList& AdbManager::getDevices(bool forceSyncUpdate)
+{
+    UNUSED(forceSyncUpdate);
+    static QStringList noDevices;
+    return noDevices;
+}
+
+int AdbManager::makeForwardFor(const QString& device, int targetPort)
+{
+    UNUSED(device);
+    UNUSED(targetPort);
+    return -1;
+}
+
+QByteArray AdbManager::encode(const QString& input)
+{
+    return input.toUtf8();
+}
+
+QString AdbManager::decode(const QByteArray& input)
+{
+    return QString::fromUtf8(input);
+}
@@ -0,0 +1,291 @@
+#include "dbandroidmockserver.h"
+#include "dbandroidjsonconnection.h"
+#include "dbandroidurl.h"
+#include "dbandroidshellsession.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QThread>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QtTest>
+
+class DbAndroidTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbAndroidTest();
+
+    private:
+        bool startServer(const QString& password = QString());
+        void stopServer();
+        DbAndroidUrl makeUrl(const QString& password = QString()) const;
+
+        QTemporaryDir* dir = nullptr;
+        QThread* serverThread = nullptr;
+        DbAndroidMockServer* server = nullptr;
+        DbAndroidJsonConnection* connection = nullptr;
+
+        static const int ROWS = 2500;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testDbList();
+        void testPagedResults();
+        void testValueTypes();
+        void testCloseCursor();
+        void testQueryError();
+        void testPassword();
+        void testWrongPassword();
+        void testShellQueryCompleteness_data();
+        void testShellQueryCompleteness();
+        void testShellSession();
+};
+
+DbAndroidTest::DbAndroidTest()
+{
+}
+
+bool DbAndroidTest::startServer(const QString& password)
+{
+    // The connection blocks while waiting for the response, so the server needs its own event loop.
+    serverThread = new QThread;
+    server = new DbAndroidMockServer;
+    server->moveToThread(serverThread);
+    connect(serverThread, &QThread::finished, server, &QObject::deleteLater);
+    serverThread->start();
+
+    bool started = false;
+    QMetaObject::invokeMethod(server, "start", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, started),
+                              Q_ARG(QString, dir->path()), Q_ARG(int, 0), Q_ARG(QString, password));
+    return started;
+}
+
+void DbAndroidTest::stopServer()
+{
+    if (!serverThread)
+        return;
+
+    QMetaObject::invokeMethod(server, "stop", Qt::BlockingQueuedConnection);
+    serverThread->quit();
+    serverThread->wait();
+    delete serverThread;
+    serverThread = nullptr;
+    server = nullptr;
+}
+
+DbAndroidUrl DbAndroidTest::makeUrl(const QString& password) const
+{
+    DbAndroidUrl url(DbAndroidMode::NETWORK);
+    url.setHost("127.0.0.1");
+    url.setPort(server->getPort());
+    url.setDbName("test.db");
+    url.setPassword(password);
+    return url;
+}
+
+void DbAndroidTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    dir = new QTemporaryDir;
+    QVERIFY(dir->isValid());
+
+    Db* db = new DbSqlite3Mock("testdb", dir->filePath("test.db"));
+    QVERIFY(db->open());
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, score REAL, data BLOB);");
+    db->exec(QString("WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < %1) "
+                     "INSERT INTO test (id, name, score, data) "
+                     "SELECT x, CASE WHEN x % 10 = 0 THEN NULL ELSE 'name' || x END, x / 2.0, zeroblob(x % 3) FROM cnt;").arg(ROWS));
+    db->close();
+    delete db;
+}
+
+void DbAndroidTest::cleanupTestCase()
+{
+    safe_delete(dir);
+}
+
+void DbAndroidTest::init()
+{
+    QVERIFY(startServer());
+    connection = new DbAndroidJsonConnection(nullptr);
+    QVERIFY(connection->connectToAndroid(makeUrl()));
+}
+
+void DbAndroidTest::cleanup()
+{
+    safe_delete(connection);
+    stopServer();
+}
+
+void DbAndroidTest::testDbList()
+{
+    QCOMPARE(connection->getDbList(), QStringList({"test.db"}));
+}
+
+void DbAndroidTest::testPagedResults()
+{
+    DbAndroidConnection::ExecutionResult results = connection->executeQuery("SELECT id, name FROM test ORDER BY id");
+    QVERIFY(!results.wasError);
+    QCOMPARE(results.resultColumns, QStringList({"id", "name"}));
+    QCOMPARE(results.resultDataList.size(), static_cast<int>(DbAndroidJsonConnection::PAGE_SIZE));
+    QVERIFY(results.hasMore);
+
+    int pages = 1;
+    int expectedId = 1;
+    while (true)
+    {
+        for (const QVariantList& row : results.resultDataList)
+            QCOMPARE(row[0].toInt(), expectedId++);
+
+        if (!results.hasMore)
+            break;
+
+        QVERIFY(connection->fetchMore(results));
+        QVERIFY(!results.wasError);
+        QCOMPARE(results.resultColumns, QStringList({"id", "name"}));
+        pages++;
+    }
+
+    QCOMPARE(expectedId - 1, ROWS);
+    QCOMPARE(pages, (ROWS + DbAndroidJsonConnection::PAGE_SIZE - 1) / DbAndroidJsonConnection::PAGE_SIZE);
+    QVERIFY(!connection->fetchMore(results));
+}
+
+void DbAndroidTest::testValueTypes()
+{
+    DbAndroidConnection::ExecutionResult results = connection->executeQuery("SELECT id, name, score, data FROM test WHERE id IN (5, 10) ORDER BY id");
+    QVERIFY(!results.wasError);
+    QVERIFY(!results.hasMore);
+    QCOMPARE(results.resultDataList.size(), 2);
+
+    QVariantList row = results.resultDataList[0];
+    QCOMPARE(row[0].toInt(), 5);
+    QCOMPARE(row[1].toString(), QString("name5"));
+    QCOMPARE(row[2].toDouble(), 2.5);
+    QCOMPARE(row[3].toByteArray(), QByteArray(2, '\0'));
+
+    row = results.resultDataList[1];
+    QVERIFY(row[1].isNull());
+    QCOMPARE(row[3].toByteArray(), QByteArray(1, '\0'));
+}
+
+void DbAndroidTest::testCloseCursor()
+{
+    DbAndroidConnection::ExecutionResult results = connection->executeQuery("SELECT id FROM test");
+    QVERIFY(!results.wasError);
+    QVERIFY(results.hasMore);
+
+    connection->closeCursor(results);
+    QVERIFY(!results.hasMore);
+    QVERIFY(!connection->fetchMore(results));
+
+    // Connection is still usable after the cursor was released.
+    results = connection->executeQuery("SELECT count(*) FROM test");
+    QVERIFY(!results.wasError);
+    QCOMPARE(results.resultDataList.size(), 1);
+    QCOMPARE(results.resultDataList[0][0].toInt(), ROWS);
+}
+
+void DbAndroidTest::testQueryError()
+{
+    DbAndroidConnection::ExecutionResult results = connection->executeQuery("SELECT * FROM missing_table");
+    QVERIFY(results.errorCode != 0);
+    QVERIFY(results.errorMsg.contains("missing_table"));
+    QVERIFY(!results.hasMore);
+}
+
+void DbAndroidTest::testPassword()
+{
+    safe_delete(connection);
+    stopServer();
+    QVERIFY(startServer("secret"));
+
+    connection = new DbAndroidJsonConnection(nullptr);
+    QVERIFY(connection->connectToAndroid(makeUrl("secret")));
+
+    DbAndroidConnection::ExecutionResult results = connection->executeQuery("SELECT count(*) FROM test");
+    QVERIFY(!results.wasError);
+    QCOMPARE(results.resultDataList[0][0].toInt(), ROWS);
+}
+
+void DbAndroidTest::testWrongPassword()
+{
+    safe_delete(connection);
+    stopServer();
+    QVERIFY(startServer("secret"));
+
+    connection = new DbAndroidJsonConnection(nullptr);
+    QVERIFY(!connection->connectToAndroid(makeUrl("wrong")));
+    QVERIFY(!connection->isConnected());
+}
+
+void DbAndroidTest::testShellQueryCompleteness_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<bool>("complete");
+
+    QTest::newRow("plain") << "SELECT 1" << true;
+    QTest::newRow("semicolon") << "SELECT 1;" << true;
+    QTest::newRow("semicolon in string") << "SELECT 'a;b'" << true;
+    QTest::newRow("line comment") << "SELECT 1 -- comment" << true;
+    QTest::newRow("closed comment") << "SELECT 1 /**/" << true;
+    QTest::newRow("empty") << "" << true;
+    QTest::newRow("trigger") << "CREATE TRIGGER t AFTER INSERT ON x BEGIN SELECT 1; END" << true;
+    QTest::newRow("trigger with case") << "CREATE TRIGGER t AFTER INSERT ON x BEGIN SELECT CASE WHEN 1 THEN 2 END; END" << true;
+    QTest::newRow("open string") << "SELECT 'abc" << false;
+    QTest::newRow("open quoted name") << "SELECT \"abc" << false;
+    QTest::newRow("open bracket name") << "SELECT [abc" << false;
+    QTest::newRow("open comment") << "SELECT 1 /* comment" << false;
+    QTest::newRow("open comment after query") << "SELECT 1; /* comment" << false;
+    QTest::newRow("open comment marker only") << "SELECT 1 /*/" << false;
+    QTest::newRow("trigger without end") << "CREATE TRIGGER t AFTER INSERT ON x BEGIN SELECT 1;" << false;
+}
+
+void DbAndroidTest::testShellQueryCompleteness()
+{
+    QFETCH(QString, query);
+    QFETCH(bool, complete);
+    QCOMPARE(DbAndroidShellSession::isComplete(query), complete);
+}
+
+void DbAndroidTest::testShellSession()
+{
+    // Local sqlite3 stands in for the one on the device, run by "adb shell".
+    QString sqlite3 = QStandardPaths::findExecutable("sqlite3");
+    if (sqlite3.isEmpty())
+        QSKIP("The sqlite3 command line tool is not available.");
+
+    DbAndroidShellSession session;
+    QVERIFY(session.start(sqlite3, {"-csv", "-separator", ",", "-batch", "-header", dir->filePath("test.db")}));
+
+    QByteArray output;
+    bool sqlError = true;
+    QVERIFY(session.execute("SELECT count(*) AS cnt FROM test", output, sqlError));
+    QVERIFY(!sqlError);
+    QCOMPARE(output.trimmed().replace("\r\n", "\n"), QByteArray("cnt\n") + QByteArray::number(ROWS));
+
+    // Error and trailing comment don't break the session
+    QVERIFY(session.execute("SELECT * FROM missing_table -- comment", output, sqlError));
+    QVERIFY(sqlError);
+    QVERIFY(output.contains("missing_table"));
+
+    QVERIFY(session.execute("SELECT 'a;\nb' AS val", output, sqlError));
+    QVERIFY(!sqlError);
+    QVERIFY(session.isRunning());
+    session.stop();
+    QVERIFY(!session.isRunning());
+}
+
+QTEST_GUILESS_MAIN(DbAndroidTest)
+
+#include "tst_dbandroidtest.moc"
@@ -0,0 +1,192 @@
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include "db/sqlquery.h"
+#include <QString>
+#include <QIODevice>
+#include <QtTest>
+
+class DbBlobTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbBlobTest();
+
+    private:
+        QByteArray storedValue();
+
+        Db* db = nullptr;
+        QByteArray value;
+
+        static const int VALUE_SIZE = 10000;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void cleanup();
+        void testRead();
+        void testSeek();
+        void testWrite();
+        void testCannotGrow();
+        void testReadOnly();
+        void testMissingRow();
+        void testClosedWithDb();
+};
+
+DbBlobTest::DbBlobTest()
+{
+}
+
+QByteArray DbBlobTest::storedValue()
+{
+    return db->exec("SELECT data FROM test WHERE id = 1")->getSingleCell().toByteArray();
+}
+
+void DbBlobTest::initTestCase()
+{
+    initMocks();
+
+    value.resize(VALUE_SIZE);
+    for (int i = 0; i < VALUE_SIZE; i++)
+        value[i] = static_cast<char>(i % 251);
+}
+
+void DbBlobTest::init()
+{
+    db = new DbSqlite3Mock("testdb");
+    QVERIFY(db->open());
+    QVERIFY(!db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, data BLOB)")->isError());
+    QVERIFY(!db->exec("INSERT INTO test (id, data) VALUES (1, ?)", QVariantList({value}))->isError());
+}
+
+void DbBlobTest::cleanup()
+{
+    db->close();
+    safe_delete(db);
+}
+
+void DbBlobTest::testRead()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 1, false);
+    QVERIFY2(blob, db->getErrorText().toUtf8().constData());
+    QCOMPARE(blob->size(), static_cast<qint64>(VALUE_SIZE));
+
+    // Read in uneven chunks, so the last one is shorter than requested
+    QByteArray readValue;
+    QByteArray chunk;
+    do
+    {
+        chunk = blob->read(3000);
+        readValue += chunk;
+    }
+    while (!chunk.isEmpty());
+
+    QCOMPARE(readValue, value);
+    QVERIFY(blob->atEnd());
+    delete blob;
+}
+
+void DbBlobTest::testSeek()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 1, false);
+    QVERIFY(blob);
+
+    QVERIFY(blob->seek(5000));
+    QCOMPARE(blob->read(100), value.mid(5000, 100));
+    QCOMPARE(blob->pos(), static_cast<qint64>(5100));
+
+    QVERIFY(blob->seek(10));
+    QCOMPARE(blob->read(10), value.mid(10, 10));
+
+    QVERIFY(blob->seek(VALUE_SIZE - 5));
+    QCOMPARE(blob->readAll(), value.right(5));
+    delete blob;
+}
+
+void DbBlobTest::testWrite()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 1, true);
+    QVERIFY(blob);
+    QVERIFY(blob->isWritable());
+
+    QByteArray patch(100, 'x');
+    QVERIFY(blob->seek(1000));
+    QCOMPARE(blob->write(patch), static_cast<qint64>(patch.size()));
+    QCOMPARE(blob->pos(), static_cast<qint64>(1100));
+
+    // Written data is visible to the same device and to queries
+    QVERIFY(blob->seek(1000));
+    QCOMPARE(blob->read(patch.size()), patch);
+    delete blob;
+
+    QByteArray expected = value;
+    expected.replace(1000, patch.size(), patch);
+    QCOMPARE(storedValue(), expected);
+}
+
+void DbBlobTest::testCannotGrow()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 1, true);
+    QVERIFY(blob);
+
+    // Only the part that fits is written
+    QVERIFY(blob->seek(VALUE_SIZE - 4));
+    QCOMPARE(blob->write(QByteArray(10, 'y')), static_cast<qint64>(4));
+
+    // Nothing can be written at the end
+    QCOMPARE(blob->write(QByteArray(1, 'z')), static_cast<qint64>(-1));
+    QVERIFY(!blob->errorString().isEmpty());
+    QCOMPARE(blob->size(), static_cast<qint64>(VALUE_SIZE));
+    delete blob;
+
+    QByteArray stored = storedValue();
+    QCOMPARE(stored.size(), VALUE_SIZE);
+    QCOMPARE(stored.right(4), QByteArray(4, 'y'));
+}
+
+void DbBlobTest::testReadOnly()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 1, false);
+    QVERIFY(blob);
+    QVERIFY(blob->isReadable());
+    QVERIFY(!blob->isWritable());
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("ReadOnly device"));
+    QCOMPARE(blob->write(QByteArray(10, 'x')), static_cast<qint64>(-1));
+    delete blob;
+
+    QCOMPARE(storedValue(), value);
+}
+
+void DbBlobTest::testMissingRow()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 2, false);
+    QVERIFY(!blob);
+    QVERIFY(!db->getErrorText().isEmpty());
+
+    blob = db->openBlob("main", "missing_table", "data", 1, false);
+    QVERIFY(!blob);
+    QVERIFY(!db->getErrorText().isEmpty());
+}
+
+void DbBlobTest::testClosedWithDb()
+{
+    QIODevice* blob = db->openBlob("main", "test", "data", 1, false);
+    QVERIFY(blob);
+    QVERIFY(blob->isOpen());
+
+    // Open blob handle would make closing the database fail, so the database closes its blobs first
+    QVERIFY(db->close());
+    QVERIFY(!blob->isOpen());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("device not open"));
+    QCOMPARE(blob->read(10), QByteArray());
+
+    // The device still belongs to the caller
+    delete blob;
+    QVERIFY(db->open());
+    QCOMPARE(storedValue(), value);
+}
+
+QTEST_APPLESS_MAIN(DbBlobTest)
+
+#include "tst_dbblobtest.moc"
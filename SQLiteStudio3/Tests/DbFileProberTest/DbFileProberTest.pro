@@ -0,0 +1,57 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib concurrent
+
+QT       -= gui
+
+TARGET = tst_dbfileprobertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+# Encrypted database is created with the same SQLCipher build as in the plugin.
+SQLCIPHER_DIR = $$PWD/../../../Plugins/DbSqliteCipher
+INCLUDEPATH += $$SQLCIPHER_DIR
+DEPENDPATH += $$SQLCIPHER_DIR
+
+DEFINES += DBSQLITECIPHER_LIBRARY
+
+SOURCES += tst_dbfileprobertest.cpp \
+    $$SQLCIPHER_DIR/dbsqlitecipherinstance.cpp \
+    $$SQLCIPHER_DIR/dbsqlitecipherconverter.cpp
+
+!unix|isEmpty(SQLCIPHER_LIB): {
+    SOURCES += $$SQLCIPHER_DIR/sqlcipher.c
+}
+
+HEADERS += $$SQLCIPHER_DIR/dbsqlitecipherinstance.h \
+    $$SQLCIPHER_DIR/dbsqlitecipherconverter.h
+
+!macx: {
+    LIBS += -L$$SQLCIPHER_DIR/../deps/lib/$${PLATFORM}/
+}
+win32: {
+    INCLUDEPATH += $$SQLCIPHER_DIR/../deps/include/$${PLATFORM}/
+    LIBS += -leay32
+}
+
+!win32: {
+    LIBS += -lcrypto
+}
+
+unix: {
+    DEFINES += SQLITE_OS_UNIX=1
+    !isEmpty(SQLCIPHER_LIB): {
+        LIBS += $$SQLCIPHER_LIB
+        DEFINES += SQLCIPHER_SYSTEM_LIB
+    }
+}
+win32: {
+    DEFINES += SQLITE_OS_WIN=1
+}
+DEFINES += SQLITE_HAS_CODEC SQLCIPHER_CRYPTO_OPENSSL BUILD_sqlite NDEBUG SQLITE_ALLOW_XTHREAD_CONNECT=1 SQLITE_THREADSAFE=1 SQLITE_TEMP_STORE=2
+
+QMAKE_CFLAGS_WARN_ON = -Wall -Wno-unused-parameter -Wno-sign-compare -Wno-unused-function
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
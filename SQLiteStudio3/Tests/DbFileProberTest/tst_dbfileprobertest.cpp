@@ -0,0 +1,355 @@
+#include "db/dbfileprober.h"
+#include "plugins/dbplugin.h"
+#include "plugins/builtinplugin.h"
+#include "dbsqlitecipherinstance.h"
+#include "dbsqlitecipher.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtConcurrent/QtConcurrent>
+#include <QtTest>
+
+/**
+ * Plugin that accepts plain SQLite 3 files (or rejects everything), counting how many times it was asked.
+ */
+class TestDbPlugin : public BuiltInPlugin, public DbPlugin
+{
+        Q_OBJECT
+
+    public:
+        TestDbPlugin(const QString& name, bool accepting) :
+            name(name), accepting(accepting)
+        {
+        }
+
+        QString getName() const
+        {
+            return name;
+        }
+
+        Db* getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString* errorMessage)
+        {
+            asked++;
+            if (!accepting || DbFileProber::detectFormat(path) != DbFileProber::Format::SQLITE3)
+            {
+                if (errorMessage)
+                    *errorMessage = this->name + " rejected " + path;
+
+                return nullptr;
+            }
+
+            return new DbSqlite3Mock(name, path, options);
+        }
+
+        QString getLabel() const
+        {
+            return name;
+        }
+
+        QList<DbPluginOption> getOptionsList() const
+        {
+            return QList<DbPluginOption>();
+        }
+
+        QString generateDbName(const QVariant& baseValue)
+        {
+            return QFileInfo(baseValue.toString()).completeBaseName();
+        }
+
+        bool checkIfDbServedByPlugin(Db* db) const
+        {
+            return db && db->getConnectionOptions().value(DB_PLUGIN).toString() == name;
+        }
+
+        bool isFileFormatSupported(DbFileProber::Format format) const
+        {
+            return sqlite3Only ? format == DbFileProber::Format::SQLITE3 : true;
+        }
+
+        int asked = 0;
+        bool sqlite3Only = false;
+
+    private:
+        QString name;
+        bool accepting;
+};
+
+class DbFileProberTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbFileProberTest();
+
+    private:
+        QString path(const QString& name) const;
+        void createSqlite3File(const QString& name);
+        void writeFile(const QString& name, const QByteArray& contents);
+        DbFileProber::Candidate candidate(const QString& name) const;
+        void resetCounters();
+
+        QTemporaryDir* dir = nullptr;
+        TestDbPlugin* rejecting = nullptr;
+        TestDbPlugin* accepting = nullptr;
+        QList<DbPlugin*> plugins;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void testDetectFormat();
+        void testRememberedDecisions();
+        void testModificationTimeInvalidatesCache();
+        void testSizeInvalidatesCache();
+        void testOptionsInvalidateCache();
+        void testUnsupportedFormatNotAsked();
+        void testProbingInBackground();
+};
+
+DbFileProberTest::DbFileProberTest()
+{
+}
+
+QString DbFileProberTest::path(const QString& name) const
+{
+    return dir->filePath(name);
+}
+
+void DbFileProberTest::createSqlite3File(const QString& name)
+{
+    DbSqlite3Mock db("create", path(name));
+    QVERIFY(db.open());
+    QVERIFY(!db.exec("CREATE TABLE test (id INTEGER PRIMARY KEY, val TEXT);")->isError());
+    QVERIFY(!db.exec("INSERT INTO test (val) VALUES ('abc');")->isError());
+    db.close();
+}
+
+void DbFileProberTest::writeFile(const QString& name, const QByteArray& contents)
+{
+    QFile file(path(name));
+    QVERIFY(file.open(QIODevice::WriteOnly|QIODevice::Truncate));
+    QCOMPARE(file.write(contents), static_cast<qint64>(contents.size()));
+    file.close();
+}
+
+DbFileProber::Candidate DbFileProberTest::candidate(const QString& name) const
+{
+    DbFileProber::Candidate candidate;
+    candidate.name = name;
+    candidate.path = path(name);
+    return candidate;
+}
+
+void DbFileProberTest::resetCounters()
+{
+    rejecting->asked = 0;
+    accepting->asked = 0;
+}
+
+void DbFileProberTest::initTestCase()
+{
+    initMocks();
+
+    dir = new QTemporaryDir;
+    QVERIFY(dir->isValid());
+
+    rejecting = new TestDbPlugin("Rejecting", false);
+    accepting = new TestDbPlugin("Accepting", true);
+    plugins = {rejecting, accepting};
+
+    createSqlite3File("plain.db");
+    writeFile("empty.db", QByteArray());
+    writeFile("text.txt", "This is not a database.\n");
+    writeFile("sqlite2.db", QByteArray("** This file contains an SQLite 2.1 database **\n") + QByteArray(100, '\0'));
+
+    QHash<QString, QVariant> cipherOptions;
+    cipherOptions[DbSqliteCipher::PASSWORD_OPT] = "secret";
+    cipherOptions[DbSqliteCipher::KDF_ITER_OPT] = 1000;
+    DbSqliteCipherInstance cipherDb("cipher", path("cipher.db"), cipherOptions);
+    QVERIFY(cipherDb.open());
+    QVERIFY(!cipherDb.exec("CREATE TABLE test (id INTEGER PRIMARY KEY);")->isError());
+    cipherDb.close();
+}
+
+void DbFileProberTest::cleanupTestCase()
+{
+    plugins.clear();
+    safe_delete(rejecting);
+    safe_delete(accepting);
+    safe_delete(dir);
+}
+
+void DbFileProberTest::init()
+{
+    rejecting->sqlite3Only = false;
+    resetCounters();
+}
+
+void DbFileProberTest::testDetectFormat()
+{
+    QCOMPARE(DbFileProber::detectFormat(path("plain.db")), DbFileProber::Format::SQLITE3);
+    QCOMPARE(DbFileProber::detectFormat(path("empty.db")), DbFileProber::Format::EMPTY);
+    QCOMPARE(DbFileProber::detectFormat(path("sqlite2.db")), DbFileProber::Format::SQLITE2);
+    QCOMPARE(DbFileProber::detectFormat(path("text.txt")), DbFileProber::Format::UNKNOWN);
+    QCOMPARE(DbFileProber::detectFormat(path("missing.db")), DbFileProber::Format::UNREADABLE);
+
+    // Encrypted database has no readable header
+    QVERIFY(QFileInfo(path("cipher.db")).size() > 0);
+    QCOMPARE(DbFileProber::detectFormat(path("cipher.db")), DbFileProber::Format::UNKNOWN);
+}
+
+void DbFileProberTest::testRememberedDecisions()
+{
+    DbFileProber prober;
+    DbFileProber::Result result = prober.probe(candidate("plain.db"), plugins);
+    QVERIFY(result.db);
+    QCOMPARE(result.plugin, static_cast<DbPlugin*>(accepting));
+    QCOMPARE(rejecting->asked, 1);
+    QCOMPARE(accepting->asked, 1);
+    safe_delete(result.db);
+
+    // The plugin that rejected unchanged file is not asked again, the accepting one is asked first
+    result = prober.probe(candidate("plain.db"), plugins);
+    QVERIFY(result.db);
+    QCOMPARE(rejecting->asked, 1);
+    QCOMPARE(accepting->asked, 2);
+    safe_delete(result.db);
+
+    // Rejections are remembered, even if nobody accepted the file
+    result = prober.probe(candidate("text.txt"), plugins);
+    QVERIFY(!result.db);
+    QVERIFY(result.errorMessage.contains("Rejecting"));
+    QCOMPARE(rejecting->asked, 2);
+    QCOMPARE(accepting->asked, 3);
+
+    result = prober.probe(candidate("text.txt"), plugins);
+    QVERIFY(!result.db);
+    QCOMPARE(rejecting->asked, 2);
+    QCOMPARE(accepting->asked, 3);
+
+    // Forgetting decisions makes all plugins asked again
+    prober.clearCache();
+    result = prober.probe(candidate("text.txt"), plugins);
+    QCOMPARE(rejecting->asked, 3);
+    QCOMPARE(accepting->asked, 4);
+}
+
+void DbFileProberTest::testModificationTimeInvalidatesCache()
+{
+    createSqlite3File("mtime.db");
+
+    DbFileProber prober;
+    DbFileProber::Result result = prober.probe(candidate("mtime.db"), plugins);
+    safe_delete(result.db);
+    QCOMPARE(rejecting->asked, 1);
+
+    // Same size, different modification time
+    QFileInfo before(path("mtime.db"));
+    QFile file(path("mtime.db"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(before.lastModified().addSecs(-3600), QFileDevice::FileModificationTime));
+    file.close();
+    QCOMPARE(QFileInfo(path("mtime.db")).size(), before.size());
+
+    result = prober.probe(candidate("mtime.db"), plugins);
+    QVERIFY(result.db);
+    QCOMPARE(rejecting->asked, 2);
+    safe_delete(result.db);
+}
+
+void DbFileProberTest::testSizeInvalidatesCache()
+{
+    writeFile("size.txt", "abc");
+
+    DbFileProber prober;
+    prober.probe(candidate("size.txt"), plugins);
+    QCOMPARE(rejecting->asked, 1);
+
+    // Same modification time, different size
+    QDateTime modified = QFileInfo(path("size.txt")).lastModified();
+    writeFile("size.txt", "abcdef");
+    QFile file(path("size.txt"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+    file.close();
+    QCOMPARE(QFileInfo(path("size.txt")).lastModified(), modified);
+
+    prober.probe(candidate("size.txt"), plugins);
+    QCOMPARE(rejecting->asked, 2);
+}
+
+void DbFileProberTest::testOptionsInvalidateCache()
+{
+    DbFileProber prober;
+    DbFileProber::Result result = prober.probe(candidate("plain.db"), plugins);
+    safe_delete(result.db);
+    QCOMPARE(rejecting->asked, 1);
+
+    // Plugin could reject the file only because of wrong password, for example
+    DbFileProber::Candidate withOptions = candidate("plain.db");
+    withOptions.options["password"] = "other";
+    result = prober.probe(withOptions, plugins);
+    safe_delete(result.db);
+    QCOMPARE(rejecting->asked, 2);
+
+    result = prober.probe(withOptions, plugins);
+    safe_delete(result.db);
+    QCOMPARE(rejecting->asked, 2);
+
+    // Plugin forced by options is the only one asked
+    withOptions.options[DB_PLUGIN] = "Rejecting";
+    prober.clearCache();
+    resetCounters();
+    result = prober.probe(withOptions, plugins);
+    QVERIFY(!result.db);
+    QCOMPARE(rejecting->asked, 1);
+    QCOMPARE(accepting->asked, 0);
+}
+
+void DbFileProberTest::testUnsupportedFormatNotAsked()
+{
+    rejecting->sqlite3Only = true;
+
+    DbFileProber prober;
+    DbFileProber::Result result = prober.probe(candidate("cipher.db"), plugins);
+    QVERIFY(!result.db);
+    QCOMPARE(rejecting->asked, 0);
+    QCOMPARE(accepting->asked, 1);
+
+    prober.probe(candidate("text.txt"), plugins);
+    QCOMPARE(rejecting->asked, 0);
+
+    result = prober.probe(candidate("plain.db"), plugins);
+    QVERIFY(result.db);
+    QCOMPARE(rejecting->asked, 1);
+    safe_delete(result.db);
+}
+
+void DbFileProberTest::testProbingInBackground()
+{
+    DbFileProber prober;
+    QList<DbFileProber::Candidate> candidates = {candidate("plain.db"), candidate("text.txt"), candidate("empty.db")};
+    QList<DbPlugin*> probingPlugins = plugins;
+    QFuture<QList<DbFileProber::Result>> future = QtConcurrent::run([&prober, candidates, probingPlugins]() -> QList<DbFileProber::Result>
+    {
+        return prober.probe(candidates, probingPlugins);
+    });
+
+    QList<DbFileProber::Result> results = future.result();
+    QCOMPARE(results.size(), candidates.size());
+    QCOMPARE(results[0].candidate.name, QString("plain.db"));
+    QVERIFY(results[0].db);
+    QVERIFY(!results[1].db);
+    QVERIFY(!results[2].db);
+
+    // Databases created by the worker belong to the main thread
+    QCOMPARE(results[0].db->thread(), thread());
+    safe_delete(results[0].db);
+}
+
+QTEST_GUILESS_MAIN(DbFileProberTest)
+
+#include "tst_dbfileprobertest.moc"
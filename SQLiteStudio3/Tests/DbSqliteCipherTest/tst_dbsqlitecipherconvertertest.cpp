@@ -0,0 +1,264 @@
+#include "dbsqlitecipherconverter.h"
+#include "dbsqlitecipherinstance.h"
+#include "dbsqlitecipher.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class DbSqliteCipherConverterTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbSqliteCipherConverterTest();
+
+    private:
+        QHash<QString, QVariant> options(const QString& password) const;
+        QString path(const QString& name) const;
+        void verifyData(Db* db);
+        QByteArray readFile(const QString& name);
+
+        QTemporaryDir* dir = nullptr;
+
+        static const int ROWS = 3000;
+        static const int KDF_ITER = 1000;
+        static const constexpr char* RAW_KEY = "x'2DD29CA851E7B56E4697B0E1F08507293D761A05CE4D1B628663F411A8086D99'";
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testRekey();
+        void testDecrypt();
+        void testThreadsDontChangeOutput();
+        void testWrongKey();
+        void testSourceStaysWritable();
+        void testRawKey();
+        void testInvalidRawKey();
+        void testConvertFunction();
+};
+
+DbSqliteCipherConverterTest::DbSqliteCipherConverterTest()
+{
+}
+
+QHash<QString, QVariant> DbSqliteCipherConverterTest::options(const QString& password) const
+{
+    QHash<QString, QVariant> opts;
+    opts[DbSqliteCipher::PASSWORD_OPT] = password;
+    opts[DbSqliteCipher::KDF_ITER_OPT] = KDF_ITER;
+    return opts;
+}
+
+QString DbSqliteCipherConverterTest::path(const QString& name) const
+{
+    return dir->filePath(name);
+}
+
+void DbSqliteCipherConverterTest::verifyData(Db* db)
+{
+    SqlQueryPtr results = db->exec("PRAGMA integrity_check;");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toString(), QString("ok"));
+
+    results = db->exec("SELECT count(*), sum(id), sum(length(data)) FROM test;");
+    QVERIFY(!results->isError());
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(0).toInt(), ROWS);
+    QCOMPARE(row->value(1).toLongLong(), static_cast<qint64>(ROWS) * (ROWS + 1) / 2);
+    QCOMPARE(row->value(2).toLongLong(), static_cast<qint64>(ROWS) * 100);
+}
+
+QByteArray DbSqliteCipherConverterTest::readFile(const QString& name)
+{
+    QFile file(path(name));
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    return file.readAll();
+}
+
+void DbSqliteCipherConverterTest::initTestCase()
+{
+    initMocks();
+
+    dir = new QTemporaryDir;
+    QVERIFY(dir->isValid());
+
+    DbSqliteCipherInstance db("source", path("source.db"), options("old key"));
+    QVERIFY(db.open());
+    QVERIFY(!db.exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, data BLOB);")->isError());
+    QVERIFY(!db.exec(QString("WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < %1) "
+                             "INSERT INTO test (id, name, data) SELECT x, 'name' || x, randomblob(100) FROM cnt;").arg(ROWS))->isError());
+    QVERIFY(!db.exec("CREATE INDEX test_name ON test (name);")->isError());
+    db.close();
+}
+
+void DbSqliteCipherConverterTest::cleanupTestCase()
+{
+    safe_delete(dir);
+}
+
+void DbSqliteCipherConverterTest::testRekey()
+{
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("old key"));
+    DbSqliteCipherConverter::Settings target = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("new key"));
+
+    // Small chunks, so there are many of them, with pages split between threads.
+    DbSqliteCipherConverter converter(source, target);
+    converter.setThreads(4);
+    converter.setChunkPages(7);
+    QVERIFY2(converter.convert(path("source.db"), path("rekeyed.db")), converter.getErrorText().toUtf8().constData());
+    QVERIFY(converter.getPageCount() > 7 * 4);
+
+    DbSqliteCipherInstance db("rekeyed", path("rekeyed.db"), options("new key"));
+    QVERIFY(db.open());
+    verifyData(&db);
+    db.close();
+
+    DbSqliteCipherInstance oldKeyDb("rekeyed with old key", path("rekeyed.db"), options("old key"));
+    QVERIFY(oldKeyDb.open());
+    QVERIFY(oldKeyDb.exec("SELECT count(*) FROM test;")->isError());
+    oldKeyDb.close();
+}
+
+void DbSqliteCipherConverterTest::testDecrypt()
+{
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("old key"));
+    DbSqliteCipherConverter::Settings target = source;
+    target.password.clear();
+
+    DbSqliteCipherConverter converter(source, target);
+    converter.setChunkPages(16);
+    QVERIFY2(converter.convert(path("source.db"), path("plain.db")), converter.getErrorText().toUtf8().constData());
+
+    DbSqlite3Mock db("plain", path("plain.db"));
+    QVERIFY(db.open());
+    verifyData(&db);
+    db.close();
+}
+
+void DbSqliteCipherConverterTest::testThreadsDontChangeOutput()
+{
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("old key"));
+    DbSqliteCipherConverter::Settings target = source;
+    target.password.clear();
+
+    DbSqliteCipherConverter serial(source, target);
+    serial.setThreads(1);
+    QVERIFY(serial.convert(path("source.db"), path("serial.db")));
+
+    DbSqliteCipherConverter parallel(source, target);
+    parallel.setThreads(8);
+    parallel.setChunkPages(5);
+    QVERIFY(parallel.convert(path("source.db"), path("parallel.db")));
+
+    QByteArray serialBytes = readFile("serial.db");
+    QVERIFY(!serialBytes.isEmpty());
+    QVERIFY(serialBytes == readFile("parallel.db"));
+}
+
+void DbSqliteCipherConverterTest::testWrongKey()
+{
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("wrong key"));
+    DbSqliteCipherConverter::Settings target = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("new key"));
+
+    DbSqliteCipherConverter converter(source, target);
+    QVERIFY(!converter.convert(path("source.db"), path("wrong.db")));
+    QVERIFY(!converter.getErrorText().isEmpty());
+    QVERIFY(!QFile::exists(path("wrong.db")));
+}
+
+void DbSqliteCipherConverterTest::testSourceStaysWritable()
+{
+    // The read transaction of the conversion is released when it's done.
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("old key"));
+    DbSqliteCipherConverter::Settings target = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("new key"));
+
+    DbSqliteCipherInstance db("source", path("source.db"), options("old key"));
+    QVERIFY(db.open());
+    {
+        DbSqliteCipherConverter converter(source, target);
+        QVERIFY(converter.convert(path("source.db"), path("copy.db")));
+    }
+    QVERIFY(!db.exec("CREATE TABLE other (x);")->isError());
+    QVERIFY(!db.exec("DROP TABLE other;")->isError());
+    db.close();
+}
+
+void DbSqliteCipherConverterTest::testRawKey()
+{
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("old key"));
+    DbSqliteCipherConverter::Settings target = DbSqliteCipherConverter::Settings::fromConnectionOptions(options(RAW_KEY));
+
+    DbSqliteCipherConverter converter(source, target);
+    QVERIFY2(converter.convert(path("source.db"), path("raw.db")), converter.getErrorText().toUtf8().constData());
+
+    // Raw key is used as the key itself, not as a passphrase
+    DbSqliteCipherInstance db("raw", path("raw.db"), options(RAW_KEY));
+    QVERIFY(db.open());
+    verifyData(&db);
+    db.close();
+
+    DbSqliteCipherInstance passphraseDb("raw as passphrase", path("raw.db"), options(QString(RAW_KEY).mid(2, 64)));
+    QVERIFY(passphraseDb.open());
+    QVERIFY(passphraseDb.exec("SELECT count(*) FROM test;")->isError());
+    passphraseDb.close();
+
+    // Raw key works for the source as well
+    DbSqliteCipherConverter::Settings plain = target;
+    plain.password.clear();
+    DbSqliteCipherConverter decrypter(target, plain);
+    QVERIFY2(decrypter.convert(path("raw.db"), path("raw_plain.db")), decrypter.getErrorText().toUtf8().constData());
+
+    DbSqlite3Mock plainDb("raw plain", path("raw_plain.db"));
+    QVERIFY(plainDb.open());
+    verifyData(&plainDb);
+    plainDb.close();
+}
+
+void DbSqliteCipherConverterTest::testInvalidRawKey()
+{
+    DbSqliteCipherConverter::Settings source = DbSqliteCipherConverter::Settings::fromConnectionOptions(options("old key"));
+    QString withSalt = QString(RAW_KEY).insert(66, "0123456789abcdef0123456789abcdef");
+    for (const QString& key : {QString("x'abcd'"), QString(RAW_KEY).replace("2D", "ZZ"), withSalt})
+    {
+        DbSqliteCipherConverter::Settings target = DbSqliteCipherConverter::Settings::fromConnectionOptions(options(key));
+        DbSqliteCipherConverter converter(source, target);
+        QVERIFY2(!converter.convert(path("source.db"), path("invalid.db")), key.toUtf8().constData());
+        QVERIFY(converter.getErrorText().contains("Raw key"));
+        QVERIFY(!QFile::exists(path("invalid.db")));
+
+        // Rejected before anything is read, also for the source
+        DbSqliteCipherConverter reverse(target, source);
+        QVERIFY(!reverse.convert(path("source.db"), path("invalid.db")));
+        QVERIFY(reverse.getErrorText().contains("Raw key"));
+    }
+}
+
+void DbSqliteCipherConverterTest::testConvertFunction()
+{
+    DbSqliteCipherInstance db("source", path("source.db"), options("old key"));
+    QVERIFY(db.open());
+
+    QString sql = QString("SELECT %1(?, ?);").arg(DbSqliteCipherInstance::CONVERT_FUNCTION);
+    SqlQueryPtr results = db.exec(sql, QVariantList({path("function.db"), "new key"}));
+    QVERIFY2(!results->isError(), results->getErrorText().toUtf8().constData());
+    QVERIFY(results->getSingleCell().toLongLong() > 0);
+
+    // Conversion errors are errors of the query
+    results = db.exec(sql, QVariantList({path("source.db"), "new key"}));
+    QVERIFY(results->isError());
+    db.close();
+
+    DbSqliteCipherInstance converted("function", path("function.db"), options("new key"));
+    QVERIFY(converted.open());
+    verifyData(&converted);
+    converted.close();
+}
+
+QTEST_APPLESS_MAIN(DbSqliteCipherConverterTest)
+
+#include "tst_dbsqlitecipherconvertertest.moc"
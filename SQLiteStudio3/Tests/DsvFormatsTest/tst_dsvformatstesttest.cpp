@@ -27,6 +27,9 @@ private:
         void testTsv1();
         void testTsv2();
         void testCsv1();
+        void testCsv2();
+        void testLongValues();
+        void testIncrementalWriter();
         void testCsvPerformance();
 };
 
@@ -106,6 +109,65 @@ void DsvFormatsTestTest::testCsv1()
     QVERIFY(result.first().size() == 2);
 }
 
+void DsvFormatsTestTest::testCsv2()
+{
+    QList<QStringList> data;
+    data << QStringList{"a", "b c", "\"d\""};
+    data << QStringList{"a,b", "c\nd", ""};
+    data << QStringList();
+    data << QStringList{"x"};
+
+    QString result = CsvSerializer::serialize(data, CsvFormat(",", "\n"));
+    QCOMPARE(result, QString("a,b c,\"\"\"d\"\"\"\n\"a,b\",\"c\nd\",\n\nx"));
+
+    // Empty separator is found in any value
+    QCOMPARE(CsvSerializer::serialize(QStringList{"a", "b\"c"}, CsvFormat(",", "")), QString("\"a\",\"b\"\"c\""));
+
+    CsvFormat format("::", "\r\n");
+    QCOMPARE(CsvSerializer::serialize(QStringList{"a:b", "a::b", "c\rd", "c\r\nd"}, format), QString("a:b::\"a::b\"::c\rd::\"c\r\nd\""));
+}
+
+void DsvFormatsTestTest::testLongValues()
+{
+    // Special characters in different places of values longer than a single scan block
+    QString filler(100, 'x');
+    QStringList values;
+    values << filler;
+    values << filler + "\"" + filler;
+    values << filler + "\t";
+    values << "\"" + filler + "\t" + filler + "\"";
+    values << filler.left(31) + "\t";
+    values << filler.left(32) + "\t";
+
+    QStringList expected;
+    expected << filler;
+    expected << filler + "\"" + filler;
+    expected << "\"" + filler + "\t\"";
+    expected << "\"\"\"" + filler + "\t" + filler + "\"\"\"";
+    expected << "\"" + filler.left(31) + "\t\"";
+    expected << "\"" + filler.left(32) + "\t\"";
+
+    QCOMPARE(TsvSerializer::serialize(values), expected.join("\t"));
+
+    expected[1] = "\"" + filler + "\"\"" + filler + "\"";
+    CsvFormat format("\t", "\n");
+    QCOMPARE(CsvSerializer::serialize(values, format), expected.join("\t"));
+}
+
+void DsvFormatsTestTest::testIncrementalWriter()
+{
+    DsvWriter writer = TsvSerializer::createWriter();
+    for (const QStringList& row : sampleData)
+    {
+        for (const QString& value : row)
+            writer.appendValue(value);
+
+        writer.finishRow();
+    }
+
+    QCOMPARE(writer.getOutput(), sampleTsv);
+}
+
 void DsvFormatsTestTest::testCsvPerformance()
 {
     QString input;
@@ -0,0 +1,67 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_enterpriseformattertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+FORMATTER_DIR = $$PWD/../../../Plugins/SqlEnterpriseFormatter
+INCLUDEPATH += $$FORMATTER_DIR
+DEPENDPATH += $$FORMATTER_DIR
+
+# Plugin classes are compiled into the test, so they're not imported from the plugin library.
+DEFINES += SQLENTERPRISEFORMATTER_LIBRARY
+
+SOURCES += tst_enterpriseformattertest.cpp \
+    enterpriseformatterstubs.cpp \
+    $$FORMATTER_DIR/sqlenterpriseformatter.cpp \
+    $$FORMATTER_DIR/formatstatement.cpp \
+    $$FORMATTER_DIR/formatselect.cpp \
+    $$FORMATTER_DIR/formatexpr.cpp \
+    $$FORMATTER_DIR/formatlimit.cpp \
+    $$FORMATTER_DIR/formatwith.cpp \
+    $$FORMATTER_DIR/formatraise.cpp \
+    $$FORMATTER_DIR/formatcreatetable.cpp \
+    $$FORMATTER_DIR/formatforeignkey.cpp \
+    $$FORMATTER_DIR/formatcolumntype.cpp \
+    $$FORMATTER_DIR/formatindexedcolumn.cpp \
+    $$FORMATTER_DIR/formatinsert.cpp \
+    $$FORMATTER_DIR/formatempty.cpp \
+    $$FORMATTER_DIR/formataltertable.cpp \
+    $$FORMATTER_DIR/formatanalyze.cpp \
+    $$FORMATTER_DIR/formatattach.cpp \
+    $$FORMATTER_DIR/formatbegintrans.cpp \
+    $$FORMATTER_DIR/formatcommittrans.cpp \
+    $$FORMATTER_DIR/formatcopy.cpp \
+    $$FORMATTER_DIR/formatcreateindex.cpp \
+    $$FORMATTER_DIR/formatcreatetrigger.cpp \
+    $$FORMATTER_DIR/formatdelete.cpp \
+    $$FORMATTER_DIR/formatupdate.cpp \
+    $$FORMATTER_DIR/formatcreateview.cpp \
+    $$FORMATTER_DIR/formatcreatevirtualtable.cpp \
+    $$FORMATTER_DIR/formatdetach.cpp \
+    $$FORMATTER_DIR/formatdropindex.cpp \
+    $$FORMATTER_DIR/formatdroptable.cpp \
+    $$FORMATTER_DIR/formatdroptrigger.cpp \
+    $$FORMATTER_DIR/formatdropview.cpp \
+    $$FORMATTER_DIR/formatpragma.cpp \
+    $$FORMATTER_DIR/formatreindex.cpp \
+    $$FORMATTER_DIR/formatrelease.cpp \
+    $$FORMATTER_DIR/formatrollback.cpp \
+    $$FORMATTER_DIR/formatsavepoint.cpp \
+    $$FORMATTER_DIR/formatvacuum.cpp \
+    $$FORMATTER_DIR/formatorderby.cpp \
+    $$FORMATTER_DIR/formatupsert.cpp \
+    $$FORMATTER_DIR/formatsimpleinsert.cpp
+
+HEADERS += $$FORMATTER_DIR/sqlenterpriseformatter.h \
+    $$FORMATTER_DIR/formatstatement.h \
+    $$FORMATTER_DIR/formatinsert.h \
+    $$FORMATTER_DIR/formatsimpleinsert.h
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,12 @@
+// Plugin resources are the config form and translations, which are not used by the tests and not compiled in,
+// so these are just enough for SqlEnterpriseFormatter::init() and deinit() to link.
+
+int qInitResources_sqlenterpriseformatter()
+{
+    return 1;
+}
+
+int qCleanupResources_sqlenterpriseformatter()
+{
+    return 1;
+}
@@ -0,0 +1,205 @@
+#include "sqlenterpriseformatter.h"
+#include "formatstatement.h"
+#include "formatsimpleinsert.h"
+#include "parser/parser.h"
+#include "parser/lexer.h"
+#include "mocks.h"
+#include <QString>
+#include <QStringList>
+#include <QtTest>
+
+class EnterpriseFormatterTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        EnterpriseFormatterTest();
+
+    private:
+        QString formatParsed(const QString& sql);
+        QString formatSimple(const QString& sql);
+        QString makeScript(int repeats) const;
+        QString formatWholeScript(const QString& code);
+
+        SqlEnterpriseFormatter* formatter = nullptr;
+        CFG_LOCAL(SqlEnterpriseFormatterConfig, cfg)
+
+        static const int PARALLEL_REPEATS = 20;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testSimpleInsertMatchesInsert();
+        void testSimpleInsertMatchesInsertWithOtherConfig();
+        void testSimpleInsertRejected();
+        void testSerialMatchesWholeScript();
+        void testParallelMatchesWholeScript();
+        void testParseErrorFallsBack();
+};
+
+EnterpriseFormatterTest::EnterpriseFormatterTest()
+{
+}
+
+QString EnterpriseFormatterTest::formatParsed(const QString& sql)
+{
+    Parser parser(Dialect::Sqlite3);
+    if (!parser.parse(sql) || parser.getQueries().size() != 1)
+        return QString();
+
+    FormatStatement* formatStmt = FormatStatement::forQuery(parser.getQueries().first().data());
+    if (!formatStmt)
+        return QString();
+
+    formatStmt->setSelectedWrapper(NameWrapper::BRACKET);
+    formatStmt->setConfig(&cfg);
+    QString formatted = formatStmt->format();
+    delete formatStmt;
+    return formatted;
+}
+
+QString EnterpriseFormatterTest::formatSimple(const QString& sql)
+{
+    FormatStatement* formatStmt = FormatSimpleInsert::forTokens(Lexer::tokenize(sql, Dialect::Sqlite3));
+    if (!formatStmt)
+        return QString();
+
+    formatStmt->setSelectedWrapper(NameWrapper::BRACKET);
+    formatStmt->setConfig(&cfg);
+    QString formatted = formatStmt->format();
+    delete formatStmt;
+    return formatted;
+}
+
+QString EnterpriseFormatterTest::makeScript(int repeats) const
+{
+    // Mixed INSERT and DDL statements, with comments between them, before them and at their ends.
+    static const QStringList pieces = {
+        "INSERT INTO test (id, name) VALUES (%1, 'a'), (%1, NULL);\n",
+        "-- line comment between statements\n",
+        "REPLACE INTO [test] VALUES (%1, x'0A', 1.5e3);",
+        " /* block comment after the semicolon */\n\n",
+        "CREATE TABLE other%1 (id INTEGER PRIMARY KEY, value TEXT /* inline */ NOT NULL);\n",
+        "/* block comment before the statement */ INSERT OR IGNORE INTO other%1 VALUES (-%1, 'b');\n",
+        "INSERT INTO main.test VALUES (%1, 'c'); -- comment at the line end\n",
+        "SELECT * FROM test WHERE id > %1;\n",
+        "CREATE INDEX idx%1 ON test (name);\n",
+        "insert into \"test\" (\"id\", name) values (%1, 'it''s');\n",
+        "DROP TABLE other%1;\n"
+    };
+
+    QString script = "-- comment before the first statement\n";
+    for (int i = 0; i < repeats; i++)
+    {
+        for (const QString& piece : pieces)
+            script += QString(piece).replace("%1", QString::number(i));
+    }
+    return script;
+}
+
+QString EnterpriseFormatterTest::formatWholeScript(const QString& code)
+{
+    // Regular path of the formatter plugin, which parses the whole script at once.
+    return formatter->SqlFormatterPlugin::format(code, nullptr);
+}
+
+void EnterpriseFormatterTest::initTestCase()
+{
+    initMocks();
+    formatter = new SqlEnterpriseFormatter();
+}
+
+void EnterpriseFormatterTest::cleanupTestCase()
+{
+    safe_delete(formatter);
+}
+
+void EnterpriseFormatterTest::testSimpleInsertMatchesInsert()
+{
+    static const QStringList queries = {
+        "INSERT INTO test VALUES (1, 'a');",
+        "INSERT INTO test (id, name, value) VALUES (1, 'a', NULL), (2, 'b', 2.5), (3, x'0a0b', 1e10);",
+        "insert into test values (1);",
+        "REPLACE INTO test (id) VALUES (9223372036854775807);",
+        "INSERT OR REPLACE INTO [test table] (\"first col\", `second col`) VALUES ('x''y', '');",
+        "INSERT OR IGNORE INTO test VALUES (0.5, null)",
+        "INSERT OR ROLLBACK INTO test VALUES (1), (2), (3), (4), (5), (6), (7), (8), (9), (10), (11), (12), (13), (14), (15), (16);"
+    };
+
+    QString simple;
+    for (const QString& query : queries)
+    {
+        simple = formatSimple(query);
+        QVERIFY2(!simple.isEmpty(), query.toUtf8().constData());
+        QCOMPARE(simple, formatParsed(query));
+    }
+}
+
+void EnterpriseFormatterTest::testSimpleInsertMatchesInsertWithOtherConfig()
+{
+    cfg.SqlEnterpriseFormatter.UppercaseKeywords.set(false);
+    cfg.SqlEnterpriseFormatter.NlAfterComma.set(false);
+    cfg.SqlEnterpriseFormatter.SpaceBeforeOpenPar.set(false);
+
+    QString query = "INSERT INTO test (id, name) VALUES (1, 'a'), (2, 'b');";
+    QString simple = formatSimple(query);
+    QString parsed = formatParsed(query);
+
+    cfg.SqlEnterpriseFormatter.UppercaseKeywords.set(true);
+    cfg.SqlEnterpriseFormatter.NlAfterComma.set(true);
+    cfg.SqlEnterpriseFormatter.SpaceBeforeOpenPar.set(true);
+
+    QVERIFY(!simple.isEmpty());
+    QCOMPARE(simple, parsed);
+}
+
+void EnterpriseFormatterTest::testSimpleInsertRejected()
+{
+    // These have to go through the parser.
+    static const QStringList queries = {
+        "INSERT INTO main.test VALUES (1);",
+        "INSERT INTO test VALUES (-1);",
+        "INSERT INTO test VALUES (1 + 2);",
+        "INSERT INTO test VALUES (0x10);",
+        "INSERT INTO test VALUES (1); -- comment",
+        "INSERT INTO test DEFAULT VALUES;",
+        "INSERT INTO test SELECT * FROM other;",
+        "WITH x AS (SELECT 1) INSERT INTO test VALUES (1);",
+        "INSERT INTO test VALUES (1) ON CONFLICT DO NOTHING;",
+        "INSERT INTO test VALUES (1);INSERT INTO test VALUES (2);",
+        "UPDATE test SET id = 1;"
+    };
+
+    for (const QString& query : queries)
+        QVERIFY2(!FormatSimpleInsert::forTokens(Lexer::tokenize(query, Dialect::Sqlite3)), query.toUtf8().constData());
+}
+
+void EnterpriseFormatterTest::testSerialMatchesWholeScript()
+{
+    QString script = makeScript(1);
+    QString formatted = formatter->format(script, nullptr);
+    QVERIFY(formatted != script);
+    QCOMPARE(formatted, formatWholeScript(script));
+}
+
+void EnterpriseFormatterTest::testParallelMatchesWholeScript()
+{
+    QString script = makeScript(PARALLEL_REPEATS);
+    QString formatted = formatter->format(script, nullptr);
+    QVERIFY(formatted != script);
+    QCOMPARE(formatted, formatWholeScript(script));
+}
+
+void EnterpriseFormatterTest::testParseErrorFallsBack()
+{
+    // Script that does not parse is returned as it is, no matter which path it went through.
+    QString script = makeScript(1) + "INSERT INTO test VALUES (1;\n";
+    QCOMPARE(formatter->format(script, nullptr), script);
+
+    script = makeScript(PARALLEL_REPEATS) + "CREATE TABLE (;\n" + makeScript(1);
+    QCOMPARE(formatter->format(script, nullptr), script);
+}
+
+QTEST_APPLESS_MAIN(EnterpriseFormatterTest)
+
+#include "tst_enterpriseformattertest.moc"
@@ -0,0 +1,258 @@
+#include "common/exportoutputbuffer.h"
+#include "csvserializer.h"
+#include <QString>
+#include <QBuffer>
+#include <QTextCodec>
+#include <QtTest>
+
+class ExportOutputBufferTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        ExportOutputBufferTest();
+
+    private:
+        QString legacyJsonEscape(const QString& str);
+        QByteArray writeThroughBuffer(const QStringList& fragments, QTextCodec* codec, int flushThreshold);
+
+        QStringList sampleValues;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void testUtf8MatchesCodec();
+        void testOtherCodecMatchesCodec();
+        void testSmallFlushThreshold();
+        void testJsonEscape();
+        void testJsonControlChars();
+        void testXmlEscape();
+        void testCsvEscape();
+        void testWriteError();
+        void benchmarkJson();
+        void benchmarkXml();
+        void benchmarkHtml();
+        void benchmarkCsv();
+};
+
+ExportOutputBufferTest::ExportOutputBufferTest()
+{
+}
+
+QString ExportOutputBufferTest::legacyJsonEscape(const QString& str)
+{
+    QString copy = str;
+    return "\"" +
+            copy.replace("\\", "\\\\")
+                .replace("\"", "\\\"")
+                .replace("/", "\\/")
+                .replace("\b", "\\b")
+                .replace("\f", "\\f")
+                .replace("\n", "\\n")
+                .replace("\r", "\\r")
+                .replace("\t", "\\t")
+            + "\"";
+}
+
+QByteArray ExportOutputBufferTest::writeThroughBuffer(const QStringList& fragments, QTextCodec* codec, int flushThreshold)
+{
+    QByteArray result;
+    QBuffer device(&result);
+    device.open(QIODevice::WriteOnly);
+
+    ExportOutputBuffer buffer;
+    buffer.setFlushThreshold(flushThreshold);
+    buffer.setOutput(&device, codec);
+    for (const QString& fragment : fragments)
+        buffer.write(fragment);
+
+    buffer.flush();
+    device.close();
+    return result;
+}
+
+void ExportOutputBufferTest::initTestCase()
+{
+    sampleValues << "plain ascii value";
+    sampleValues << "a \"quoted\" value, with separator";
+    sampleValues << "multi\nline\r\nvalue\twith tab";
+    sampleValues << "<tag attr=\"x\">a & b</tag>";
+    sampleValues << "path/to\\file";
+    sampleValues << QString::fromUtf8("za\xC5\xBC\xC3\xB3\xC5\x82\xC4\x87 g\xC4\x99\xC5\x9Bl\xC4\x85 ja\xC5\xBA\xC5\x84");
+    sampleValues << QString::fromUtf8("\xE6\xBC\xA2\xE5\xAD\x97 \xF0\x9F\x98\x80 emoji");
+    sampleValues << "";
+}
+
+void ExportOutputBufferTest::testUtf8MatchesCodec()
+{
+    QTextCodec* codec = QTextCodec::codecForName("UTF-8");
+    QByteArray result = writeThroughBuffer(sampleValues, codec, ExportOutputBuffer::DEFAULT_FLUSH_THRESHOLD);
+    QCOMPARE(result, codec->fromUnicode(sampleValues.join("")));
+}
+
+void ExportOutputBufferTest::testOtherCodecMatchesCodec()
+{
+    QTextCodec* codec = QTextCodec::codecForName("ISO-8859-2");
+    QStringList latin2Values = sampleValues.mid(0, 6);
+    QByteArray result = writeThroughBuffer(latin2Values, codec, ExportOutputBuffer::DEFAULT_FLUSH_THRESHOLD);
+    QCOMPARE(result, codec->fromUnicode(latin2Values.join("")));
+}
+
+void ExportOutputBufferTest::testSmallFlushThreshold()
+{
+    QStringList fragments;
+    for (int i = 0; i < 1000; i++)
+        fragments << sampleValues;
+
+    QTextCodec* codec = QTextCodec::codecForName("UTF-8");
+    QByteArray result = writeThroughBuffer(fragments, codec, 100);
+    QCOMPARE(result, codec->fromUnicode(fragments.join("")));
+}
+
+void ExportOutputBufferTest::testJsonEscape()
+{
+    for (const QString& value : sampleValues)
+        QCOMPARE(ExportOutputBuffer::escapeJson(value), legacyJsonEscape(value));
+}
+
+void ExportOutputBufferTest::testJsonControlChars()
+{
+    QString value = QString("a") + QChar(0x01) + "b" + QChar(0x1f);
+    QCOMPARE(ExportOutputBuffer::escapeJson(value), QString("\"a\\u0001b\\u001f\""));
+}
+
+void ExportOutputBufferTest::testXmlEscape()
+{
+    for (const QString& value : sampleValues)
+    {
+        QCOMPARE(ExportOutputBuffer::escapeXml(value), value.toHtmlEscaped());
+        QCOMPARE(ExportOutputBuffer::hasXmlSpecialChars(value), value != value.toHtmlEscaped());
+    }
+}
+
+void ExportOutputBufferTest::testCsvEscape()
+{
+    CsvFormat format(",", "\n");
+    QStringList escaped;
+    for (const QString& value : sampleValues)
+        escaped << ExportOutputBuffer::escapeCsv(value, format.columnSeparator, format.rowSeparator);
+
+    QCOMPARE(escaped.join(format.columnSeparator), CsvSerializer::serialize(sampleValues, format));
+
+    format.columnSeparator = "||";
+    QCOMPARE(ExportOutputBuffer::escapeCsv("a|b", format.columnSeparator, format.rowSeparator), QString("a|b"));
+    QCOMPARE(ExportOutputBuffer::escapeCsv("a||b", format.columnSeparator, format.rowSeparator), QString("\"a||b\""));
+}
+
+void ExportOutputBufferTest::testWriteError()
+{
+    // Device opened for reading refuses every write.
+    QByteArray data;
+    QBuffer device(&data);
+    device.open(QIODevice::ReadOnly);
+
+    ExportOutputBuffer buffer;
+    buffer.setFlushThreshold(16);
+    buffer.setOutput(&device, nullptr);
+    buffer.write(QString(32, 'x'));
+    QVERIFY(buffer.hasWriteError());
+    QVERIFY(buffer.flush()); // nothing left to write, but the error is still remembered
+    QVERIFY(buffer.hasWriteError());
+
+    buffer.setOutput(&device, nullptr);
+    QVERIFY(!buffer.hasWriteError());
+    buffer.write("abc");
+    QVERIFY(!buffer.flush());
+    QVERIFY(buffer.hasWriteError());
+}
+
+void ExportOutputBufferTest::benchmarkJson()
+{
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    ExportOutputBuffer buffer;
+    buffer.setOutput(&device, QTextCodec::codecForName("UTF-8"));
+
+    QBENCHMARK {
+        device.seek(0);
+        for (int i = 0; i < 10000; i++)
+        {
+            for (const QString& value : sampleValues)
+            {
+                buffer.writeJsonString(value);
+                buffer.writeAscii(",\n", 2);
+            }
+        }
+        buffer.flush();
+    }
+}
+
+void ExportOutputBufferTest::benchmarkXml()
+{
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    ExportOutputBuffer buffer;
+    buffer.setOutput(&device, QTextCodec::codecForName("UTF-8"));
+
+    QBENCHMARK {
+        device.seek(0);
+        for (int i = 0; i < 10000; i++)
+        {
+            for (const QString& value : sampleValues)
+            {
+                buffer.writeAscii("<value>", 7);
+                buffer.writeXmlEscaped(value);
+                buffer.writeAscii("</value>\n", 9);
+            }
+        }
+        buffer.flush();
+    }
+}
+
+void ExportOutputBufferTest::benchmarkHtml()
+{
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    ExportOutputBuffer buffer;
+    buffer.setOutput(&device, QTextCodec::codecForName("ISO-8859-2"));
+
+    QBENCHMARK {
+        device.seek(0);
+        for (int i = 0; i < 10000; i++)
+        {
+            for (const QString& value : sampleValues)
+            {
+                buffer.writeAscii("<td>", 4);
+                buffer.writeHtmlEscaped(value);
+                buffer.writeAscii("</td>\n", 6);
+            }
+        }
+        buffer.flush();
+    }
+}
+
+void ExportOutputBufferTest::benchmarkCsv()
+{
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    ExportOutputBuffer buffer;
+    buffer.setOutput(&device, QTextCodec::codecForName("UTF-8"));
+    CsvFormat format(",", "\n");
+
+    QBENCHMARK {
+        device.seek(0);
+        for (int i = 0; i < 10000; i++)
+        {
+            for (const QString& value : sampleValues)
+            {
+                buffer.writeCsvField(value, format.columnSeparator, format.rowSeparator);
+                buffer.write(format.columnSeparator);
+            }
+            buffer.write(QChar('\n'));
+        }
+        buffer.flush();
+    }
+}
+
+QTEST_APPLESS_MAIN(ExportOutputBufferTest)
+
+#include "tst_exportoutputbuffertest.moc"
@@ -0,0 +1,174 @@
+#include "diff/linediff.h"
+#include <QString>
+#include <QStringList>
+#include <QtTest>
+
+class LineDiffTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        LineDiffTest();
+
+    private:
+        QString unchangedPart(const QString& text, const QList<LineDiff::Range>& changed);
+        QString randomText(int lines, int variety);
+
+    private Q_SLOTS:
+        void testEqualTexts();
+        void testChangedLine();
+        void testChangedLineNoRefinement();
+        void testInsertedAndDeletedLines();
+        void testTokenMode();
+        void testSingleLineAgainstMany();
+        void testUnchangedPartsMatch();
+        void testTimeBudget();
+        void benchmarkLargeDump();
+};
+
+LineDiffTest::LineDiffTest()
+{
+}
+
+QString LineDiffTest::unchangedPart(const QString& text, const QList<LineDiff::Range>& changed)
+{
+    QString result;
+    int pos = 0;
+    for (const LineDiff::Range& range : changed)
+    {
+        result += text.mid(pos, range.start - pos);
+        pos = range.start + range.length;
+    }
+    result += text.mid(pos);
+    return result;
+}
+
+QString LineDiffTest::randomText(int lines, int variety)
+{
+    QStringList result;
+    for (int i = 0; i < lines; i++)
+        result << QString("CREATE TABLE t%1 (id INTEGER PRIMARY KEY, val TEXT);").arg(qrand() % variety);
+
+    return result.join("\n");
+}
+
+void LineDiffTest::testEqualTexts()
+{
+    QString text = "CREATE TABLE a (x);\nCREATE TABLE b (y);\n";
+    LineDiff::Result result = LineDiff().diff(text, text);
+    QVERIFY(result.deleted.isEmpty());
+    QVERIFY(result.inserted.isEmpty());
+    QVERIFY(!result.timedOut);
+}
+
+void LineDiffTest::testChangedLine()
+{
+    QString left = "CREATE TABLE a (x);\nCREATE TABLE b (y);\nCREATE TABLE c (z);\n";
+    QString right = "CREATE TABLE a (x);\nCREATE TABLE b (y, w);\nCREATE TABLE c (z);\n";
+    LineDiff::Result result = LineDiff().diff(left, right);
+    QVERIFY(result.deleted.isEmpty());
+    QCOMPARE(result.inserted.size(), 1);
+    QCOMPARE(right.mid(result.inserted.first().start, result.inserted.first().length), QString(", w"));
+}
+
+void LineDiffTest::testChangedLineNoRefinement()
+{
+    QString left = "CREATE TABLE a (x);\nCREATE TABLE b (y);\nCREATE TABLE c (z);\n";
+    QString right = "CREATE TABLE a (x);\nCREATE TABLE b (y, w);\nCREATE TABLE c (z);\n";
+    LineDiff lineDiff;
+    lineDiff.setCharRefinementLimit(0);
+    LineDiff::Result result = lineDiff.diff(left, right);
+    QCOMPARE(result.deleted.size(), 1);
+    QCOMPARE(result.inserted.size(), 1);
+    QCOMPARE(left.mid(result.deleted.first().start, result.deleted.first().length), QString("CREATE TABLE b (y);\n"));
+    QCOMPARE(right.mid(result.inserted.first().start, result.inserted.first().length), QString("CREATE TABLE b (y, w);\n"));
+}
+
+void LineDiffTest::testInsertedAndDeletedLines()
+{
+    QString left = "line 1\nline 2\nline 3\nline 4";
+    QString right = "line 0\nline 1\nline 3\nline 4\nline 5";
+    LineDiff::Result result = LineDiff().diff(left, right);
+    QCOMPARE(unchangedPart(left, result.deleted), unchangedPart(right, result.inserted));
+    QCOMPARE(unchangedPart(left, result.deleted), QString("line 1\nline 3\nline 4"));
+}
+
+void LineDiffTest::testTokenMode()
+{
+    QString left = "SELECT a, b FROM t WHERE x = 1";
+    QString right = "SELECT a, c FROM t WHERE x = 1";
+    LineDiff lineDiff;
+    lineDiff.setMode(LineDiff::Mode::TOKENS);
+    lineDiff.setCharRefinementLimit(0);
+    LineDiff::Result result = lineDiff.diff(left, right);
+    QCOMPARE(result.deleted.size(), 1);
+    QCOMPARE(result.inserted.size(), 1);
+    QCOMPARE(left.mid(result.deleted.first().start, result.deleted.first().length), QString("b"));
+    QCOMPARE(right.mid(result.inserted.first().start, result.inserted.first().length), QString("c"));
+}
+
+void LineDiffTest::testSingleLineAgainstMany()
+{
+    LineDiff lineDiff;
+    lineDiff.setCharRefinementLimit(0);
+
+    LineDiff::Result result = lineDiff.diff("a\nb\n", "x\nb\ny\n");
+    QCOMPARE(unchangedPart("a\nb\n", result.deleted), QString("b\n"));
+    QCOMPARE(unchangedPart("x\nb\ny\n", result.inserted), QString("b\n"));
+
+    result = lineDiff.diff("x\ny\nz\n", "q\n");
+    QCOMPARE(unchangedPart("x\ny\nz\n", result.deleted), QString());
+    QCOMPARE(unchangedPart("q\n", result.inserted), QString());
+}
+
+void LineDiffTest::testUnchangedPartsMatch()
+{
+    qsrand(1);
+    LineDiff lineDiff;
+    lineDiff.setTimeBudget(0);
+    for (int i = 0; i < 200; i++)
+    {
+        QString left = randomText(qrand() % 40, 8);
+        QString right = randomText(qrand() % 40, 8);
+        LineDiff::Result result = lineDiff.diff(left, right);
+        QCOMPARE(unchangedPart(left, result.deleted), unchangedPart(right, result.inserted));
+    }
+}
+
+void LineDiffTest::testTimeBudget()
+{
+    qsrand(2);
+    QString left = randomText(20000, 20000);
+    QString right = randomText(20000, 20000);
+    LineDiff lineDiff;
+    lineDiff.setTimeBudget(1);
+    LineDiff::Result result = lineDiff.diff(left, right);
+
+    // Regardless of the time budget, the result must be consistent.
+    QCOMPARE(unchangedPart(left, result.deleted), unchangedPart(right, result.inserted));
+}
+
+void LineDiffTest::benchmarkLargeDump()
+{
+    qsrand(3);
+    QStringList leftLines;
+    for (int i = 0; i < 50000; i++)
+        leftLines << QString("CREATE TABLE t%1 (id INTEGER PRIMARY KEY, val TEXT);").arg(i);
+
+    QStringList rightLines = leftLines;
+    for (int i = 0; i < 200; i++)
+        rightLines[qrand() % rightLines.size()] += " -- changed";
+
+    QString left = leftLines.join("\n");
+    QString right = rightLines.join("\n");
+    LineDiff lineDiff;
+    lineDiff.setTimeBudget(0);
+    QBENCHMARK
+    {
+        lineDiff.diff(left, right);
+    }
+}
+
+QTEST_APPLESS_MAIN(LineDiffTest)
+
+#include "tst_linedifftest.moc"
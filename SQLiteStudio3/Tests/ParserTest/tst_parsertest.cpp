@@ -49,6 +49,7 @@ class ParserTest : public QObject
         void testRebuildTokensUpdate();
         void testRebuildTokensInsertUpsert();
         void testGetColumnTokensFromInsertUpsert();
+        void testStatementTree();
         void initTestCase();
         void cleanupTestCase();
 };
@@ -498,6 +499,36 @@ void ParserTest::testGetColumnTokensFromInsertUpsert()
     QVERIFY(tk.toValueList().join(" ") == "a1 a2 b1 b2 b3 col1 col2 col3 x");
 }
 
+void ParserTest::testStatementTree()
+{
+    QString sql = "CREATE TABLE tab (a INTEGER, b TEXT CHECK (b <> ''));";
+    bool res = parser3->parse(sql);
+    QVERIFY(res);
+
+    SqliteCreateTablePtr createTable = parser3->getQueries().first().dynamicCast<SqliteCreateTable>();
+    QVERIFY(createTable);
+    QCOMPARE(createTable->columns.size(), 2);
+    QVERIFY(createTable->columns[0]->parent() == createTable.data());
+    QVERIFY(createTable->childStatements().contains(createTable->columns[1]));
+
+    SqliteCreateTablePtr copy = SqliteCreateTablePtr(dynamic_cast<SqliteCreateTable*>(createTable->clone()));
+    QVERIFY(copy->columns[1]->parent() == copy.data());
+    QVERIFY(copy->columns[1] != createTable->columns[1]);
+
+    SqliteStatementGuard<SqliteCreateTable::Column> guard = copy->columns[1];
+    SqliteStatementGuard<SqliteCreateTable::Column> detachedGuard = copy->columns[0];
+    SqliteStatementPtr detached = copy->columns[0]->detach();
+    copy->columns.removeFirst();
+    QVERIFY(detached->parent() == nullptr);
+    QVERIFY(!copy->childStatements().contains(detached.data()));
+
+    copy.clear();
+    QVERIFY(guard.isNull());
+    QVERIFY(!detachedGuard.isNull());
+    QCOMPARE(detachedGuard->name, QString("a"));
+    QCOMPARE(createTable->columns[1]->name, QString("b"));
+}
+
 void ParserTest::initTestCase()
 {
     initKeywords();
@@ -0,0 +1,22 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_regexpscannertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+REGEXP_IMPORT_DIR = $$PWD/../../../Plugins/RegExpImport
+INCLUDEPATH += $$REGEXP_IMPORT_DIR
+DEPENDPATH += $$REGEXP_IMPORT_DIR
+
+SOURCES += tst_regexpscannertest.cpp \
+    $$REGEXP_IMPORT_DIR/regexpscanner.cpp
+
+HEADERS += $$REGEXP_IMPORT_DIR/regexpscanner.h
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
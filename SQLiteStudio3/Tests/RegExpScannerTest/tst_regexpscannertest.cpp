@@ -0,0 +1,94 @@
+#include "regexpscanner.h"
+#include <QString>
+#include <QStringList>
+#include <QtTest>
+
+class RegExpScannerTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        RegExpScannerTest();
+
+    private:
+        QStringList scan(const QString& pattern, const QStringList& pieces);
+
+    private Q_SLOTS:
+        void testEmptyMatchAtStart();
+        void testEmptyMatchesBetween();
+        void testEmptyMatchBeforeSurrogatePair();
+        void testMatchAcrossPieces();
+        void testPartialMatchAcrossPieces();
+        void testAnchorAtPieceEnd();
+        void testSparseMatches();
+        void testLookbehindAfterCompaction();
+};
+
+RegExpScannerTest::RegExpScannerTest()
+{
+}
+
+QStringList RegExpScannerTest::scan(const QString& pattern, const QStringList& pieces)
+{
+    QRegularExpression re(pattern);
+    re.optimize();
+
+    RegExpScanner scanner(re);
+    QRegularExpressionMatch match;
+    QStringList results;
+    for (const QString& piece : pieces)
+    {
+        scanner.append(piece);
+        while (scanner.next(match))
+            results << match.captured(0);
+    }
+    return results;
+}
+
+void RegExpScannerTest::testEmptyMatchAtStart()
+{
+    QCOMPARE(scan("a*", {"bba"}), QStringList({"a"}));
+}
+
+void RegExpScannerTest::testEmptyMatchesBetween()
+{
+    QCOMPARE(scan("a*", {"abaab", "ba"}), QStringList({"a", "aa", "a"}));
+}
+
+void RegExpScannerTest::testEmptyMatchBeforeSurrogatePair()
+{
+    QString smile = QString::fromUtf8("\xF0\x9F\x98\x80");
+    QCOMPARE(scan("a*", {smile + "a" + smile}), QStringList({"a"}));
+}
+
+void RegExpScannerTest::testMatchAcrossPieces()
+{
+    QCOMPARE(scan("\\d+;", {"x12", "34;y5", "6;"}), QStringList({"1234;", "56;"}));
+}
+
+void RegExpScannerTest::testPartialMatchAcrossPieces()
+{
+    // Empty match at the piece end must not make the scanner skip the text that may start a match with the next piece.
+    QCOMPARE(scan("(ab)*", {"xa", "b"}), QStringList({"ab"}));
+}
+
+void RegExpScannerTest::testAnchorAtPieceEnd()
+{
+    QCOMPARE(scan("\\w+$", {"foo bar", "baz"}), QStringList({"bar", "baz"}));
+}
+
+void RegExpScannerTest::testSparseMatches()
+{
+    QString filler(100000, 'x');
+    QCOMPARE(scan("needle\\d", {filler, "need", "le1" + filler, filler + "needle2"}), QStringList({"needle1", "needle2"}));
+}
+
+void RegExpScannerTest::testLookbehindAfterCompaction()
+{
+    QString filler(100000, 'x');
+    QCOMPARE(scan("(?<=x)y", {filler, "y"}), QStringList({"y"}));
+}
+
+QTEST_APPLESS_MAIN(RegExpScannerTest)
+
+#include "tst_regexpscannertest.moc"
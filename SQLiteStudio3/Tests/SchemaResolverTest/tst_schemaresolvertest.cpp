@@ -0,0 +1,167 @@
+#include "schemaresolver.h"
+#include "parser/parser.h"
+#include "parser/lexer.h"
+#include "parser/keywords.h"
+#include "parser/ast/sqlitecreatetable.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QSet>
+#include <QtTest>
+
+class SchemaResolverTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        SchemaResolverTest();
+
+    private:
+        QString freshParse(const QString& ddl);
+        QSet<Token*> collectTokens(SqliteStatement* stmt);
+
+        Db* db = nullptr;
+
+        static const constexpr char* tableDdl = "CREATE TABLE test (id INTEGER PRIMARY KEY, val TEXT NOT NULL DEFAULT 'x' CHECK (length(val) < 10), "
+                                                "ref INTEGER REFERENCES other (id) ON DELETE CASCADE, UNIQUE (val, ref))";
+        static const constexpr char* triggerDdl = "CREATE TRIGGER trig AFTER INSERT ON test BEGIN UPDATE test SET val = upper(new.val) WHERE id = new.id; END";
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void testCachedCloneMatchesFreshParse();
+        void testCachedClonesShareNoTokens();
+        void testModifiedCloneDoesNotChangeCache();
+        void testClearCache();
+};
+
+SchemaResolverTest::SchemaResolverTest()
+{
+}
+
+QString SchemaResolverTest::freshParse(const QString& ddl)
+{
+    Parser parser(Dialect::Sqlite3);
+    if (!parser.parse(ddl) || parser.getQueries().isEmpty())
+        return QString();
+
+    return parser.getQueries().first()->detokenize();
+}
+
+QSet<Token*> SchemaResolverTest::collectTokens(SqliteStatement* stmt)
+{
+    QSet<Token*> tokens;
+    for (const TokenPtr& token : stmt->tokens)
+        tokens << token.data();
+
+    for (const TokenList& tokenList : stmt->tokensMap)
+    {
+        for (const TokenPtr& token : tokenList)
+            tokens << token.data();
+    }
+
+    for (SqliteStatement* child : stmt->childStatements())
+    {
+        if (child)
+            tokens += collectTokens(child);
+    }
+
+    tokens.remove(nullptr);
+    return tokens;
+}
+
+void SchemaResolverTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    SchemaResolver::staticInit();
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    QVERIFY(db->open());
+    QVERIFY(!db->exec("CREATE TABLE other (id INTEGER PRIMARY KEY)")->isError());
+    QVERIFY(!db->exec(tableDdl)->isError());
+    QVERIFY(!db->exec(triggerDdl)->isError());
+}
+
+void SchemaResolverTest::cleanupTestCase()
+{
+    db->close();
+    safe_delete(db);
+}
+
+void SchemaResolverTest::init()
+{
+    SchemaResolver::clearParsedDdlCache();
+}
+
+void SchemaResolverTest::testCachedCloneMatchesFreshParse()
+{
+    SchemaResolver resolver(db);
+    for (const QString& name : {QString("test"), QString("trig")})
+    {
+        SqliteQueryPtr parsed = resolver.getParsedObject(name, SchemaResolver::ANY);
+        SqliteQueryPtr cached = resolver.getParsedObject(name, SchemaResolver::ANY);
+        QVERIFY(parsed);
+        QVERIFY(cached);
+        QCOMPARE(cached->detokenize(), parsed->detokenize());
+        QCOMPARE(cached->detokenize(), freshParse(resolver.getObjectDdl(name, SchemaResolver::ANY)));
+    }
+
+    // Many DDLs at once go through the same cache
+    StrHash<SqliteQueryPtr> all = resolver.getAllParsedObjects();
+    QVERIFY(all.contains("test"));
+    QCOMPARE(all["test"]->detokenize(), freshParse(resolver.getObjectDdl("test", SchemaResolver::TABLE)));
+}
+
+void SchemaResolverTest::testCachedClonesShareNoTokens()
+{
+    SchemaResolver resolver(db);
+    SqliteQueryPtr first = resolver.getParsedObject("test", SchemaResolver::TABLE);
+    SqliteQueryPtr second = resolver.getParsedObject("test", SchemaResolver::TABLE);
+    QVERIFY(first);
+    QVERIFY(second);
+    QVERIFY(first.data() != second.data());
+
+    QSet<Token*> firstTokens = collectTokens(first.data());
+    QSet<Token*> secondTokens = collectTokens(second.data());
+    QVERIFY(!firstTokens.isEmpty());
+    QVERIFY(!firstTokens.intersects(secondTokens));
+}
+
+void SchemaResolverTest::testModifiedCloneDoesNotChangeCache()
+{
+    SchemaResolver resolver(db);
+    SqliteCreateTablePtr table = resolver.getParsedObject("test", SchemaResolver::TABLE).dynamicCast<SqliteCreateTable>();
+    QVERIFY(table);
+
+    // Tokens modified in place, as well as the rebuilt statement
+    for (const TokenPtr& token : table->tokens)
+    {
+        if (token->type == Token::OTHER)
+            token->value = "changed";
+    }
+    table->table = "renamed";
+    table->rebuildTokens();
+    QVERIFY(table->detokenize().contains("renamed"));
+
+    SqliteQueryPtr again = resolver.getParsedObject("test", SchemaResolver::TABLE);
+    QVERIFY(again);
+    QCOMPARE(again->detokenize(), freshParse(resolver.getObjectDdl("test", SchemaResolver::TABLE)));
+}
+
+void SchemaResolverTest::testClearCache()
+{
+    SchemaResolver resolver(db);
+    SqliteQueryPtr before = resolver.getParsedObject("test", SchemaResolver::TABLE);
+    SchemaResolver::clearParsedDdlCache();
+    SqliteQueryPtr after = resolver.getParsedObject("test", SchemaResolver::TABLE);
+    QVERIFY(before);
+    QVERIFY(after);
+    QCOMPARE(after->detokenize(), before->detokenize());
+}
+
+QTEST_APPLESS_MAIN(SchemaResolverTest)
+
+#include "tst_schemaresolvertest.moc"
@@ -0,0 +1,153 @@
+#include "db/storageanalyzer.h"
+#include "db/sqlquery.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class StorageAnalyzerTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        StorageAnalyzerTest();
+
+    private:
+        const StorageAnalyzer::ObjectStats* findObject(const StorageAnalyzer::Report& report, const QString& name);
+
+        QTemporaryDir* dir = nullptr;
+        Db* db = nullptr;
+
+        static const int ROWS = 600;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testPageWalkMatchesDbstat();
+        void testOverflowAndFreePages();
+};
+
+StorageAnalyzerTest::StorageAnalyzerTest()
+{
+}
+
+const StorageAnalyzer::ObjectStats* StorageAnalyzerTest::findObject(const StorageAnalyzer::Report& report, const QString& name)
+{
+    // Newer SQLite versions report the schema table as sqlite_schema in dbstat
+    const StorageAnalyzer::ObjectStats* stats = report.getObject(name);
+    if (!stats && name == "sqlite_schema")
+        stats = report.getObject("sqlite_master");
+
+    return stats;
+}
+
+void StorageAnalyzerTest::initTestCase()
+{
+    initMocks();
+
+    dir = new QTemporaryDir;
+    QVERIFY(dir->isValid());
+
+    db = new DbSqlite3Mock("testdb", dir->filePath("test.db"));
+    QVERIFY(db->open());
+
+    // Small pages, so rows and index entries spill to overflow pages
+    QVERIFY(!db->exec("PRAGMA page_size = 1024;")->isError());
+    QVERIFY(!db->exec("PRAGMA auto_vacuum = NONE;")->isError());
+    QVERIFY(!db->exec("CREATE TABLE big (id INTEGER PRIMARY KEY, name TEXT, data BLOB);")->isError());
+    QVERIFY(!db->exec("CREATE INDEX big_name ON big (name);")->isError());
+    QVERIFY(!db->exec("CREATE TABLE small (id INTEGER PRIMARY KEY, val TEXT UNIQUE);")->isError());
+    QVERIFY(!db->exec(QString("WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < %1) "
+                              "INSERT INTO big (id, name, data) SELECT x, substr(hex(randomblob(200)), 1, 1 + (x * 37) % 400), "
+                              "randomblob((x * 997) % 5000) FROM cnt;").arg(ROWS))->isError());
+    QVERIFY(!db->exec(QString("WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < %1) "
+                              "INSERT INTO small (id, val) SELECT x, 'value ' || x FROM cnt;").arg(ROWS * 3))->isError());
+
+    // Deleted rows leave free pages behind, as there is no auto-vacuum
+    QVERIFY(!db->exec("DELETE FROM big WHERE id % 3 = 0;")->isError());
+    QVERIFY(db->exec("PRAGMA freelist_count;")->getSingleCell().toLongLong() > 0);
+}
+
+void StorageAnalyzerTest::cleanupTestCase()
+{
+    db->close();
+    safe_delete(db);
+    safe_delete(dir);
+}
+
+void StorageAnalyzerTest::testPageWalkMatchesDbstat()
+{
+    StorageAnalyzer::Report walked = STORAGE_ANALYZER->analyze(db, StorageAnalyzer::Method::PAGE_WALK);
+    QVERIFY2(walked.isValid(), walked.errorMessage.toUtf8().constData());
+    QVERIFY(!walked.fromDbstat);
+    QVERIFY(!walked.approximate);
+
+    StorageAnalyzer::Report dbstat = STORAGE_ANALYZER->analyze(db, StorageAnalyzer::Method::DBSTAT);
+    if (!dbstat.isValid())
+        QSKIP("The dbstat virtual table is not available in this SQLite build.");
+
+    QVERIFY(dbstat.fromDbstat);
+    QCOMPARE(walked.pageSize, dbstat.pageSize);
+    QCOMPARE(walked.pageCount, dbstat.pageCount);
+    QCOMPARE(walked.freePages, dbstat.freePages);
+    QCOMPARE(walked.objects.size(), dbstat.objects.size());
+
+    const StorageAnalyzer::ObjectStats* walkedStats = nullptr;
+    for (const StorageAnalyzer::ObjectStats& stats : dbstat.objects)
+    {
+        walkedStats = findObject(walked, stats.name);
+        QVERIFY2(walkedStats, stats.name.toUtf8().constData());
+        QCOMPARE(walkedStats->pages, stats.pages);
+        QCOMPARE(walkedStats->leafPages, stats.leafPages);
+        QCOMPARE(walkedStats->interiorPages, stats.interiorPages);
+        QCOMPARE(walkedStats->overflowPages, stats.overflowPages);
+        QCOMPARE(walkedStats->cells, stats.cells);
+        QCOMPARE(walkedStats->payload, stats.payload);
+        QCOMPARE(walkedStats->unused, stats.unused);
+        QCOMPARE(walkedStats->fragmentation, stats.fragmentation);
+        QCOMPARE(walkedStats->getSize(walked.pageSize), stats.getSize(dbstat.pageSize));
+    }
+}
+
+void StorageAnalyzerTest::testOverflowAndFreePages()
+{
+    StorageAnalyzer::Report report = STORAGE_ANALYZER->analyze(db, StorageAnalyzer::Method::PAGE_WALK);
+    QVERIFY2(report.isValid(), report.errorMessage.toUtf8().constData());
+    QCOMPARE(report.pageSize, 1024);
+    QCOMPARE(report.freePages, db->exec("PRAGMA freelist_count;")->getSingleCell().toLongLong());
+
+    const StorageAnalyzer::ObjectStats* big = report.getObject("big");
+    QVERIFY(big);
+    QCOMPARE(big->type, QString("table"));
+    QCOMPARE(big->cells, db->exec("SELECT count(*) FROM big;")->getSingleCell().toLongLong());
+    QVERIFY(big->overflowPages > 0);
+    QVERIFY(big->interiorPages > 0);
+    QVERIFY(big->payload >= db->exec("SELECT sum(length(data)) FROM big;")->getSingleCell().toLongLong());
+
+    const StorageAnalyzer::ObjectStats* index = report.getObject("big_name");
+    QVERIFY(index);
+    QCOMPARE(index->type, QString("index"));
+    QCOMPARE(index->table, QString("big"));
+    QVERIFY(index->cells > 0);
+    QVERIFY(index->cells <= big->cells); // the rest of entries is in interior pages
+    QVERIFY(index->overflowPages > 0);
+
+    // Every page is either free, or belongs to some b-tree (no pointer-map or lock-byte pages in such small file)
+    qint64 pages = report.freePages;
+    for (const StorageAnalyzer::ObjectStats& stats : report.objects)
+        pages += stats.pages;
+
+    QCOMPARE(pages, report.pageCount);
+    QVERIFY(report.getEstimatedVacuumGain() >= report.freePages * report.pageSize);
+
+    // Forced methods don't replace the cached report
+    StorageAnalyzer::Report cached;
+    STORAGE_ANALYZER->clearCache();
+    STORAGE_ANALYZER->analyze(db, StorageAnalyzer::Method::PAGE_WALK);
+    QVERIFY(!STORAGE_ANALYZER->getCached(db, cached));
+}
+
+QTEST_APPLESS_MAIN(StorageAnalyzerTest)
+
+#include "tst_storageanalyzertest.moc"
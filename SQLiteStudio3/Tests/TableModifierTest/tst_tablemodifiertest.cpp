@@ -18,6 +18,7 @@ class TableModifierTest : public QObject
 
     private:
         void verifyRe(const QString& re, const QString& sql, Qt::CaseSensitivity cs = Qt::CaseSensitive);
+        bool isSqliteAtLeast(int major, int minor);
 
         Db* db = nullptr;
         static const constexpr char* mainTableDdl = "CREATE TABLE test (id int, val text, val2 text);";
@@ -33,6 +34,10 @@ class TableModifierTest : public QObject
         void testCase4();
         void testCase5();
         void testCase6();
+        void testNativeAddColumn();
+        void testNativeRenameColumn();
+        void testNativeDropColumn();
+        void testNativeFallback();
 };
 
 TableModifierTest::TableModifierTest()
@@ -45,6 +50,14 @@ void TableModifierTest::verifyRe(const QString& re, const QString& sql, Qt::Case
     QVERIFY2(regExp.exactMatch(sql), QString("Failed RegExp validation:\n%1\nfor SQL:\n%2").arg(re).arg(sql).toLatin1().data());
 }
 
+bool TableModifierTest::isSqliteAtLeast(int major, int minor)
+{
+    QStringList version = db->exec("SELECT sqlite_version()")->getSingleCell().toString().split(".");
+    int actualMajor = version.value(0).toInt();
+    int actualMinor = version.value(1).toInt();
+    return actualMajor > major || (actualMajor == major && actualMinor >= minor);
+}
+
 void TableModifierTest::testCase1()
 {
     db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
@@ -85,6 +98,7 @@ void TableModifierTest::testCase2()
     db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
 
     TableModifier mod(db, "test");
+    mod.setNativeAlterEnabled(false);
     createTable->columns[1]->name = "newCol";
     mod.alterTable(createTable);
     QStringList sqls = mod.generateSqls();
@@ -266,6 +280,78 @@ void TableModifierTest::testCase6()
     verifyRe("PRAGMA foreign_keys = 1;", sqls[i++]);
 }
 
+void TableModifierTest::testNativeAddColumn()
+{
+    Parser parser(db->getDialect());
+    QVERIFY(parser.parse("CREATE TABLE test (id int, val text, val2 text, val3 int NOT NULL DEFAULT 5);"));
+    SqliteCreateTablePtr newCreateTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+
+    TableModifier mod(db, "test");
+    mod.alterTable(newCreateTable);
+    QStringList sqls = mod.generateSqls();
+
+    QVERIFY(mod.isNativeAlter());
+    QVERIFY(sqls.size() == 1);
+    verifyRe("ALTER TABLE test ADD COLUMN val3 int.*NOT NULL.*DEFAULT 5;", sqls[0]);
+}
+
+void TableModifierTest::testNativeRenameColumn()
+{
+    if (!isSqliteAtLeast(3, 25))
+        QSKIP("ALTER TABLE RENAME COLUMN is not supported by this SQLite version.");
+
+    db->exec("CREATE INDEX i1 ON test (val);");
+
+    TableModifier mod(db, "test");
+    createTable->columns[1]->name = "newCol";
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    QVERIFY(mod.isNativeAlter());
+    QVERIFY(sqls.size() == 1);
+    verifyRe("ALTER TABLE test RENAME COLUMN val TO newCol;", sqls[0]);
+    QVERIFY(mod.getModifiedIndexes().contains("i1"));
+}
+
+void TableModifierTest::testNativeDropColumn()
+{
+    if (!isSqliteAtLeast(3, 35))
+        QSKIP("ALTER TABLE DROP COLUMN is not supported by this SQLite version.");
+
+    TableModifier mod(db, "test");
+    delete createTable->columns.takeAt(2);
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    QVERIFY(mod.isNativeAlter());
+    QVERIFY(sqls.size() == 1);
+    verifyRe("ALTER TABLE test DROP COLUMN val2;", sqls[0]);
+}
+
+void TableModifierTest::testNativeFallback()
+{
+    // Indexed column cannot be dropped with ALTER TABLE, so the table has to be recreated.
+    db->exec("CREATE INDEX i1 ON test (val2);");
+
+    TableModifier mod(db, "test");
+    delete createTable->columns.takeAt(2);
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    QVERIFY(!mod.isNativeAlter());
+    verifyRe("PRAGMA foreign_keys = 0;", sqls.first());
+    verifyRe("PRAGMA foreign_keys = 1;", sqls.last());
+
+    // Column with PRIMARY KEY cannot be added with ALTER TABLE.
+    Parser parser(db->getDialect());
+    QVERIFY(parser.parse("CREATE TABLE test (id int, val text, val2 text, val3 int PRIMARY KEY);"));
+    SqliteCreateTablePtr newCreateTable = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+
+    TableModifier mod2(db, "test");
+    mod2.alterTable(newCreateTable);
+    QVERIFY(!mod2.isNativeAlter());
+}
+
 void TableModifierTest::initTestCase()
 {
     initKeywords();
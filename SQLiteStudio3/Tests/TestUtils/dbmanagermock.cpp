@@ -67,6 +67,11 @@ bool DbManagerMock::isTemporary(Db*)
     return false;
 }
 
+bool DbManagerMock::isDbListLoaded() const
+{
+    return true;
+}
+
 DbPlugin* DbManagerMock::getPluginForDbFile(const QString&)
 {
     return nullptr;
@@ -20,6 +20,7 @@ class DbManagerMock : public DbManager
         Db* getByPath(const QString&);
         Db* createInMemDb(bool = false);
         bool isTemporary(Db*);
+        bool isDbListLoaded() const;
         QString quickAddDb(const QString &path, const QHash<QString, QVariant> &);
         DbPlugin* getPluginForDbFile(const QString&);
         QString generateUniqueDbName(const QString&);
@@ -23,6 +23,42 @@ db_ver_conv.depends = test_utils
 dsv.subdir = DsvFormatsTest
 dsv.depends = test_utils
 
+export_output.subdir = ExportOutputBufferTest
+export_output.depends = test_utils
+
+line_diff.subdir = LineDiffTest
+line_diff.depends = test_utils
+
+column_profiler.subdir = ColumnProfilerTest
+column_profiler.depends = test_utils
+
+regexp_scanner.subdir = RegExpScannerTest
+regexp_scanner.depends = test_utils
+
+db_android.subdir = DbAndroidTest
+db_android.depends = test_utils
+
+db_sqlite_cipher.subdir = DbSqliteCipherTest
+db_sqlite_cipher.depends = test_utils
+
+enterprise_formatter.subdir = EnterpriseFormatterTest
+enterprise_formatter.depends = test_utils
+
+schema_resolver.subdir = SchemaResolverTest
+schema_resolver.depends = test_utils
+
+db_blob.subdir = DbBlobTest
+db_blob.depends = test_utils
+
+storage_analyzer.subdir = StorageAnalyzerTest
+storage_analyzer.depends = test_utils
+
+db_file_prober.subdir = DbFileProberTest
+db_file_prober.depends = test_utils
+
+benchmarks.subdir = Benchmarks
+benchmarks.depends = test_utils
+
 SUBDIRS += \
     test_utils \
     completion_helper \
@@ -32,5 +68,17 @@ SUBDIRS += \
     hash_tables \
     db_ver_conv \
     dsv \
+    export_output \
+    line_diff \
+    column_profiler \
+    regexp_scanner \
+    db_android \
+    db_sqlite_cipher \
+    enterprise_formatter \
+    schema_resolver \
+    db_blob \
+    storage_analyzer \
+    db_file_prober \
+    benchmarks \
     UtilsTest \
     LexerTest
@@ -15,6 +15,7 @@ private Q_SLOTS:
     void testRemoveComments();
     void testRemoveCommentsAndEmpties();
     void testDoubleToString();
+    void testQueryAccessMode();
 };
 
 UtilsSqlTest::UtilsSqlTest()
@@ -81,6 +82,25 @@ void UtilsSqlTest::testDoubleToString()
     QVERIFY(doubleToString(QVariant(0.1 + 0.1 + 0.1)) == "0.3");
 }
 
+void UtilsSqlTest::testQueryAccessMode()
+{
+    bool isSelect = false;
+    QVERIFY(getQueryAccessMode("select * from t", Dialect::Sqlite3, &isSelect) == QueryAccessMode::READ);
+    QVERIFY(isSelect);
+    QVERIFY(getQueryAccessMode("  -- comment\n/* insert */ Pragma table_info(t)", Dialect::Sqlite3, &isSelect) == QueryAccessMode::READ);
+    QVERIFY(!isSelect);
+    QVERIFY(getQueryAccessMode("EXPLAIN QUERY PLAN DELETE FROM t", Dialect::Sqlite3) == QueryAccessMode::READ);
+    QVERIFY(getQueryAccessMode("insert into t values ('select', 1)", Dialect::Sqlite3, &isSelect) == QueryAccessMode::WRITE);
+    QVERIFY(!isSelect);
+    QVERIFY(getQueryAccessMode("", Dialect::Sqlite3) == QueryAccessMode::WRITE);
+
+    QVERIFY(getQueryAccessMode("WITH x AS (SELECT 1) SELECT * FROM x", Dialect::Sqlite3, &isSelect) == QueryAccessMode::READ);
+    QVERIFY(isSelect);
+    QVERIFY(getQueryAccessMode("WITH x(a) AS (SELECT 1) INSERT INTO t SELECT a FROM x", Dialect::Sqlite3, &isSelect) == QueryAccessMode::WRITE);
+    QVERIFY(!isSelect);
+    QVERIFY(getQueryAccessMode("with \"select\" as (select ')') update t set a = (select 1)", Dialect::Sqlite3) == QueryAccessMode::WRITE);
+}
+
 QTEST_APPLESS_MAIN(UtilsSqlTest)
 
 #include "tst_utilssqltest.moc"
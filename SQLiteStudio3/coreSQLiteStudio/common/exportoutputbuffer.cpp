@@ -0,0 +1,447 @@
+#include "exportoutputbuffer.h"
+#include "common/global.h"
+#include <QIODevice>
+#include <QTextCodec>
+#include <QDebug>
+
+namespace
+{
+    static const int UTF8_MIB = 106;
+
+    /**
+     * Adapter letting escaping routines write either into ExportOutputBuffer, or into a QString.
+     */
+    class StringSink
+    {
+        public:
+            explicit StringSink(QString& target) : target(target) {}
+
+            void write(const QChar* chars, int length)
+            {
+                target.append(chars, length);
+            }
+
+            void writeAscii(const char* str, int length)
+            {
+                target.append(QLatin1String(str, length));
+            }
+
+        private:
+            QString& target;
+    };
+
+    template <class T>
+    void escapeJsonInternal(const QString& str, T& target)
+    {
+        static const char* hexDigits = "0123456789abcdef";
+
+        const QChar* begin = str.constData();
+        const QChar* end = begin + str.length();
+        const QChar* runStart = begin;
+        char unicodeEsc[6] = {'\\', 'u', '0', '0', '0', '0'};
+        ushort c;
+        for (const QChar* it = begin; it < end; ++it)
+        {
+            c = it->unicode();
+            if (c >= 0x20 && c != '"' && c != '\\' && c != '/')
+                continue;
+
+            if (it > runStart)
+                target.write(runStart, it - runStart);
+
+            runStart = it + 1;
+            switch (c)
+            {
+                case '"':
+                    target.writeAscii("\\\"", 2);
+                    break;
+                case '\\':
+                    target.writeAscii("\\\\", 2);
+                    break;
+                case '/':
+                    target.writeAscii("\\/", 2);
+                    break;
+                case '\b':
+                    target.writeAscii("\\b", 2);
+                    break;
+                case '\f':
+                    target.writeAscii("\\f", 2);
+                    break;
+                case '\n':
+                    target.writeAscii("\\n", 2);
+                    break;
+                case '\r':
+                    target.writeAscii("\\r", 2);
+                    break;
+                case '\t':
+                    target.writeAscii("\\t", 2);
+                    break;
+                default:
+                    unicodeEsc[4] = hexDigits[(c >> 4) & 0xf];
+                    unicodeEsc[5] = hexDigits[c & 0xf];
+                    target.writeAscii(unicodeEsc, 6);
+                    break;
+            }
+        }
+
+        if (end > runStart)
+            target.write(runStart, end - runStart);
+    }
+
+    template <class T>
+    void escapeXmlInternal(const QString& str, T& target)
+    {
+        const QChar* begin = str.constData();
+        const QChar* end = begin + str.length();
+        const QChar* runStart = begin;
+        for (const QChar* it = begin; it < end; ++it)
+        {
+            switch (it->unicode())
+            {
+                case '<':
+                case '>':
+                case '&':
+                case '"':
+                    break;
+                default:
+                    continue;
+            }
+
+            if (it > runStart)
+                target.write(runStart, it - runStart);
+
+            runStart = it + 1;
+            switch (it->unicode())
+            {
+                case '<':
+                    target.writeAscii("&lt;", 4);
+                    break;
+                case '>':
+                    target.writeAscii("&gt;", 4);
+                    break;
+                case '&':
+                    target.writeAscii("&amp;", 5);
+                    break;
+                case '"':
+                    target.writeAscii("&quot;", 6);
+                    break;
+            }
+        }
+
+        if (end > runStart)
+            target.write(runStart, end - runStart);
+    }
+
+    template <class T>
+    void writeCsvQuoted(const QString& str, T& target)
+    {
+        const QChar* begin = str.constData();
+        const QChar* end = begin + str.length();
+        const QChar* runStart = begin;
+
+        target.writeAscii("\"", 1);
+        for (const QChar* it = begin; it < end; ++it)
+        {
+            if (*it != '"')
+                continue;
+
+            // Write the run including the quote, then start next run from the same quote, so it gets doubled.
+            target.write(runStart, it - runStart + 1);
+            runStart = it;
+        }
+
+        if (end > runStart)
+            target.write(runStart, end - runStart);
+
+        target.writeAscii("\"", 1);
+    }
+
+    bool matchesAt(const QChar* pos, const QChar* end, const QString& pattern)
+    {
+        int lgt = pattern.length();
+        if (end - pos < lgt)
+            return false;
+
+        const QChar* patternChars = pattern.constData();
+        for (int i = 1; i < lgt; i++)
+        {
+            if (pos[i] != patternChars[i])
+                return false;
+        }
+        return true;
+    }
+}
+
+ExportOutputBuffer::ExportOutputBuffer()
+{
+}
+
+ExportOutputBuffer::~ExportOutputBuffer()
+{
+    safe_delete(encoder);
+}
+
+void ExportOutputBuffer::setOutput(QIODevice* output, QTextCodec* codec)
+{
+    this->output = output;
+    safe_delete(encoder);
+
+    utf8 = (!codec || codec->mibEnum() == UTF8_MIB);
+    if (!utf8)
+        encoder = codec->makeEncoder();
+
+    bytes.resize(0);
+    text.resize(0);
+    writeError = false;
+    if (utf8)
+        bytes.reserve(flushThreshold + flushThreshold / 4);
+    else
+        text.reserve(flushThreshold / 2);
+}
+
+void ExportOutputBuffer::setFlushThreshold(int bytes)
+{
+    flushThreshold = bytes;
+}
+
+void ExportOutputBuffer::write(const QString& str)
+{
+    write(str.constData(), str.length());
+}
+
+void ExportOutputBuffer::write(const QChar* chars, int length)
+{
+    if (length <= 0)
+        return;
+
+    if (utf8)
+        appendUtf8(chars, length);
+    else
+        text.append(chars, length);
+
+    flushIfNeeded();
+}
+
+void ExportOutputBuffer::write(QChar c)
+{
+    if (utf8 && c.unicode() < 0x80)
+    {
+        bytes.append(static_cast<char>(c.unicode()));
+        flushIfNeeded();
+        return;
+    }
+
+    write(&c, 1);
+}
+
+void ExportOutputBuffer::writeAscii(const char* str, int length)
+{
+    if (utf8)
+        bytes.append(str, length);
+    else
+        text.append(QLatin1String(str, length));
+
+    flushIfNeeded();
+}
+
+void ExportOutputBuffer::writeln(const QString& str)
+{
+    write(str);
+    write(QChar('\n'));
+}
+
+void ExportOutputBuffer::writeJsonString(const QString& str)
+{
+    writeAscii("\"", 1);
+    escapeJsonInternal(str, *this);
+    writeAscii("\"", 1);
+}
+
+void ExportOutputBuffer::writeXmlEscaped(const QString& str)
+{
+    escapeXmlInternal(str, *this);
+}
+
+void ExportOutputBuffer::writeHtmlEscaped(const QString& str)
+{
+    escapeXmlInternal(str, *this);
+}
+
+void ExportOutputBuffer::writeCsvField(const QString& str, const QString& columnSeparator, const QString& rowSeparator)
+{
+    if (csvNeedsQuoting(str, columnSeparator, rowSeparator))
+        writeCsvQuoted(str, *this);
+    else
+        write(str);
+}
+
+bool ExportOutputBuffer::flush()
+{
+    if (!output)
+        return false;
+
+    QByteArray encoded;
+    const QByteArray* toWrite = &bytes;
+    if (!utf8)
+    {
+        if (text.isEmpty())
+            return true;
+
+        encoded = encoder->fromUnicode(text);
+        text.resize(0);
+        toWrite = &encoded;
+    }
+
+    if (toWrite->isEmpty())
+        return true;
+
+    qint64 written = output->write(*toWrite);
+    bool res = (written == toWrite->size());
+    if (!res)
+    {
+        qWarning() << "Could not write all export data to the output device:" << output->errorString();
+        writeError = true;
+    }
+
+    bytes.resize(0);
+    return res;
+}
+
+bool ExportOutputBuffer::hasWriteError() const
+{
+    return writeError;
+}
+
+QString ExportOutputBuffer::escapeJson(const QString& str)
+{
+    QString result;
+    result.reserve(str.length() + 2);
+    StringSink sink(result);
+    sink.writeAscii("\"", 1);
+    escapeJsonInternal(str, sink);
+    sink.writeAscii("\"", 1);
+    return result;
+}
+
+QString ExportOutputBuffer::escapeXml(const QString& str)
+{
+    if (!hasXmlSpecialChars(str))
+        return str;
+
+    QString result;
+    result.reserve(str.length() + str.length() / 8 + 8);
+    StringSink sink(result);
+    escapeXmlInternal(str, sink);
+    return result;
+}
+
+QString ExportOutputBuffer::escapeHtml(const QString& str)
+{
+    return escapeXml(str);
+}
+
+QString ExportOutputBuffer::escapeCsv(const QString& str, const QString& columnSeparator, const QString& rowSeparator)
+{
+    if (!csvNeedsQuoting(str, columnSeparator, rowSeparator))
+        return str;
+
+    QString result;
+    result.reserve(str.length() + 8);
+    StringSink sink(result);
+    writeCsvQuoted(str, sink);
+    return result;
+}
+
+bool ExportOutputBuffer::hasXmlSpecialChars(const QString& str)
+{
+    const QChar* end = str.constData() + str.length();
+    for (const QChar* it = str.constData(); it < end; ++it)
+    {
+        switch (it->unicode())
+        {
+            case '<':
+            case '>':
+            case '&':
+            case '"':
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+bool ExportOutputBuffer::csvNeedsQuoting(const QString& str, const QString& columnSeparator, const QString& rowSeparator)
+{
+    // Empty separator is "contained" in any string, as QString::contains() defines it.
+    if (columnSeparator.isEmpty() || rowSeparator.isEmpty())
+        return true;
+
+    QChar colFirst = columnSeparator[0];
+    QChar rowFirst = rowSeparator[0];
+    const QChar* end = str.constData() + str.length();
+    for (const QChar* it = str.constData(); it < end; ++it)
+    {
+        if (*it == '"')
+            return true;
+
+        if (*it == colFirst && matchesAt(it, end, columnSeparator))
+            return true;
+
+        if (*it == rowFirst && matchesAt(it, end, rowSeparator))
+            return true;
+    }
+    return false;
+}
+
+void ExportOutputBuffer::appendUtf8(const QChar* chars, int length)
+{
+    // Each UTF-16 unit is at most 3 bytes in UTF-8 (surrogate pair is 2 units and 4 bytes).
+    int oldSize = bytes.size();
+    bytes.resize(oldSize + length * 3);
+
+    uchar* out = reinterpret_cast<uchar*>(bytes.data()) + oldSize;
+    const ushort* in = reinterpret_cast<const ushort*>(chars);
+    const ushort* end = in + length;
+    ushort c;
+    uint ucs;
+    while (in < end)
+    {
+        c = *in++;
+        if (c < 0x80)
+        {
+            *out++ = static_cast<uchar>(c);
+        }
+        else if (c < 0x800)
+        {
+            *out++ = 0xc0 | static_cast<uchar>(c >> 6);
+            *out++ = 0x80 | static_cast<uchar>(c & 0x3f);
+        }
+        else if (QChar::isHighSurrogate(c) && in < end && QChar::isLowSurrogate(*in))
+        {
+            ucs = QChar::surrogateToUcs4(c, *in++);
+            *out++ = 0xf0 | static_cast<uchar>(ucs >> 18);
+            *out++ = 0x80 | static_cast<uchar>((ucs >> 12) & 0x3f);
+            *out++ = 0x80 | static_cast<uchar>((ucs >> 6) & 0x3f);
+            *out++ = 0x80 | static_cast<uchar>(ucs & 0x3f);
+        }
+        else
+        {
+            if (QChar::isSurrogate(c))
+                c = QChar::ReplacementCharacter;
+
+            *out++ = 0xe0 | static_cast<uchar>(c >> 12);
+            *out++ = 0x80 | static_cast<uchar>((c >> 6) & 0x3f);
+            *out++ = 0x80 | static_cast<uchar>(c & 0x3f);
+        }
+    }
+
+    bytes.resize(out - reinterpret_cast<uchar*>(bytes.data()));
+}
+
+void ExportOutputBuffer::flushIfNeeded()
+{
+    // Non-UTF-8 text is kept as UTF-16, so 2 bytes per character.
+    if ((utf8 ? bytes.size() : text.size() * 2) >= flushThreshold)
+        flush();
+}
@@ -0,0 +1,110 @@
+#ifndef EXPORTOUTPUTBUFFER_H
+#define EXPORTOUTPUTBUFFER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QByteArray>
+#include <QString>
+
+class QIODevice;
+class QTextCodec;
+class QTextEncoder;
+
+/**
+ * @brief Buffered, encoding-aware output for export plugins.
+ *
+ * Text written to this buffer is collected in memory and passed to the output device in large chunks
+ * (see setFlushThreshold()), instead of a device write per each small fragment.
+ *
+ * When the target codec is UTF-8 (or no codec is given), characters are encoded directly into
+ * the byte buffer, without going through QTextCodec. For any other codec the text is collected as is
+ * and encoded with a single QTextEncoder (which keeps its state across chunks) when the buffer is flushed.
+ *
+ * The write*Escaped() methods escape the text for the specific format in a single pass over the input,
+ * copying unchanged runs of characters in bulk. Static escape*() counterparts return an escaped QString
+ * for places where the escaped value is needed as a string.
+ */
+class API_EXPORT ExportOutputBuffer
+{
+    public:
+        static const int DEFAULT_FLUSH_THRESHOLD = 1024 * 1024;
+
+        ExportOutputBuffer();
+        ~ExportOutputBuffer();
+
+        /**
+         * @brief Sets the device and codec to write to.
+         * @param output Output device.
+         * @param codec Codec to encode text with. Null means UTF-8.
+         *
+         * Any data remaining in the buffer from previous output is discarded.
+         */
+        void setOutput(QIODevice* output, QTextCodec* codec);
+        void setFlushThreshold(int bytes);
+
+        void write(const QString& str);
+        void write(const QChar* chars, int length);
+        void write(QChar c);
+        void writeAscii(const char* str, int length);
+        void writeln(const QString& str);
+
+        /**
+         * @brief Writes string as a JSON string literal, including enclosing double quotes.
+         */
+        void writeJsonString(const QString& str);
+        void writeXmlEscaped(const QString& str);
+        void writeHtmlEscaped(const QString& str);
+
+        /**
+         * @brief Writes a single CSV field.
+         * @param str Field value.
+         * @param columnSeparator Column separator in use.
+         * @param rowSeparator Row separator in use.
+         *
+         * The field is enclosed in double quotes (and quotes in it are doubled) if it contains a double quote
+         * or any of separators. This is the same rule as in CsvSerializer::serialize().
+         */
+        void writeCsvField(const QString& str, const QString& columnSeparator, const QString& rowSeparator);
+
+        /**
+         * @brief Passes all buffered data to the output device.
+         * @return true on success, false if the device refused to write the data.
+         */
+        bool flush();
+
+        /**
+         * @brief Tells if any write to the output device failed since setOutput().
+         *
+         * Buffer is also flushed implicitly, when it reaches the flush threshold, so a failure may happen
+         * before the final flush() call.
+         */
+        bool hasWriteError() const;
+
+        static QString escapeJson(const QString& str);
+        static QString escapeXml(const QString& str);
+        static QString escapeHtml(const QString& str);
+        static QString escapeCsv(const QString& str, const QString& columnSeparator, const QString& rowSeparator);
+
+        /**
+         * @brief Tells if string has any characters that have special meaning in XML/HTML.
+         */
+        static bool hasXmlSpecialChars(const QString& str);
+
+        /**
+         * @brief Tells if CSV field needs to be enclosed in quotes.
+         */
+        static bool csvNeedsQuoting(const QString& str, const QString& columnSeparator, const QString& rowSeparator);
+
+    private:
+        void appendUtf8(const QChar* chars, int length);
+        void flushIfNeeded();
+
+        QIODevice* output = nullptr;
+        QTextEncoder* encoder = nullptr;
+        bool utf8 = true;
+        int flushThreshold = DEFAULT_FLUSH_THRESHOLD;
+        bool writeError = false;
+        QByteArray bytes;
+        QString text;
+};
+
+#endif // EXPORTOUTPUTBUFFER_H
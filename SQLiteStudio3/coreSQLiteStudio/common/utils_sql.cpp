@@ -1,5 +1,6 @@
 #include "common/utils_sql.h"
 #include "common/utils.h"
+#include "common/unused.h"
 #include "db/sqlquery.h"
 #include "parser/token.h"
 #include "parser/lexer.h"
@@ -719,72 +720,163 @@ QString getBindTokenName(const TokenPtr& token)
     return token->value.mid(1);
 }
 
+/**
+ * @brief Finds next word of the query, skipping everything that is not a word.
+ * @param query Query to scan.
+ * @param pos Position to start at. It's moved right after the returned word.
+ * @param depth Depth of parenthesis at the returned word. It's updated for every parenthesis passed.
+ * @return The word, or null reference if there are no more words.
+ *
+ * Strings, quoted names, comments and bind parameters are skipped, so words inside of them are never returned.
+ * This is a lot cheaper than the Lexer for checking just a few leading words of a (possibly huge) query.
+ */
+static QStringRef nextQueryWord(const QString& query, int& pos, int& depth)
+{
+    const QChar* chars = query.constData();
+    int lgt = query.length();
+    int start;
+    QChar c;
+    QChar endChar;
+    while (pos < lgt)
+    {
+        c = chars[pos];
+        if (c.isLetter() || c == '_')
+        {
+            start = pos;
+            while (pos < lgt && (chars[pos].isLetterOrNumber() || chars[pos] == '_' || chars[pos] == '$'))
+                pos++;
+
+            return QStringRef(&query, start, pos - start);
+        }
+
+        switch (c.unicode())
+        {
+            case '(':
+                depth++;
+                pos++;
+                break;
+            case ')':
+                depth--;
+                pos++;
+                break;
+            case '\'':
+            case '"':
+            case '`':
+            case '[':
+            {
+                // Doubled quote character is handled as two strings next to each other, which gives the same result.
+                endChar = (c == '[') ? QChar(']') : c;
+                pos++;
+                while (pos < lgt && chars[pos] != endChar)
+                    pos++;
+
+                pos++;
+                break;
+            }
+            case '-':
+            {
+                pos++;
+                if (pos < lgt && chars[pos] == '-')
+                {
+                    while (pos < lgt && chars[pos] != '\n' && chars[pos] != '\r')
+                        pos++;
+                }
+                break;
+            }
+            case '/':
+            {
+                pos++;
+                if (pos < lgt && chars[pos] == '*')
+                {
+                    pos++;
+                    while (pos < lgt && !(chars[pos] == '*' && pos + 1 < lgt && chars[pos + 1] == '/'))
+                        pos++;
+
+                    pos += 2;
+                }
+                break;
+            }
+            case ':':
+            case '@':
+            case '$':
+            case '?':
+            {
+                // Bind parameters
+                pos++;
+                while (pos < lgt && (chars[pos].isLetterOrNumber() || chars[pos] == '_'))
+                    pos++;
+
+                break;
+            }
+            default:
+            {
+                // Numbers (including hex ones and exponents) are skipped as whole, so they're not taken as words.
+                if (c.isDigit())
+                {
+                    while (pos < lgt && (chars[pos].isLetterOrNumber() || chars[pos] == '.' || chars[pos] == '_'))
+                        pos++;
+                }
+                else
+                {
+                    pos++;
+                }
+                break;
+            }
+        }
+    }
+    return QStringRef();
+}
+
 QueryAccessMode getQueryAccessMode(const QString& query, Dialect dialect, bool* isSelect)
 {
-    static QStringList readOnlyCommands = {"ANALYZE", "EXPLAIN", "PRAGMA", "SELECT"};
+    UNUSED(dialect);
+    static_char* readOnlyCommands[] = {"ANALYZE", "EXPLAIN", "PRAGMA", "SELECT"};
 
     if (isSelect)
         *isSelect = false;
 
-    TokenList tokens = Lexer::tokenize(query, dialect);
-    int keywordIdx = tokens.indexOf(Token::KEYWORD);
-    if (keywordIdx < 0)
+    // Only leading words are checked, so the cost doesn't depend on the query length.
+    int pos = 0;
+    int depth = 0;
+    QStringRef word = nextQueryWord(query, pos, depth);
+    if (word.isNull())
         return QueryAccessMode::WRITE;
 
-    int cmdIdx = readOnlyCommands.indexOf(tokens[keywordIdx]->value.toUpper());
-    if (keywordIdx > -1 && cmdIdx > -1)
+    for (const char* cmd : readOnlyCommands)
     {
-        if (cmdIdx == 3 && isSelect)
+        if (word.compare(QLatin1String(cmd), Qt::CaseInsensitive) != 0)
+            continue;
+
+        if (isSelect && word.compare(QLatin1String("SELECT"), Qt::CaseInsensitive) == 0)
             *isSelect = true;
 
         return QueryAccessMode::READ;
     }
 
-    if (keywordIdx > -1 && tokens[keywordIdx]->value.toUpper() == "WITH")
-    {
-        bool matched = false;
-        bool queryIsSelect = false;
-        int depth = 0;
-        for (TokenPtr token : tokens)
-        {
-            switch (token->type)
-            {
-                case Token::PAR_LEFT:
-                    depth++;
-                    break;
-                case Token::PAR_RIGHT:
-                    depth--;
-                    break;
-                case Token::KEYWORD:
-                    if (depth == 0)
-                    {
-                        QString val = token->value.toUpper();
-                        if (val == "SELECT")
-                        {
-                            matched = true;
-                            queryIsSelect = true;
-                        }
-                        else if (val == "DELETE" || val == "UPDATE" || val == "INSERT")
-                        {
-                            matched = true;
-                        }
-                    }
-                    break;
-                default:
-                    break;
-            }
+    if (word.compare(QLatin1String("WITH"), Qt::CaseInsensitive) != 0)
+        return QueryAccessMode::WRITE;
 
-            if (matched)
-                break;
-        }
+    // Common table expressions are followed by the actual statement, the first top-level one of these keywords.
+    while (!(word = nextQueryWord(query, pos, depth)).isNull())
+    {
+        if (depth != 0)
+            continue;
 
-        if (queryIsSelect)
+        if (word.compare(QLatin1String("SELECT"), Qt::CaseInsensitive) == 0)
         {
             if (isSelect)
                 *isSelect = true;
 
             return QueryAccessMode::READ;
         }
+
+        if (word.compare(QLatin1String("DELETE"), Qt::CaseInsensitive) == 0 ||
+                word.compare(QLatin1String("UPDATE"), Qt::CaseInsensitive) == 0 ||
+                word.compare(QLatin1String("INSERT"), Qt::CaseInsensitive) == 0 ||
+                word.compare(QLatin1String("REPLACE"), Qt::CaseInsensitive) == 0)
+        {
+            return QueryAccessMode::WRITE;
+        }
     }
 
     return QueryAccessMode::WRITE;
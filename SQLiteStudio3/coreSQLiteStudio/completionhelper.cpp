@@ -1,5 +1,6 @@
 #include "completionhelper.h"
 #include "completioncomparer.h"
+#include "completionindex.h"
 #include "db/db.h"
 #include "parser/keywords.h"
 #include "parser/parser.h"
@@ -546,12 +547,30 @@ QList<ExpectedTokenPtr> CompletionHelper::getObjects(ExpectedToken::Type type, c
     }
 
     QList<ExpectedTokenPtr> results;
-    for (QString object : schemaResolver->getObjects(dbName, typeStr))
+    for (QString object : getObjectNames(dbName, typeStr))
         results << getExpectedToken(type, object, originalDbName);
 
     return results;
 }
 
+QStringList CompletionHelper::getObjectNames(const QString& database, const QString& type)
+{
+    QStringList objects;
+    if (!COMPLETION_INDEX->getObjects(db, database, type, objects))
+        objects = schemaResolver->getObjects(database, type);
+
+    return objects;
+}
+
+QStringList CompletionHelper::getTableColumnNames(const QString& database, const QString& table)
+{
+    QStringList columns;
+    if (!COMPLETION_INDEX->getTableColumns(db, database, table, columns))
+        columns = schemaResolver->getTableColumns(database, table);
+
+    return columns;
+}
+
 QList<ExpectedTokenPtr> CompletionHelper::getColumns()
 {
     QList<ExpectedTokenPtr> results;
@@ -599,9 +618,20 @@ QList<ExpectedTokenPtr> CompletionHelper::getColumnsNoPrefix()
 
     // Getting all tables for main db. If any column repeats in many tables,
     // then tables are stored as a list for the same column.
-    for (QString table : schemaResolver->getTables(QString::null))
-        for (QString column : schemaResolver->getTableColumns(table))
-            columnList[column] += table;
+    QHash<QString,QStringList> tableColumns;
+    if (!COMPLETION_INDEX->getAllTableColumns(db, QString::null, tableColumns))
+    {
+        for (const QString& table : schemaResolver->getTables(QString::null))
+            tableColumns[table] = schemaResolver->getTableColumns(table);
+    }
+
+    QHashIterator<QString,QStringList> tableIt(tableColumns);
+    while (tableIt.hasNext())
+    {
+        tableIt.next();
+        for (const QString& column : tableIt.value())
+            columnList[column] += tableIt.key();
+    }
 
     // Now, for each column the expected token is created.
     // If a column occured in more tables, then multiple expected tokens
@@ -700,7 +730,7 @@ QList<ExpectedTokenPtr> CompletionHelper::getColumns(const QString &prefixTable)
     }
 
     // Get columns for given table in main db.
-    for (const QString& column : schemaResolver->getTableColumns(dbName, table))
+    for (const QString& column : getTableColumnNames(dbName, table))
         results << getExpectedToken(ExpectedToken::COLUMN, column, table, label);
 
     return results;
@@ -712,7 +742,7 @@ QList<ExpectedTokenPtr> CompletionHelper::getColumns(const QString &prefixDb, co
 
     // Get columns for given table in given db.
     QString context = prefixDb+"."+prefixTable;
-    for (const QString& column : schemaResolver->getTableColumns(translateDatabase(prefixDb), prefixTable))
+    for (const QString& column : getTableColumnNames(translateDatabase(prefixDb), prefixTable))
         results << getExpectedToken(ExpectedToken::COLUMN, column, context);
 
     return results;
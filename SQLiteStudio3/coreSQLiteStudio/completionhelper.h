@@ -96,6 +96,8 @@ class API_EXPORT CompletionHelper : public QObject
         QList<ExpectedTokenPtr> getDatabases();
         QList<ExpectedTokenPtr> getObjects(ExpectedToken::Type type);
         QList<ExpectedTokenPtr> getObjects(ExpectedToken::Type type, const QString& database);
+        QStringList getObjectNames(const QString& database, const QString& type);
+        QStringList getTableColumnNames(const QString& database, const QString& table);
         QList<ExpectedTokenPtr> getColumns();
         QList<ExpectedTokenPtr> getColumnsNoPrefix();
         QList<ExpectedTokenPtr> getColumnsNoPrefix(const QString &column, const QStringList &tables);
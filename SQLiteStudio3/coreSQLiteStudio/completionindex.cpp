@@ -0,0 +1,565 @@
+#include "completionindex.h"
+#include "schemaresolver.h"
+#include "db/db.h"
+#include "services/dbmanager.h"
+#include "services/importmanager.h"
+#include "services/notifymanager.h"
+#include "parser/ast/sqlitecreatetable.h"
+#include "parser/ast/sqlitecreatevirtualtable.h"
+#include "parser/ast/sqlitecreateindex.h"
+#include "parser/ast/sqlitecreatetrigger.h"
+#include "parser/ast/sqlitecreateview.h"
+#include "parser/ast/sqlitedroptable.h"
+#include "parser/ast/sqlitedropindex.h"
+#include "parser/ast/sqlitedroptrigger.h"
+#include "parser/ast/sqlitedropview.h"
+#include "parser/ast/sqlitealtertable.h"
+#include "parser/ast/sqliterollback.h"
+#include "parser/ast/sqlitesavepoint.h"
+#include "parser/ast/sqliterelease.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+
+DEFINE_SINGLETON(CompletionIndex)
+
+static const QStringList objectTypes = {"table", "index", "trigger", "view"};
+
+CompletionIndex::CompletionIndex()
+{
+}
+
+CompletionIndex::~CompletionIndex()
+{
+    QList<Db*> dbList;
+    mutex.lock();
+    dbList = entries.keys();
+    mutex.unlock();
+
+    for (Db* db : dbList)
+        remove(db);
+}
+
+void CompletionIndex::init()
+{
+    connect(DBLIST, &DbManager::dbConnected, this, &CompletionIndex::build);
+    connect(DBLIST, &DbManager::dbDisconnected, this, &CompletionIndex::remove);
+    connect(IMPORT_MANAGER, &ImportManager::schemaModified, this, &CompletionIndex::build);
+    connect(NOTIFY_MANAGER, SIGNAL(objectCreated(Db*,QString,QString)), this, SLOT(handleObjectChanged(Db*,QString,QString)));
+    connect(NOTIFY_MANAGER, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(handleObjectChanged(Db*,QString,QString)));
+    connect(NOTIFY_MANAGER, SIGNAL(objectDeleted(Db*,QString,QString)), this, SLOT(handleObjectDeleted(Db*,QString,QString)));
+    connect(NOTIFY_MANAGER, SIGNAL(objectRenamed(Db*,QString,QString,QString)), this, SLOT(handleObjectRenamed(Db*,QString,QString,QString)));
+
+    for (Db* db : DBLIST->getDbList())
+    {
+        if (db->isOpen())
+            build(db);
+    }
+}
+
+void CompletionIndex::build(Db* db)
+{
+    QMutexLocker lock(&mutex);
+    Entry& entry = entries[db];
+    int generation = ++entry.generation;
+    schedule(entry, QtConcurrent::run(this, &CompletionIndex::runBuild, db, generation));
+}
+
+void CompletionIndex::remove(Db* db)
+{
+    QList<QFuture<void>> pendingWork;
+    mutex.lock();
+    if (entries.contains(db))
+    {
+        pendingWork = entries[db].pendingWork;
+        entries.remove(db);
+    }
+    mutex.unlock();
+
+    // Work still running will notice that the entry is gone and will discard its results.
+    for (QFuture<void>& future : pendingWork)
+        future.waitForFinished();
+}
+
+bool CompletionIndex::isReady(Db* db)
+{
+    QMutexLocker lock(&mutex);
+    return entries.contains(db) && entries[db].ready;
+}
+
+void CompletionIndex::waitForReady(Db* db)
+{
+    QList<QFuture<void>> pendingWork;
+    mutex.lock();
+    if (entries.contains(db))
+        pendingWork = entries[db].pendingWork;
+
+    mutex.unlock();
+
+    for (QFuture<void>& future : pendingWork)
+        future.waitForFinished();
+}
+
+bool CompletionIndex::getObjects(Db* db, const QString& database, const QString& type, QStringList& objects)
+{
+    QMutexLocker lock(&mutex);
+    Database* dbIndex = getDatabase(db, database);
+    if (!dbIndex)
+        return false;
+
+    objects = dbIndex->objects.value(type.toLower());
+    return true;
+}
+
+bool CompletionIndex::getTableColumns(Db* db, const QString& database, const QString& table, QStringList& columns)
+{
+    QMutexLocker lock(&mutex);
+    Database* dbIndex = getDatabase(db, database);
+    if (!dbIndex)
+        return false;
+
+    columns = dbIndex->tables.value(table.toLower()).columns;
+    return true;
+}
+
+bool CompletionIndex::getAllTableColumns(Db* db, const QString& database, QHash<QString, QStringList>& columns)
+{
+    QMutexLocker lock(&mutex);
+    Database* dbIndex = getDatabase(db, database);
+    if (!dbIndex)
+        return false;
+
+    columns.clear();
+    for (const Table& table : dbIndex->tables)
+        columns[table.name] = table.columns;
+
+    return true;
+}
+
+void CompletionIndex::handleDdl(Db* db, const QList<SqliteQueryPtr>& queries)
+{
+    mutex.lock();
+    if (!entries.contains(db))
+    {
+        mutex.unlock();
+        return;
+    }
+
+    Entry& entry = entries[db];
+    bool rebuild = false;
+    for (const SqliteQueryPtr& query : queries)
+    {
+        switch (query->queryType)
+        {
+            case SqliteQueryType::BeginTrans:
+            {
+                entry.inTransaction = true;
+                break;
+            }
+            case SqliteQueryType::Savepoint:
+            {
+                // The outermost savepoint starts a transaction, which is then committed by releasing that savepoint.
+                if (!entry.inTransaction)
+                {
+                    entry.inTransaction = true;
+                    entry.transactionSavepoint = query.dynamicCast<SqliteSavepoint>()->name;
+                }
+                break;
+            }
+            case SqliteQueryType::Release:
+            {
+                QString name = query.dynamicCast<SqliteRelease>()->name;
+                if (entry.inTransaction && !entry.transactionSavepoint.isNull() && name.compare(entry.transactionSavepoint, Qt::CaseInsensitive) == 0)
+                    rebuild |= commitDdl(db, entry);
+
+                break;
+            }
+            case SqliteQueryType::CommitTrans:
+            {
+                rebuild |= commitDdl(db, entry);
+                break;
+            }
+            case SqliteQueryType::Rollback:
+            {
+                entry.uncommittedDdl.clear();
+                if (query.dynamicCast<SqliteRollback>()->name.isNull())
+                {
+                    entry.inTransaction = false;
+                    entry.transactionSavepoint = QString();
+                    entry.rebuildOnCommit = false;
+                }
+                else
+                {
+                    // It's not known which of the uncommitted changes were undone, so the schema has to be read after commit.
+                    entry.rebuildOnCommit = true;
+                }
+                break;
+            }
+            case SqliteQueryType::Attach:
+            case SqliteQueryType::Detach:
+            {
+                rebuild = true;
+                break;
+            }
+            default:
+            {
+                if (!isDdl(query->queryType))
+                    break;
+
+                if (entry.inTransaction)
+                    entry.uncommittedDdl << query;
+                else if (entry.ready)
+                    rebuild |= handleDdl(db, entry, query);
+                else
+                    rebuild = true;
+
+                break;
+            }
+        }
+    }
+    mutex.unlock();
+
+    if (rebuild)
+        build(db);
+}
+
+void CompletionIndex::runBuild(Db* db, int generation)
+{
+    if (!db->isOpen())
+        return;
+
+    QStringList databaseNames = {"main", "temp"};
+    databaseNames += db->getAllAttaches().toList();
+
+    QHash<QString, Database> databases;
+    for (const QString& database : databaseNames)
+        databases[database.toLower()] = loadDatabase(db, database);
+
+    QMutexLocker lock(&mutex);
+    if (!entries.contains(db) || entries[db].generation != generation)
+        return; // index was dropped or rebuilt in the meantime
+
+    Entry& entry = entries[db];
+    entry.databases = databases;
+    entry.ready = true;
+}
+
+void CompletionIndex::runObjectReload(Db* db, int generation, const QString& database, const QString& object)
+{
+    if (!db->isOpen())
+        return;
+
+    SchemaResolver resolver(db);
+    QString type;
+    for (const QString& objectType : objectTypes)
+    {
+        if (resolver.getObjects(database, objectType).contains(object, Qt::CaseInsensitive))
+        {
+            type = objectType;
+            break;
+        }
+    }
+
+    QStringList columns;
+    if (type == "table")
+        columns = resolver.getTableColumns(database, object);
+
+    QMutexLocker lock(&mutex);
+    if (!entries.contains(db) || entries[db].generation != generation)
+        return;
+
+    Entry& entry = entries[db];
+    if (!entry.databases.contains(database))
+        return; // database not known to the index (for example detached in the meantime)
+
+    removeObject(entry, database, object);
+    if (type.isNull())
+        return; // the object doesn't exist anymore
+
+    addObject(entry, database, type, object);
+    if (type == "table")
+    {
+        Table& table = entry.databases[database].tables[object.toLower()];
+        table.name = object;
+        table.columns = columns;
+    }
+}
+
+void CompletionIndex::schedule(Entry& entry, const QFuture<void>& future)
+{
+    QMutableListIterator<QFuture<void>> it(entry.pendingWork);
+    while (it.hasNext())
+    {
+        if (it.next().isFinished())
+            it.remove();
+    }
+    entry.pendingWork << future;
+}
+
+void CompletionIndex::scheduleObjectReload(Db* db, const QString& database, const QString& object)
+{
+    // Called with the mutex locked.
+    Entry& entry = entries[db];
+    schedule(entry, QtConcurrent::run(this, &CompletionIndex::runObjectReload, db, entry.generation, database, object));
+}
+
+bool CompletionIndex::handleDdl(Db* db, Entry& entry, SqliteQueryPtr query)
+{
+    // Called with the mutex locked. Returns true if the whole index needs to be rebuilt.
+    switch (query->queryType)
+    {
+        case SqliteQueryType::CreateTable:
+        {
+            SqliteCreateTablePtr createTable = query.dynamicCast<SqliteCreateTable>();
+            QString database = normalizeDatabase(createTable->database, createTable->tempKw || createTable->temporaryKw);
+            if (!entry.databases.contains(database))
+                break;
+
+            if (createTable->ifNotExistsKw && entry.databases[database].tables.contains(createTable->table.toLower()))
+                break; // nothing was created, the existing table stays as it was
+
+            if (createTable->select)
+            {
+                // Columns are known only after the table is created.
+                addObject(entry, database, "table", createTable->table);
+                scheduleObjectReload(db, database, createTable->table);
+                break;
+            }
+
+            addObject(entry, database, "table", createTable->table);
+            Table& table = entry.databases[database].tables[createTable->table.toLower()];
+            table.name = createTable->table;
+            table.columns = createTable->getColumnNames();
+            break;
+        }
+        case SqliteQueryType::CreateVirtualTable:
+        {
+            SqliteCreateVirtualTablePtr createVirtualTable = query.dynamicCast<SqliteCreateVirtualTable>();
+            QString database = normalizeDatabase(createVirtualTable->database);
+            if (!entry.databases.contains(database))
+                break;
+
+            if (createVirtualTable->ifNotExistsKw && entry.databases[database].tables.contains(createVirtualTable->table.toLower()))
+                break;
+
+            addObject(entry, database, "table", createVirtualTable->table);
+            scheduleObjectReload(db, database, createVirtualTable->table);
+            break;
+        }
+        case SqliteQueryType::CreateIndex:
+        {
+            SqliteCreateIndexPtr createIndex = query.dynamicCast<SqliteCreateIndex>();
+            addObject(entry, normalizeDatabase(createIndex->database), "index", createIndex->index);
+            break;
+        }
+        case SqliteQueryType::CreateTrigger:
+        {
+            SqliteCreateTriggerPtr createTrigger = query.dynamicCast<SqliteCreateTrigger>();
+            QString database = normalizeDatabase(createTrigger->database, createTrigger->tempKw || createTrigger->temporaryKw);
+            addObject(entry, database, "trigger", createTrigger->trigger);
+            break;
+        }
+        case SqliteQueryType::CreateView:
+        {
+            SqliteCreateViewPtr createView = query.dynamicCast<SqliteCreateView>();
+            QString database = normalizeDatabase(createView->database, createView->tempKw || createView->temporaryKw);
+            addObject(entry, database, "view", createView->view);
+            break;
+        }
+        case SqliteQueryType::DropIndex:
+        {
+            SqliteDropIndexPtr dropIndex = query.dynamicCast<SqliteDropIndex>();
+            removeObject(entry, normalizeDatabase(dropIndex->database), dropIndex->index);
+            break;
+        }
+        case SqliteQueryType::DropTrigger:
+        {
+            SqliteDropTriggerPtr dropTrigger = query.dynamicCast<SqliteDropTrigger>();
+            removeObject(entry, normalizeDatabase(dropTrigger->database), dropTrigger->trigger);
+            break;
+        }
+        case SqliteQueryType::AlterTable:
+        {
+            SqliteAlterTablePtr alterTable = query.dynamicCast<SqliteAlterTable>();
+            QString database = normalizeDatabase(alterTable->database);
+            if (alterTable->command == SqliteAlterTable::Command::RENAME)
+            {
+                removeObject(entry, database, alterTable->table);
+                scheduleObjectReload(db, database, alterTable->newName);
+            }
+            else
+            {
+                scheduleObjectReload(db, database, alterTable->table);
+            }
+            break;
+        }
+        case SqliteQueryType::DropTable:
+        case SqliteQueryType::DropView:
+            // Dropping a table or a view drops also its indexes and triggers, which are not known from the DDL.
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+bool CompletionIndex::commitDdl(Db* db, Entry& entry)
+{
+    // Called with the mutex locked. Returns true if the whole index needs to be rebuilt.
+    bool rebuild = entry.rebuildOnCommit || !entry.ready;
+    if (!rebuild)
+    {
+        for (const SqliteQueryPtr& query : entry.uncommittedDdl)
+            rebuild |= handleDdl(db, entry, query);
+    }
+
+    entry.uncommittedDdl.clear();
+    entry.inTransaction = false;
+    entry.transactionSavepoint = QString();
+    entry.rebuildOnCommit = false;
+    return rebuild;
+}
+
+void CompletionIndex::addObject(Entry& entry, const QString& database, const QString& type, const QString& name)
+{
+    if (!entry.databases.contains(database))
+        return; // database not known to the index, nothing to update
+
+    QStringList& objects = entry.databases[database].objects[type];
+    if (!objects.contains(name, Qt::CaseInsensitive))
+        insertSorted(objects, name);
+}
+
+void CompletionIndex::removeObject(Entry& entry, const QString& database, const QString& name)
+{
+    if (!entry.databases.contains(database))
+        return;
+
+    Database& dbIndex = entry.databases[database];
+    for (QStringList& objects : dbIndex.objects)
+    {
+        QMutableStringListIterator it(objects);
+        while (it.hasNext())
+        {
+            if (it.next().compare(name, Qt::CaseInsensitive) == 0)
+                it.remove();
+        }
+    }
+    dbIndex.tables.remove(name.toLower());
+}
+
+CompletionIndex::Database* CompletionIndex::getDatabase(Db* db, const QString& database)
+{
+    // Called with the mutex locked.
+    if (!entries.contains(db))
+        return nullptr;
+
+    Entry& entry = entries[db];
+    if (!entry.ready)
+        return nullptr;
+
+    QString normalized = normalizeDatabase(database);
+    if (!entry.databases.contains(normalized))
+        return nullptr;
+
+    return &entry.databases[normalized];
+}
+
+CompletionIndex::Database CompletionIndex::loadDatabase(Db* db, const QString& database)
+{
+    SchemaResolver resolver(db);
+    Database dbIndex;
+    QStringList objects;
+    for (const QString& type : objectTypes)
+    {
+        objects = resolver.getObjects(database, type);
+        std::sort(objects.begin(), objects.end(), [](const QString& s1, const QString& s2)
+        {
+            return s1.compare(s2, Qt::CaseInsensitive) < 0;
+        });
+        dbIndex.objects[type] = objects;
+    }
+
+    for (const QString& tableName : dbIndex.objects["table"])
+    {
+        Table& table = dbIndex.tables[tableName.toLower()];
+        table.name = tableName;
+        table.columns = resolver.getTableColumns(database, tableName);
+    }
+    return dbIndex;
+}
+
+bool CompletionIndex::isDdl(SqliteQueryType queryType)
+{
+    switch (queryType)
+    {
+        case SqliteQueryType::AlterTable:
+        case SqliteQueryType::CreateIndex:
+        case SqliteQueryType::CreateTable:
+        case SqliteQueryType::CreateTrigger:
+        case SqliteQueryType::CreateView:
+        case SqliteQueryType::CreateVirtualTable:
+        case SqliteQueryType::DropIndex:
+        case SqliteQueryType::DropTable:
+        case SqliteQueryType::DropTrigger:
+        case SqliteQueryType::DropView:
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+QString CompletionIndex::normalizeDatabase(const QString& database)
+{
+    if (database.isEmpty())
+        return "main";
+
+    return database.toLower();
+}
+
+QString CompletionIndex::normalizeDatabase(const QString& database, bool temp)
+{
+    if (temp)
+        return "temp";
+
+    return normalizeDatabase(database);
+}
+
+void CompletionIndex::insertSorted(QStringList& list, const QString& value)
+{
+    QStringList::iterator it = std::lower_bound(list.begin(), list.end(), value, [](const QString& s1, const QString& s2)
+    {
+        return s1.compare(s2, Qt::CaseInsensitive) < 0;
+    });
+    list.insert(it, value);
+}
+
+void CompletionIndex::handleObjectChanged(Db* db, const QString& database, const QString& object)
+{
+    QMutexLocker lock(&mutex);
+    if (!entries.contains(db) || !entries[db].ready)
+        return;
+
+    scheduleObjectReload(db, normalizeDatabase(database), object);
+}
+
+void CompletionIndex::handleObjectDeleted(Db* db, const QString& database, const QString& object)
+{
+    QMutexLocker lock(&mutex);
+    if (!entries.contains(db) || !entries[db].ready)
+        return;
+
+    removeObject(entries[db], normalizeDatabase(database), object);
+}
+
+void CompletionIndex::handleObjectRenamed(Db* db, const QString& database, const QString& oldObject, const QString& newObject)
+{
+    QMutexLocker lock(&mutex);
+    if (!entries.contains(db) || !entries[db].ready)
+        return;
+
+    QString normalized = normalizeDatabase(database);
+    removeObject(entries[db], normalized, oldObject);
+    scheduleObjectReload(db, normalized, newObject);
+}
@@ -0,0 +1,164 @@
+#ifndef COMPLETIONINDEX_H
+#define COMPLETIONINDEX_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/global.h"
+#include "parser/ast/sqlitequery.h"
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QFuture>
+#include <QStringList>
+
+class Db;
+
+/**
+ * @brief Per-database index of object and column names used by the code completion.
+ *
+ * The index is built in a background thread as soon as the database gets connected, so CompletionHelper
+ * can provide names of tables, indexes, triggers, views and columns without querying the database schema
+ * at the moment when the completion popup is being opened. Names are kept in lists sorted case-insensitively,
+ * grouped by the object type, while columns are grouped by the table.
+ *
+ * The index is updated incrementally when objects are created, dropped or modified, either by queries
+ * executed with QueryExecutor (see handleDdl()), or by any other code announcing changes through NotifyManager.
+ * DDL executed inside of a transaction is applied once the transaction is committed and forgotten when it's rolled back.
+ * ATTACH and DETACH cause the index to be rebuilt.
+ * Changes that cannot be reflected directly from the DDL (like new columns of CREATE TABLE AS SELECT)
+ * are reloaded in the background for the affected object only.
+ *
+ * Until the index for the database is ready, all getters return false, so the caller should fall back
+ * to using SchemaResolver directly.
+ */
+class API_EXPORT CompletionIndex : public QObject
+{
+    Q_OBJECT
+
+    DECLARE_SINGLETON(CompletionIndex)
+
+    public:
+        CompletionIndex();
+        ~CompletionIndex();
+
+        /**
+         * @brief Connects the index with application services.
+         *
+         * It's called by SQLiteStudio during initialization, after DbManager was created.
+         * Databases already open at that moment get their index built.
+         */
+        void init();
+
+        /**
+         * @brief Schedules (re)building of the index for given database.
+         * @param db Database to build index for.
+         *
+         * The index is built in a background thread. Until it's finished, previous index (if any) is not used.
+         */
+        void build(Db* db);
+
+        /**
+         * @brief Drops index for given database.
+         * @param db Database to drop index for.
+         *
+         * Waits for any background work for the database to finish.
+         */
+        void remove(Db* db);
+
+        bool isReady(Db* db);
+
+        /**
+         * @brief Waits until all scheduled background work for the database is finished.
+         * @param db Database to wait for.
+         */
+        void waitForReady(Db* db);
+
+        /**
+         * @brief Provides names of objects of given type.
+         * @param db Database to get names for.
+         * @param database Attach name ("main", "temp", or any attached database name). Null means "main".
+         * @param type Object type, one of: table, index, trigger, view.
+         * @param objects Output list, sorted case-insensitively.
+         * @return true if the index was ready for the database, or false if the caller should ask the schema itself.
+         */
+        bool getObjects(Db* db, const QString& database, const QString& type, QStringList& objects);
+
+        /**
+         * @brief Provides column names of the table.
+         * @param db Database to get columns for.
+         * @param database Attach name. Null means "main".
+         * @param table Table name (case insensitive).
+         * @param columns Output list, in the table's order.
+         * @return true if the index was ready for the database, or false if the caller should ask the schema itself.
+         */
+        bool getTableColumns(Db* db, const QString& database, const QString& table, QStringList& columns);
+
+        /**
+         * @brief Provides column names of all tables in the database.
+         * @param db Database to get columns for.
+         * @param database Attach name. Null means "main".
+         * @param columns Output hash of table name to list of its columns.
+         * @return true if the index was ready for the database, or false if the caller should ask the schema itself.
+         */
+        bool getAllTableColumns(Db* db, const QString& database, QHash<QString, QStringList>& columns);
+
+        /**
+         * @brief Updates index with DDL queries that were successfully executed.
+         * @param db Database that the queries were executed on.
+         * @param queries Executed queries. Transaction control and ATTACH/DETACH queries are tracked,
+         * other queries that don't modify the schema are ignored.
+         */
+        void handleDdl(Db* db, const QList<SqliteQueryPtr>& queries);
+
+    private:
+        struct Table
+        {
+            QString name;
+            QStringList columns;
+        };
+
+        struct Database
+        {
+            QHash<QString, QStringList> objects;
+            QHash<QString, Table> tables;
+        };
+
+        struct Entry
+        {
+            QHash<QString, Database> databases;
+            QList<QFuture<void>> pendingWork;
+            bool ready = false;
+            int generation = 0;
+            bool inTransaction = false;
+            QString transactionSavepoint;
+            QList<SqliteQueryPtr> uncommittedDdl;
+            bool rebuildOnCommit = false;
+        };
+
+        void runBuild(Db* db, int generation);
+        void runObjectReload(Db* db, int generation, const QString& database, const QString& object);
+        void schedule(Entry& entry, const QFuture<void>& future);
+        void scheduleObjectReload(Db* db, const QString& database, const QString& object);
+        bool handleDdl(Db* db, Entry& entry, SqliteQueryPtr query);
+        bool commitDdl(Db* db, Entry& entry);
+        void addObject(Entry& entry, const QString& database, const QString& type, const QString& name);
+        void removeObject(Entry& entry, const QString& database, const QString& name);
+        Database* getDatabase(Db* db, const QString& database);
+
+        static Database loadDatabase(Db* db, const QString& database);
+        static bool isDdl(SqliteQueryType queryType);
+        static QString normalizeDatabase(const QString& database);
+        static QString normalizeDatabase(const QString& database, bool temp);
+        static void insertSorted(QStringList& list, const QString& value);
+
+        QHash<Db*, Entry> entries;
+        QMutex mutex;
+
+    private slots:
+        void handleObjectChanged(Db* db, const QString& database, const QString& object);
+        void handleObjectDeleted(Db* db, const QString& database, const QString& object);
+        void handleObjectRenamed(Db* db, const QString& database, const QString& oldObject, const QString& newObject);
+};
+
+#define COMPLETION_INDEX CompletionIndex::getInstance()
+
+#endif // COMPLETIONINDEX_H
@@ -128,8 +128,12 @@ SOURCES += sqlitestudio.cpp \
     db/sqlresultsrow.cpp \
     db/asyncqueryrunner.cpp \
     completionhelper.cpp \
+    completionindex.cpp \
     completioncomparer.cpp \
     db/queryexecutor.cpp \
+    db/queryplancache.cpp \
+    db/storageanalyzer.cpp \
+    db/columnprofiler.cpp \
     qio.cpp \
     plugins/pluginsymbolresolver.cpp \
     db/sqlerrorresults.cpp \
@@ -140,6 +144,7 @@ SOURCES += sqlitestudio.cpp \
     db/queryexecutorsteps/queryexecutorattaches.cpp \
     db/queryexecutorsteps/queryexecutoraddrowids.cpp \
     db/queryexecutorsteps/queryexecutorlimit.cpp \
+    db/queryexecutorsteps/queryexecutorstoreplan.cpp \
     db/queryexecutorsteps/queryexecutorcolumns.cpp \
     db/queryexecutorsteps/queryexecutorcellsize.cpp \
     db/queryexecutorsteps/queryexecutororder.cpp \
@@ -148,6 +153,7 @@ SOURCES += sqlitestudio.cpp \
     db/queryexecutorsteps/queryexecutorwrapdistinctresults.cpp \
     csvformat.cpp \
     csvserializer.cpp \
+    dsvwriter.cpp \
     db/queryexecutorsteps/queryexecutordatasources.cpp \
     expectedtoken.cpp \
     sqlhistorymodel.cpp \
@@ -189,9 +195,11 @@ SOURCES += sqlitestudio.cpp \
     plugins/genericexportplugin.cpp \
     dbobjectorganizer.cpp \
     db/attachguard.cpp \
+    db/dbfileprober.cpp \
     db/invaliddb.cpp \
     dbversionconverter.cpp \
     diff/diff_match_patch.cpp \
+    diff/linediff.cpp \
     db/sqlquery.cpp \
     db/queryexecutorsteps/queryexecutorvaluesmode.cpp \
     services/importmanager.cpp \
@@ -232,7 +240,8 @@ SOURCES += sqlitestudio.cpp \
     common/xmldeserializer.cpp \
     services/impl/sqliteextensionmanagerimpl.cpp \
     common/lazytrigger.cpp \
-    parser/ast/sqliteupsert.cpp
+    parser/ast/sqliteupsert.cpp \
+    common/exportoutputbuffer.cpp
 
 HEADERS += sqlitestudio.h\
         coreSQLiteStudio_global.h \
@@ -300,11 +309,15 @@ HEADERS += sqlitestudio.h\
     db/sqlresultsrow.h \
     db/asyncqueryrunner.h \
     completionhelper.h \
+    completionindex.h \
     expectedtoken.h \
     completioncomparer.h \
     plugins/dbplugin.h \
     services/pluginmanager.h \
     db/queryexecutor.h \
+    db/queryplancache.h \
+    db/storageanalyzer.h \
+    db/columnprofiler.h \
     qio.h \
     db/dbpluginoption.h \
     common/global.h \
@@ -319,6 +332,7 @@ HEADERS += sqlitestudio.h\
     db/queryexecutorsteps/queryexecutorattaches.h \
     db/queryexecutorsteps/queryexecutoraddrowids.h \
     db/queryexecutorsteps/queryexecutorlimit.h \
+    db/queryexecutorsteps/queryexecutorstoreplan.h \
     db/queryexecutorsteps/queryexecutorcolumns.h \
     db/queryexecutorsteps/queryexecutorcellsize.h \
     common/unused.h \
@@ -327,6 +341,7 @@ HEADERS += sqlitestudio.h\
     db/queryexecutorsteps/queryexecutorwrapdistinctresults.h \
     csvformat.h \
     csvserializer.h \
+    dsvwriter.h \
     db/queryexecutorsteps/queryexecutordatasources.h \
     sqlhistorymodel.h \
     db/queryexecutorsteps/queryexecutorexplainmode.h \
@@ -379,10 +394,12 @@ HEADERS += sqlitestudio.h\
     plugins/genericexportplugin.h \
     dbobjectorganizer.h \
     db/attachguard.h \
+    db/dbfileprober.h \
     interruptable.h \
     db/invaliddb.h \
     dbversionconverter.h \
     diff/diff_match_patch.h \
+    diff/linediff.h \
     db/sqlquery.h \
     dbobjecttype.h \
     db/queryexecutorsteps/queryexecutorvaluesmode.h \
@@ -434,7 +451,8 @@ HEADERS += sqlitestudio.h\
     services/sqliteextensionmanager.h \
     services/impl/sqliteextensionmanagerimpl.h \
     common/lazytrigger.h \
-    parser/ast/sqliteupsert.h
+    parser/ast/sqliteupsert.h \
+    common/exportoutputbuffer.h
 
 unix: {
     target.path = $$LIBDIR
@@ -1,4 +1,5 @@
 #include "csvserializer.h"
+#include "dsvwriter.h"
 #include <QStringList>
 #include <QList>
 #include <QDebug>
@@ -185,34 +186,19 @@ QList<T> typedDeserializeOneEntry(QTextStream& data, const CsvFormat& format)
 
 QString CsvSerializer::serialize(const QList<QStringList>& data, const CsvFormat& format)
 {
-    QStringList outputRows;
-
+    DsvWriter writer(format.columnSeparator, format.rowSeparator, true);
+    writer.reserve(writer.estimateSize(data));
     for (const QStringList& dataRow : data)
-        outputRows << serialize(dataRow, format);
+        writer.appendRow(dataRow);
 
-    return outputRows.join(format.rowSeparator);
+    return writer.getOutput();
 }
 
 QString CsvSerializer::serialize(const QStringList& data, const CsvFormat& format)
 {
-    QString value;
-    bool hasQuote;
-    QStringList outputCells;
-    for (const QString& rowValue : data)
-    {
-        value = rowValue;
-
-        hasQuote = value.contains("\"");
-        if (hasQuote)
-            value.replace("\"", "\"\"");
-
-        if (hasQuote || value.contains(format.columnSeparator) || value.contains(format.rowSeparator))
-            value = "\""+value+"\"";
-
-        outputCells << value;
-    }
-
-    return outputCells.join(format.columnSeparator);
+    DsvWriter writer(format.columnSeparator, format.rowSeparator, true);
+    writer.appendRow(data);
+    return writer.getOutput();
 }
 
 QStringList CsvSerializer::deserializeOneEntry(QTextStream& data, const CsvFormat& format)
@@ -47,6 +47,7 @@ class AbstractDb2 : public AbstractDb
         ~AbstractDb2();
 
         bool loadExtension(const QString& filePath, const QString& initFunc = QString());
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable);
         bool isComplete(const QString& sql) const;
 
     protected:
@@ -165,6 +166,19 @@ bool AbstractDb2<T>::loadExtension(const QString& filePath, const QString& initF
     return false;
 }
 
+template <class T>
+QIODevice* AbstractDb2<T>::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(writable);
+    dbErrorCode = SQLITE_ERROR;
+    dbErrorMessage = QObject::tr("SQLite 2 does not support incremental BLOB access.");
+    return nullptr;
+}
+
 template<class T>
 bool AbstractDb2<T>::isComplete(const QString& sql) const
 {
@@ -11,6 +11,7 @@
 #include "log.h"
 #include <QThread>
 #include <QPointer>
+#include <QIODevice>
 #include <QDebug>
 
 /**
@@ -46,6 +47,7 @@ class AbstractDb3 : public AbstractDb
 
         bool loadExtension(const QString& filePath, const QString& initFunc = QString());
         bool isComplete(const QString& sql) const;
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable);
 
     protected:
         bool isOpenInternal();
@@ -64,6 +66,36 @@ class AbstractDb3 : public AbstractDb
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
 
+        /**
+         * @brief Provides native handle of the open database.
+         * @return Database handle, or null if the database is not open.
+         *
+         * Lets derived classes use driver API which is specific to them, like registering their own SQL functions.
+         */
+        typename T::handle* getHandle() const;
+
+        /**
+         * @brief Stores given result in function's context.
+         * @param context Custom SQL function call context.
+         * @param result Value returned from function execution.
+         * @param ok true if the result is from a successful execution, or false if the result contains error message (QString).
+         *
+         * This method is called after custom implementation of the function was evaluated and it returned the result.
+         * It stores the result in function's context, so it becomes the result of the function call.
+         */
+        static void storeResult(typename T::context* context, const QVariant& result, bool ok);
+
+        /**
+         * @brief Converts SQLite arguments into the list of argument values.
+         * @param argCount Number of arguments.
+         * @param args SQLite argument values.
+         * @return Convenient Qt list with argument values as QVariant.
+         *
+         * This function does necessary conversions reflecting internal SQLite datatype, so if the type
+         * was for example BLOB, then the QVariant will be a QByteArray, etc.
+         */
+        static QList<QVariant> getArgs(int argCount, typename T::value** args);
+
     private:
         class Query : public SqlQuery
         {
@@ -113,6 +145,34 @@ class AbstractDb3 : public AbstractDb
                 bool rowAvailable = false;
         };
 
+        /**
+         * @brief Device for incremental I/O on a single BLOB value.
+         *
+         * Reads and writes go directly to the SQLite blob handle, at the current position of the device,
+         * so the device is unbuffered. The handle is released when the device is closed, or when the database
+         * is closed (then the device is closed as well).
+         */
+        class Blob : public QIODevice
+        {
+            public:
+                Blob(AbstractDb3<T>* db, typename T::blob* blob);
+                ~Blob();
+
+                qint64 size() const;
+                void close();
+
+            protected:
+                qint64 readData(char* data, qint64 maxSize);
+                qint64 writeData(const char* data, qint64 maxSize);
+
+            private:
+                bool checkBlobState();
+
+                QPointer<AbstractDb3<T>> db;
+                typename T::blob* blob = nullptr;
+                qint64 blobSize = 0;
+        };
+
         struct CollationUserData
         {
             QString name;
@@ -133,28 +193,6 @@ class AbstractDb3 : public AbstractDb
          */
         void registerDefaultCollationRequestHandler();
 
-        /**
-         * @brief Stores given result in function's context.
-         * @param context Custom SQL function call context.
-         * @param result Value returned from function execution.
-         * @param ok true if the result is from a successful execution, or false if the result contains error message (QString).
-         *
-         * This method is called after custom implementation of the function was evaluated and it returned the result.
-         * It stores the result in function's context, so it becomes the result of the function call.
-         */
-        static void storeResult(typename T::context* context, const QVariant& result, bool ok);
-
-        /**
-         * @brief Converts SQLite arguments into the list of argument values.
-         * @param argCount Number of arguments.
-         * @param args SQLite argument values.
-         * @return Convenient Qt list with argument values as QVariant.
-         *
-         * This function does necessary conversions reflecting internal SQLite datatype, so if the type
-         * was for example BLOB, then the QVariant will be a QByteArray, etc.
-         */
-        static QList<QVariant> getArgs(int argCount, typename T::value** args);
-
         /**
          * @brief Evaluates requested function using defined implementation code and provides result.
          * @param context SQL function call context.
@@ -291,6 +329,7 @@ class AbstractDb3 : public AbstractDb
         QString dbErrorMessage;
         int dbErrorCode = T::OK;
         QList<Query*> queries;
+        QList<Blob*> blobs;
 
         /**
          * @brief User data for default collation request handling function.
@@ -343,12 +382,48 @@ bool AbstractDb3<T>::isComplete(const QString& sql) const
     return T::complete(sql.toUtf8().constData());
 }
 
+template<class T>
+QIODevice* AbstractDb3<T>::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable)
+{
+    QWriteLocker locker(&dbOperLock);
+    resetError();
+    if (!dbHandle)
+    {
+        dbErrorMessage = QObject::tr("Could not open BLOB value, because the database is not open.");
+        dbErrorCode = SqlErrorCode::DB_NOT_OPEN;
+        return nullptr;
+    }
+
+    typename T::blob* blob = nullptr;
+    QByteArray dbName = (database.isEmpty() ? QString("main") : database).toUtf8();
+    int res = T::blob_open(dbHandle, dbName.constData(), table.toUtf8().constData(), column.toUtf8().constData(), rowId, writable ? 1 : 0, &blob);
+    if (res != T::OK)
+    {
+        dbErrorMessage = QObject::tr("Could not open BLOB value: %1").arg(extractLastError());
+        dbErrorCode = res;
+        if (blob)
+            T::blob_close(blob);
+
+        return nullptr;
+    }
+
+    Blob* device = new Blob(this, blob);
+    device->open((writable ? QIODevice::ReadWrite : QIODevice::ReadOnly) | QIODevice::Unbuffered);
+    return device;
+}
+
 template <class T>
 bool AbstractDb3<T>::isOpenInternal()
 {
     return dbHandle != nullptr;
 }
 
+template <class T>
+typename T::handle* AbstractDb3<T>::getHandle() const
+{
+    return dbHandle;
+}
+
 template <class T>
 void AbstractDb3<T>::interruptExecution()
 {
@@ -527,6 +602,11 @@ void AbstractDb3<T>::cleanUp()
     for (Query* q : queries)
         q->finalize();
 
+    // Closing the blob removes it from the list
+    QList<Blob*> openBlobs = blobs;
+    for (Blob* blob : openBlobs)
+        blob->close();
+
     safe_delete(defaultCollationUserData);
 }
 
@@ -793,6 +873,101 @@ void AbstractDb3<T>::registerDefaultCollationRequestHandler()
         qWarning() << "Could not register default collation request handler. Unknown collations will cause errors.";
 }
 
+//------------------------------------------------------------------------------------
+// Blob
+//------------------------------------------------------------------------------------
+
+template <class T>
+AbstractDb3<T>::Blob::Blob(AbstractDb3<T>* db, typename T::blob* blob) :
+    db(db), blob(blob)
+{
+    blobSize = T::blob_bytes(blob);
+    db->blobs << this;
+}
+
+template <class T>
+AbstractDb3<T>::Blob::~Blob()
+{
+    close();
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::size() const
+{
+    return blobSize;
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::close()
+{
+    if (blob)
+    {
+        T::blob_close(blob);
+        blob = nullptr;
+    }
+
+    if (!db.isNull())
+        db->blobs.removeOne(this);
+
+    QIODevice::close();
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::readData(char* data, qint64 maxSize)
+{
+    if (!checkBlobState())
+        return -1;
+
+    qint64 offset = pos();
+    int length = static_cast<int>(qMin(maxSize, blobSize - offset));
+    if (length <= 0)
+        return 0;
+
+    QReadLocker locker(&db->dbOperLock);
+    int res = T::blob_read(blob, data, length, static_cast<int>(offset));
+    if (res != T::OK)
+    {
+        setErrorString(QString::fromUtf8(T::errmsg(db->dbHandle)));
+        return -1;
+    }
+    return length;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::writeData(const char* data, qint64 maxSize)
+{
+    if (!checkBlobState())
+        return -1;
+
+    qint64 offset = pos();
+    int length = static_cast<int>(qMin(maxSize, blobSize - offset));
+    if (length <= 0)
+    {
+        setErrorString(QObject::tr("Cannot write beyond the end of BLOB value. Its size cannot be changed."));
+        return -1;
+    }
+
+    QWriteLocker locker(&db->dbOperLock);
+    int res = T::blob_write(blob, data, length, static_cast<int>(offset));
+    if (res != T::OK)
+    {
+        setErrorString(QString::fromUtf8(T::errmsg(db->dbHandle)));
+        return -1;
+    }
+    return length;
+}
+
+template <class T>
+bool AbstractDb3<T>::Blob::checkBlobState()
+{
+    if (db.isNull() || !db->dbHandle || !blob)
+    {
+        setErrorString(QObject::tr("BLOB value is no longer accessible, because its database was closed."));
+        return false;
+    }
+    return true;
+}
+
 //------------------------------------------------------------------------------------
 // Results
 //------------------------------------------------------------------------------------
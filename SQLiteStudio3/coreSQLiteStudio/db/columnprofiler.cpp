@@ -0,0 +1,443 @@
+#include "columnprofiler.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "schemaresolver.h"
+#include "common/utils_sql.h"
+#include "services/pluginmanager.h"
+#include "plugins/dbplugin.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QFileInfo>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+
+ColumnProfiler::HyperLogLog::HyperLogLog(int precision) :
+    precision(precision), registers(1 << precision, 0)
+{
+}
+
+void ColumnProfiler::HyperLogLog::add(quint64 hash)
+{
+    int idx = static_cast<int>(hash >> (64 - precision));
+    quint64 rest = hash << precision;
+    quint8 rank = static_cast<quint8>(rest == 0 ? (64 - precision + 1) : (qCountLeadingZeroBits(rest) + 1));
+    if (rank > registers[idx])
+        registers[idx] = rank;
+}
+
+qint64 ColumnProfiler::HyperLogLog::estimate() const
+{
+    int m = registers.size();
+    double sum = 0.0;
+    int zeros = 0;
+    for (quint8 reg : registers)
+    {
+        sum += 1.0 / static_cast<double>(1ULL << reg);
+        if (reg == 0)
+            zeros++;
+    }
+
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Small range correction (linear counting). With 64-bit hashes there is no need for the large range correction.
+    if (estimate <= 2.5 * m && zeros > 0)
+        estimate = m * qLn(static_cast<double>(m) / zeros);
+
+    return qRound64(estimate);
+}
+
+quint64 ColumnProfiler::HyperLogLog::hash(const QByteArray& data)
+{
+    // FNV-1a, followed by the splitmix64 finalizer to spread bits of short keys
+    quint64 hash = 14695981039346656037ULL;
+    for (char c : data)
+    {
+        hash ^= static_cast<quint8>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+ColumnProfiler::TopValues::TopValues(int capacity) :
+    capacity(capacity)
+{
+    heap.reserve(capacity);
+}
+
+void ColumnProfiler::TopValues::add(const QByteArray& key, const QVariant& value)
+{
+    auto it = positions.constFind(key);
+    if (it != positions.constEnd())
+    {
+        int idx = it.value();
+        heap[idx].count++;
+        siftDown(idx);
+        return;
+    }
+
+    if (heap.size() < capacity)
+    {
+        Counter counter;
+        counter.key = key;
+        counter.value = value;
+        counter.count = 1;
+        heap << counter;
+        positions[key] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+        return;
+    }
+
+    // The least frequent value is replaced. The new one inherits its count as a possible error.
+    Counter& counter = heap[0];
+    positions.remove(counter.key);
+    counter.error = counter.count;
+    counter.count++;
+    counter.key = key;
+    counter.value = value;
+    positions[key] = 0;
+    siftDown(0);
+}
+
+QList<ColumnProfiler::ValueCount> ColumnProfiler::TopValues::getTop(int count) const
+{
+    QVector<Counter> sorted = heap;
+    std::sort(sorted.begin(), sorted.end(), [](const Counter& c1, const Counter& c2)
+    {
+        return c1.count > c2.count;
+    });
+
+    QList<ValueCount> results;
+    ValueCount valueCount;
+    for (int i = 0, total = qMin(count, sorted.size()); i < total; i++)
+    {
+        valueCount.value = sorted[i].value;
+        valueCount.count = sorted[i].count;
+        valueCount.error = sorted[i].error;
+        results << valueCount;
+    }
+    return results;
+}
+
+void ColumnProfiler::TopValues::siftUp(int idx)
+{
+    int parent;
+    while (idx > 0)
+    {
+        parent = (idx - 1) / 2;
+        if (heap[parent].count <= heap[idx].count)
+            break;
+
+        swapCounters(idx, parent);
+        idx = parent;
+    }
+}
+
+void ColumnProfiler::TopValues::siftDown(int idx)
+{
+    int size = heap.size();
+    int smallest;
+    int child;
+    while (true)
+    {
+        smallest = idx;
+        child = idx * 2 + 1;
+        if (child < size && heap[child].count < heap[smallest].count)
+            smallest = child;
+
+        child++;
+        if (child < size && heap[child].count < heap[smallest].count)
+            smallest = child;
+
+        if (smallest == idx)
+            break;
+
+        swapCounters(idx, smallest);
+        idx = smallest;
+    }
+}
+
+void ColumnProfiler::TopValues::swapCounters(int idx1, int idx2)
+{
+    std::swap(heap[idx1], heap[idx2]);
+    positions[heap[idx1].key] = idx1;
+    positions[heap[idx2].key] = idx2;
+}
+
+ColumnProfiler::Accumulator::Accumulator(int topValuesCount) :
+    topValuesCount(topValuesCount), topValues(topValuesCount * 10)
+{
+}
+
+void ColumnProfiler::Accumulator::add(const QString& type, const QVariant& value)
+{
+    rows++;
+    if (type == "null" || value.isNull())
+    {
+        nulls++;
+        types["null"]++;
+        return;
+    }
+
+    types[type]++;
+
+    int rank = typeRank(type);
+    QByteArray key;
+    key.append(static_cast<char>('0' + rank));
+    switch (rank)
+    {
+        case 1:
+        {
+            if (type == "integer")
+                key.append(QByteArray::number(value.toLongLong()));
+            else
+                key.append(QByteArray::number(value.toDouble(), 'g', 17));
+
+            break;
+        }
+        case 2:
+        {
+            QString text = value.toString();
+            key.append(text.toUtf8());
+            lengthValues++;
+            totalLength += text.length();
+            minLength = (lengthValues == 1) ? text.length() : qMin(minLength, static_cast<qint64>(text.length()));
+            maxLength = qMax(maxLength, static_cast<qint64>(text.length()));
+            break;
+        }
+        default:
+        {
+            QByteArray bytes = value.toByteArray();
+            key.append(bytes);
+            lengthValues++;
+            totalLength += bytes.size();
+            minLength = (lengthValues == 1) ? bytes.size() : qMin(minLength, static_cast<qint64>(bytes.size()));
+            maxLength = qMax(maxLength, static_cast<qint64>(bytes.size()));
+            break;
+        }
+    }
+
+    distinct.add(HyperLogLog::hash(key));
+    topValues.add(key, value);
+
+    if (min.isNull() || compare(rank, value, minRank, min) < 0)
+    {
+        min = value;
+        minRank = rank;
+    }
+
+    if (max.isNull() || compare(rank, value, maxRank, max) > 0)
+    {
+        max = value;
+        maxRank = rank;
+    }
+}
+
+ColumnProfiler::ColumnProfile ColumnProfiler::Accumulator::getProfile(const QString& column) const
+{
+    ColumnProfile profile;
+    profile.column = column;
+    profile.rows = rows;
+    profile.nulls = nulls;
+    profile.distinct = (rows > nulls) ? qMin(distinct.estimate(), rows - nulls) : 0;
+    profile.min = min;
+    profile.max = max;
+    profile.types = types;
+    profile.lengthValues = lengthValues;
+    profile.minLength = minLength;
+    profile.maxLength = maxLength;
+    profile.avgLength = (lengthValues > 0) ? static_cast<double>(totalLength) / lengthValues : 0.0;
+    profile.topValues = topValues.getTop(topValuesCount);
+    return profile;
+}
+
+int ColumnProfiler::Accumulator::typeRank(const QString& type)
+{
+    if (type == "integer" || type == "real")
+        return 1;
+
+    if (type == "text")
+        return 2;
+
+    return 3;
+}
+
+int ColumnProfiler::Accumulator::compare(int rank1, const QVariant& value1, int rank2, const QVariant& value2)
+{
+    if (rank1 != rank2)
+        return rank1 - rank2;
+
+    switch (rank1)
+    {
+        case 1:
+        {
+            if (value1.type() == QVariant::LongLong && value2.type() == QVariant::LongLong)
+            {
+                qint64 int1 = value1.toLongLong();
+                qint64 int2 = value2.toLongLong();
+                return (int1 < int2) ? -1 : (int1 > int2 ? 1 : 0);
+            }
+
+            double num1 = value1.toDouble();
+            double num2 = value2.toDouble();
+            return (num1 < num2) ? -1 : (num1 > num2 ? 1 : 0);
+        }
+        case 2:
+            return value1.toString().compare(value2.toString());
+        default:
+            break;
+    }
+
+    QByteArray bytes1 = value1.toByteArray();
+    QByteArray bytes2 = value2.toByteArray();
+    return (bytes1 < bytes2) ? -1 : (bytes1 > bytes2 ? 1 : 0);
+}
+
+bool ColumnProfiler::Report::isValid() const
+{
+    return errorMessage.isNull();
+}
+
+ColumnProfiler::Report ColumnProfiler::profile(Db* db, const QString& database, const QString& table, const QStringList& columns,
+                                               qint64 sampleLimit)
+{
+    Report report;
+    report.table = table;
+
+    QStringList columnsToProfile = columns;
+    if (columnsToProfile.isEmpty())
+    {
+        SchemaResolver resolver(db);
+        columnsToProfile = resolver.getTableColumns(database, table);
+    }
+
+    if (columnsToProfile.isEmpty())
+    {
+        report.errorMessage = QObject::tr("Could not read columns of table %1.").arg(table);
+        return report;
+    }
+
+    Dialect dialect = db->getDialect();
+    QString dbName = database.isEmpty() ? "main" : database;
+    QString source = wrapObjIfNeeded(dbName, dialect) + "." + wrapObjIfNeeded(table, dialect);
+
+    Db* bgDb = openBackgroundConnection(db, database);
+    profile(bgDb ? bgDb : db, source, columnsToProfile, sampleLimit, report);
+    if (bgDb)
+    {
+        bgDb->closeQuiet();
+        delete bgDb;
+    }
+    return report;
+}
+
+QFuture<ColumnProfiler::Report> ColumnProfiler::profileAsync(Db* db, const QString& database, const QString& table, const QStringList& columns,
+                                                             qint64 sampleLimit)
+{
+    Report (*profileFn)(Db*, const QString&, const QString&, const QStringList&, qint64) = &ColumnProfiler::profile;
+    return QtConcurrent::run(profileFn, db, database, table, columns, sampleLimit);
+}
+
+void ColumnProfiler::profile(Db* db, const QString& source, const QStringList& columns, qint64 sampleLimit, ColumnProfiler::Report& report)
+{
+    static_qstring(countSql, "SELECT count(*) FROM %1");
+    static_qstring(profileSql, "SELECT %1 FROM %2");
+    static_qstring(sampleSql, "SELECT %1 FROM %2 WHERE abs(random() % %3) < %4");
+    static_qstring(columnTpl, "typeof(%1), %1");
+    static const qint64 sampleBase = 1000000;
+
+    SqlQueryPtr results = db->exec(countSql.arg(source));
+    if (results->isError())
+    {
+        report.errorMessage = results->getErrorText();
+        return;
+    }
+    report.totalRows = results->getSingleCell().toLongLong();
+
+    Dialect dialect = db->getDialect();
+    QStringList resultColumns;
+    for (const QString& column : columns)
+        resultColumns << columnTpl.arg(wrapObjIfNeeded(column, dialect));
+
+    QString sql;
+    if (sampleLimit > 0 && report.totalRows > sampleLimit)
+    {
+        // Bernoulli sampling. It still reads all rows, but only the sample is transferred and accumulated.
+        qint64 threshold = qMax(1LL, static_cast<qint64>(sampleBase * static_cast<double>(sampleLimit) / report.totalRows));
+        sql = sampleSql.arg(resultColumns.join(", "), source, QString::number(sampleBase), QString::number(threshold));
+        report.sampled = true;
+    }
+    else
+    {
+        sql = profileSql.arg(resultColumns.join(", "), source);
+    }
+
+    results = db->exec(sql);
+    if (results->isError())
+    {
+        report.errorMessage = results->getErrorText();
+        return;
+    }
+
+    QVector<Accumulator> accumulators(columns.size());
+    SqlResultsRowPtr row;
+    int colCount = columns.size();
+    while (results->hasNext())
+    {
+        row = results->next();
+        const QList<QVariant>& values = row->valueList();
+        for (int i = 0; i < colCount; i++)
+            accumulators[i].add(values[i * 2].toString(), values[i * 2 + 1]);
+
+        report.scannedRows++;
+    }
+
+    if (results->isError())
+    {
+        report.errorMessage = results->getErrorText();
+        return;
+    }
+
+    for (int i = 0; i < colCount; i++)
+        report.columns << accumulators[i].getProfile(columns[i]);
+}
+
+Db* ColumnProfiler::openBackgroundConnection(Db* db, const QString& database)
+{
+    // Attached and temporary databases are visible only to the original connection
+    if (!database.isEmpty() && database.compare("main", Qt::CaseInsensitive) != 0)
+        return nullptr;
+
+    QString path = db->getPath();
+    if (path.isEmpty() || path == ":memory:" || !QFileInfo(path).isFile())
+        return nullptr;
+
+    QHash<QString, QVariant> options = db->getConnectionOptions();
+    DbPlugin* plugin = dynamic_cast<DbPlugin*>(PLUGINS->getLoadedPlugin(options[DB_PLUGIN].toString()));
+    if (!plugin)
+        return nullptr;
+
+    QString errorMessage;
+    Db* bgDb = plugin->getInstance(db->getName(), path, options, &errorMessage);
+    if (!bgDb)
+    {
+        qDebug() << "Could not create background connection for column profiling:" << errorMessage;
+        return nullptr;
+    }
+
+    if (!bgDb->initAfterCreated() || !bgDb->openQuiet())
+    {
+        qDebug() << "Could not open background connection for column profiling:" << bgDb->getErrorText();
+        delete bgDb;
+        return nullptr;
+    }
+
+    bgDb->exec("PRAGMA query_only = 1");
+    return bgDb;
+}
@@ -0,0 +1,177 @@
+#ifndef COLUMNPROFILER_H
+#define COLUMNPROFILER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <QFuture>
+
+class Db;
+
+/**
+ * @brief Computes statistics of column values in a single pass through the table.
+ *
+ * All requested columns are profiled by one query, which reads every row (or a random sample of rows
+ * for tables bigger than the sample limit) only once. Statistics are collected by Accumulator,
+ * which keeps constant memory per column:
+ * <ul>
+ * <li>number of nulls,</li>
+ * <li>estimated number of distinct values (HyperLogLog),</li>
+ * <li>minimum and maximum value (in SQLite ordering: numbers, then text, then blobs),</li>
+ * <li>histogram of value types (as reported by typeof()),</li>
+ * <li>length of text and blob values,</li>
+ * <li>most frequent values (space-saving algorithm, counts are upper bounds with known error).</li>
+ * </ul>
+ *
+ * For local database files the query is executed on a separate, read-only connection, so the database
+ * stays responsive for other work. Otherwise the query is executed on the given database.
+ */
+class API_EXPORT ColumnProfiler
+{
+    public:
+        /**
+         * @brief Estimates the number of distinct values, using fixed amount of memory.
+         */
+        class API_EXPORT HyperLogLog
+        {
+            public:
+                explicit HyperLogLog(int precision = 12);
+
+                void add(quint64 hash);
+                qint64 estimate() const;
+
+                static quint64 hash(const QByteArray& data);
+
+            private:
+                int precision;
+                QVector<quint8> registers;
+        };
+
+        struct ValueCount
+        {
+            QVariant value;
+            qint64 count = 0;
+            qint64 error = 0;           /**< Maximum overestimation of the count. */
+        };
+
+        /**
+         * @brief Finds most frequent values, using fixed number of counters (space-saving algorithm).
+         *
+         * Counters are kept in a min-heap, so replacing the least frequent value is cheap.
+         */
+        class API_EXPORT TopValues
+        {
+            public:
+                explicit TopValues(int capacity);
+
+                void add(const QByteArray& key, const QVariant& value);
+                QList<ValueCount> getTop(int count) const;
+
+            private:
+                struct Counter
+                {
+                    QByteArray key;
+                    QVariant value;
+                    qint64 count = 0;
+                    qint64 error = 0;
+                };
+
+                void siftUp(int idx);
+                void siftDown(int idx);
+                void swapCounters(int idx1, int idx2);
+
+                int capacity;
+                QVector<Counter> heap;
+                QHash<QByteArray, int> positions;
+        };
+
+        struct ColumnProfile
+        {
+            QString column;
+            qint64 rows = 0;
+            qint64 nulls = 0;
+            qint64 distinct = 0;        /**< Estimated, nulls excluded. */
+            QVariant min;
+            QVariant max;
+            QHash<QString, qint64> types;
+            qint64 lengthValues = 0;    /**< Number of text and blob values, that the length statistics apply to. */
+            qint64 minLength = 0;
+            qint64 maxLength = 0;
+            double avgLength = 0.0;
+            QList<ValueCount> topValues;
+        };
+
+        /**
+         * @brief Statistics collector for a single column.
+         */
+        class API_EXPORT Accumulator
+        {
+            public:
+                explicit Accumulator(int topValuesCount = DEFAULT_TOP_VALUES);
+
+                /**
+                 * @brief Adds value to statistics.
+                 * @param type Type as returned by SQLite's typeof() - null, integer, real, text or blob.
+                 * @param value The value.
+                 */
+                void add(const QString& type, const QVariant& value);
+                ColumnProfile getProfile(const QString& column) const;
+
+            private:
+                static int typeRank(const QString& type);
+                static int compare(int rank1, const QVariant& value1, int rank2, const QVariant& value2);
+
+                int topValuesCount;
+                qint64 rows = 0;
+                qint64 nulls = 0;
+                HyperLogLog distinct;
+                TopValues topValues;
+                QHash<QString, qint64> types;
+                QVariant min;
+                QVariant max;
+                int minRank = 0;
+                int maxRank = 0;
+                qint64 lengthValues = 0;
+                qint64 minLength = 0;
+                qint64 maxLength = 0;
+                qint64 totalLength = 0;
+        };
+
+        struct Report
+        {
+            QString table;
+            qint64 totalRows = 0;
+            qint64 scannedRows = 0;
+            bool sampled = false;
+            QList<ColumnProfile> columns;
+            QString errorMessage;
+
+            bool isValid() const;
+        };
+
+        /**
+         * @brief Profiles given columns of a table.
+         * @param db Database with the table.
+         * @param database Attached database name (or empty string for the main database).
+         * @param table Table name.
+         * @param columns Columns to profile. Empty list means all columns of the table.
+         * @param sampleLimit Tables with more rows are profiled by a random sample of about this many rows.
+         * @return Statistics of columns.
+         */
+        static Report profile(Db* db, const QString& database, const QString& table, const QStringList& columns = QStringList(),
+                              qint64 sampleLimit = DEFAULT_SAMPLE_LIMIT);
+        static QFuture<Report> profileAsync(Db* db, const QString& database, const QString& table, const QStringList& columns = QStringList(),
+                                            qint64 sampleLimit = DEFAULT_SAMPLE_LIMIT);
+
+        static const int DEFAULT_TOP_VALUES = 10;
+        static const qint64 DEFAULT_SAMPLE_LIMIT = 1000000;
+
+    private:
+        static Db* openBackgroundConnection(Db* db, const QString& database);
+        static void profile(Db* db, const QString& source, const QStringList& columns, qint64 sampleLimit, Report& report);
+};
+
+#endif // COLUMNPROFILER_H
@@ -25,6 +25,7 @@ class AsyncQueryRunner;
 class Db;
 class DbManager;
 class SqlQuery;
+class QIODevice;
 
 typedef QSharedPointer<SqlQuery> SqlQueryPtr;
 
@@ -703,6 +704,28 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         virtual bool loadExtension(const QString& filePath, const QString& initFunc = QString()) = 0;
 
+        /**
+         * @brief Opens a single BLOB (or text) value for incremental reading and writing.
+         * @param database Attach name of the database containing the table ("main" if empty).
+         * @param table Table to open the value from. It has to be a table with ROWID.
+         * @param column Column to open the value from.
+         * @param rowId ROWID of the row.
+         * @param writable true to open the value for writing, or false to open it read-only.
+         * @return Opened device, or null pointer on failure.
+         *
+         * Data is read from and written to the database file in chunks requested by the caller,
+         * so even a huge value is never loaded into memory as a whole. Writing modifies bytes in place,
+         * without rewriting the row, but it cannot change the size of the value.
+         *
+         * The caller takes ownership of the device. The device stops working once the database is closed,
+         * or once the row is modified by any other means (like an UPDATE statement).
+         *
+         * This function works only on SQLite 3 drivers. More details can be found at https://sqlite.org/c3ref/blob_open.html
+         *
+         * If function returns null, use getErrorText() to discover details.
+         */
+        virtual QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable) = 0;
+
     signals:
         /**
          * @brief Emitted when the connection to the database was established.
@@ -0,0 +1,245 @@
+#include "dbfileprober.h"
+#include "db/db.h"
+#include "plugins/dbplugin.h"
+#include "common/global.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QUrl>
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrent>
+
+namespace
+{
+    const char SQLITE3_HEADER[] = "SQLite format 3";
+    const char SQLITE2_HEADER[] = "** This file contains an SQLite 2";
+}
+
+DbFileProber::DbFileProber()
+{
+    // Probing is mostly waiting for I/O, so it's worth to use more threads than there are CPU cores.
+    threadPool.setMaxThreadCount(qMax(QThread::idealThreadCount(), MIN_PROBING_THREADS));
+}
+
+DbFileProber::~DbFileProber()
+{
+    threadPool.waitForDone();
+}
+
+QList<DbFileProber::Plan> DbFileProber::plan(const QList<Candidate>& candidates, const QList<DbPlugin*>& plugins)
+{
+    QList<QFuture<Plan>> futures;
+    for (const Candidate& candidate : candidates)
+    {
+        futures << QtConcurrent::run(&threadPool, [this, candidate, plugins]() -> Plan
+        {
+            return plan(candidate, plugins);
+        });
+    }
+
+    QList<Plan> plans;
+    for (QFuture<Plan>& future : futures)
+        plans << future.result();
+
+    return plans;
+}
+
+QList<DbFileProber::Result> DbFileProber::createInstances(const QList<Plan>& plans)
+{
+    QList<Result> results;
+    for (const Plan& plan : plans)
+        results << createInstance(plan);
+
+    return results;
+}
+
+QList<DbFileProber::Result> DbFileProber::probe(const QList<Candidate>& candidates, const QList<DbPlugin*>& plugins)
+{
+    return createInstances(plan(candidates, plugins));
+}
+
+DbFileProber::Result DbFileProber::probe(const Candidate& candidate, const QList<DbPlugin*>& plugins)
+{
+    return createInstance(plan(candidate, plugins));
+}
+
+DbFileProber::Plan DbFileProber::plan(const Candidate& candidate, const QList<DbPlugin*>& plugins)
+{
+    Plan plan;
+    plan.candidate = candidate;
+    plan.path = normalizePath(candidate.path, &plan.localFile);
+    plan.entry = getCacheEntry(candidate, plan.path, plan.localFile);
+    plan.plugins = getPluginsToAsk(candidate, plan.entry, plugins);
+    return plan;
+}
+
+DbFileProber::Result DbFileProber::createInstance(const Plan& plan)
+{
+    Result result;
+    result.candidate = plan.candidate;
+    if (plan.plugins.isEmpty())
+        return result;
+
+    QSet<QString> rejectedBy;
+    QStringList messages;
+    QString message;
+    Db* db = nullptr;
+    for (DbPlugin* plugin : plan.plugins)
+    {
+        message.clear();
+        db = plugin->getInstance(plan.candidate.name, plan.path, plan.candidate.options, &message);
+        if (!db)
+        {
+            rejectedBy << plugin->getName();
+            if (!message.isEmpty())
+                messages << message;
+
+            continue;
+        }
+
+        if (!db->initAfterCreated())
+        {
+            safe_delete(db);
+            rejectedBy << plugin->getName();
+            messages << QCoreApplication::translate("DbManagerImpl", "Database could not be initialized.");
+            continue;
+        }
+
+        // Probing may run in a background thread, but databases are used by the main thread
+        if (db->thread() != qApp->thread())
+            db->moveToThread(qApp->thread());
+
+        result.db = db;
+        result.plugin = plugin;
+        break;
+    }
+
+    if (plan.localFile)
+        storeDecision(plan.path, plan.entry, rejectedBy, result.plugin);
+
+    if (!result.db)
+    {
+        if (messages.size() == 0)
+            messages << QCoreApplication::translate("DbManagerImpl", "No suitable database driver plugin found.");
+
+        result.errorMessage = messages.join("; ");
+    }
+
+    return result;
+}
+
+void DbFileProber::clearCache()
+{
+    QMutexLocker lock(&cacheMutex);
+    cache.clear();
+}
+
+DbFileProber::Format DbFileProber::detectFormat(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return Format::UNREADABLE;
+
+    if (file.size() == 0)
+        return Format::EMPTY;
+
+    QByteArray header = file.read(sizeof(SQLITE2_HEADER));
+    file.close();
+
+    // The header of SQLite 3 is terminated with the null character, which is included in the sizeof()
+    if (header.startsWith(QByteArray(SQLITE3_HEADER, sizeof(SQLITE3_HEADER))))
+        return Format::SQLITE3;
+
+    if (header.startsWith(SQLITE2_HEADER))
+        return Format::SQLITE2;
+
+    return Format::UNKNOWN;
+}
+
+DbFileProber::CacheEntry DbFileProber::getCacheEntry(const Candidate& candidate, const QString& path, bool localFile)
+{
+    CacheEntry entry;
+    if (!localFile)
+        return entry;
+
+    QFileInfo fileInfo(path);
+    if (!fileInfo.exists() || !fileInfo.isFile())
+        return entry;
+
+    entry.modified = fileInfo.lastModified();
+    entry.size = fileInfo.size();
+    entry.options = candidate.options;
+
+    cacheMutex.lock();
+    if (cache.contains(path))
+    {
+        const CacheEntry& cached = cache[path];
+        if (cached.modified == entry.modified && cached.size == entry.size && cached.options == entry.options)
+        {
+            entry = cached;
+            cacheMutex.unlock();
+            return entry;
+        }
+    }
+    cacheMutex.unlock();
+
+    entry.format = detectFormat(path);
+    return entry;
+}
+
+QList<DbPlugin*> DbFileProber::getPluginsToAsk(const Candidate& candidate, const CacheEntry& entry, const QList<DbPlugin*>& plugins)
+{
+    QList<DbPlugin*> results;
+    QString pluginName;
+    for (DbPlugin* plugin : plugins)
+    {
+        pluginName = plugin->getName();
+        if (candidate.options.contains(DB_PLUGIN) && candidate.options[DB_PLUGIN].toString() != pluginName)
+            continue;
+
+        if (entry.rejectedBy.contains(pluginName) || !plugin->isFileFormatSupported(entry.format))
+            continue;
+
+        if (pluginName == entry.acceptedBy)
+            results.prepend(plugin);
+        else
+            results << plugin;
+    }
+    return results;
+}
+
+void DbFileProber::storeDecision(const QString& path, CacheEntry entry, const QSet<QString>& rejectedBy, DbPlugin* acceptedBy)
+{
+    entry.rejectedBy += rejectedBy;
+    if (acceptedBy)
+    {
+        entry.acceptedBy = acceptedBy->getName();
+        entry.rejectedBy.remove(entry.acceptedBy);
+    }
+
+    QMutexLocker lock(&cacheMutex);
+    cache[path] = entry;
+}
+
+QString DbFileProber::normalizePath(const QString& path, bool* localFile)
+{
+    bool local = false;
+    QString normalizedPath;
+    QUrl url(path);
+    if (url.scheme().isEmpty() || url.scheme() == "file")
+    {
+        normalizedPath = QDir(path).absolutePath();
+        local = QUrl::fromUserInput(path).isLocalFile();
+    }
+    else
+    {
+        normalizedPath = path;
+    }
+
+    if (localFile)
+        *localFile = local;
+
+    return normalizedPath;
+}
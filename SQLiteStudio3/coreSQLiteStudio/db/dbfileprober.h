@@ -0,0 +1,177 @@
+#ifndef DBFILEPROBER_H
+#define DBFILEPROBER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QVariant>
+#include <QDateTime>
+#include <QMutex>
+#include <QThreadPool>
+
+class Db;
+class DbPlugin;
+
+/**
+ * @brief Finds out which DbPlugin handles given database files.
+ *
+ * Finding a plugin for a database means asking every DbPlugin for an instance, which opens the file
+ * and reads its schema. Doing that for many databases, for every plugin, each time another plugin gets loaded
+ * is slow, especially for files on network mounts. The prober reduces that work in three ways:
+ * <ul>
+ * <li>It reads the file header first (see detectFormat()) and skips plugins that cannot handle the format
+ * (see DbPlugin::isFileFormatSupported()),</li>
+ * <li>It remembers plugins that accepted or rejected the file, together with the file modification time,
+ * so the same plugin is not asked again about the same unchanged file,</li>
+ * <li>It reads headers of many files at once, using its own thread pool.</li>
+ * </ul>
+ *
+ * Probing is split into two phases. Planning (see plan()) reads file headers and the cache to decide
+ * which plugins to ask and in what order. Creating instances (see createInstances()) calls DbPlugin::getInstance()
+ * and Db::initAfterCreated(), one database after another. If a plugin fails to create or to initialize the database,
+ * the next plugin from the plan is asked. Both phases can run in a background thread. Created databases are moved
+ * to the main application thread, where the rest of application uses them.
+ */
+class API_EXPORT DbFileProber
+{
+    public:
+        /**
+         * @brief Database file format, as recognized by its header.
+         */
+        enum class Format
+        {
+            EMPTY,      /**< Empty file, any plugin can create database in it. */
+            SQLITE3,    /**< Plain SQLite 3 database. */
+            SQLITE2,    /**< Plain SQLite 2 database. */
+            UNKNOWN,    /**< File with unknown header, possibly encrypted database, or not a database at all. */
+            UNREADABLE  /**< Not a local file, or the file could not be read. Format has to be checked by plugins. */
+        };
+
+    private:
+        /**
+         * @brief Decisions remembered for a database file.
+         */
+        struct CacheEntry
+        {
+            QDateTime modified;
+            qint64 size = -1;
+            QHash<QString,QVariant> options;
+            Format format = Format::UNREADABLE;
+            QString acceptedBy;
+            QSet<QString> rejectedBy;
+        };
+
+    public:
+        /**
+         * @brief Database to find a plugin for.
+         */
+        struct Candidate
+        {
+            QString name;
+            QString path;
+            QHash<QString,QVariant> options;
+        };
+
+        /**
+         * @brief Plugins to ask for a single database, as decided by plan().
+         */
+        struct Plan
+        {
+            Candidate candidate;
+            QString path;
+            bool localFile = false;
+            QList<DbPlugin*> plugins;
+            CacheEntry entry;
+        };
+
+        /**
+         * @brief Result of probing a single database.
+         *
+         * If no plugin accepted the database, then db and plugin are null and the errorMessage
+         * contains messages from plugins (if any of them was asked).
+         */
+        struct Result
+        {
+            Candidate candidate;
+            Db* db = nullptr;
+            DbPlugin* plugin = nullptr;
+            QString errorMessage;
+        };
+
+        DbFileProber();
+        ~DbFileProber();
+
+        /**
+         * @brief Decides which plugins to ask for given databases.
+         * @param candidates Databases to probe.
+         * @param plugins Plugins to ask for the databases, in order of preference.
+         * @return Plans in the same order as candidates.
+         *
+         * File headers are read concurrently. This method blocks until all of them are read.
+         * It can be called from any thread.
+         */
+        QList<Plan> plan(const QList<Candidate>& candidates, const QList<DbPlugin*>& plugins);
+
+        /**
+         * @brief Creates and initializes databases according to plans.
+         * @param plans Plans prepared by plan().
+         * @return Results in the same order as plans.
+         *
+         * It can be called from any thread. Databases are created one by one, in the calling thread,
+         * and then moved to the main application thread.
+         */
+        QList<Result> createInstances(const QList<Plan>& plans);
+
+        /**
+         * @brief Probes databases.
+         * @param candidates Databases to probe.
+         * @param plugins Plugins to ask for the databases, in order of preference.
+         * @return Results in the same order as candidates.
+         *
+         * It's plan() followed by createInstances(). It can be called from any thread.
+         */
+        QList<Result> probe(const QList<Candidate>& candidates, const QList<DbPlugin*>& plugins);
+
+        /**
+         * @brief Probes single database.
+         * @param candidate Database to probe.
+         * @param plugins Plugins to ask for the database, in order of preference.
+         * @return Result of probing.
+         *
+         * It can be called from any thread.
+         */
+        Result probe(const Candidate& candidate, const QList<DbPlugin*>& plugins);
+
+        /**
+         * @brief Forgets all remembered decisions.
+         */
+        void clearCache();
+
+        /**
+         * @brief Recognizes database file format by its header.
+         * @param path Path to the file.
+         * @return Detected format.
+         *
+         * It reads only first bytes of the file, without opening any database connection.
+         */
+        static Format detectFormat(const QString& path);
+
+    private:
+        Plan plan(const Candidate& candidate, const QList<DbPlugin*>& plugins);
+        Result createInstance(const Plan& plan);
+        CacheEntry getCacheEntry(const Candidate& candidate, const QString& path, bool localFile);
+        QList<DbPlugin*> getPluginsToAsk(const Candidate& candidate, const CacheEntry& entry, const QList<DbPlugin*>& plugins);
+        void storeDecision(const QString& path, CacheEntry entry, const QSet<QString>& rejectedBy, DbPlugin* acceptedBy);
+
+        static QString normalizePath(const QString& path, bool* localFile = nullptr);
+
+        static const int MIN_PROBING_THREADS = 8;
+
+        QHash<QString,CacheEntry> cache;
+        QMutex cacheMutex;
+        QThreadPool threadPool;
+};
+
+#endif // DBFILEPROBER_H
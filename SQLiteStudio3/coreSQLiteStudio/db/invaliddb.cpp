@@ -332,6 +332,16 @@ bool InvalidDb::loadExtension(const QString& filePath, const QString& initFunc)
     return false;
 }
 
+QIODevice* InvalidDb::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(writable);
+    return nullptr;
+}
+
 bool InvalidDb::isComplete(const QString& sql) const
 {
     UNUSED(sql);
@@ -60,6 +60,7 @@ class API_EXPORT InvalidDb : public Db
         QString getError() const;
         void setError(const QString& value);
         bool loadExtension(const QString& filePath, const QString& initFunc);
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool writable);
         bool isComplete(const QString& sql) const;
 
     public slots:
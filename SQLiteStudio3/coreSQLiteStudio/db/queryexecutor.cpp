@@ -4,6 +4,7 @@
 #include "services/dbmanager.h"
 #include "db/sqlerrorcodes.h"
 #include "services/notifymanager.h"
+#include "completionindex.h"
 #include "queryexecutorsteps/queryexecutoraddrowids.h"
 #include "queryexecutorsteps/queryexecutorcolumns.h"
 #include "queryexecutorsteps/queryexecutorparsequery.h"
@@ -19,6 +20,8 @@
 #include "queryexecutorsteps/queryexecutorreplaceviews.h"
 #include "queryexecutorsteps/queryexecutordetectschemaalter.h"
 #include "queryexecutorsteps/queryexecutorvaluesmode.h"
+#include "queryexecutorsteps/queryexecutorstoreplan.h"
+#include "queryplancache.h"
 #include "common/unused.h"
 #include "chainexecutor.h"
 #include "log.h"
@@ -28,8 +31,10 @@
 #include <QDebug>
 #include <schemaresolver.h>
 #include <parser/lexer.h>
+#include <parser/parser.h>
 #include <common/table.h>
 #include <QtMath>
+#include <QRegularExpression>
 
 // TODO modify all executor steps to use rebuildTokensFromContents() method, instead of replacing tokens manually.
 
@@ -106,8 +111,27 @@ void QueryExecutor::setupExecutionChain()
 
     executionChain << new QueryExecutorCellSize()
                    << new QueryExecutorCountResults()
-                   << new QueryExecutorParseQuery("after CellSize");
+                   << new QueryExecutorParseQuery("after CellSize")
+                   << new QueryExecutorStorePlan();
 
+    appendFinalSteps();
+
+    for (QueryExecutorStep* step : executionChain)
+        step->init(this, context);
+}
+
+void QueryExecutor::setupCachedPlanChain()
+{
+    executionChain << new QueryExecutorParseQuery("cached plan");
+
+    appendFinalSteps();
+
+    for (QueryExecutorStep* step : executionChain)
+        step->init(this, context);
+}
+
+void QueryExecutor::appendFinalSteps()
+{
     executionChain.append(additionalStatelessSteps[AFTER_CELL_SIZE_LIMIT]);
     executionChain.append(createSteps(AFTER_CELL_SIZE_LIMIT));
 
@@ -122,9 +146,6 @@ void QueryExecutor::setupExecutionChain()
     executionChain.append(createSteps(LAST));
 
     executionChain << new QueryExecutorExecute();
-
-    for (QueryExecutorStep* step : executionChain)
-        step->init(this, context);
 }
 
 void QueryExecutor::clearChain()
@@ -170,11 +191,27 @@ void QueryExecutor::executeChain()
     executionInProgress = false;
     executionMutex.unlock();
 
+    handleSchemaChanges(context->parsedQueries, context->schemaModified);
+
     emit executionFinished(context->executionResults);
 }
 
 void QueryExecutor::stepFailed(QueryExecutorStep* currentStep)
 {
+    if (context->planFromCache && !isInterrupted())
+    {
+        // The plan might be outdated in a way that the cache couldn't detect. Full chain goes before the simple method.
+        qDebug() << "Execution of cached query plan failed at step" << currentStep->metaObject()->className() << currentStep->objectName()
+                 << "\nUsing full execution chain.";
+
+        clearChain();
+        QUERY_PLAN_CACHE->remove(db, context->planCacheKey);
+        resetContext();
+        setupExecutionChain();
+        executeChain();
+        return;
+    }
+
     qDebug() << "Smart execution failed at step" << currentStep->metaObject()->className() << currentStep->objectName()
              << "\nUsing simple execution method.";
 
@@ -284,7 +321,19 @@ void QueryExecutor::execInternal()
         releaseResultsAndCleanup();
     }
 
-    // Reset context
+    resetContext();
+
+    // Start the execution
+    if (restoreCachedPlan())
+        setupCachedPlanChain();
+    else
+        setupExecutionChain();
+
+    executeChain();
+}
+
+void QueryExecutor::resetContext()
+{
     delete context;
     context = new Context();
     context->processedQuery = originalQuery;
@@ -294,10 +343,53 @@ void QueryExecutor::execInternal()
     context->resultsHandler = resultsHandler;
     context->preloadResults = preloadResults;
     context->queryParameters = queryParameters;
+    if (isPlanCacheUsable())
+        context->planCacheKey = getPlanCacheKey();
+}
 
-    // Start the execution
-    setupExecutionChain();
-    executeChain();
+bool QueryExecutor::isPlanCacheUsable() const
+{
+    if (!db || db->getDialect() != Dialect::Sqlite3)
+        return false;
+
+    static const QList<StepPosition> cachedPositions = {FIRST, AFTER_ATTACHES, AFTER_REPLACED_VIEWS, AFTER_ROW_IDS,
+                                                        AFTER_REPLACED_COLUMNS, AFTER_ORDER, AFTER_DISTINCT_WRAP};
+
+    for (StepPosition position : cachedPositions)
+    {
+        if (!additionalStatelessSteps.value(position).isEmpty() || !additionalStatefulStepFactories.value(position).isEmpty())
+            return false;
+    }
+    return true;
+}
+
+QString QueryExecutor::getPlanCacheKey() const
+{
+    QStringList keyParts = {originalQuery, QString::number(explainMode), QString::number(noMetaColumns), QString::number(dataLengthLimit)};
+    for (const Sort& sort : sortOrder)
+        keyParts << QString::number(sort.column) + ":" + QString::number(sort.order);
+
+    return keyParts.join(QChar(0));
+}
+
+bool QueryExecutor::restoreCachedPlan()
+{
+    if (context->planCacheKey.isNull())
+        return false;
+
+    QueryPlanCache::Plan plan;
+    if (!QUERY_PLAN_CACHE->get(db, context->planCacheKey, plan))
+        return false;
+
+    context->processedQuery = plan.processedQuery;
+    context->countingQuery = plan.countingQuery;
+    context->resultColumns = plan.resultColumns;
+    context->rowIdColumns = plan.rowIdColumns;
+    context->sourceTables = plan.sourceTables;
+    context->editionForbiddenReasons = plan.editionForbiddenReasons;
+    context->colNameSeq = plan.colNameSeq;
+    context->planFromCache = true;
+    return true;
 }
 
 void QueryExecutor::interrupt()
@@ -528,9 +620,52 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
     if (!forceSimpleMode && queriesForSimpleExecution.size() <= queryCountLimitForSmartMode)
         notifyWarn(tr("SQLiteStudio was unable to extract metadata from the query. Results won't be editable."));
 
+    handleSimpleMethodSchemaChanges();
+
     emit executionFinished(results);
 }
 
+void QueryExecutor::handleSchemaChanges(const QList<SqliteQueryPtr>& queries, bool schemaModified)
+{
+    // Transaction control and ATTACH/DETACH matter to the completion index too, not only the DDL
+    COMPLETION_INDEX->handleDdl(db, queries);
+    if (schemaModified)
+        QUERY_PLAN_CACHE->invalidate(db);
+}
+
+void QueryExecutor::handleSimpleMethodSchemaChanges()
+{
+    static_qstring(keywordsPattern, "^(CREATE|DROP|ALTER|BEGIN|COMMIT|END|ROLLBACK|SAVEPOINT|RELEASE|ATTACH|DETACH)\\b");
+    static const QRegularExpression schemaOrTransactionRe(keywordsPattern, QRegularExpression::CaseInsensitiveOption);
+
+    Parser parser(db->getDialect());
+    QList<SqliteQueryPtr> queries;
+    bool schemaModified = false;
+    for (const QString& query : queriesForSimpleExecution)
+    {
+        if (!schemaOrTransactionRe.match(query.trimmed()).hasMatch())
+            continue;
+
+        if (!parser.parse(query))
+        {
+            // The query was executed, so it's valid, just not understood by the parser. The schema has to be read again.
+            schemaModified = true;
+            COMPLETION_INDEX->build(db);
+            continue;
+        }
+
+        for (const SqliteQueryPtr& parsedQuery : parser.getQueries())
+        {
+            queries << parsedQuery;
+            if (QueryExecutorDetectSchemaAlter::isSchemaAlter(parsedQuery->queryType))
+                schemaModified = true;
+        }
+    }
+
+    context->schemaModified |= schemaModified;
+    handleSchemaChanges(queries, schemaModified);
+}
+
 bool QueryExecutor::simpleExecIsSelect()
 {
     TokenList tokens = Lexer::tokenize(queriesForSimpleExecution.last(), db->getDialect());
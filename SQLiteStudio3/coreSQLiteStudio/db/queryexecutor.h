@@ -644,6 +644,19 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              * message from smart execution.
              */
             QString errorMessageFromSmartExecution;
+
+            /**
+             * @brief Key of the query in the QueryPlanCache.
+             *
+             * It's null if the plan cache cannot be used for this execution.
+             * See QueryExecutor::getPlanCacheKey() for details.
+             */
+            QString planCacheKey;
+
+            /**
+             * @brief Tells if the transforming steps were skipped, because the plan was taken from the QueryPlanCache.
+             */
+            bool planFromCache = false;
         };
 
         /**
@@ -1200,6 +1213,23 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool simpleExecIsSelect();
 
+        /**
+         * @brief Passes executed queries to the CompletionIndex and drops outdated query plans.
+         * @param queries Parsed queries that were executed.
+         * @param schemaModified Tells if any of the queries modified the schema.
+         */
+        void handleSchemaChanges(const QList<SqliteQueryPtr>& queries, bool schemaModified);
+
+        /**
+         * @brief Handles schema changes made by queries executed with the simple method.
+         *
+         * Steps that parse the query and detect schema changes were either not executed at all (forced simple mode),
+         * or they might have failed before getting to it, so queries of the simple method are analyzed here.
+         * Only queries starting with a keyword that may change the schema or the transaction state are parsed,
+         * so big scripts with data don't pay for it.
+         */
+        void handleSimpleMethodSchemaChanges();
+
         /**
          * @brief Releases resources acquired during query execution.
          *
@@ -1231,6 +1261,53 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         QList<QueryExecutorStep*> createSteps(StepPosition position);
 
+        /**
+         * @brief Recreates the context for a new execution.
+         *
+         * Copies configuration parameters from local members to the new context.
+         */
+        void resetContext();
+
+        /**
+         * @brief Tells if the QueryPlanCache can be used for the execution.
+         * @return true if the plan can be taken from the cache and stored in it.
+         *
+         * The cache is used only for SQLite 3 databases and only if no custom steps
+         * are registered before the cached part of the chain ends, because their effect
+         * is unknown to the cache.
+         */
+        bool isPlanCacheUsable() const;
+
+        /**
+         * @brief Builds key for the QueryPlanCache.
+         * @return Key made of the original query and all settings that affect the transforming steps.
+         *
+         * The page and the number of results per page are not part of the key, as they are applied
+         * after the cached part of the chain.
+         */
+        QString getPlanCacheKey() const;
+
+        /**
+         * @brief Fills the context with the plan from QueryPlanCache.
+         * @return true if the plan was found, or false if the full chain has to be executed.
+         */
+        bool restoreCachedPlan();
+
+        /**
+         * @brief Build chain of executor steps for the plan taken from the cache.
+         *
+         * It contains only steps from the point where QueryExecutorStorePlan is placed
+         * in the full chain (see setupExecutionChain()).
+         */
+        void setupCachedPlanChain();
+
+        /**
+         * @brief Appends steps placed at the end of the chain, starting from the row limit.
+         *
+         * It's the common part of setupExecutionChain() and setupCachedPlanChain().
+         */
+        void appendFinalSteps();
+
         /**
          * @brief Query executor context object.
          *
@@ -4,20 +4,14 @@ bool QueryExecutorDetectSchemaAlter::exec()
 {
     for (SqliteQueryPtr query : context->parsedQueries)
     {
+        if (isSchemaAlter(query->queryType))
+        {
+            context->schemaModified = true;
+            continue;
+        }
+
         switch (query->queryType)
         {
-            case SqliteQueryType::AlterTable:
-            case SqliteQueryType::CreateIndex:
-            case SqliteQueryType::CreateTable:
-            case SqliteQueryType::CreateTrigger:
-            case SqliteQueryType::CreateView:
-            case SqliteQueryType::DropIndex:
-            case SqliteQueryType::DropTable:
-            case SqliteQueryType::DropTrigger:
-            case SqliteQueryType::DropView:
-            case SqliteQueryType::CreateVirtualTable:
-                context->schemaModified = true;
-                break;
             case SqliteQueryType::Insert:
             case SqliteQueryType::Delete:
             case SqliteQueryType::Update:
@@ -28,3 +22,24 @@ bool QueryExecutorDetectSchemaAlter::exec()
     }
     return true;
 }
+
+bool QueryExecutorDetectSchemaAlter::isSchemaAlter(SqliteQueryType queryType)
+{
+    switch (queryType)
+    {
+        case SqliteQueryType::AlterTable:
+        case SqliteQueryType::CreateIndex:
+        case SqliteQueryType::CreateTable:
+        case SqliteQueryType::CreateTrigger:
+        case SqliteQueryType::CreateView:
+        case SqliteQueryType::DropIndex:
+        case SqliteQueryType::DropTable:
+        case SqliteQueryType::DropTrigger:
+        case SqliteQueryType::DropView:
+        case SqliteQueryType::CreateVirtualTable:
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
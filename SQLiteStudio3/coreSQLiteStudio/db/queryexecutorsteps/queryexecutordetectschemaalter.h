@@ -9,6 +9,8 @@ class QueryExecutorDetectSchemaAlter : public QueryExecutorStep
 
     public:
         bool exec();
+
+        static bool isSchemaAlter(SqliteQueryType queryType);
 };
 
 #endif // QUERYEXECUTORDETECTSCHEMAALTER_H
@@ -0,0 +1,26 @@
+#include "queryexecutorstoreplan.h"
+#include "db/queryplancache.h"
+
+bool QueryExecutorStorePlan::exec()
+{
+    if (context->planCacheKey.isNull() || context->planFromCache)
+        return true;
+
+    if (context->parsedQueries.size() != 1 || context->schemaModified || context->dataModifyingQuery || !context->dbNameToAttach.isEmpty())
+        return true;
+
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain)
+        return true;
+
+    QueryPlanCache::Plan plan;
+    plan.processedQuery = context->processedQuery;
+    plan.countingQuery = context->countingQuery;
+    plan.resultColumns = context->resultColumns;
+    plan.rowIdColumns = context->rowIdColumns;
+    plan.sourceTables = context->sourceTables;
+    plan.editionForbiddenReasons = context->editionForbiddenReasons;
+    plan.colNameSeq = context->colNameSeq;
+    QUERY_PLAN_CACHE->put(db, context->planCacheKey, plan);
+    return true;
+}
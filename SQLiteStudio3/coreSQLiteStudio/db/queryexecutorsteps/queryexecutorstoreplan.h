@@ -0,0 +1,24 @@
+#ifndef QUERYEXECUTORSTOREPLAN_H
+#define QUERYEXECUTORSTOREPLAN_H
+
+#include "queryexecutorstep.h"
+
+/**
+ * @brief Stores transformed query in the QueryPlanCache.
+ *
+ * It's placed just before the row limit is applied, so the stored plan covers everything
+ * that does not depend on the requested page. Only single, read-only SELECT statements,
+ * which didn't need any databases to be attached, are stored.
+ *
+ * The step does nothing if the QueryExecutor decided not to use the cache
+ * (QueryExecutor::Context::planCacheKey is null), or if the plan was just taken from the cache.
+ */
+class QueryExecutorStorePlan : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+};
+
+#endif // QUERYEXECUTORSTOREPLAN_H
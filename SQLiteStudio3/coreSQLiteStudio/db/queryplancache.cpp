@@ -0,0 +1,156 @@
+#include "queryplancache.h"
+#include "db/db.h"
+#include "services/dbmanager.h"
+#include "services/importmanager.h"
+#include "services/notifymanager.h"
+#include "common/utils_sql.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+DEFINE_SINGLETON(QueryPlanCache)
+
+QueryPlanCache::QueryPlanCache()
+{
+    entries.setMaxCost(MAX_PLANS);
+}
+
+void QueryPlanCache::init()
+{
+    connect(DBLIST, &DbManager::dbDisconnected, this, &QueryPlanCache::invalidate);
+    connect(DBLIST, &DbManager::dbRemoved, this, &QueryPlanCache::invalidate);
+    connect(DBLIST, SIGNAL(dbAboutToBeUnloaded(Db*,DbPlugin*)), this, SLOT(invalidate(Db*)));
+    connect(IMPORT_MANAGER, &ImportManager::schemaModified, this, &QueryPlanCache::invalidate);
+    connect(NOTIFY_MANAGER, SIGNAL(objectCreated(Db*,QString,QString)), this, SLOT(invalidate(Db*)));
+    connect(NOTIFY_MANAGER, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(invalidate(Db*)));
+    connect(NOTIFY_MANAGER, SIGNAL(objectDeleted(Db*,QString,QString)), this, SLOT(invalidate(Db*)));
+    connect(NOTIFY_MANAGER, SIGNAL(objectRenamed(Db*,QString,QString,QString)), this, SLOT(invalidate(Db*)));
+}
+
+bool QueryPlanCache::get(Db* db, const QString& key, Plan& plan)
+{
+    QString cacheKey = getCacheKey(db, key);
+    QStringList databases;
+    QString schemaStamp;
+
+    mutex.lock();
+    Entry* entry = entries.object(cacheKey);
+    if (entry)
+    {
+        databases = entry->databases;
+        schemaStamp = entry->schemaStamp;
+    }
+    mutex.unlock();
+
+    if (databases.isEmpty())
+        return false;
+
+    // Schema is checked without holding the mutex, as it involves queries to the database.
+    if (getSchemaStamp(db, databases) != schemaStamp)
+    {
+        remove(db, key);
+        return false;
+    }
+
+    QMutexLocker lock(&mutex);
+    entry = entries.object(cacheKey);
+    if (!entry || entry->schemaStamp != schemaStamp)
+        return false;
+
+    plan = copy(entry->plan);
+    return true;
+}
+
+void QueryPlanCache::put(Db* db, const QString& key, const Plan& plan)
+{
+    Entry* entry = new Entry();
+    entry->db = db;
+    entry->databases = getDatabases(plan);
+    entry->schemaStamp = getSchemaStamp(db, entry->databases);
+    entry->plan = copy(plan);
+    if (entry->schemaStamp.isNull())
+    {
+        delete entry;
+        return;
+    }
+
+    QMutexLocker lock(&mutex);
+    entries.insert(getCacheKey(db, key), entry);
+}
+
+void QueryPlanCache::remove(Db* db, const QString& key)
+{
+    QMutexLocker lock(&mutex);
+    entries.remove(getCacheKey(db, key));
+}
+
+void QueryPlanCache::clear()
+{
+    QMutexLocker lock(&mutex);
+    entries.clear();
+}
+
+void QueryPlanCache::invalidate(Db* db)
+{
+    QMutexLocker lock(&mutex);
+    for (const QString& cacheKey : entries.keys())
+    {
+        if (entries.object(cacheKey)->db == db)
+            entries.remove(cacheKey);
+    }
+}
+
+QString QueryPlanCache::getCacheKey(Db* db, const QString& key)
+{
+    return QString::number(reinterpret_cast<quintptr>(db), 16) + QChar(0) + key;
+}
+
+QStringList QueryPlanCache::getDatabases(const Plan& plan)
+{
+    QStringList databases = {"main", "temp"};
+    QString database;
+    for (const QueryExecutor::SourceTablePtr& table : plan.sourceTables)
+    {
+        database = table->database.toLower();
+        if (!database.isEmpty() && !databases.contains(database))
+            databases << database;
+    }
+    return databases;
+}
+
+QString QueryPlanCache::getSchemaStamp(Db* db, const QStringList& databases)
+{
+    static_qstring(pragmaTpl, "PRAGMA %1.schema_version");
+
+    QStringList versions;
+    SqlQueryPtr results;
+    for (const QString& database : databases)
+    {
+        results = db->exec(pragmaTpl.arg(wrapObjIfNeeded(database, db->getDialect())), Db::Flag::NO_LOCK);
+        if (results->isError())
+            return QString();
+
+        versions << results->getSingleCell().toString();
+    }
+    return versions.join(",");
+}
+
+QueryPlanCache::Plan QueryPlanCache::copy(const Plan& plan)
+{
+    // Result columns are shared pointers and their users are free to modify them, so they are never shared with the cache.
+    Plan result;
+    result.processedQuery = plan.processedQuery;
+    result.countingQuery = plan.countingQuery;
+    result.editionForbiddenReasons = plan.editionForbiddenReasons;
+    result.colNameSeq = plan.colNameSeq;
+
+    for (const QueryExecutor::ResultColumnPtr& col : plan.resultColumns)
+        result.resultColumns << QueryExecutor::ResultColumnPtr::create(*col);
+
+    for (const QueryExecutor::ResultRowIdColumnPtr& col : plan.rowIdColumns)
+        result.rowIdColumns << QueryExecutor::ResultRowIdColumnPtr::create(*col);
+
+    for (const QueryExecutor::SourceTablePtr& table : plan.sourceTables)
+        result.sourceTables << QueryExecutor::SourceTablePtr::create(*table);
+
+    return result;
+}
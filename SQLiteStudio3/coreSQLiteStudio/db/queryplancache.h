@@ -0,0 +1,120 @@
+#ifndef QUERYPLANCACHE_H
+#define QUERYPLANCACHE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/global.h"
+#include "db/queryexecutor.h"
+#include <QObject>
+#include <QCache>
+#include <QMutex>
+#include <QStringList>
+
+class Db;
+
+/**
+ * @brief Cache of queries already transformed by the QueryExecutor.
+ *
+ * Before QueryExecutor executes a SELECT, it passes it through the whole chain of steps, which parse the query,
+ * resolve its data sources, replace views, add ROWID columns, resolve result columns, apply the order and the cell size limit.
+ * This involves several parsing passes and schema queries, while the outcome depends only on the query itself,
+ * the database schema and few executor settings. Page changes and repeated executions of the same query
+ * differ only by the LIMIT/OFFSET applied at the very end of the chain.
+ *
+ * The cache keeps the outcome of the chain up to the QueryExecutorStorePlan step (see Plan),
+ * so the QueryExecutor can skip right to applying the page limit and executing the query.
+ *
+ * Each plan remembers schema_version of databases it depends on ("main", "temp" and databases of its source tables).
+ * The plan is dropped if any of these versions has changed. Additionally plans of the database are dropped
+ * when the database gets disconnected, or when any object in it is created, modified or deleted.
+ */
+class API_EXPORT QueryPlanCache : public QObject
+{
+    Q_OBJECT
+
+    DECLARE_SINGLETON(QueryPlanCache)
+
+    public:
+        /**
+         * @brief Outcome of the transforming part of the QueryExecutor chain.
+         */
+        struct Plan
+        {
+            QString processedQuery;
+            QString countingQuery;
+            QList<QueryExecutor::ResultColumnPtr> resultColumns;
+            QList<QueryExecutor::ResultRowIdColumnPtr> rowIdColumns;
+            QSet<QueryExecutor::SourceTablePtr> sourceTables;
+            QSet<QueryExecutor::EditionForbiddenReason> editionForbiddenReasons;
+            int colNameSeq = 0;
+        };
+
+        QueryPlanCache();
+
+        /**
+         * @brief Connects the cache with application services, so it can drop outdated plans.
+         *
+         * It's called by SQLiteStudio during initialization.
+         */
+        void init();
+
+        /**
+         * @brief Provides cached plan.
+         * @param db Database the query is executed on.
+         * @param key Key of the query, as built by the QueryExecutor out of the query and its settings.
+         * @param plan Output plan. It's a deep copy, so it can be modified freely.
+         * @return true if the plan was found and the database schema didn't change since it was stored.
+         *
+         * Checking the schema requires executing a few PRAGMA queries on the database.
+         */
+        bool get(Db* db, const QString& key, Plan& plan);
+
+        /**
+         * @brief Stores plan in the cache.
+         * @param db Database the query was executed on.
+         * @param key Key of the query.
+         * @param plan Plan to store. The cache keeps its deep copy.
+         */
+        void put(Db* db, const QString& key, const Plan& plan);
+
+        /**
+         * @brief Drops single plan.
+         * @param db Database the query was executed on.
+         * @param key Key of the query.
+         */
+        void remove(Db* db, const QString& key);
+
+        /**
+         * @brief Drops all plans.
+         */
+        void clear();
+
+        static const int MAX_PLANS = 64;
+
+    public slots:
+        /**
+         * @brief Drops all plans of given database.
+         * @param db Database to drop plans for.
+         */
+        void invalidate(Db* db);
+
+    private:
+        struct Entry
+        {
+            Db* db = nullptr;
+            QStringList databases;
+            QString schemaStamp;
+            Plan plan;
+        };
+
+        static QString getCacheKey(Db* db, const QString& key);
+        static QStringList getDatabases(const Plan& plan);
+        static QString getSchemaStamp(Db* db, const QStringList& databases);
+        static Plan copy(const Plan& plan);
+
+        QCache<QString, Entry> entries;
+        QMutex mutex;
+};
+
+#define QUERY_PLAN_CACHE QueryPlanCache::getInstance()
+
+#endif // QUERYPLANCACHE_H
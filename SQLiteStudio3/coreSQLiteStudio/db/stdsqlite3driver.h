@@ -26,6 +26,7 @@
         typedef Prefix##sqlite3_value value; \
         typedef Prefix##sqlite3_int64 int64; \
         typedef Prefix##sqlite3_destructor_type destructor_type; \
+        typedef Prefix##sqlite3_blob blob; \
         \
         static destructor_type TRANSIENT() {return UppercasePrefix##SQLITE_TRANSIENT;} \
         static void interrupt(handle* arg) {Prefix##sqlite3_interrupt(arg);} \
@@ -83,6 +84,12 @@
         static int create_collation_v2(handle* a1, const char *a2, int a3, void *a4, int(*a5)(void*,int,const void*,int,const void*), void(*a6)(void*)) \
             {return Prefix##sqlite3_create_collation_v2(a1, a2, a3, a4, a5, a6);} \
         static int complete(const char* arg) {return Prefix##sqlite3_complete(arg);} \
+        static int blob_open(handle* a1, const char* a2, const char* a3, const char* a4, int64 a5, int a6, blob** a7) \
+            {return Prefix##sqlite3_blob_open(a1, a2, a3, a4, a5, a6, a7);} \
+        static int blob_close(blob* arg) {return Prefix##sqlite3_blob_close(arg);} \
+        static int blob_bytes(blob* arg) {return Prefix##sqlite3_blob_bytes(arg);} \
+        static int blob_read(blob* a1, void* a2, int a3, int a4) {return Prefix##sqlite3_blob_read(a1, a2, a3, a4);} \
+        static int blob_write(blob* a1, const void* a2, int a3, int a4) {return Prefix##sqlite3_blob_write(a1, a2, a3, a4);} \
     };
 
 #endif // STDSQLITE3DRIVER_H
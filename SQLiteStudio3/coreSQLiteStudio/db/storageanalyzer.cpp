@@ -0,0 +1,560 @@
+#include "storageanalyzer.h"
+#include "db/db.h"
+#include "db/dbfileprober.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QFile>
+#include <QFileInfo>
+#include <QUrl>
+#include <QSet>
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+
+DEFINE_SINGLETON(StorageAnalyzer)
+
+namespace
+{
+    const int PAGE_INTERIOR_INDEX = 2;
+    const int PAGE_INTERIOR_TABLE = 5;
+    const int PAGE_LEAF_INDEX = 10;
+    const int PAGE_LEAF_TABLE = 13;
+    const int DB_HEADER_SIZE = 100;
+    const int PAGE_PADDING = 16;
+
+    /**
+     * Reads b-tree pages directly from the database file, as described in the SQLite file format documentation.
+     */
+    class PageWalker
+    {
+        public:
+            bool open(const QString& path, QString& errorMessage)
+            {
+                file.setFileName(path);
+                if (!file.open(QIODevice::ReadOnly))
+                {
+                    errorMessage = QCoreApplication::translate("StorageAnalyzer", "Could not open database file for reading: %1").arg(file.errorString());
+                    return false;
+                }
+
+                QByteArray header = file.read(DB_HEADER_SIZE);
+                if (header.size() < DB_HEADER_SIZE)
+                {
+                    errorMessage = QCoreApplication::translate("StorageAnalyzer", "Database file header is incomplete.");
+                    return false;
+                }
+
+                const uchar* data = reinterpret_cast<const uchar*>(header.constData());
+                pageSize = get16(data, 16);
+                if (pageSize == 1)
+                    pageSize = 65536;
+
+                usableSize = pageSize - data[20];
+                if (pageSize < 512 || usableSize < 480)
+                {
+                    errorMessage = QCoreApplication::translate("StorageAnalyzer", "Database file header contains invalid page size.");
+                    return false;
+                }
+
+                // The page count in the header is valid only if the "version valid for" matches the change counter.
+                pageCount = get32(data, 28);
+                if (pageCount == 0 || get32(data, 92) != get32(data, 24))
+                    pageCount = file.size() / pageSize;
+
+                freePages = get32(data, 36);
+                return true;
+            }
+
+            void walk(qint64 rootPage, StorageAnalyzer::ObjectStats& stats)
+            {
+                QVector<qint64> stack = {rootPage};
+                QSet<qint64> visited;
+                QVector<qint64> children;
+                qint64 prevLeaf = -1;
+                qint64 gaps = 0;
+                qint64 pageNo;
+                while (!stack.isEmpty())
+                {
+                    pageNo = stack.takeLast();
+                    if (pageNo < 1 || pageNo > pageCount || visited.contains(pageNo))
+                        continue; // corrupted file, or a loop in the tree
+
+                    visited << pageNo;
+                    if (!readPage(pageNo))
+                        continue;
+
+                    children.clear();
+                    if (!processPage(pageNo, stats, children))
+                        continue;
+
+                    if (children.isEmpty())
+                    {
+                        if (prevLeaf > 0 && pageNo != prevLeaf + 1)
+                            gaps++;
+
+                        prevLeaf = pageNo;
+                    }
+
+                    // Children are pushed in reverse order, so leaves are visited in the key order.
+                    for (int i = children.size() - 1; i >= 0; i--)
+                        stack << children[i];
+                }
+
+                if (stats.leafPages > 1)
+                    stats.fragmentation = static_cast<double>(gaps) / (stats.leafPages - 1);
+            }
+
+            int pageSize = 0;
+            int usableSize = 0;
+            qint64 pageCount = 0;
+            qint64 freePages = 0;
+
+        private:
+            bool readPage(qint64 pageNo)
+            {
+                if (!file.seek((pageNo - 1) * pageSize))
+                    return false;
+
+                page = file.read(pageSize);
+                if (page.size() != pageSize)
+                    return false;
+
+                // Padding lets cells at the end of the page to be decoded without checking bounds for every byte.
+                page.append(QByteArray(PAGE_PADDING, '\0'));
+                return true;
+            }
+
+            bool processPage(qint64 pageNo, StorageAnalyzer::ObjectStats& stats, QVector<qint64>& children)
+            {
+                const uchar* data = reinterpret_cast<const uchar*>(page.constData());
+                int hdr = (pageNo == 1) ? DB_HEADER_SIZE : 0;
+                int type = data[hdr];
+                bool leaf = (type == PAGE_LEAF_INDEX || type == PAGE_LEAF_TABLE);
+                if (!leaf && type != PAGE_INTERIOR_INDEX && type != PAGE_INTERIOR_TABLE)
+                    return false;
+
+                int hdrSize = leaf ? 8 : 12;
+                int cellCount = get16(data, hdr + 3);
+                int contentStart = get16(data, hdr + 5);
+                if (contentStart == 0)
+                    contentStart = 65536;
+
+                int cellPointers = hdr + hdrSize;
+                if (cellPointers + cellCount * 2 > usableSize)
+                    return false;
+
+                // Unused space is the gap between cell pointers and cell contents, freeblocks and fragmented bytes.
+                qint64 unused = qMax(0, contentStart - (cellPointers + cellCount * 2)) + data[hdr + 7];
+                int freeblock = get16(data, hdr + 1);
+                for (int i = 0; freeblock > 0 && freeblock + 4 <= usableSize && i < usableSize / 4; i++)
+                {
+                    unused += get16(data, freeblock + 2);
+                    freeblock = get16(data, freeblock);
+                }
+
+                stats.pages++;
+                stats.unused += unused;
+                if (leaf)
+                {
+                    stats.leafPages++;
+                    stats.cells += cellCount;
+                }
+                else
+                {
+                    stats.interiorPages++;
+                }
+
+                int cellOffset;
+                for (int i = 0; i < cellCount; i++)
+                {
+                    cellOffset = get16(data, cellPointers + i * 2);
+                    if (cellOffset + 4 > usableSize)
+                        continue;
+
+                    if (!leaf)
+                        children << get32(data, cellOffset);
+
+                    if (type != PAGE_INTERIOR_TABLE)
+                        processPayload(type, data, leaf ? cellOffset : cellOffset + 4, stats);
+                }
+
+                if (!leaf)
+                    children << get32(data, hdr + 8);
+
+                return true;
+            }
+
+            void processPayload(int type, const uchar* data, int offset, StorageAnalyzer::ObjectStats& stats)
+            {
+                qint64 payload = 0;
+                getVarint(data, offset, payload);
+
+                qint64 maxLocal = (type == PAGE_LEAF_TABLE) ? (usableSize - 35) : ((usableSize - 12) * 64 / 255 - 23);
+                qint64 minLocal = (usableSize - 12) * 32 / 255 - 23;
+                qint64 local = payload;
+                if (payload > maxLocal)
+                {
+                    local = minLocal + (payload - minLocal) % (usableSize - 4);
+                    if (local > maxLocal)
+                        local = minLocal;
+                }
+
+                stats.payload += payload;
+                if (payload <= local)
+                    return;
+
+                // Overflow pages are not read, their number and unused space comes from the payload size.
+                qint64 overflowCapacity = usableSize - 4;
+                qint64 overflowBytes = payload - local;
+                qint64 overflowPages = (overflowBytes + overflowCapacity - 1) / overflowCapacity;
+                stats.overflowPages += overflowPages;
+                stats.pages += overflowPages;
+                stats.unused += overflowPages * overflowCapacity - overflowBytes;
+            }
+
+            static int get16(const uchar* data, int offset)
+            {
+                return (data[offset] << 8) | data[offset + 1];
+            }
+
+            static qint64 get32(const uchar* data, int offset)
+            {
+                return (static_cast<quint32>(data[offset]) << 24) | (data[offset + 1] << 16) | (data[offset + 2] << 8) | data[offset + 3];
+            }
+
+            static int getVarint(const uchar* data, int offset, qint64& value)
+            {
+                quint64 result = 0;
+                for (int i = 0; i < 8; i++)
+                {
+                    result = (result << 7) | (data[offset + i] & 0x7f);
+                    if (!(data[offset + i] & 0x80))
+                    {
+                        value = static_cast<qint64>(result);
+                        return i + 1;
+                    }
+                }
+
+                result = (result << 8) | data[offset + 8];
+                value = static_cast<qint64>(result);
+                return 9;
+            }
+
+            QFile file;
+            QByteArray page;
+    };
+}
+
+StorageAnalyzer::StorageAnalyzer()
+{
+}
+
+StorageAnalyzer::Report StorageAnalyzer::analyze(Db* db, Method method)
+{
+    Report report;
+    if (!db || !db->isOpen())
+    {
+        report.errorMessage = QCoreApplication::translate("StorageAnalyzer", "Database is not open.");
+        return report;
+    }
+
+    if (db->getDialect() != Dialect::Sqlite3)
+    {
+        report.errorMessage = QCoreApplication::translate("StorageAnalyzer", "Storage analysis is supported only for SQLite 3 databases.");
+        return report;
+    }
+
+    FileStamp stamp = getFileStamp(db);
+    report.path = stamp.path.isEmpty() ? db->getPath() : stamp.path;
+    report.modified = stamp.modified;
+    report.fileSize = stamp.size;
+
+    bool analyzed = false;
+    switch (method)
+    {
+        case Method::AUTO:
+            analyzed = analyzeWithDbstat(db, report) || analyzeWithPageWalk(db, report);
+            break;
+        case Method::DBSTAT:
+            analyzed = analyzeWithDbstat(db, report);
+            break;
+        case Method::PAGE_WALK:
+            analyzed = analyzeWithPageWalk(db, report);
+            break;
+    }
+
+    if (!analyzed)
+    {
+        if (!report.errorMessage.isEmpty())
+            return report;
+
+        switch (method)
+        {
+            case Method::AUTO:
+                report.errorMessage = QCoreApplication::translate("StorageAnalyzer", "The dbstat virtual table is not available and the database is not a local file, that could be read directly.");
+                break;
+            case Method::DBSTAT:
+                report.errorMessage = QCoreApplication::translate("StorageAnalyzer", "The dbstat virtual table is not available.");
+                break;
+            case Method::PAGE_WALK:
+                report.errorMessage = QCoreApplication::translate("StorageAnalyzer", "The database is not a local SQLite 3 file, that could be read directly.");
+                break;
+        }
+        return report;
+    }
+
+    finalizeReport(report);
+    if (!stamp.path.isEmpty() && method == Method::AUTO)
+    {
+        QMutexLocker lock(&mutex);
+        cache[stamp.path] = qMakePair(stamp, report);
+    }
+    return report;
+}
+
+QFuture<StorageAnalyzer::Report> StorageAnalyzer::analyzeAsync(Db* db)
+{
+    return QtConcurrent::run(this, &StorageAnalyzer::analyze, db, Method::AUTO);
+}
+
+bool StorageAnalyzer::getCached(Db* db, Report& report)
+{
+    FileStamp stamp = getFileStamp(db);
+    if (stamp.path.isEmpty())
+        return false;
+
+    QMutexLocker lock(&mutex);
+    if (!cache.contains(stamp.path))
+        return false;
+
+    const QPair<FileStamp, Report>& entry = cache[stamp.path];
+    if (!(entry.first == stamp))
+    {
+        cache.remove(stamp.path);
+        return false;
+    }
+
+    report = entry.second;
+    return true;
+}
+
+void StorageAnalyzer::clearCache()
+{
+    QMutexLocker lock(&mutex);
+    cache.clear();
+}
+
+bool StorageAnalyzer::analyzeWithDbstat(Db* db, Report& report)
+{
+    static_qstring(dbstatSql, "SELECT name, pageno, pagetype, ncell, payload, unused FROM dbstat ORDER BY name, path");
+
+    SqlQueryPtr results = db->exec(dbstatSql, Db::Flag::NO_LOCK);
+    if (results->isError())
+    {
+        qDebug() << "dbstat is not available, storage analysis will read database file directly:" << results->getErrorText();
+        return false;
+    }
+
+    QHash<QString, MasterEntry> masterEntries;
+    loadMasterEntries(db, masterEntries);
+
+    ObjectStats stats;
+    SqlResultsRowPtr row;
+    QString name;
+    QString pageType;
+    qint64 pageNo;
+    qint64 prevLeaf = -1;
+    qint64 gaps = 0;
+    auto finishObject = [&]()
+    {
+        if (stats.name.isNull())
+            return;
+
+        if (stats.leafPages > 1)
+            stats.fragmentation = static_cast<double>(gaps) / (stats.leafPages - 1);
+
+        report.objects << stats;
+    };
+
+    while (results->hasNext())
+    {
+        row = results->next();
+        name = row->value("name").toString();
+        if (name != stats.name)
+        {
+            finishObject();
+            stats = ObjectStats();
+            stats.name = name;
+            stats.type = masterEntries.value(name).type;
+            stats.table = masterEntries.value(name).table;
+            if (stats.type.isEmpty()) // sqlite_schema in newer SQLite versions
+            {
+                stats.type = "table";
+                stats.table = name;
+            }
+
+            prevLeaf = -1;
+            gaps = 0;
+        }
+
+        pageNo = row->value("pageno").toLongLong();
+        pageType = row->value("pagetype").toString();
+        stats.pages++;
+        stats.payload += row->value("payload").toLongLong();
+        stats.unused += row->value("unused").toLongLong();
+        if (pageType == "leaf")
+        {
+            stats.leafPages++;
+            stats.cells += row->value("ncell").toLongLong();
+            if (prevLeaf > 0 && pageNo != prevLeaf + 1)
+                gaps++;
+
+            prevLeaf = pageNo;
+        }
+        else if (pageType == "overflow")
+        {
+            stats.overflowPages++;
+        }
+        else
+        {
+            stats.interiorPages++;
+        }
+    }
+    finishObject();
+
+    report.pageSize = db->exec("PRAGMA page_size", Db::Flag::NO_LOCK)->getSingleCell().toInt();
+    report.pageCount = db->exec("PRAGMA page_count", Db::Flag::NO_LOCK)->getSingleCell().toLongLong();
+    report.freePages = db->exec("PRAGMA freelist_count", Db::Flag::NO_LOCK)->getSingleCell().toLongLong();
+    report.fromDbstat = true;
+    return true;
+}
+
+bool StorageAnalyzer::analyzeWithPageWalk(Db* db, Report& report)
+{
+    FileStamp stamp = getFileStamp(db);
+    if (stamp.path.isEmpty() || DbFileProber::detectFormat(stamp.path) != DbFileProber::Format::SQLITE3)
+        return false;
+
+    QHash<QString, MasterEntry> masterEntries;
+    if (!loadMasterEntries(db, masterEntries))
+    {
+        report.errorMessage = QCoreApplication::translate("StorageAnalyzer", "Could not read list of database objects.");
+        return false;
+    }
+
+    PageWalker walker;
+    if (!walker.open(stamp.path, report.errorMessage))
+        return false;
+
+    ObjectStats stats;
+    for (auto it = masterEntries.begin(), end = masterEntries.end(); it != end; ++it)
+    {
+        stats = ObjectStats();
+        stats.name = it.key();
+        stats.type = it.value().type;
+        stats.table = it.value().table;
+        walker.walk(it.value().rootPage, stats);
+        report.objects << stats;
+    }
+
+    report.pageSize = walker.pageSize;
+    report.pageCount = walker.pageCount;
+    report.freePages = walker.freePages;
+    report.approximate = (stamp.walSize > 0);
+    return true;
+}
+
+bool StorageAnalyzer::loadMasterEntries(Db* db, QHash<QString, MasterEntry>& entries)
+{
+    static_qstring(masterSql, "SELECT type, name, tbl_name, rootpage FROM sqlite_master WHERE rootpage > 0");
+
+    SqlQueryPtr results = db->exec(masterSql, Db::Flag::NO_LOCK);
+    if (results->isError())
+        return false;
+
+    MasterEntry entry;
+    entry.type = "table";
+    entry.table = "sqlite_master";
+    entry.rootPage = 1;
+    entries["sqlite_master"] = entry;
+
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        entry.type = row->value("type").toString();
+        entry.table = row->value("tbl_name").toString();
+        entry.rootPage = row->value("rootpage").toLongLong();
+        entries[row->value("name").toString()] = entry;
+    }
+    return true;
+}
+
+void StorageAnalyzer::finalizeReport(Report& report)
+{
+    int pageSize = report.pageSize;
+    std::sort(report.objects.begin(), report.objects.end(), [pageSize](const ObjectStats& s1, const ObjectStats& s2)
+    {
+        return s1.getSize(pageSize) > s2.getSize(pageSize);
+    });
+}
+
+StorageAnalyzer::FileStamp StorageAnalyzer::getFileStamp(Db* db)
+{
+    FileStamp stamp;
+    QUrl url(db->getPath());
+    if (!url.scheme().isEmpty() && url.scheme() != "file")
+        return stamp;
+
+    QFileInfo fileInfo(db->getPath());
+    if (!fileInfo.exists() || !fileInfo.isFile())
+        return stamp;
+
+    stamp.path = fileInfo.absoluteFilePath();
+    stamp.modified = fileInfo.lastModified();
+    stamp.size = fileInfo.size();
+
+    QFileInfo walInfo(stamp.path + "-wal");
+    if (walInfo.exists())
+    {
+        stamp.walModified = walInfo.lastModified();
+        stamp.walSize = walInfo.size();
+    }
+    return stamp;
+}
+
+bool StorageAnalyzer::FileStamp::operator==(const FileStamp& other) const
+{
+    return path == other.path && modified == other.modified && size == other.size &&
+            walModified == other.walModified && walSize == other.walSize;
+}
+
+qint64 StorageAnalyzer::ObjectStats::getSize(int pageSize) const
+{
+    return pages * pageSize;
+}
+
+bool StorageAnalyzer::Report::isValid() const
+{
+    return errorMessage.isEmpty() && pageSize > 0;
+}
+
+const StorageAnalyzer::ObjectStats* StorageAnalyzer::Report::getObject(const QString& name) const
+{
+    for (const ObjectStats& stats : objects)
+    {
+        if (stats.name.compare(name, Qt::CaseInsensitive) == 0)
+            return &stats;
+    }
+    return nullptr;
+}
+
+qint64 StorageAnalyzer::Report::getEstimatedVacuumGain() const
+{
+    qint64 gain = freePages * pageSize;
+    for (const ObjectStats& stats : objects)
+        gain += stats.unused;
+
+    return gain;
+}
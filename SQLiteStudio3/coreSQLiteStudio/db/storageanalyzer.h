@@ -0,0 +1,149 @@
+#ifndef STORAGEANALYZER_H
+#define STORAGEANALYZER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/global.h"
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QFuture>
+#include <QDateTime>
+#include <QStringList>
+
+class Db;
+
+/**
+ * @brief Reports how the space of the database file is used by tables and indexes.
+ *
+ * The analysis uses the dbstat virtual table if the SQLite library provides it. Otherwise the b-tree pages
+ * are read directly from the database file (which works only for local, unencrypted SQLite 3 files).
+ * Reading pages directly skips changes that were not checkpointed from the WAL file yet, so in that case
+ * the report is marked as approximate.
+ *
+ * Analysis reads every page of the database, so it should be done in a background thread (see analyzeAsync()).
+ * Reports are cached per file, together with the file modification time and size, so asking again
+ * about an unchanged file is instant.
+ */
+class API_EXPORT StorageAnalyzer
+{
+    DECLARE_SINGLETON(StorageAnalyzer)
+
+    public:
+        /**
+         * @brief Storage statistics of single b-tree (table or index).
+         */
+        struct ObjectStats
+        {
+            QString name;
+            QString table;              /**< Table that the index belongs to, or the table name itself. */
+            QString type;               /**< Either "table" or "index". */
+            qint64 pages = 0;           /**< All pages, including overflow pages. */
+            qint64 leafPages = 0;
+            qint64 interiorPages = 0;
+            qint64 overflowPages = 0;
+            qint64 cells = 0;           /**< Number of entries in leaf pages (rows of the table, entries of the index). */
+            qint64 payload = 0;         /**< Bytes of stored data, including overflow pages. */
+            qint64 unused = 0;          /**< Unused bytes in all pages of the b-tree. */
+            double fragmentation = 0.0; /**< Fraction (0-1) of leaf pages not following the previous leaf page in the file. */
+
+            qint64 getSize(int pageSize) const;
+        };
+
+        /**
+         * @brief Analysis results for single database file.
+         */
+        struct Report
+        {
+            QString path;
+            QDateTime modified;
+            qint64 fileSize = -1;
+            int pageSize = 0;
+            qint64 pageCount = 0;
+            qint64 freePages = 0;
+            bool fromDbstat = false;
+            bool approximate = false;
+            QList<ObjectStats> objects; /**< Sorted by the size, descending. */
+            QString errorMessage;
+
+            bool isValid() const;
+            const ObjectStats* getObject(const QString& name) const;
+
+            /**
+             * @brief Estimates number of bytes that VACUUM would give back.
+             * @return Size of free pages plus unused space in pages of all objects.
+             *
+             * It's an upper bound, as VACUUM doesn't fill pages completely.
+             */
+            qint64 getEstimatedVacuumGain() const;
+        };
+
+        /**
+         * @brief Source of page statistics.
+         */
+        enum class Method
+        {
+            AUTO,       /**< The dbstat if it's available, reading the file directly otherwise. */
+            DBSTAT,
+            PAGE_WALK
+        };
+
+        StorageAnalyzer();
+
+        /**
+         * @brief Analyzes the "main" database of given connection in the calling thread.
+         * @param db Open database.
+         * @param method Source of page statistics. Only reports made with Method::AUTO are cached.
+         * @return Analysis report. In case of failure Report::errorMessage is set.
+         */
+        Report analyze(Db* db, Method method = Method::AUTO);
+
+        /**
+         * @brief Analyzes the database in a background thread.
+         * @param db Open database.
+         * @return Future of the analysis report.
+         */
+        QFuture<Report> analyzeAsync(Db* db);
+
+        /**
+         * @brief Provides cached report.
+         * @param db Database to get the report for.
+         * @param report Output report.
+         * @return true if the report was found and the file was not modified since then.
+         */
+        bool getCached(Db* db, Report& report);
+
+        void clearCache();
+
+    private:
+        struct FileStamp
+        {
+            QString path;
+            QDateTime modified;
+            qint64 size = -1;
+            QDateTime walModified;
+            qint64 walSize = -1;
+
+            bool operator==(const FileStamp& other) const;
+        };
+
+        struct MasterEntry
+        {
+            QString type;
+            QString table;
+            qint64 rootPage = 0;
+        };
+
+        bool analyzeWithDbstat(Db* db, Report& report);
+        bool analyzeWithPageWalk(Db* db, Report& report);
+        bool loadMasterEntries(Db* db, QHash<QString, MasterEntry>& entries);
+        void finalizeReport(Report& report);
+
+        static FileStamp getFileStamp(Db* db);
+
+        QHash<QString, QPair<FileStamp, Report>> cache;
+        QMutex mutex;
+};
+
+#define STORAGE_ANALYZER StorageAnalyzer::getInstance()
+
+#endif // STORAGEANALYZER_H
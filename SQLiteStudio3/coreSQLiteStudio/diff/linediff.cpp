@@ -0,0 +1,446 @@
+#include "linediff.h"
+#include "diff/diff_match_patch.h"
+#include "parser/lexer.h"
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+
+namespace
+{
+    struct Unit
+    {
+        int start;
+        int length;
+    };
+
+    QVector<Unit> splitLines(const QString& text)
+    {
+        QVector<Unit> units;
+        int start = 0;
+        int lgt = text.length();
+        const QChar* chars = text.constData();
+        for (int i = 0; i < lgt; i++)
+        {
+            if (chars[i] != '\n')
+                continue;
+
+            units << Unit{start, i - start + 1};
+            start = i + 1;
+        }
+
+        if (start < lgt)
+            units << Unit{start, lgt - start};
+
+        return units;
+    }
+
+    QVector<Unit> splitTokens(const QString& text)
+    {
+        QVector<Unit> units;
+        TokenList tokens = Lexer::tokenize(text, Dialect::Sqlite3);
+        units.reserve(tokens.size());
+        for (const TokenPtr& token : tokens)
+            units << Unit{static_cast<int>(token->start), static_cast<int>(token->end - token->start + 1)};
+
+        return units;
+    }
+
+    /**
+     * Linear space variant of the Myers algorithm, working on unit identifiers.
+     * Its outcome is a flag for every unit of both sides, telling if the unit was changed.
+     */
+    class MyersEngine
+    {
+        public:
+            MyersEngine(const QVector<int>& left, const QVector<int>& right, const QElapsedTimer& timer, int timeBudget) :
+                left(left), right(right), timer(timer), timeBudget(timeBudget)
+            {
+                leftChanged.fill(false, left.size());
+                rightChanged.fill(false, right.size());
+            }
+
+            void run()
+            {
+                compare(0, left.size(), 0, right.size());
+            }
+
+            bool isExpired() const
+            {
+                return timeBudget > 0 && timer.hasExpired(timeBudget);
+            }
+
+            QVector<bool> leftChanged;
+            QVector<bool> rightChanged;
+            bool timedOut = false;
+
+        private:
+            void compare(int leftLo, int leftHi, int rightLo, int rightHi)
+            {
+                while (leftLo < leftHi && rightLo < rightHi && left[leftLo] == right[rightLo])
+                {
+                    leftLo++;
+                    rightLo++;
+                }
+
+                while (leftLo < leftHi && rightLo < rightHi && left[leftHi - 1] == right[rightHi - 1])
+                {
+                    leftHi--;
+                    rightHi--;
+                }
+
+                if (leftLo == leftHi || rightLo == rightHi)
+                {
+                    markChanged(leftLo, leftHi, rightLo, rightHi);
+                    return;
+                }
+
+                // Single unit on either side is too short for the bisection, it's either in the other range, or not at all.
+                if (leftHi - leftLo == 1 || rightHi - rightLo == 1)
+                {
+                    compareSingle(leftLo, leftHi, rightLo, rightHi);
+                    return;
+                }
+
+                int leftMid;
+                int rightMid;
+                if (!findMiddleSnake(leftLo, leftHi, rightLo, rightHi, leftMid, rightMid))
+                {
+                    markChanged(leftLo, leftHi, rightLo, rightHi);
+                    return;
+                }
+
+                compare(leftLo, leftMid, rightLo, rightMid);
+                compare(leftMid, leftHi, rightMid, rightHi);
+            }
+
+            bool findMiddleSnake(int leftLo, int leftHi, int rightLo, int rightHi, int& leftMid, int& rightMid)
+            {
+                const int* a = left.constData() + leftLo;
+                const int* b = right.constData() + rightLo;
+                int n = leftHi - leftLo;
+                int m = rightHi - rightLo;
+                int maxD = (n + m + 1) / 2;
+                int vOffset = maxD;
+                int vLength = 2 * maxD;
+                QVector<int> v1(vLength, -1);
+                QVector<int> v2(vLength, -1);
+                v1[vOffset + 1] = 0;
+                v2[vOffset + 1] = 0;
+
+                // If the total number of units is odd, then the front path will collide with the reverse path.
+                int delta = n - m;
+                bool front = (delta % 2 != 0);
+
+                // Offsets for start and end of k loop, preventing mapping of space beyond the grid.
+                int k1start = 0;
+                int k1end = 0;
+                int k2start = 0;
+                int k2end = 0;
+                int x1;
+                int y1;
+                int x2;
+                int y2;
+                int k1Offset;
+                int k2Offset;
+                for (int d = 0; d < maxD; d++)
+                {
+                    if (isExpired())
+                    {
+                        timedOut = true;
+                        return false;
+                    }
+
+                    // Forward path
+                    for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2)
+                    {
+                        k1Offset = vOffset + k1;
+                        if (k1 == -d || (k1 != d && v1[k1Offset - 1] < v1[k1Offset + 1]))
+                            x1 = v1[k1Offset + 1];
+                        else
+                            x1 = v1[k1Offset - 1] + 1;
+
+                        y1 = x1 - k1;
+                        while (x1 < n && y1 < m && a[x1] == b[y1])
+                        {
+                            x1++;
+                            y1++;
+                        }
+
+                        v1[k1Offset] = x1;
+                        if (x1 > n)
+                        {
+                            k1end += 2;
+                        }
+                        else if (y1 > m)
+                        {
+                            k1start += 2;
+                        }
+                        else if (front)
+                        {
+                            k2Offset = vOffset + delta - k1;
+                            if (k2Offset >= 0 && k2Offset < vLength && v2[k2Offset] != -1 && x1 >= n - v2[k2Offset])
+                            {
+                                leftMid = leftLo + x1;
+                                rightMid = rightLo + y1;
+                                return true;
+                            }
+                        }
+                    }
+
+                    // Reverse path
+                    for (int k2 = -d + k2start; k2 <= d - k2end; k2 += 2)
+                    {
+                        k2Offset = vOffset + k2;
+                        if (k2 == -d || (k2 != d && v2[k2Offset - 1] < v2[k2Offset + 1]))
+                            x2 = v2[k2Offset + 1];
+                        else
+                            x2 = v2[k2Offset - 1] + 1;
+
+                        y2 = x2 - k2;
+                        while (x2 < n && y2 < m && a[n - x2 - 1] == b[m - y2 - 1])
+                        {
+                            x2++;
+                            y2++;
+                        }
+
+                        v2[k2Offset] = x2;
+                        if (x2 > n)
+                        {
+                            k2end += 2;
+                        }
+                        else if (y2 > m)
+                        {
+                            k2start += 2;
+                        }
+                        else if (!front)
+                        {
+                            k1Offset = vOffset + delta - k2;
+                            if (k1Offset >= 0 && k1Offset < vLength && v1[k1Offset] != -1)
+                            {
+                                x1 = v1[k1Offset];
+                                y1 = vOffset + x1 - k1Offset;
+                                if (x1 >= n - x2)
+                                {
+                                    leftMid = leftLo + x1;
+                                    rightMid = rightLo + y1;
+                                    return true;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                // No common units at all.
+                return false;
+            }
+
+            void compareSingle(int leftLo, int leftHi, int rightLo, int rightHi)
+            {
+                markChanged(leftLo, leftHi, rightLo, rightHi);
+                if (leftHi - leftLo == 1)
+                {
+                    for (int i = rightLo; i < rightHi; i++)
+                    {
+                        if (right[i] == left[leftLo])
+                        {
+                            leftChanged[leftLo] = false;
+                            rightChanged[i] = false;
+                            return;
+                        }
+                    }
+                    return;
+                }
+
+                for (int i = leftLo; i < leftHi; i++)
+                {
+                    if (left[i] == right[rightLo])
+                    {
+                        leftChanged[i] = false;
+                        rightChanged[rightLo] = false;
+                        return;
+                    }
+                }
+            }
+
+            void markChanged(int leftLo, int leftHi, int rightLo, int rightHi)
+            {
+                for (int i = leftLo; i < leftHi; i++)
+                    leftChanged[i] = true;
+
+                for (int i = rightLo; i < rightHi; i++)
+                    rightChanged[i] = true;
+            }
+
+            const QVector<int>& left;
+            const QVector<int>& right;
+            const QElapsedTimer& timer;
+            int timeBudget;
+    };
+
+    QVector<int> toIdentifiers(const QString& text, const QVector<Unit>& units, QHash<QStringRef, int>& identifiers)
+    {
+        QVector<int> result;
+        result.reserve(units.size());
+        QStringRef ref;
+        for (const Unit& unit : units)
+        {
+            ref = QStringRef(&text, unit.start, unit.length);
+            if (!identifiers.contains(ref))
+                identifiers.insert(ref, identifiers.size());
+
+            result << identifiers.value(ref);
+        }
+        return result;
+    }
+
+    void addRange(QList<LineDiff::Range>& ranges, int start, int length)
+    {
+        if (length <= 0)
+            return;
+
+        if (!ranges.isEmpty())
+        {
+            LineDiff::Range& last = ranges.last();
+            if (last.start + last.length == start)
+            {
+                last.length += length;
+                return;
+            }
+        }
+
+        LineDiff::Range range;
+        range.start = start;
+        range.length = length;
+        ranges << range;
+    }
+}
+
+LineDiff::LineDiff()
+{
+}
+
+LineDiff::Mode LineDiff::getMode() const
+{
+    return mode;
+}
+
+void LineDiff::setMode(Mode value)
+{
+    mode = value;
+}
+
+void LineDiff::setTimeBudget(int value)
+{
+    timeBudget = value;
+}
+
+int LineDiff::getTimeBudget() const
+{
+    return timeBudget;
+}
+
+void LineDiff::setCharRefinementLimit(int value)
+{
+    charRefinementLimit = value;
+}
+
+int LineDiff::getCharRefinementLimit() const
+{
+    return charRefinementLimit;
+}
+
+LineDiff::Result LineDiff::diff(const QString& left, const QString& right) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<Unit> leftUnits = (mode == Mode::LINES) ? splitLines(left) : splitTokens(left);
+    QVector<Unit> rightUnits = (mode == Mode::LINES) ? splitLines(right) : splitTokens(right);
+
+    // Same units get the same identifier, so the algorithm compares integers only.
+    QHash<QStringRef, int> identifiers;
+    identifiers.reserve(leftUnits.size() + rightUnits.size());
+    QVector<int> leftIds = toIdentifiers(left, leftUnits, identifiers);
+    QVector<int> rightIds = toIdentifiers(right, rightUnits, identifiers);
+
+    MyersEngine engine(leftIds, rightIds, timer, timeBudget);
+    engine.run();
+
+    Result result;
+    diff_match_patch charDiff;
+
+    int leftCount = leftUnits.size();
+    int rightCount = rightUnits.size();
+    int i = 0;
+    int j = 0;
+    int leftStart;
+    int rightStart;
+    int leftLength;
+    int rightLength;
+    int leftPos;
+    int rightPos;
+    int lgt;
+    while (i < leftCount || j < rightCount)
+    {
+        if (i < leftCount && j < rightCount && !engine.leftChanged[i] && !engine.rightChanged[j])
+        {
+            i++;
+            j++;
+            continue;
+        }
+
+        // Changed block - all consecutive changed units on both sides.
+        leftStart = (i < leftCount) ? leftUnits[i].start : left.length();
+        rightStart = (j < rightCount) ? rightUnits[j].start : right.length();
+        leftLength = 0;
+        rightLength = 0;
+        while (i < leftCount && engine.leftChanged[i])
+            leftLength += leftUnits[i++].length;
+
+        while (j < rightCount && engine.rightChanged[j])
+            rightLength += rightUnits[j++].length;
+
+        if (leftLength == 0 && rightLength == 0)
+            break; // shouldn't happen, unchanged units of both sides should always pair up
+
+        if (leftLength == 0 || rightLength == 0 || charRefinementLimit <= 0 || leftLength + rightLength > charRefinementLimit ||
+                engine.isExpired())
+        {
+            addRange(result.deleted, leftStart, leftLength);
+            addRange(result.inserted, rightStart, rightLength);
+            continue;
+        }
+
+        if (timeBudget > 0)
+            charDiff.Diff_Timeout = qMax(0.001f, static_cast<float>(timeBudget - timer.elapsed()) / 1000.0f);
+        else
+            charDiff.Diff_Timeout = 0;
+
+        QList<Diff> diffs = charDiff.diff_main(left.mid(leftStart, leftLength), right.mid(rightStart, rightLength), false);
+        charDiff.diff_cleanupSemantic(diffs);
+        leftPos = leftStart;
+        rightPos = rightStart;
+        for (const Diff& d : diffs)
+        {
+            lgt = d.text.length();
+            switch (d.operation)
+            {
+                case DELETE:
+                    addRange(result.deleted, leftPos, lgt);
+                    leftPos += lgt;
+                    break;
+                case INSERT:
+                    addRange(result.inserted, rightPos, lgt);
+                    rightPos += lgt;
+                    break;
+                case EQUAL:
+                    leftPos += lgt;
+                    rightPos += lgt;
+                    break;
+            }
+        }
+    }
+
+    result.timedOut = engine.timedOut;
+    return result;
+}
@@ -0,0 +1,94 @@
+#ifndef LINEDIFF_H
+#define LINEDIFF_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QList>
+
+/**
+ * @brief Diff of two texts, computed on lines or SQL tokens instead of single characters.
+ *
+ * Both texts are split into units (lines or SQL tokens, see Mode), each unit is replaced with an integer identifier
+ * and identifiers are compared with the linear space variant of the Myers algorithm. Common prefix and suffix
+ * are stripped before each recursion step, so large, mostly equal texts (like schema dumps) are compared quickly.
+ *
+ * Units that were changed on both sides in the same place are compared once again at the character level,
+ * using diff_match_patch, as long as they are not longer than the character refinement limit.
+ * This gives precise highlighting of small changes within a line, without running the character level
+ * algorithm on whole texts.
+ *
+ * The comparison has a time budget. Parts of texts that were not compared until the budget ran out are reported
+ * as deleted on the left side and inserted on the right side. In that case Result::timedOut is set.
+ *
+ * The class keeps only settings, so single instance can be used from many threads at once.
+ */
+class API_EXPORT LineDiff
+{
+    public:
+        /**
+         * @brief Unit of comparison.
+         */
+        enum class Mode
+        {
+            LINES,  /**< Lines, including the line terminator. */
+            TOKENS  /**< SQL tokens, as produced by the Lexer (including whitespaces and comments). */
+        };
+
+        /**
+         * @brief Range of characters in the compared text.
+         */
+        struct Range
+        {
+            int start = 0;
+            int length = 0;
+        };
+
+        /**
+         * @brief Result of the comparison.
+         *
+         * Ranges are sorted, they don't overlap and they don't touch each other.
+         */
+        struct Result
+        {
+            QList<Range> deleted;  /**< Ranges of the left text that are missing in the right text. */
+            QList<Range> inserted; /**< Ranges of the right text that are missing in the left text. */
+            bool timedOut = false; /**< Time budget ran out and some parts were not compared precisely. */
+        };
+
+        LineDiff();
+
+        Mode getMode() const;
+        void setMode(Mode value);
+
+        /**
+         * @brief Defines time budget for single comparison.
+         * @param value Time in milliseconds. Zero or less means no limit.
+         */
+        void setTimeBudget(int value);
+        int getTimeBudget() const;
+
+        /**
+         * @brief Defines maximum length of changed block to be compared at character level.
+         * @param value Maximum number of characters (sum of both sides). Zero disables character level comparison.
+         */
+        void setCharRefinementLimit(int value);
+        int getCharRefinementLimit() const;
+
+        /**
+         * @brief Compares two texts.
+         * @param left Old text.
+         * @param right New text.
+         * @return Changed ranges of both texts.
+         */
+        Result diff(const QString& left, const QString& right) const;
+
+        static const int DEFAULT_TIME_BUDGET = 1000;
+        static const int DEFAULT_CHAR_REFINEMENT_LIMIT = 4000;
+
+    private:
+        Mode mode = Mode::LINES;
+        int timeBudget = DEFAULT_TIME_BUDGET;
+        int charRefinementLimit = DEFAULT_CHAR_REFINEMENT_LIMIT;
+};
+
+#endif // LINEDIFF_H
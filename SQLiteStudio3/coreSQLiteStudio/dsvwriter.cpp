@@ -0,0 +1,142 @@
+#include "dsvwriter.h"
+#include <limits>
+
+DsvWriter::DsvWriter(const QString& columnSeparator, const QString& rowSeparator, bool quoteValuesWithQuotes) :
+    columnSeparator(columnSeparator), rowSeparator(rowSeparator), quoteValuesWithQuotes(quoteValuesWithQuotes)
+{
+    // Values are always quoted with empty separator (see scan()), so these are used only for non-empty ones
+    columnChar = columnSeparator.isEmpty() ? '"' : columnSeparator[0].unicode();
+    rowChar = rowSeparator.isEmpty() ? '"' : rowSeparator[0].unicode();
+}
+
+void DsvWriter::reserve(int size)
+{
+    output.reserve(size);
+}
+
+int DsvWriter::size() const
+{
+    return output.size();
+}
+
+void DsvWriter::appendRow(const QStringList& values)
+{
+    for (const QString& value : values)
+        appendValue(value);
+
+    finishRow();
+}
+
+void DsvWriter::appendValue(const QString& value)
+{
+    if (column == 0)
+    {
+        if (rows > 0)
+            output.append(rowSeparator);
+
+        rows++;
+    }
+    else
+    {
+        output.append(columnSeparator);
+    }
+
+    column++;
+    appendEscaped(value);
+}
+
+void DsvWriter::finishRow()
+{
+    if (column == 0)
+    {
+        // Row without values still takes its place in the output
+        if (rows > 0)
+            output.append(rowSeparator);
+
+        rows++;
+    }
+    column = 0;
+}
+
+QString DsvWriter::getOutput() const
+{
+    return output;
+}
+
+int DsvWriter::estimateSize(const QList<QStringList>& data) const
+{
+    qint64 total = 0;
+    for (const QStringList& row : data)
+    {
+        for (const QString& value : row)
+            total += value.size();
+
+        total += qMax(row.size() - 1, 0) * columnSeparator.size() + rowSeparator.size();
+    }
+    return static_cast<int>(qMin<qint64>(total, std::numeric_limits<int>::max()));
+}
+
+void DsvWriter::appendEscaped(const QString& value)
+{
+    bool hasQuote = false;
+    bool hasSeparator = false;
+    scan(value, hasQuote, hasSeparator);
+    if (!hasSeparator && !(hasQuote && quoteValuesWithQuotes))
+    {
+        output.append(value);
+        return;
+    }
+
+    output.append('"');
+    int start = 0;
+    int pos;
+    while (hasQuote && (pos = value.indexOf('"', start)) > -1)
+    {
+        output.append(value.midRef(start, pos - start + 1));
+        output.append('"');
+        start = pos + 1;
+    }
+    output.append(value.midRef(start));
+    output.append('"');
+}
+
+void DsvWriter::scan(const QString& value, bool& hasQuote, bool& hasSeparator) const
+{
+    if (columnSeparator.isEmpty() || rowSeparator.isEmpty())
+    {
+        // Empty separator is "contained" in any string, as QString::contains() defines it.
+        hasSeparator = true;
+        hasQuote = value.contains('"');
+        return;
+    }
+
+    const QChar* data = value.constData();
+    int length = value.size();
+    int pos = 0;
+    for (; pos < length; pos += SCAN_BLOCK_SIZE)
+    {
+        if (hasCandidateChars(data + pos, qMin(SCAN_BLOCK_SIZE, length - pos)))
+            break;
+    }
+
+    if (pos >= length)
+        return;
+
+    // None of separators can start before the block with first candidate character
+    hasQuote = value.indexOf('"', pos) > -1;
+    hasSeparator = value.indexOf(columnSeparator, pos) > -1 || value.indexOf(rowSeparator, pos) > -1;
+}
+
+bool DsvWriter::hasCandidateChars(const QChar* data, int length) const
+{
+    ushort colChr = columnChar;
+    ushort rowChr = rowChar;
+    ushort found = 0;
+    ushort c;
+    for (int i = 0; i < length; i++)
+    {
+        c = data[i].unicode();
+        found |= (c == '"') | (c == colChr) | (c == rowChr);
+    }
+    return found;
+}
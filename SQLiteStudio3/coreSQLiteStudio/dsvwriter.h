@@ -0,0 +1,57 @@
+#ifndef DSVWRITER_H
+#define DSVWRITER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Writes delimiter separated values (CSV, TSV) into a single output buffer.
+ *
+ * Values are appended one by one, so the caller does not need to build intermediate lists of strings.
+ * Each value is scanned only once for characters that require quoting. Values are skipped block by block,
+ * with comparisons that have no branches in the inner loop, so the compiler can turn them into vector instructions.
+ * Only blocks with a candidate character are checked precisely.
+ */
+class API_EXPORT DsvWriter
+{
+    public:
+        /**
+         * @brief Creates writer.
+         * @param columnSeparator Separator put between values in a row.
+         * @param rowSeparator Separator put between rows.
+         * @param quoteValuesWithQuotes If true, values containing double quote character are quoted (CSV).
+         * Otherwise only values containing a separator are quoted (TSV).
+         */
+        DsvWriter(const QString& columnSeparator, const QString& rowSeparator, bool quoteValuesWithQuotes);
+
+        void reserve(int size);
+        int size() const;
+        void appendRow(const QStringList& values);
+        void appendValue(const QString& value);
+        void finishRow();
+        QString getOutput() const;
+
+        /**
+         * @brief Calculates output size for given data, not counting quotes that might be needed.
+         */
+        int estimateSize(const QList<QStringList>& data) const;
+
+    private:
+        void appendEscaped(const QString& value);
+        void scan(const QString& value, bool& hasQuote, bool& hasSeparator) const;
+        bool hasCandidateChars(const QChar* data, int length) const;
+
+        static const int SCAN_BLOCK_SIZE = 32;
+
+        QString columnSeparator;
+        QString rowSeparator;
+        bool quoteValuesWithQuotes;
+        ushort columnChar;
+        ushort rowChar;
+        QString output;
+        int rows = 0;
+        int column = 0;
+};
+
+#endif // DSVWRITER_H
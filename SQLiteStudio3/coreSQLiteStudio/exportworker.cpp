@@ -6,6 +6,7 @@
 #include "common/utils.h"
 #include "db/sqlresultsrow.h"
 #include <QMutexLocker>
+#include <QFileDevice>
 #include <QDebug>
 
 ExportWorker::ExportWorker(ExportPlugin* plugin, ExportManager::StandardExportConfig* config, QIODevice* output, QObject *parent) :
@@ -52,6 +53,9 @@ void ExportWorker::run()
             break;
     }
 
+    if (res)
+        res = flushOutput();
+
     plugin->cleanupAfterExport();
 
     emit finished(res, output);
@@ -650,6 +654,22 @@ bool ExportWorker::isInterrupted()
     return interrupted;
 }
 
+bool ExportWorker::flushOutput()
+{
+    // The last chunk of buffered data is written only now, so full disk and such errors may show up here
+    bool res = plugin->flushOutput();
+    QFileDevice* file = qobject_cast<QFileDevice*>(output);
+    if (res && file)
+        res = file->flush();
+
+    if (!res)
+    {
+        logExportFail("flushOutput()");
+        notifyError(tr("Could not write exported data: %1").arg(output ? output->errorString() : QString()));
+    }
+    return res;
+}
+
 void ExportWorker::logExportFail(const QString &stageName)
 {
     qWarning() << "Export has faild at" << stageName << "stage.";
@@ -9,13 +9,27 @@ SqliteStatement::SqliteStatement()
 }
 
 SqliteStatement::SqliteStatement(const SqliteStatement& other) :
-    QObject(), tokens(other.tokens), tokensMap(other.tokensMap), dialect(other.dialect)
+    tokens(other.tokens), tokensMap(other.tokensMap), dialect(other.dialect)
 {
 
 }
 
 SqliteStatement::~SqliteStatement()
 {
+    if (guard)
+        *guard = nullptr;
+
+    if (parentStmt)
+        parentStmt->children.removeOne(this);
+
+    // Children are told they have no parent anymore, so they don't look for themselves in the list being deleted.
+    QList<SqliteStatement*> childrenToDelete = children;
+    children.clear();
+    for (SqliteStatement* child : childrenToDelete)
+    {
+        child->parentStmt = nullptr;
+        delete child;
+    }
 }
 
 QString SqliteStatement::detokenize()
@@ -510,21 +524,19 @@ SqliteStatement *SqliteStatement::findStatementWithPosition(quint64 cursorPositi
     return findStatementWithToken(token);
 }
 
-SqliteStatement *SqliteStatement::parentStatement()
+SqliteStatement* SqliteStatement::parent() const
 {
-    if (!parent())
-        return nullptr;
-
-    return dynamic_cast<SqliteStatement*>(parent());
+    return parentStmt;
 }
 
-QList<SqliteStatement *> SqliteStatement::childStatements()
+SqliteStatement *SqliteStatement::parentStatement() const
 {
-    QList<SqliteStatement*> results;
-    for (QObject* obj : children())
-        results += dynamic_cast<SqliteStatement*>(obj);
+    return parentStmt;
+}
 
-    return results;
+QList<SqliteStatement *> SqliteStatement::childStatements() const
+{
+    return children;
 }
 
 void SqliteStatement::rebuildTokens()
@@ -537,12 +549,28 @@ void SqliteStatement::rebuildTokens()
     // and then compare new tokens map with previous one. This way we should be able to get all maps correctly.
 }
 
-void SqliteStatement::setParent(QObject* parent)
+void SqliteStatement::setParent(SqliteStatement* parent)
 {
-    QObject::setParent(parent);
-    SqliteStatement* stmt = qobject_cast<SqliteStatement*>(parent);
-    if (stmt)
-        dialect = stmt->dialect;
+    if (parent != parentStmt && parent != this)
+    {
+        if (parentStmt)
+            parentStmt->children.removeOne(this);
+
+        parentStmt = parent;
+        if (parentStmt)
+            parentStmt->children << this;
+    }
+
+    if (parentStmt)
+        dialect = parentStmt->dialect;
+}
+
+const QSharedPointer<SqliteStatement*>& SqliteStatement::getGuard()
+{
+    if (!guard)
+        guard = QSharedPointer<SqliteStatement*>::create(this);
+
+    return guard;
 }
 
 void SqliteStatement::attach(SqliteStatement*& memberForChild, SqliteStatement* childStatementToAttach)
@@ -6,7 +6,6 @@
 #include "dialect.h"
 #include <QList>
 #include <QHash>
-#include <QObject>
 #include <QPair>
 #include <QStringList>
 #include <QSharedPointer>
@@ -180,10 +179,18 @@ typedef QSharedPointer<SqliteStatement> SqliteStatementPtr;
  * an independed entity, with its own lifetime.
  *
  * For the opposite operation, use SqliteStatement::attach().
+ *
+ * @section statement_not_qobject Statements are not QObjects
+ *
+ * Parsing a big schema creates hundreds of thousands of statements, so they are kept as light as possible.
+ * The parent-children relation is maintained by the statement itself (see parent(), childStatements() and setParent())
+ * and there are no signals or slots. If you need a pointer that gets nulled when the statement is deleted
+ * (like QPointer for QObjects), use SqliteStatementGuard.
  */
-class API_EXPORT SqliteStatement : public QObject
+class API_EXPORT SqliteStatement
 {
-    Q_OBJECT
+    template <class T>
+    friend class SqliteStatementGuard;
 
     public:
         struct FullObject
@@ -209,12 +216,15 @@ class API_EXPORT SqliteStatement : public QObject
         SqliteStatement(const SqliteStatement& other);
         virtual ~SqliteStatement();
 
+        SqliteStatement& operator=(const SqliteStatement& other) = delete;
+
         QString detokenize();
         Range getRange();
         SqliteStatement* findStatementWithToken(TokenPtr token);
         SqliteStatement* findStatementWithPosition(quint64 cursorPosition);
-        SqliteStatement* parentStatement();
-        QList<SqliteStatement*> childStatements();
+        SqliteStatement* parent() const;
+        SqliteStatement* parentStatement() const;
+        QList<SqliteStatement*> childStatements() const;
         QStringList getContextColumns(bool checkParent = true, bool checkChilds = true);
         QStringList getContextTables(bool checkParent = true, bool checkChilds = true);
         QStringList getContextDatabases(bool checkParent = true, bool checkChilds = true);
@@ -224,7 +234,7 @@ class API_EXPORT SqliteStatement : public QObject
         QList<FullObject> getContextFullObjects(bool checkParent = true, bool checkChilds = true);
         void setSqliteDialect(Dialect dialect);
         void rebuildTokens();
-        void setParent(QObject* parent);
+        void setParent(SqliteStatement* parent);
         void attach(SqliteStatement*& memberForChild, SqliteStatement* childStatementToAttach);
         SqliteStatementPtr detach();
         void processPostParsing();
@@ -334,6 +344,49 @@ class API_EXPORT SqliteStatement : public QObject
 
     private:
         QList<SqliteStatement*> getContextStatements(SqliteStatement* caller, bool checkParent, bool checkChilds);
+        const QSharedPointer<SqliteStatement*>& getGuard();
+
+        SqliteStatement* parentStmt = nullptr;
+        QList<SqliteStatement*> children;
+
+        /**
+         * @brief Shared cell pointing to this statement, nulled in the destructor.
+         * Created only when the first SqliteStatementGuard is made for this statement.
+         */
+        QSharedPointer<SqliteStatement*> guard;
+};
+
+/**
+ * @ingroup sqlite_statement
+ *
+ * @brief Guarded pointer to the statement.
+ *
+ * Works just like QPointer works for QObjects - it becomes null once the pointed statement is deleted.
+ * It's meant for long living references to statements owned by someone else (like in dialogs editing
+ * parts of the CREATE TABLE statement). It should not be used for statements being currently parsed,
+ * as creating the guard allocates memory.
+ */
+template <class T>
+class SqliteStatementGuard
+{
+    public:
+        SqliteStatementGuard() {}
+        SqliteStatementGuard(T* stmt) :
+            stmt(stmt)
+        {
+            if (stmt)
+                guard = static_cast<SqliteStatement*>(stmt)->getGuard();
+        }
+
+        T* data() const {return (guard && *guard) ? stmt : nullptr;}
+        bool isNull() const {return !data();}
+        T* operator->() const {return data();}
+        T& operator*() const {return *data();}
+        operator T*() const {return data();}
+
+    private:
+        T* stmt = nullptr;
+        QSharedPointer<SqliteStatement*> guard;
 };
 
 #endif // SQLITESTATEMENT_H
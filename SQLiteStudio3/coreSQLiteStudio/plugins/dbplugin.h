@@ -3,6 +3,8 @@
 
 #include "db/db.h"
 #include "db/dbpluginoption.h"
+#include "db/dbfileprober.h"
+#include "common/unused.h"
 #include "plugins/plugin.h"
 
 /**
@@ -68,6 +70,21 @@ class API_EXPORT DbPlugin : virtual public Plugin
          * so when some plugin is about to be unloaded, all its databases are closed properly first.
          */
         virtual bool checkIfDbServedByPlugin(Db* db) const = 0;
+
+        /**
+         * @brief Tells if the plugin can handle database file of given format.
+         * @param format Format recognized from the file header.
+         * @return true if getInstance() may succeed for such file, or false if there is no point in calling it.
+         *
+         * DbManager uses this to avoid opening database files with plugins that cannot handle them anyway.
+         * Default implementation returns true, so the plugin is asked about every file.
+         * Plugins supporting encrypted databases should keep it that way, as encrypted files have no known header.
+         */
+        virtual bool isFileFormatSupported(DbFileProber::Format format) const
+        {
+            UNUSED(format);
+            return true;
+        }
 };
 
 #endif // DBPLUGIN_H
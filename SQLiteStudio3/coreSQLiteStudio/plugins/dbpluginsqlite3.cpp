@@ -45,3 +45,18 @@ bool DbPluginSqlite3::checkIfDbServedByPlugin(Db* db) const
 {
     return (db && dynamic_cast<DbSqlite3*>(db));
 }
+
+bool DbPluginSqlite3::isFileFormatSupported(DbFileProber::Format format) const
+{
+    switch (format)
+    {
+        case DbFileProber::Format::SQLITE3:
+        case DbFileProber::Format::EMPTY:
+        case DbFileProber::Format::UNREADABLE:
+            return true;
+        case DbFileProber::Format::SQLITE2:
+        case DbFileProber::Format::UNKNOWN:
+            break;
+    }
+    return false;
+}
@@ -361,6 +361,15 @@ class ExportPlugin : virtual public Plugin
          */
         virtual bool afterExport() = 0;
 
+        /**
+         * @brief Passes any data still buffered by the plugin to the output device.
+         * @return true for success, or false if the data could not be written.
+         *
+         * This is called after afterExport() of a successful export, before cleanupAfterExport().
+         * If it fails, the export is reported as failed.
+         */
+        virtual bool flushOutput() = 0;
+
         /**
          * @brief Called after every export, even failed one.
          *
@@ -21,6 +21,7 @@ bool GenericExportPlugin::initBeforeExport(Db* db, QIODevice* output, const Expo
         }
     }
 
+    outputBuffer.setOutput(output, codec);
     return beforeExport();
 }
 
@@ -87,12 +88,18 @@ bool GenericExportPlugin::initBeforeExport()
 
 void GenericExportPlugin::write(const QString& str)
 {
-    output->write(codec->fromUnicode(str));
+    outputBuffer.write(str);
 }
 
 void GenericExportPlugin::writeln(const QString& str)
 {
-    write(str + "\n");
+    outputBuffer.writeln(str);
+}
+
+bool GenericExportPlugin::flushOutput()
+{
+    // Data flushed earlier, when the buffer was full, could have failed as well
+    return outputBuffer.flush() && !outputBuffer.hasWriteError();
 }
 
 bool GenericExportPlugin::isTableExport() const
@@ -3,6 +3,7 @@
 
 #include "exportplugin.h"
 #include "genericplugin.h"
+#include "common/exportoutputbuffer.h"
 
 class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public ExportPlugin
 {
@@ -31,6 +32,7 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
         bool afterExportViews();
         bool afterExportDatabase();
         bool afterExport();
+        bool flushOutput();
         void cleanupAfterExport();
 
         /**
@@ -53,6 +55,14 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
         const ExportManager::StandardExportConfig* config = nullptr;
         QTextCodec* codec = nullptr;
         ExportManager::ExportMode exportMode = ExportManager::UNDEFINED;
+
+        /**
+         * @brief Buffer for the export output.
+         *
+         * write() and writeln() go through this buffer. Plugins can also use it directly to write escaped values
+         * without building intermediate strings.
+         */
+        ExportOutputBuffer outputBuffer;
 };
 
 #endif // GENERICEXPORTPLUGIN_H
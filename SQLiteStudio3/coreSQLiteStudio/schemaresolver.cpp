@@ -2,12 +2,14 @@
 #include "db/db.h"
 #include "db/sqlresultsrow.h"
 #include "parser/parsererror.h"
+#include "parser/token.h"
 #include "parser/ast/sqlitecreatetable.h"
 #include "parser/ast/sqlitecreateindex.h"
 #include "parser/ast/sqlitecreatetrigger.h"
 #include "parser/ast/sqlitecreateview.h"
 #include "parser/ast/sqlitecreatevirtualtable.h"
 #include "parser/ast/sqlitetablerelatedddl.h"
+#include <QtConcurrent/QtConcurrent>
 #include <QDebug>
 
 const char* sqliteMasterDdl =
@@ -16,6 +18,8 @@ const char* sqliteTempMasterDdl =
     "CREATE TABLE sqlite_temp_master (type text, name text, tbl_name text, rootpage integer, sql text)";
 
 ExpiringCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::cache;
+QCache<QString, SqliteQueryPtr> SchemaResolver::parsedDdlCache;
+QMutex SchemaResolver::parsedDdlCacheMutex;
 
 SchemaResolver::SchemaResolver(Db *db)
     : db(db)
@@ -551,6 +555,83 @@ StrHash< SqliteCreateViewPtr> SchemaResolver::getAllParsedViews(const QString& d
 }
 
 SqliteQueryPtr SchemaResolver::getParsedDdl(const QString& ddl)
+{
+    QString key = getParsedDdlCacheKey(ddl, db->getDialect());
+    parsedDdlCacheMutex.lock();
+    if (parsedDdlCache.contains(key))
+    {
+        SqliteQueryPtr query = cloneParsedDdl(*parsedDdlCache.object(key));
+        parsedDdlCacheMutex.unlock();
+        return query;
+    }
+    parsedDdlCacheMutex.unlock();
+
+    SqliteQueryPtr query = parseDdl(parser, ddl);
+
+    QMutexLocker lock(&parsedDdlCacheMutex);
+    parsedDdlCache.insert(key, new SqliteQueryPtr(query));
+    return cloneParsedDdl(query);
+}
+
+QList<SqliteQueryPtr> SchemaResolver::getParsedDdls(const QStringList& ddls)
+{
+    Dialect dialect = db->getDialect();
+    QVector<SqliteQueryPtr> results(ddls.size());
+    QStringList keys;
+    QList<int> toParse;
+
+    // Reuse whatever was parsed before
+    parsedDdlCacheMutex.lock();
+    for (int i = 0, total = ddls.size(); i < total; ++i)
+    {
+        keys << getParsedDdlCacheKey(ddls[i], dialect);
+        if (parsedDdlCache.contains(keys[i]))
+            results[i] = cloneParsedDdl(*parsedDdlCache.object(keys[i]));
+        else
+            toParse << i;
+    }
+    parsedDdlCacheMutex.unlock();
+
+    if (toParse.isEmpty())
+        return results.toList();
+
+    // Parse the rest
+    QVector<SqliteQueryPtr> parsed(ddls.size());
+    if (toParse.size() < PARALLEL_PARSING_THRESHOLD)
+    {
+        for (int idx : toParse)
+            parsed[idx] = parseDdl(parser, ddls[idx]);
+    }
+    else
+    {
+        int chunkCount = qMax(1, QThread::idealThreadCount());
+        int chunkSize = (toParse.size() + chunkCount - 1) / chunkCount;
+        QList<QList<int>> chunks;
+        for (int i = 0, total = toParse.size(); i < total; i += chunkSize)
+            chunks << toParse.mid(i, chunkSize);
+
+        // Each chunk writes to its own indexes of the already allocated vector.
+        SqliteQueryPtr* parsedData = parsed.data();
+        QtConcurrent::blockingMap(chunks, [parsedData, &ddls, dialect](const QList<int>& chunk)
+        {
+            Parser threadParser(dialect);
+            for (int idx : chunk)
+                parsedData[idx] = parseDdl(&threadParser, ddls[idx]);
+        });
+    }
+
+    // Objects created in pool threads stay in the cache. Copies handed out are created in the current thread.
+    QMutexLocker lock(&parsedDdlCacheMutex);
+    for (int idx : toParse)
+    {
+        parsedDdlCache.insert(keys[idx], new SqliteQueryPtr(parsed[idx]));
+        results[idx] = cloneParsedDdl(parsed[idx]);
+    }
+
+    return results.toList();
+}
+
+SqliteQueryPtr SchemaResolver::parseDdl(Parser* parser, const QString& ddl)
 {
     if (!parser->parse(ddl))
     {
@@ -573,6 +654,60 @@ SqliteQueryPtr SchemaResolver::getParsedDdl(const QString& ddl)
     return queries[0];
 }
 
+QString SchemaResolver::getParsedDdlCacheKey(const QString& ddl, Dialect dialect)
+{
+    return (dialect == Dialect::Sqlite3 ? QStringLiteral("3:") : QStringLiteral("2:")) + ddl;
+}
+
+SqliteQueryPtr SchemaResolver::cloneParsedDdl(const SqliteQueryPtr& query)
+{
+    if (!query)
+        return SqliteQueryPtr();
+
+    SqliteQuery* copy = dynamic_cast<SqliteQuery*>(query->clone());
+    if (!copy)
+        return SqliteQueryPtr();
+
+    // Cloned statements share tokens with the original and callers tend to modify tokens,
+    // so the copy gets tokens of its own. Same token used in many places is copied only once.
+    QHash<Token*, TokenPtr> tokenCopies;
+    copyTokens(copy, tokenCopies);
+    return SqliteQueryPtr(copy);
+}
+
+void SchemaResolver::copyTokens(SqliteStatement* stmt, QHash<Token*, TokenPtr>& tokenCopies)
+{
+    copyTokens(stmt->tokens, tokenCopies);
+    for (TokenList& tokens : stmt->tokensMap)
+        copyTokens(tokens, tokenCopies);
+
+    for (SqliteStatement* child : stmt->childStatements())
+    {
+        if (child)
+            copyTokens(child, tokenCopies);
+    }
+}
+
+void SchemaResolver::copyTokens(TokenList& tokens, QHash<Token*, TokenPtr>& tokenCopies)
+{
+    for (TokenPtr& token : tokens)
+    {
+        if (!token)
+            continue;
+
+        TokenPtr& tokenCopy = tokenCopies[token.data()];
+        if (!tokenCopy)
+        {
+            TolerantToken* tolerantToken = dynamic_cast<TolerantToken*>(token.data());
+            if (tolerantToken)
+                tokenCopy = TokenPtr(new TolerantToken(*tolerantToken));
+            else
+                tokenCopy = TokenPtr::create(*token);
+        }
+        token = tokenCopy;
+    }
+}
+
 QStringList SchemaResolver::getObjects(const QString &type)
 {
     return getObjects(QString::null, type);
@@ -949,6 +1084,13 @@ SchemaResolver::ObjectType SchemaResolver::stringToObjectType(const QString& typ
 void SchemaResolver::staticInit()
 {
     cache.setExpireTime(3000);
+    parsedDdlCache.setMaxCost(PARSED_DDL_CACHE_SIZE);
+}
+
+void SchemaResolver::clearParsedDdlCache()
+{
+    QMutexLocker lock(&parsedDdlCacheMutex);
+    parsedDdlCache.clear();
 }
 
 bool SchemaResolver::usesCache()
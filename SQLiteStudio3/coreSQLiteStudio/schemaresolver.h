@@ -16,6 +16,8 @@
 #include "common/strhash.h"
 #include "common/expiringcache.h"
 #include <QStringList>
+#include <QCache>
+#include <QMutex>
 
 class SqliteCreateTable;
 
@@ -190,11 +192,45 @@ class API_EXPORT SchemaResolver
         static ObjectType stringToObjectType(const QString& type);
         static void staticInit();
 
+        /**
+         * @brief Drops all parsed DDLs shared by resolvers.
+         *
+         * The cache is keyed by the DDL only, so it's not known which database the entries came from.
+         * It's cleared as a whole whenever a database is closed or unloaded.
+         */
+        static void clearParsedDdlCache();
+
         static_char* USE_SCHEMA_CACHING = "useSchemaCaching";
 
+        /**
+         * @brief Maximum number of parsed DDLs kept in the cache shared by all resolvers.
+         */
+        static const int PARSED_DDL_CACHE_SIZE = 2000;
+
+        /**
+         * @brief Minimum number of DDLs to parse at once, for which parsing is spread over the thread pool.
+         */
+        static const int PARALLEL_PARSING_THRESHOLD = 64;
+
     private:
         bool usesCache();
         SqliteQueryPtr getParsedDdl(const QString& ddl);
+
+        /**
+         * @brief Parses many DDLs at once.
+         * @param ddls DDLs to parse.
+         * @return Parsed objects, in the same order as \p ddls. Null pointers for DDLs that could not be parsed.
+         *
+         * DDLs that were parsed before are taken from the cache. If there's enough DDLs left to parse,
+         * they're parsed in the global thread pool, with a separate Parser for each thread.
+         */
+        QList<SqliteQueryPtr> getParsedDdls(const QStringList& ddls);
+        static SqliteQueryPtr parseDdl(Parser* parser, const QString& ddl);
+        static QString getParsedDdlCacheKey(const QString& ddl, Dialect dialect);
+        static SqliteQueryPtr cloneParsedDdl(const SqliteQueryPtr& query);
+        static void copyTokens(SqliteStatement* stmt, QHash<Token*, TokenPtr>& tokenCopies);
+        static void copyTokens(TokenList& tokens, QHash<Token*, TokenPtr>& tokenCopies);
+
         SqliteCreateTablePtr virtualTableAsRegularTable(const QString& database, const QString& table);
         StrHash< QStringList> getGroupedObjects(const QString &database, const QStringList& inputList, SqliteQueryType type);
         bool isFilteredOut(const QString& value, const QString& type);
@@ -212,6 +248,15 @@ class API_EXPORT SchemaResolver
         Db::Flags dbFlags;
 
         static ExpiringCache<ObjectCacheKey,QVariant> cache;
+
+        /**
+         * @brief Parsed DDLs, keyed by the DDL itself (prefixed with the dialect).
+         *
+         * Objects in the cache are never handed out directly, as callers are free to modify them.
+         * Each caller gets its own copy (see cloneParsedDdl()).
+         */
+        static QCache<QString, SqliteQueryPtr> parsedDdlCache;
+        static QMutex parsedDdlCacheMutex;
 };
 
 int qHash(const SchemaResolver::ObjectCacheKey& key);
@@ -231,22 +276,27 @@ StrHash<QSharedPointer<T>> SchemaResolver::getAllParsedObjectsForType(const QStr
      else
          results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master WHERE type = '%2';").arg(dbName, type));
 
-     QString name;
-     SqliteQueryPtr parsedObject;
-     QSharedPointer<T> castedObject;
+     QStringList names;
+     QStringList ddls;
      for (SqlResultsRowPtr row : results->getAll())
      {
-         name = row->value("name").toString();
-         parsedObject = getParsedDdl(row->value("sql").toString());
-         if (!parsedObject)
+         if (isFilteredOut(row->value("name").toString(), row->value("type").toString()))
              continue;
 
-         if (isFilteredOut(name, row->value("type").toString()))
+         names << row->value("name").toString();
+         ddls << row->value("sql").toString();
+     }
+
+     QList<SqliteQueryPtr> parsedDdls = getParsedDdls(ddls);
+     QSharedPointer<T> castedObject;
+     for (int i = 0, total = names.size(); i < total; ++i)
+     {
+         if (!parsedDdls[i])
              continue;
 
-         castedObject = parsedObject.dynamicCast<T>();
+         castedObject = parsedDdls[i].dynamicCast<T>();
          if (castedObject)
-             parsedObjects[name] = castedObject;
+             parsedObjects[names[i]] = castedObject;
      }
 
      return parsedObjects;
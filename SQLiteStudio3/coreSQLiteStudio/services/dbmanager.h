@@ -163,6 +163,15 @@ class API_EXPORT DbManager : public QObject
          */
         virtual bool isTemporary(Db* db) = 0;
 
+        /**
+         * @brief Tells if the initial list of databases is completely loaded.
+         * @return true if dbListLoaded() was already emitted, false otherwise.
+         *
+         * When running with GUI, databases from configuration are probed for supporting plugins in background,
+         * so the application doesn't wait for it. Until this is finished, databases not probed yet are invalid.
+         */
+        virtual bool isDbListLoaded() const = 0;
+
         virtual DbPlugin* getPluginForDbFile(const QString& filePath) = 0;
         virtual QString generateUniqueDbName(const QString& filePath) = 0;
         virtual QString generateUniqueDbName(DbPlugin* plugin, const QString& filePath) = 0;
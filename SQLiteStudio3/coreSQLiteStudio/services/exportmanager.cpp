@@ -62,7 +62,7 @@ bool ExportManager::isExportInProgress() const
     return exportInProgress;
 }
 
-void ExportManager::exportQueryResults(Db* db, const QString& query)
+void ExportManager::exportQueryResults(Db* db, const QString& query, bool async)
 {
     if (!checkInitialConditions())
         return;
@@ -78,15 +78,15 @@ void ExportManager::exportQueryResults(Db* db, const QString& query)
     exportInProgress = true;
     mode = QUERY_RESULTS;
 
-    ExportWorker* worker = prepareExport();
+    ExportWorker* worker = prepareExport(async);
     if (!worker)
         return;
 
     worker->prepareExportQueryResults(db, query);
-    QThreadPool::globalInstance()->start(worker);
+    startExport(worker, async);
 }
 
-void ExportManager::exportTable(Db* db, const QString& database, const QString& table)
+void ExportManager::exportTable(Db* db, const QString& database, const QString& table, bool async)
 {
     static const QString sql = QStringLiteral("SELECT * FROM %1");
 
@@ -104,15 +104,15 @@ void ExportManager::exportTable(Db* db, const QString& database, const QString&
     exportInProgress = true;
     mode = TABLE;
 
-    ExportWorker* worker = prepareExport();
+    ExportWorker* worker = prepareExport(async);
     if (!worker)
         return;
 
     worker->prepareExportTable(db, database, table);
-    QThreadPool::globalInstance()->start(worker);
+    startExport(worker, async);
 }
 
-void ExportManager::exportDatabase(Db* db, const QStringList& objectListToExport)
+void ExportManager::exportDatabase(Db* db, const QStringList& objectListToExport, bool async)
 {
     if (!checkInitialConditions())
         return;
@@ -128,12 +128,12 @@ void ExportManager::exportDatabase(Db* db, const QStringList& objectListToExport
     exportInProgress = true;
     mode = DATABASE;
 
-    ExportWorker* worker = prepareExport();
+    ExportWorker* worker = prepareExport(async);
     if (!worker)
         return;
 
     worker->prepareExportDatabase(db, objectListToExport);
-    QThreadPool::globalInstance()->start(worker);
+    startExport(worker, async);
 }
 
 void ExportManager::interrupt()
@@ -176,7 +176,7 @@ bool ExportManager::checkInitialConditions()
     return true;
 }
 
-ExportWorker* ExportManager::prepareExport()
+ExportWorker* ExportManager::prepareExport(bool async)
 {
     bool usesOutput = plugin->getSupportedModes().testFlag(FILE) || plugin->getSupportedModes().testFlag(CLIPBOARD);
     QIODevice* output = nullptr;
@@ -193,11 +193,27 @@ ExportWorker* ExportManager::prepareExport()
     }
 
     ExportWorker* worker = new ExportWorker(plugin, config, output);
-    connect(worker, SIGNAL(finished(bool,QIODevice*)), this, SLOT(finalizeExport(bool,QIODevice*)));
+
+    // Synchronous export can be called from other thread than this manager lives in (like the CLI thread).
+    // Finalization (and failure signals) must happen before the export*() method returns, not be queued for later.
+    connect(worker, SIGNAL(finished(bool,QIODevice*)), this, SLOT(finalizeExport(bool,QIODevice*)), async ? Qt::AutoConnection : Qt::DirectConnection);
     connect(this, SIGNAL(orderWorkerToInterrupt()), worker, SLOT(interrupt()));
     return worker;
 }
 
+void ExportManager::startExport(ExportWorker* worker, bool async)
+{
+    if (async)
+    {
+        QThreadPool::globalInstance()->start(worker);
+        return;
+    }
+
+    // Worker lives in this thread, so finalizeExport() is called directly from the run().
+    worker->run();
+    delete worker;
+}
+
 void ExportManager::handleClipboardExport()
 {
     if (plugin->getMimeType().isNull())
@@ -190,9 +190,34 @@ class API_EXPORT ExportManager : public PluginServiceBase
          */
         void configure(const QString& format, const StandardExportConfig& config);
         bool isExportInProgress() const;
-        void exportQueryResults(Db* db, const QString& query);
-        void exportTable(Db* db, const QString& database, const QString& table);
-        void exportDatabase(Db* db, const QStringList& objectListToExport);
+
+        /**
+         * @brief Exports results of the query.
+         * @param db Database to execute the query on.
+         * @param query Query to export results of.
+         * @param async If false, the export is done in the calling thread and it's finished when this method returns.
+         *
+         * Synchronous export is meant for non-interactive usage (like batch mode of the CLI), where there is no event loop
+         * running to deliver signals from the export thread.
+         */
+        void exportQueryResults(Db* db, const QString& query, bool async = true);
+
+        /**
+         * @brief Exports table, including its data, indexes and triggers (depending on configuration).
+         * @param db Database of the table.
+         * @param database Attach name of the table.
+         * @param table Table to export.
+         * @param async If false, the export is done in the calling thread. See exportQueryResults() for details.
+         */
+        void exportTable(Db* db, const QString& database, const QString& table, bool async = true);
+
+        /**
+         * @brief Exports database objects.
+         * @param db Database to export.
+         * @param objectListToExport Names of objects to export. Empty list means all objects.
+         * @param async If false, the export is done in the calling thread. See exportQueryResults() for details.
+         */
+        void exportDatabase(Db* db, const QStringList& objectListToExport, bool async = true);
 
         static bool isAnyPluginAvailable();
 
@@ -200,7 +225,8 @@ class API_EXPORT ExportManager : public PluginServiceBase
         void invalidFormat(const QString& format);
         bool checkInitialConditions();
         QIODevice* getOutputStream();
-        ExportWorker* prepareExport();
+        ExportWorker* prepareExport(bool async);
+        void startExport(ExportWorker* worker, bool async);
         void handleClipboardExport();
 
         bool exportInProgress = false;
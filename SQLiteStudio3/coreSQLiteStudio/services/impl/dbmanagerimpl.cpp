@@ -13,6 +13,7 @@
 #include <QDebug>
 #include <QUrl>
 #include <QDir>
+#include <QtConcurrent/QtConcurrent>
 #include <db/invaliddb.h>
 
 DbManagerImpl::DbManagerImpl(QObject *parent) :
@@ -24,6 +25,14 @@ DbManagerImpl::DbManagerImpl(QObject *parent) :
 DbManagerImpl::~DbManagerImpl()
 {
 //    qDebug() << "DbManagerImpl::~DbManagerImpl()";
+    if (pluginsInitiallyLoaded && !initialLoadingFinished)
+    {
+        disconnect(&initialProbing, SIGNAL(finished()), this, SLOT(initialProbingFinished()));
+        initialProbing.waitForFinished();
+        for (const DbFileProber::Result& result : initialProbing.result())
+            delete result.db;
+    }
+
     for (Db* db : dbList)
     {
         disconnect(db, SIGNAL(disconnected()), this, SLOT(dbDisconnectedSlot()));
@@ -279,6 +288,11 @@ bool DbManagerImpl::isTemporary(Db* db)
     return CFG->getDb(db->getName()).isNull();
 }
 
+bool DbManagerImpl::isDbListLoaded() const
+{
+    return initialLoadingFinished;
+}
+
 QString DbManagerImpl::quickAddDb(const QString& path, const QHash<QString, QVariant>& options)
 {
     QString newName = DbManager::generateDbName(path);
@@ -295,20 +309,15 @@ DbPlugin* DbManagerImpl::getPluginForDbFile(const QString& filePath)
     if (!file.exists() || file.isDir())
         return nullptr;
 
-    QHash<QString,QVariant> options;
-    Db* probeDb = nullptr;
-    for (DbPlugin* plugin : dbPlugins)
-    {
-        probeDb = plugin->getInstance("", filePath, options);
-        if (probeDb)
-        {
-            delete probeDb;
-            probeDb = nullptr;
-            return plugin;
-        }
-    }
+    DbFileProber::Candidate candidate;
+    candidate.path = filePath;
 
-    return nullptr;
+    // Any plugin may support the file, so plugins deferred by PluginManager have to be loaded now
+    PLUGINS->getLoadedPlugins<DbPlugin>();
+
+    DbFileProber::Result result = prober.probe(candidate, dbPlugins);
+    safe_delete(result.db);
+    return result.plugin;
 }
 
 QString DbManagerImpl::generateUniqueDbName(const QString& filePath)
@@ -340,6 +349,7 @@ void DbManagerImpl::init()
 
     connect(PLUGINS, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(aboutToUnload(Plugin*,PluginType*)));
     connect(PLUGINS, SIGNAL(loaded(Plugin*,PluginType*)), this, SLOT(loaded(Plugin*,PluginType*)));
+    connect(&initialProbing, SIGNAL(finished()), this, SLOT(initialProbingFinished()));
 }
 
 void DbManagerImpl::loadInitialDbList()
@@ -362,8 +372,31 @@ void DbManagerImpl::loadInitialDbList()
 
 void DbManagerImpl::notifyDatabasesAreLoaded()
 {
-    // Any databases were already loaded by loaded() slot, which is called when DbPlugin was loaded.
-    emit dbListLoaded();
+    QList<DbFileProber::Candidate> candidates = getProbingCandidates();
+    loadPluginsForCandidates(candidates);
+
+    // All plugins are loaded now, so databases from configuration are probed once, for all plugins at the same time.
+    pluginsInitiallyLoaded = true;
+
+    if (candidates.isEmpty())
+    {
+        finishInitialLoading();
+        return;
+    }
+
+    QList<DbPlugin*> plugins = dbPlugins;
+    if (SQLITESTUDIO->isGuiAvailable())
+    {
+        // GUI doesn't wait for databases to be probed. Only registering them is done in the main thread, once they are.
+        initialProbing.setFuture(QtConcurrent::run([this, candidates, plugins]() -> QList<DbFileProber::Result>
+        {
+            return prober.probe(candidates, plugins);
+        }));
+        return;
+    }
+
+    applyProbingResults(prober.probe(candidates, plugins));
+    finishInitialLoading();
 }
 
 void DbManagerImpl::scanForNewDatabasesInConfig()
@@ -398,39 +431,78 @@ void DbManagerImpl::rescanInvalidDatabasesForPlugin(DbPlugin* dbPlugin)
         return;
     }
 
-    Db* db = nullptr;
+    // Plugins loaded at startup are handled all together by notifyDatabasesAreLoaded()
+    if (!pluginsInitiallyLoaded)
+        return;
+
+    if (!initialLoadingFinished)
+    {
+        if (!pluginsToRescan.contains(dbPlugin))
+            pluginsToRescan << dbPlugin;
 
+        return;
+    }
+
+    // Other plugins were already asked about these databases, so only the given one is asked now.
+    applyProbingResults(prober.probe(getProbingCandidates(), {dbPlugin}));
+}
+
+QList<DbFileProber::Candidate> DbManagerImpl::getProbingCandidates() const
+{
+    QList<DbFileProber::Candidate> candidates;
+    DbFileProber::Candidate candidate;
     QUrl url;
-    QString errorMessages;
     for (Db* invalidDb : getInvalidDatabases())
     {
-        if (invalidDb->getConnectionOptions().contains(DB_PLUGIN) && invalidDb->getConnectionOptions()[DB_PLUGIN].toString() != dbPlugin->getName())
-            continue;
-
         url = QUrl::fromUserInput(invalidDb->getPath());
         if (url.isLocalFile() && !QFile::exists(invalidDb->getPath()))
             continue;
 
-        errorMessages = QString();
-        db = createDb(invalidDb->getName(), invalidDb->getPath(), invalidDb->getConnectionOptions(), &errorMessages);
-        if (!db)
+        candidate.name = invalidDb->getName();
+        candidate.path = invalidDb->getPath();
+        candidate.options = invalidDb->getConnectionOptions();
+        candidates << candidate;
+    }
+    return candidates;
+}
+
+void DbManagerImpl::loadPluginsForCandidates(const QList<DbFileProber::Candidate>& candidates)
+{
+    for (const DbFileProber::Candidate& candidate : candidates)
+    {
+        if (!candidate.options.contains(DB_PLUGIN))
         {
-            if (!errorMessages.isNull())
-            {
-                dynamic_cast<InvalidDb*>(invalidDb)->setError(errorMessages);
-            }
-            continue; // For this db driver was not loaded yet.
+            PLUGINS->getLoadedPlugins<DbPlugin>();
+            return;
         }
 
-        if (!dbPlugin->checkIfDbServedByPlugin(db))
-        {
-            qDebug() << "Managed to load database" << db->getPath() << " (" << db->getName() << ")"
-                     << "but it doesn't use DbPlugin that was just loaded, so it will not be loaded to the db manager";
+        PLUGINS->getLoadedPlugin(candidate.options[DB_PLUGIN].toString());
+    }
+}
 
-            delete db;
+void DbManagerImpl::applyProbingResults(const QList<DbFileProber::Result>& results)
+{
+    Db* db = nullptr;
+    InvalidDb* invalidDb = nullptr;
+    for (const DbFileProber::Result& result : results)
+    {
+        db = result.db;
+        invalidDb = dynamic_cast<InvalidDb*>(getByName(result.candidate.name));
+        if (!invalidDb || invalidDb->getPath() != result.candidate.path)
+        {
+            // Removed, loaded or changed while it was being probed
+            safe_delete(db);
             continue;
         }
 
+        if (!db)
+        {
+            if (!result.errorMessage.isNull())
+                invalidDb->setError(result.errorMessage);
+
+            continue; // For this db driver was not loaded yet.
+        }
+
         removeDbInternal(invalidDb, false);
         delete invalidDb;
 
@@ -438,7 +510,7 @@ void DbManagerImpl::rescanInvalidDatabasesForPlugin(DbPlugin* dbPlugin)
 
         if (!db->getConnectionOptions().contains(DB_PLUGIN))
         {
-            db->getConnectionOptions()[DB_PLUGIN] = dbPlugin->getName();
+            db->getConnectionOptions()[DB_PLUGIN] = result.plugin->getName();
             if (!CFG->updateDb(db->getName(), db->getName(), db->getPath(), db->getConnectionOptions()))
                 qWarning() << "Could not store handling plugin in options for database" << db->getName();
         }
@@ -450,6 +522,17 @@ void DbManagerImpl::rescanInvalidDatabasesForPlugin(DbPlugin* dbPlugin)
     }
 }
 
+void DbManagerImpl::finishInitialLoading()
+{
+    initialLoadingFinished = true;
+    emit dbListLoaded();
+
+    QList<DbPlugin*> plugins = pluginsToRescan;
+    pluginsToRescan.clear();
+    for (DbPlugin* plugin : plugins)
+        rescanInvalidDatabasesForPlugin(plugin);
+}
+
 void DbManagerImpl::addDbInternal(Db* db, bool alsoToConfig)
 {
     if (alsoToConfig)
@@ -586,7 +669,16 @@ void DbManagerImpl::aboutToUnload(Plugin* plugin, PluginType* type)
 
     InvalidDb* invalidDb = nullptr;
     DbPlugin* dbPlugin = dynamic_cast<DbPlugin*>(plugin);
+
+    // Initial probing may be using the plugin right now, or have its databases waiting to be applied
+    if (pluginsInitiallyLoaded && !initialLoadingFinished)
+    {
+        initialProbing.waitForFinished();
+        initialProbingFinished();
+    }
+
     dbPlugins.removeOne(dbPlugin);
+    pluginsToRescan.removeOne(dbPlugin);
     QList<Db*> toRemove;
     for (Db* db : dbList)
     {
@@ -624,3 +716,12 @@ void DbManagerImpl::loaded(Plugin* plugin, PluginType* type)
     dbPlugins << dbPlugin;
     rescanInvalidDatabasesForPlugin(dbPlugin);
 }
+
+void DbManagerImpl::initialProbingFinished()
+{
+    if (initialLoadingFinished)
+        return;
+
+    applyProbingResults(initialProbing.result());
+    finishInitialLoading();
+}
@@ -6,11 +6,13 @@
 #include "common/strhash.h"
 #include "common/global.h"
 #include "services/dbmanager.h"
+#include "db/dbfileprober.h"
 #include <QObject>
 #include <QList>
 #include <QHash>
 #include <QReadWriteLock>
 #include <QSharedPointer>
+#include <QFutureWatcher>
 
 class InvalidDb;
 
@@ -44,6 +46,7 @@ class API_EXPORT DbManagerImpl : public DbManager
         Db* getByPath(const QString& path);
         Db* createInMemDb(bool pureInit = false);
         bool isTemporary(Db* db);
+        bool isDbListLoaded() const;
         QString quickAddDb(const QString &path, const QHash<QString, QVariant> &options);
         DbPlugin* getPluginForDbFile(const QString& filePath);
         QString generateUniqueDbName(const QString& filePath);
@@ -99,6 +102,37 @@ class API_EXPORT DbManagerImpl : public DbManager
 
         Db* tryToLoadDb(InvalidDb* invalidDb, bool emitNotifySignal = true);
 
+        /**
+         * @brief Provides invalid databases that are worth probing for a supporting plugin.
+         * @return Invalid databases, except local files that don't exist.
+         */
+        QList<DbFileProber::Candidate> getProbingCandidates() const;
+
+        /**
+         * @brief Makes sure that database plugins needed to probe given databases are loaded.
+         * @param candidates Databases to be probed.
+         *
+         * Database plugins are loaded by PluginManager on demand. Databases that remember their plugin
+         * need only that plugin, but if any database doesn't, then all database plugins are needed.
+         */
+        void loadPluginsForCandidates(const QList<DbFileProber::Candidate>& candidates);
+
+        /**
+         * @brief Replaces invalid databases with databases loaded by the prober.
+         * @param results Results of probing.
+         *
+         * Databases that were removed, loaded or modified while being probed are skipped.
+         * For databases that couldn't be loaded the error message is updated.
+         */
+        void applyProbingResults(const QList<DbFileProber::Result>& results);
+
+        /**
+         * @brief Marks the initial list of databases as loaded and emits dbListLoaded().
+         *
+         * Plugins loaded while initial probing was running get their rescan now.
+         */
+        void finishInitialLoading();
+
         /**
          * @brief Creates database object.
          * @param name Symbolic name of the database.
@@ -143,6 +177,35 @@ class API_EXPORT DbManagerImpl : public DbManager
 
         QList<DbPlugin*> dbPlugins;
 
+        /**
+         * @brief Finds plugins for database files.
+         */
+        DbFileProber prober;
+
+        /**
+         * @brief Watches probing of database files from configuration, done at startup in background.
+         *
+         * Databases are only registered in the main thread, when it's finished.
+         */
+        QFutureWatcher<QList<DbFileProber::Result>> initialProbing;
+
+        /**
+         * @brief Plugins loaded while initial probing was running, to be rescanned once it's finished.
+         */
+        QList<DbPlugin*> pluginsToRescan;
+
+        /**
+         * @brief True after PluginManager loaded all plugins at startup.
+         *
+         * Before that, databases are not probed for each plugin being loaded. They are probed once for all plugins.
+         */
+        bool pluginsInitiallyLoaded = false;
+
+        /**
+         * @brief True after dbListLoaded() was emitted.
+         */
+        bool initialLoadingFinished = false;
+
     private slots:
         /**
          * @brief Slot called when connected to db.
@@ -180,6 +243,11 @@ class API_EXPORT DbManagerImpl : public DbManager
          */
         void loaded(Plugin* plugin, PluginType* type);
 
+        /**
+         * @brief Applies results of probing done in background at startup.
+         */
+        void initialProbingFinished();
+
     public slots:
         void notifyDatabasesAreLoaded();
         void scanForNewDatabasesInConfig();
@@ -1,6 +1,10 @@
 #include "pluginmanagerimpl.h"
 #include "plugins/scriptingplugin.h"
 #include "plugins/genericplugin.h"
+#include "plugins/dbplugin.h"
+#include "plugins/exportplugin.h"
+#include "plugins/importplugin.h"
+#include "plugins/populateplugin.h"
 #include "services/notifymanager.h"
 #include "common/unused.h"
 #include "translations.h"
@@ -9,6 +13,10 @@
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonValue>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
+#include <QElapsedTimer>
 
 PluginManagerImpl::PluginManagerImpl()
 {
@@ -41,8 +49,12 @@ void PluginManagerImpl::init()
     pluginDirs += QCoreApplication::applicationDirPath()+"/../PlugIns";
 #endif
 
+    QElapsedTimer timer;
+    timer.start();
     scanPlugins();
+    qint64 scanTime = timer.restart();
     loadPlugins();
+    qDebug() << "Plugins scanned in" << scanTime << "ms and loaded in" << timer.elapsed() << "ms.";
 }
 
 void PluginManagerImpl::deinit()
@@ -112,24 +124,30 @@ void PluginManagerImpl::scanPlugins()
     QStringList nameFilters;
     nameFilters << "*.so" << "*.dll" << "*.dylib";
 
-    QPluginLoader* loader = nullptr;
+    QHash<QString,QVariant> index = CFG->get(PLUGIN_INDEX_CFG_GROUP, PLUGIN_INDEX_CFG_KEY).toHash();
+    QHash<QString,QVariant> scannedIndex;
+    bool indexModified = false;
+
+    QJsonObject pluginMetaData;
     for (QString pluginDirPath : pluginDirs)
     {
         QDir pluginDir(pluginDirPath);
         for (QString fileName : pluginDir.entryList(nameFilters, QDir::Files))
         {
             fileName = pluginDir.absoluteFilePath(fileName);
-            loader = new QPluginLoader(fileName);
-            loader->setLoadHints(QLibrary::ExportExternalSymbolsHint|QLibrary::ResolveAllSymbolsHint);
+            pluginMetaData = getPluginFileMetaData(fileName, index, indexModified);
+            if (index.contains(fileName))
+                scannedIndex[fileName] = index[fileName];
 
-            if (!initPlugin(loader, fileName))
-            {
-                qDebug() << "File" << fileName << "was loaded as plugin, but SQLiteStudio couldn't initialize plugin.";
-                delete loader;
-            }
+            if (!initPlugin(fileName, pluginMetaData))
+                qDebug() << "File" << fileName << "was recognized as plugin, but SQLiteStudio couldn't initialize plugin.";
         }
     }
 
+    // Files that are gone are dropped from the index
+    if (indexModified || scannedIndex.size() != index.size())
+        CFG->set(PLUGIN_INDEX_CFG_GROUP, PLUGIN_INDEX_CFG_KEY, scannedIndex);
+
     QStringList names;
     for (PluginContainer* container : pluginContainer.values())
     {
@@ -140,22 +158,118 @@ void PluginManagerImpl::scanPlugins()
     qDebug() << "Following plugins found:" << names;
 }
 
+QJsonObject PluginManagerImpl::getPluginFileMetaData(const QString& fileName, QHash<QString,QVariant>& index, bool& indexModified)
+{
+    QFileInfo fileInfo(fileName);
+    QDateTime modified = fileInfo.lastModified();
+    qint64 size = fileInfo.size();
+
+    if (index.contains(fileName))
+    {
+        QHash<QString,QVariant> entry = index[fileName].toHash();
+        if (entry["modified"].toDateTime() == modified && entry["size"].toLongLong() == size)
+            return QJsonObject::fromVariantMap(entry["metaData"].toMap());
+    }
+
+    // Temporary loader only reads the metadata, it doesn't load the library
+    QJsonObject metaData = QPluginLoader(fileName).metaData();
+    QHash<QString,QVariant> entry;
+    entry["modified"] = modified;
+    entry["size"] = size;
+    entry["metaData"] = metaData.toVariantMap();
+    index[fileName] = entry;
+    indexModified = true;
+    return metaData;
+}
+
 void PluginManagerImpl::loadPlugins()
 {
     QStringList alreadyAttempted;
+    PluginContainer* container = nullptr;
     for (const QString& pluginName : pluginContainer.keys())
     {
-        if (shouldAutoLoad(pluginName))
-            load(pluginName, alreadyAttempted);
+        if (!shouldAutoLoad(pluginName))
+            continue;
+
+        container = pluginContainer[pluginName];
+        if (!container->builtIn && isLoadedOnDemand(container->type))
+        {
+            // Could be already loaded as a dependency of other plugin
+            container->deferred = !container->loaded;
+            continue;
+        }
+
+        load(pluginName, alreadyAttempted);
     }
 
     pluginsAreInitiallyLoaded = true;
     emit pluginsInitiallyLoaded();
 }
 
-bool PluginManagerImpl::initPlugin(QPluginLoader* loader, const QString& fileName)
+QPluginLoader* PluginManagerImpl::getLoader(PluginContainer* container)
+{
+    if (!container->loader)
+    {
+        container->loader = new QPluginLoader(container->filePath);
+        container->loader->setLoadHints(QLibrary::ExportExternalSymbolsHint|QLibrary::ResolveAllSymbolsHint);
+    }
+    return container->loader;
+}
+
+bool PluginManagerImpl::isLoadedOnDemand(PluginType* type) const
+{
+    // Scripting plugins are not deferred, because they are used also from threads executing queries,
+    // while plugins can be loaded only in the main thread.
+    return type->isForPluginType<DbPlugin>() || type->isForPluginType<ExportPlugin>() ||
+            type->isForPluginType<ImportPlugin>() || type->isForPluginType<PopulatePlugin>();
+}
+
+void PluginManagerImpl::loadDeferredPlugins(PluginType* type) const
+{
+    for (PluginContainer* container : pluginContainer.values())
+    {
+        if (container->deferred && (!type || container->type == type))
+            loadDeferredPlugin(container);
+    }
+}
+
+bool PluginManagerImpl::loadDeferredPlugin(PluginContainer* container) const
+{
+    // Loading deferred plugin doesn't change the state visible to callers, as it was reported as loaded already.
+    PluginManagerImpl* self = const_cast<PluginManagerImpl*>(this);
+    if (QThread::currentThread() != qApp->thread())
+    {
+        bool res = false;
+        bool invokation = QMetaObject::invokeMethod(self, "loadDeferredPluginInMainThread", Qt::BlockingQueuedConnection,
+                                                    Q_RETURN_ARG(bool, res), Q_ARG(QString, container->name));
+        if (!invokation)
+        {
+            qCritical() << "Could not call PluginManagerImpl::loadDeferredPluginInMainThread() between threads!";
+            return false;
+        }
+        return res;
+    }
+
+    container->deferred = false;
+    qDebug() << "Loading plugin" << container->name << "on demand.";
+    return self->load(container->name);
+}
+
+bool PluginManagerImpl::loadDeferredPluginInMainThread(const QString& pluginName)
+{
+    if (!pluginContainer.contains(pluginName))
+        return false;
+
+    // Could be loaded already by the time this call was delivered
+    PluginContainer* container = pluginContainer[pluginName];
+    if (!container->deferred)
+        return container->loaded;
+
+    return loadDeferredPlugin(container);
+}
+
+bool PluginManagerImpl::initPlugin(const QString& fileName, const QJsonObject& pluginMetaData)
 {
-    QJsonObject pluginMetaData = loader->metaData();
     QString pluginTypeName = pluginMetaData.value("MetaData").toObject().value("type").toString();
     PluginType* pluginType = nullptr;
     for (PluginType* type : registeredPluginTypes)
@@ -183,7 +297,7 @@ bool PluginManagerImpl::initPlugin(QPluginLoader* loader, const QString& fileNam
     container->type = pluginType;
     container->filePath = fileName;
     container->loaded = false;
-    container->loader = loader;
+    container->metaData = pluginMetaData;
     pluginCategories[pluginType] << container;
     pluginContainer[pluginName] = container;
 
@@ -443,6 +557,14 @@ void PluginManagerImpl::unload(const QString& pluginName)
     if (container->builtIn)
         return;
 
+    if (container->deferred)
+    {
+        // Was never actually loaded, so there's nobody to notify.
+        container->deferred = false;
+        qDebug() << pluginName << "will not be loaded on demand anymore.";
+        return;
+    }
+
     if (!container->loaded)
         return;
 
@@ -528,14 +650,13 @@ bool PluginManagerImpl::load(const QString& pluginName, QStringList& alreadyAtte
     if (container->builtIn)
         return true;
 
-    QPluginLoader* loader = container->loader;
-    if (loader->isLoaded())
+    if (container->loaded)
         return true;
 
     // Checking for conflicting plugins
     for (PluginContainer* otherContainer : pluginContainer.values())
     {
-        if (!otherContainer->loaded || otherContainer->name == pluginName)
+        if ((!otherContainer->loaded && !otherContainer->deferred) || otherContainer->name == pluginName)
             continue;
 
         if (container->conflicts.contains(otherContainer->name) || otherContainer->conflicts.contains(pluginName))
@@ -558,6 +679,7 @@ bool PluginManagerImpl::load(const QString& pluginName, QStringList& alreadyAtte
     }
 
     // Loading pluginName
+    QPluginLoader* loader = getLoader(container);
     if (!loader->load())
     {
         notifyWarn(tr("Cannot load plugin %1. Error details: %2").arg(pluginName, loader->errorString()));
@@ -566,11 +688,11 @@ bool PluginManagerImpl::load(const QString& pluginName, QStringList& alreadyAtte
     }
 
     // Initializing loaded plugin
-    Plugin* plugin = dynamic_cast<Plugin*>(container->loader->instance());
+    Plugin* plugin = dynamic_cast<Plugin*>(loader->instance());
     GenericPlugin* genericPlugin = dynamic_cast<GenericPlugin*>(plugin);
     if (genericPlugin)
     {
-        genericPlugin->loadMetaData(container->loader->metaData());
+        genericPlugin->loadMetaData(container->metaData);
     }
 
     if (!plugin->init())
@@ -593,6 +715,7 @@ void PluginManagerImpl::pluginLoaded(PluginManagerImpl::PluginContainer* contain
         loadTranslation(container->name);
         container->plugin = dynamic_cast<Plugin*>(container->loader->instance());
         container->loaded = true;
+        container->deferred = false;
     }
     addPluginToCollections(container->plugin);
 
@@ -617,9 +740,9 @@ void PluginManagerImpl::removePluginFromCollections(Plugin* plugin)
 
 bool PluginManagerImpl::readMetaData(PluginManagerImpl::PluginContainer* container)
 {
-    if (container->loader)
+    if (!container->builtIn)
     {
-        QHash<QString, QVariant> metaData = readMetaData(container->loader->metaData());
+        QHash<QString, QVariant> metaData = readMetaData(container->metaData);
         container->name = metaData["name"].toString();
         container->version = metaData["version"].toInt();
         container->printableVersion = toPrintableVersion(metaData["version"].toInt());
@@ -640,7 +763,7 @@ bool PluginManagerImpl::readMetaData(PluginManagerImpl::PluginContainer* contain
     }
     else
     {
-        qCritical() << "Could not read metadata for some plugin. It has no loader or plugin object defined.";
+        qCritical() << "Could not read metadata for some plugin. It has no file metadata or plugin object defined.";
         return false;
     }
     return true;
@@ -654,7 +777,7 @@ bool PluginManagerImpl::isLoaded(const QString& pluginName) const
         return false;
     }
 
-    return pluginContainer[pluginName]->loaded;
+    return pluginContainer[pluginName]->loaded || pluginContainer[pluginName]->deferred;
 }
 
 bool PluginManagerImpl::isBuiltIn(const QString& pluginName) const
@@ -673,10 +796,14 @@ Plugin* PluginManagerImpl::getLoadedPlugin(const QString& pluginName) const
     if (!pluginContainer.contains(pluginName))
         return nullptr;
 
-    if (!pluginContainer[pluginName]->loaded)
+    PluginContainer* container = pluginContainer[pluginName];
+    if (container->deferred)
+        loadDeferredPlugin(container);
+
+    if (!container->loaded)
         return nullptr;
 
-    return pluginContainer[pluginName]->plugin;
+    return container->plugin;
 }
 
 QList<Plugin*> PluginManagerImpl::getLoadedPlugins(PluginType* type) const
@@ -685,6 +812,7 @@ QList<Plugin*> PluginManagerImpl::getLoadedPlugins(PluginType* type) const
     if (!pluginCategories.contains(type))
         return list;
 
+    loadDeferredPlugins(type);
     for (PluginContainer* container : pluginCategories[type])
     {
         if (container->loaded)
@@ -768,6 +896,8 @@ bool PluginManagerImpl::arePluginsInitiallyLoaded() const
 
 QList<Plugin*> PluginManagerImpl::getLoadedPlugins() const
 {
+    loadDeferredPlugins();
+
     QList<Plugin*> plugins;
     for (PluginContainer* container : pluginContainer.values())
     {
@@ -782,7 +912,7 @@ QStringList PluginManagerImpl::getLoadedPluginNames() const
     QStringList names;
     for (PluginContainer* container : pluginContainer.values())
     {
-        if (container->loaded)
+        if (container->loaded || container->deferred)
             names << container->name;
     }
     return names;
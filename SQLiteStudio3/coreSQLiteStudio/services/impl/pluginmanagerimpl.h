@@ -4,6 +4,7 @@
 #include "services/pluginmanager.h"
 #include <QPluginLoader>
 #include <QHash>
+#include <QJsonObject>
 
 class API_EXPORT PluginManagerImpl : public PluginManager
 {
@@ -118,11 +119,29 @@ class API_EXPORT PluginManagerImpl : public PluginManager
              */
             bool loaded;
 
+            /**
+             * @brief Flag indicating that the plugin should be loaded, but loading was deferred until it's needed.
+             *
+             * Deferred plugins are reported as loaded, but their files are loaded on the first request
+             * for the plugin object (see loadDeferredPlugins()).
+             */
+            bool deferred = false;
+
             /**
              * @brief Qt's plugin framework loaded for this plugin.
+             *
+             * It's created when the plugin is loaded for the first time (see getLoader()),
+             * because creating it reads the plugin file, while metadata is usually taken from the index.
              */
             QPluginLoader* loader = nullptr;
 
+            /**
+             * @brief Plugin's file metadata, as provided by QPluginLoader::metaData().
+             *
+             * It's kept here, because it might come from the metadata index, without reading the plugin file.
+             */
+            QJsonObject metaData;
+
             /**
              * @brief Plugin object.
              *
@@ -180,6 +199,27 @@ class API_EXPORT PluginManagerImpl : public PluginManager
          */
         void scanPlugins();
 
+        /**
+         * @brief Provides file metadata of the plugin.
+         * @param fileName Plugin's file path.
+         * @param index Metadata index loaded from configuration. It's updated if the file metadata had to be read.
+         * @param indexModified Set to true if the \p index was updated.
+         * @return Metadata as provided by QPluginLoader::metaData().
+         *
+         * Reading metadata from the plugin file means scanning the whole file for the metadata section,
+         * which is noticeable for big plugins (like the ones linking the whole SQLite library).
+         * Metadata is therefore remembered in the index, together with file modification time and size,
+         * and read from the file again only if the file was changed.
+         */
+        QJsonObject getPluginFileMetaData(const QString& fileName, QHash<QString,QVariant>& index, bool& indexModified);
+
+        /**
+         * @brief Provides Qt's plugin loader for the plugin file.
+         * @param container Container of the plugin.
+         * @return Loader, created on the first call.
+         */
+        QPluginLoader* getLoader(PluginContainer* container);
+
         /**
          * @brief Loads plugins defined in configuration.
          *
@@ -189,9 +229,36 @@ class API_EXPORT PluginManagerImpl : public PluginManager
          * In other words, every plugin will load by default, unless it was
          * explicitly unloaded previously and that was saved in the configuration
          * (when application was closing).
+         *
+         * Plugins of types that are used only on demand (see isLoadedOnDemand()) are not loaded here.
+         * They are marked as deferred instead and loaded when they are requested for the first time.
          */
         void loadPlugins();
 
+        /**
+         * @brief Tells if plugins of given type can have their loading deferred.
+         * @param type Plugin type.
+         * @return true for types which plugins are always looked up through the plugin manager when they are needed,
+         * instead of being used right after they are loaded.
+         */
+        bool isLoadedOnDemand(PluginType* type) const;
+
+        /**
+         * @brief Loads plugins that were deferred at startup.
+         * @param type Type of plugins to load, or null to load deferred plugins of all types.
+         *
+         * Plugin objects have to live in the main thread, so when it's called from other thread,
+         * the main thread is asked to load plugins and the calling thread waits for it.
+         */
+        void loadDeferredPlugins(PluginType* type = nullptr) const;
+
+        /**
+         * @brief Loads single plugin that was deferred at startup.
+         * @param container Container of the plugin.
+         * @return true if the plugin is loaded now, false otherwise.
+         */
+        bool loadDeferredPlugin(PluginContainer* container) const;
+
         /**
          * @brief Loads given plugin.
          * @param pluginName Name of the plugin to load.
@@ -257,21 +324,17 @@ class API_EXPORT PluginManagerImpl : public PluginManager
 
         /**
          * @brief Creates plugin container and initializes it.
-         * @param loader Qt's plugin framework loader used to load this plugin.
-         *               For built-in plugins (statically linked) this must be null.
-         * @param fileName Plugin's file path. For built-in plugins it's ignored.
-         * @param plugin Plugin object from loaded plugin.
+         * @param fileName Plugin's file path.
+         * @param pluginMetaData Plugin's file metadata (see getPluginFileMetaData()).
          * @return true if the initialization succeeded, or false otherwise.
          *
          * It assigns plugin type to the plugin, creates plugin container and fills
          * all necessary data for the plugin. If the plugin was configured to not load,
          * then this method unloads the file, before plugin was initialized (with Plugin::init()).
          *
-         * All plugins are loaded at the start, but before they are fully initialized
-         * and enabled, they are simply queried for metadata, then either unloaded
-         * (when configured to not load at startup), or the initialization proceeds.
+         * The plugin file is not loaded here. Its loader is created when the plugin gets loaded.
          */
-        bool initPlugin(QPluginLoader* loader, const QString& fileName);
+        bool initPlugin(const QString& fileName, const QJsonObject& pluginMetaData);
 
         bool checkPluginRequirements(const QString& pluginName, const QJsonObject& metaObject);
         bool readDependencies(const QString& pluginName, PluginContainer* container, const QJsonValue& depsValue);
@@ -324,6 +387,19 @@ class API_EXPORT PluginManagerImpl : public PluginManager
         QHash<QString,ScriptingPlugin*> scriptingPlugins;
 
         bool pluginsAreInitiallyLoaded = false;
+
+        static_char* PLUGIN_INDEX_CFG_GROUP = "PluginIndex";
+        static_char* PLUGIN_INDEX_CFG_KEY = "files";
+
+    private slots:
+        /**
+         * @brief Loads deferred plugin on behalf of other thread.
+         * @param pluginName Name of the plugin.
+         * @return true if the plugin is loaded now, false otherwise.
+         *
+         * It's invoked by loadDeferredPlugin() with the blocking queued connection.
+         */
+        bool loadDeferredPluginInMainThread(const QString& pluginName);
 };
 
 #endif // PLUGINMANAGERIMPL_H
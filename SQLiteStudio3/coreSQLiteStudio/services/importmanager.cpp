@@ -67,14 +67,20 @@ void ImportManager::importToTable(Db* db, const QString& table, bool async)
     importInProgress = true;
 
     ImportWorker* worker = new ImportWorker(plugin, &importConfig, db, table);
-    connect(worker, SIGNAL(finished(bool)), this, SLOT(finalizeImport(bool)));
+    // Synchronous import can be called from other thread than this manager lives in (like the CLI thread).
+    // Finalization (and failure signals) must happen before this method returns, not be queued for later.
+    connect(worker, SIGNAL(finished(bool)), this, SLOT(finalizeImport(bool)), async ? Qt::AutoConnection : Qt::DirectConnection);
     connect(worker, SIGNAL(createdTable(Db*,QString)), this, SLOT(handleTableCreated(Db*,QString)));
     connect(this, SIGNAL(orderWorkerToInterrupt()), worker, SLOT(interrupt()));
 
     if (async)
         QThreadPool::globalInstance()->start(worker);
     else
+    {
+        // Worker lives in this thread, so finalizeImport() is called directly from the run().
         worker->run();
+        delete worker;
+    }
 }
 
 void ImportManager::interrupt()
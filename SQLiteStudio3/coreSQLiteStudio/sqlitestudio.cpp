@@ -4,6 +4,9 @@
 #include "common/utils.h"
 #include "common/utils_sql.h"
 #include "completionhelper.h"
+#include "completionindex.h"
+#include "db/queryplancache.h"
+#include "schemaresolver.h"
 #include "parser/keywords.h"
 #include "parser/lexer.h"
 #include "services/notifymanager.h"
@@ -335,6 +338,10 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
     exportManager = new ExportManager();
     importManager = new ImportManager();
     populateManager = new PopulateManager();
+    CompletionIndex::getInstance()->init();
+    QueryPlanCache::getInstance()->init();
+    connect(DBLIST, &DbManager::dbDisconnected, this, &SchemaResolver::clearParsedDdlCache);
+    connect(DBLIST, &DbManager::dbAboutToBeUnloaded, this, &SchemaResolver::clearParsedDdlCache);
 #ifdef PORTABLE_CONFIG
     updateManager = new UpdateManager();
 #endif
@@ -364,6 +371,8 @@ void SQLiteStudio::cleanUp()
     disconnect(pluginManager, SIGNAL(unloaded(QString,PluginType*)), this, SLOT(pluginUnloaded(QString,PluginType*)));
     if (!immediateQuit)
     {
+        CompletionIndex::destroy();
+        QueryPlanCache::destroy();
         if (pluginManager)
             pluginManager->deinit();
 
@@ -32,6 +32,10 @@ TableModifier::TableModifier(Db* db, const QString& database, const QString& tab
 
 void TableModifier::alterTable(SqliteCreateTablePtr newCreateTable)
 {
+    nativeAlter = false;
+    if (alterTableNatively(newCreateTable))
+        return;
+
     tableColMap = newCreateTable->getModifiedColumnsMap(true);
     existingColumns = newCreateTable->getColumnNames();
     newName = newCreateTable->table;
@@ -63,6 +67,310 @@ void TableModifier::alterTable(SqliteCreateTablePtr newCreateTable)
         sqls << "PRAGMA foreign_keys = 1;";
 }
 
+bool TableModifier::alterTableNatively(SqliteCreateTablePtr newCreateTable)
+{
+    static const int RENAME_COLUMN_MIN_VERSION = 3025000;
+    static const int DROP_COLUMN_MIN_VERSION = 3035000;
+
+    if (!nativeAlterEnabled || dialect != Dialect::Sqlite3 || !createTable)
+        return false;
+
+    // Table renaming is always done by copying, see comment in renameTo().
+    if (table.compare(newCreateTable->table, Qt::CaseInsensitive) != 0)
+        return false;
+
+    if (createTable->withOutRowId.isNull() != newCreateTable->withOutRowId.isNull())
+        return false;
+
+    if (createTable->constraints.size() != newCreateTable->constraints.size())
+        return false;
+
+    for (int i = 0, total = createTable->constraints.size(); i < total; ++i)
+    {
+        if (getStatementDefinition(createTable->constraints[i]) != getStatementDefinition(newCreateTable->constraints[i]))
+            return false;
+    }
+
+    // Remaining columns must keep their order and definitions (except for the name). New columns can be only appended at the end.
+    QList<SqliteCreateTable::Column*> droppedColumns;
+    QList<QPair<QString, QString>> renamedColumns;
+    QList<SqliteCreateTable::Column*> addedColumns;
+    QSet<int> matchedColumns;
+    int lastMatchedIdx = -1;
+    int newIdx;
+    SqliteCreateTable::Column* newColumn = nullptr;
+    for (SqliteCreateTable::Column* oldColumn : createTable->columns)
+    {
+        newIdx = findColumnByOriginalName(newCreateTable->columns, oldColumn->name);
+        if (newIdx < 0)
+        {
+            droppedColumns << oldColumn;
+            continue;
+        }
+
+        if (newIdx < lastMatchedIdx)
+            return false;
+
+        lastMatchedIdx = newIdx;
+        matchedColumns << newIdx;
+        newColumn = newCreateTable->columns[newIdx];
+        if (getColumnDefinition(oldColumn, false) != getColumnDefinition(newColumn, false))
+            return false;
+
+        if (oldColumn->name != newColumn->name)
+            renamedColumns << QPair<QString, QString>(oldColumn->name, newColumn->name);
+    }
+
+    for (int i = 0, total = newCreateTable->columns.size(); i < total; ++i)
+    {
+        if (matchedColumns.contains(i))
+            continue;
+
+        if (i < lastMatchedIdx)
+            return false; // column inserted in the middle
+
+        addedColumns << newCreateTable->columns[i];
+    }
+
+    if (droppedColumns.isEmpty() && renamedColumns.isEmpty() && addedColumns.isEmpty())
+        return false;
+
+    if (!renamedColumns.isEmpty())
+    {
+        if (getSqliteVersion() < RENAME_COLUMN_MIN_VERSION || isLegacyAlterTable())
+            return false;
+
+        // Swapping names between columns would require intermediate names. Not worth it.
+        for (const QPair<QString, QString>& renamed : renamedColumns)
+        {
+            if (renamed.first.compare(renamed.second, Qt::CaseInsensitive) != 0 && createTable->getColumn(renamed.second))
+                return false;
+        }
+    }
+
+    if (!droppedColumns.isEmpty())
+    {
+        if (getSqliteVersion() < DROP_COLUMN_MIN_VERSION)
+            return false;
+
+        for (SqliteCreateTable::Column* column : droppedColumns)
+        {
+            if (!canDropColumnNatively(column))
+                return false;
+        }
+    }
+
+    for (SqliteCreateTable::Column* column : addedColumns)
+    {
+        if (!canAddColumnNatively(column))
+            return false;
+    }
+
+    QString wrappedTable = wrapObjIfNeeded(table, dialect);
+    for (SqliteCreateTable::Column* column : droppedColumns)
+        sqls << QString("ALTER TABLE %1 DROP COLUMN %2;").arg(wrappedTable, wrapObjIfNeeded(column->name, dialect));
+
+    for (const QPair<QString, QString>& renamed : renamedColumns)
+    {
+        sqls << QString("ALTER TABLE %1 RENAME COLUMN %2 TO %3;").arg(wrappedTable, wrapObjIfNeeded(renamed.first, dialect),
+                                                                      wrapObjIfNeeded(renamed.second, dialect));
+    }
+
+    for (SqliteCreateTable::Column* column : addedColumns)
+        sqls << QString("ALTER TABLE %1 ADD COLUMN %2;").arg(wrappedTable, getColumnDefinition(column, true));
+
+    // SQLite updates column references in dependent objects by itself when renaming columns,
+    // but those objects are still reported as modified, so they get refreshed.
+    if (!renamedColumns.isEmpty())
+    {
+        SchemaResolver resolver(db);
+        modifiedTables += resolver.getFkReferencingTables(originalTable);
+        modifiedIndexes += resolver.getIndexesForTable(originalTable);
+        modifiedTriggers += resolver.getTriggersForTable(originalTable);
+        modifiedViews += resolver.getViewsForTable(originalTable);
+    }
+
+    nativeAlter = true;
+    return true;
+}
+
+bool TableModifier::canAddColumnNatively(SqliteCreateTable::Column* column)
+{
+    // Rules from the SQLite documentation of ALTER TABLE ADD COLUMN.
+    bool notNull = false;
+    bool foreignKey = false;
+    bool nonNullDefault = false;
+    for (SqliteCreateTable::Column::Constraint* constr : column->constraints)
+    {
+        switch (constr->type)
+        {
+            case SqliteCreateTable::Column::Constraint::PRIMARY_KEY:
+            case SqliteCreateTable::Column::Constraint::UNIQUE:
+                return false;
+            case SqliteCreateTable::Column::Constraint::DEFAULT:
+            {
+                if (!constr->ctime.isNull() || constr->expr)
+                    return false;
+
+                nonNullDefault = !constr->literalNull;
+                break;
+            }
+            case SqliteCreateTable::Column::Constraint::NOT_NULL:
+                notNull = true;
+                break;
+            case SqliteCreateTable::Column::Constraint::FOREIGN_KEY:
+                foreignKey = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (notNull && !nonNullDefault)
+        return false;
+
+    if (foreignKey && nonNullDefault)
+        return false;
+
+    return true;
+}
+
+bool TableModifier::canDropColumnNatively(SqliteCreateTable::Column* column)
+{
+    for (SqliteCreateTable::Column::Constraint* constr : column->constraints)
+    {
+        switch (constr->type)
+        {
+            case SqliteCreateTable::Column::Constraint::PRIMARY_KEY:
+            case SqliteCreateTable::Column::Constraint::UNIQUE:
+            case SqliteCreateTable::Column::Constraint::FOREIGN_KEY:
+                return false;
+            default:
+                break;
+        }
+    }
+
+    for (SqliteCreateTable::Constraint* constr : createTable->constraints)
+    {
+        if (tokensContainName(constr->tokens, column->name, dialect))
+            return false;
+    }
+
+    for (SqliteCreateTable::Column* otherColumn : createTable->columns)
+    {
+        if (otherColumn == column)
+            continue;
+
+        for (SqliteCreateTable::Column::Constraint* constr : otherColumn->constraints)
+        {
+            if (tokensContainName(constr->tokens, column->name, dialect))
+                return false;
+        }
+    }
+
+    return !isColumnUsedByOtherObjects(column->name);
+}
+
+bool TableModifier::isColumnUsedByOtherObjects(const QString& column)
+{
+    // This is intentionally conservative - any token matching the column name counts as usage.
+    SchemaResolver resolver(db);
+    if (!resolver.getFkReferencingTables(originalTable).isEmpty())
+        return true;
+
+    for (SqliteCreateIndexPtr index : resolver.getParsedIndexesForTable(originalTable))
+    {
+        if (tokensContainName(index->tokens, column, dialect))
+            return true;
+    }
+
+    for (SqliteCreateTriggerPtr trig : resolver.getParsedTriggersForTable(originalTable, true))
+    {
+        if (tokensContainName(trig->tokens, column, dialect))
+            return true;
+    }
+
+    for (SqliteCreateViewPtr view : resolver.getParsedViewsForTable(originalTable))
+    {
+        if (tokensContainName(view->tokens, column, dialect))
+            return true;
+    }
+
+    return false;
+}
+
+int TableModifier::getSqliteVersion()
+{
+    SqlQueryPtr results = db->exec("SELECT sqlite_version()");
+    if (results->isError())
+        return 0;
+
+    QStringList parts = results->getSingleCell().toString().split(".");
+    int version = 0;
+    int multiplier = 1000000;
+    for (int i = 0; i < 3; i++)
+    {
+        if (i < parts.size())
+            version += parts[i].toInt() * multiplier;
+
+        multiplier /= 1000;
+    }
+    return version;
+}
+
+bool TableModifier::isLegacyAlterTable()
+{
+    SqlQueryPtr results = db->exec("PRAGMA legacy_alter_table");
+    if (results->isError())
+        return true;
+
+    return results->getSingleCell().toInt() != 0;
+}
+
+int TableModifier::findColumnByOriginalName(const QList<SqliteCreateTable::Column*>& columns, const QString& name)
+{
+    for (int i = 0, total = columns.size(); i < total; ++i)
+    {
+        if (columns[i]->originalName.compare(name, Qt::CaseInsensitive) == 0)
+            return i;
+    }
+    return -1;
+}
+
+QString TableModifier::getColumnDefinition(SqliteCreateTable::Column* column, bool withName)
+{
+    SqliteCreateTable::Column* columnCopy = dynamic_cast<SqliteCreateTable::Column*>(column->clone());
+    if (!withName)
+        columnCopy->name = "x";
+
+    columnCopy->rebuildTokens();
+    QString definition = columnCopy->detokenize();
+    delete columnCopy;
+    return definition;
+}
+
+QString TableModifier::getStatementDefinition(SqliteStatement* stmt)
+{
+    SqliteStatement* stmtCopy = stmt->clone();
+    stmtCopy->rebuildTokens();
+    QString definition = stmtCopy->detokenize();
+    delete stmtCopy;
+    return definition;
+}
+
+bool TableModifier::tokensContainName(const TokenList& tokens, const QString& name, Dialect dialect)
+{
+    for (const TokenPtr& token : tokens)
+    {
+        if (token->type == Token::SPACE || token->type == Token::COMMENT)
+            continue;
+
+        if (stripObjName(token->value, dialect).compare(name, Qt::CaseInsensitive) == 0)
+            return true;
+    }
+    return false;
+}
+
 void TableModifier::renameTo(const QString& newName)
 {
     if (!createTable)
@@ -932,6 +1240,16 @@ QStringList TableModifier::generateSqls() const
     return sqls;
 }
 
+bool TableModifier::isNativeAlter() const
+{
+    return nativeAlter;
+}
+
+void TableModifier::setNativeAlterEnabled(bool enabled)
+{
+    nativeAlterEnabled = enabled;
+}
+
 bool TableModifier::isValid() const
 {
     return !createTable.isNull();
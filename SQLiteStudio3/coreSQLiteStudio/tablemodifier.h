@@ -30,6 +30,20 @@ class API_EXPORT TableModifier
         QStringList getModifiedViews() const;
         bool hasMessages() const;
 
+        /**
+         * @brief Tells if the last alterTable() call was handled with ALTER TABLE statements.
+         * @return true if the table is modified in place, or false if it's recreated and data is copied.
+         */
+        bool isNativeAlter() const;
+
+        /**
+         * @brief Enables or disables use of ALTER TABLE statements for simple modifications.
+         * @param enabled true to use ALTER TABLE (ADD/RENAME/DROP COLUMN) when possible, false to always recreate the table.
+         *
+         * It's enabled by default. It has to be called before alterTable() to take effect.
+         */
+        void setNativeAlterEnabled(bool enabled);
+
     private:
         void init();
         void parseDdl();
@@ -40,6 +54,23 @@ class API_EXPORT TableModifier
         void copyDataTo(const QString& table);
         void copyDataTo(SqliteCreateTablePtr newCreateTable);
 
+        /**
+         * @brief Tries to apply modifications using ALTER TABLE statements.
+         * @param newCreateTable New table definition.
+         * @return true if all modifications could be expressed with ALTER TABLE ADD/RENAME/DROP COLUMN
+         * and statements were added to the sqls, or false if the table has to be recreated.
+         */
+        bool alterTableNatively(SqliteCreateTablePtr newCreateTable);
+        bool canAddColumnNatively(SqliteCreateTable::Column* column);
+        bool canDropColumnNatively(SqliteCreateTable::Column* column);
+        bool isColumnUsedByOtherObjects(const QString& column);
+        int getSqliteVersion();
+        bool isLegacyAlterTable();
+        static int findColumnByOriginalName(const QList<SqliteCreateTable::Column*>& columns, const QString& name);
+        static QString getColumnDefinition(SqliteCreateTable::Column* column, bool withName);
+        static QString getStatementDefinition(SqliteStatement* stmt);
+        static bool tokensContainName(const TokenList& tokens, const QString& name, Dialect dialect);
+
         void handleIndexes();
         void handleIndex(SqliteCreateIndexPtr index);
         void handleTriggers();
@@ -162,6 +193,8 @@ class API_EXPORT TableModifier
         QStringList modifiedTriggers;
         QStringList modifiedViews;
         QStringList usedTempTableNames;
+        bool nativeAlterEnabled = true;
+        bool nativeAlter = false;
 };
 
 
@@ -9,36 +9,24 @@ QString TsvSerializer::columnSeparator = "\t";
 
 QString TsvSerializer::serialize(const QList<QStringList>& data)
 {
-    QStringList outputRows;
-
+    DsvWriter writer = createWriter();
+    writer.reserve(writer.estimateSize(data));
     for (const QStringList& dataRow : data)
-        outputRows << serialize(dataRow);
+        writer.appendRow(dataRow);
 
-    return outputRows.join(rowSeparator);
+    return writer.getOutput();
 }
 
 QString TsvSerializer::serialize(const QStringList& data)
 {
-    QString value;
-    bool hasQuote;
-    QStringList outputCells;
-    for (const QString& rowValue : data)
-    {
-        value = rowValue;
-
-        hasQuote = value.contains("\"");
-        if (value.contains(columnSeparator) || value.contains(rowSeparator))
-        {
-            if (hasQuote)
-                value.replace("\"", "\"\"");
-
-            value = "\""+value+"\"";
-        }
-
-        outputCells << value;
-    }
+    DsvWriter writer = createWriter();
+    writer.appendRow(data);
+    return writer.getOutput();
+}
 
-    return outputCells.join(columnSeparator);
+DsvWriter TsvSerializer::createWriter()
+{
+    return DsvWriter(columnSeparator, rowSeparator, false);
 }
 
 QList<QStringList> TsvSerializer::deserialize(const QString& data)
@@ -3,6 +3,7 @@
 
 #include "coreSQLiteStudio_global.h"
 #include "common/global.h"
+#include "dsvwriter.h"
 #include <QStringList>
 
 class API_EXPORT TsvSerializer
@@ -12,6 +13,11 @@ class API_EXPORT TsvSerializer
         static QString serialize(const QStringList& data);
         static QList<QStringList> deserialize(const QString& data);
 
+        /**
+         * @brief Creates writer producing the same output as serialize(), for data that is serialized incrementally.
+         */
+        static DsvWriter createWriter();
+
     private:
         static QStringList tokenizeStrWithRowSeparator(const QString& data);
         static QString flushToken(const QString& token);
@@ -5,7 +5,6 @@
 #include "parser/ast/sqlitecreatetable.h"
 #include "guiSQLiteStudio_global.h"
 #include <QWidget>
-#include <QPointer>
 
 class GUI_API_EXPORT ConstraintPanel : public QWidget
 {
@@ -67,7 +66,7 @@ class GUI_API_EXPORT ConstraintPanel : public QWidget
         virtual void storeConfiguration() = 0;
 
         Db* db = nullptr;
-        QPointer<SqliteStatement> constraint;
+        SqliteStatementGuard<SqliteStatement> constraint;
 
     public slots:
 
@@ -33,6 +33,13 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
     connect(queryExecutor, SIGNAL(executionFailed(int,QString)), this, SLOT(handleExecFailed(int,QString)));
     connect(queryExecutor, SIGNAL(resultsCountingFinished(quint64,quint64,int)), this, SLOT(resultsCountingFinished(quint64,quint64,int)));
 
+    prefetchExecutor = new QueryExecutor();
+    prefetchExecutor->setDataLengthLimit(cellDataLengthLimit);
+    prefetchExecutor->setSkipRowCounting(true);
+    prefetchExecutor->setPreloadResults(true);
+    connect(prefetchExecutor, SIGNAL(executionFinished(SqlQueryPtr)), this, SLOT(handlePrefetchFinished(SqlQueryPtr)));
+    connect(prefetchExecutor, SIGNAL(executionFailed(int,QString)), this, SLOT(handlePrefetchFailed()));
+
     NotifyManager* notifyManager = NotifyManager::getInstance();
     connect(notifyManager, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(handlePossibleTableModification(Db*,QString,QString)));
     connect(notifyManager, SIGNAL(objectRenamed(Db*,QString,QString,QString)), this, SLOT(handlePossibleTableRename(Db*,QString,QString,QString)));
@@ -47,6 +54,9 @@ SqlQueryModel::~SqlQueryModel()
 
     delete queryExecutor;
     queryExecutor = nullptr;
+
+    delete prefetchExecutor;
+    prefetchExecutor = nullptr;
 }
 
 void SqlQueryModel::staticInit()
@@ -76,6 +86,7 @@ void SqlQueryModel::setParams(const QHash<QString, QVariant>& params)
 void SqlQueryModel::setAsyncMode(bool enabled)
 {
     queryExecutor->setAsyncMode(enabled);
+    pageCache.clear();
 }
 
 void SqlQueryModel::executeQuery()
@@ -86,6 +97,9 @@ void SqlQueryModel::executeQuery()
         return;
     }
 
+    // Explicit execution always shows fresh data.
+    pageCache.clear();
+
     sortOrder.clear();
     queryExecutor->setSkipRowCounting(false);
     queryExecutor->setSortOrder(sortOrder);
@@ -464,6 +478,8 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
     numberOfItemsDeleted -= groupItemsByRows(findItems(SqlQueryItem::DataRole::DELETED, true)).size();
     int itemsAddedDeletedDelta = numberOfItemsAdded - numberOfItemsDeleted;
 
+    // Pages cached before the commit would show old data.
+    pageCache.clear();
     recalculateRowsAndPages(itemsAddedDeletedDelta);
 
     emit commitFinished();
@@ -480,6 +496,7 @@ void SqlQueryModel::rollbackInternal(const QList<SqlQueryItem*>& items)
 
 void SqlQueryModel::reload()
 {
+    pageCache.clear();
     queryExecutor->setSkipRowCounting(false);
     reloadInternal();
 }
@@ -757,7 +774,7 @@ QList<SqlQueryModelColumnPtr> SqlQueryModel::getTableColumnModels(const QString&
     return getTableColumnModels("main", table);
 }
 
-bool SqlQueryModel::loadData(SqlQueryPtr results)
+bool SqlQueryModel::loadData(SqlQueryPtr results, QList<SqlResultsRowPtr>& loadedRows)
 {
     if (rowCount() > 0)
         clear();
@@ -783,6 +800,7 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
             break;
 
         rowList << loadRow(row);
+        loadedRows << row;
 
         if ((rowIdx % 50) == 0)
         {
@@ -802,6 +820,26 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
     return true;
 }
 
+void SqlQueryModel::loadCachedData(const QList<SqlResultsRowPtr>& rows)
+{
+    // Columns stay as they are, only rows are replaced.
+    if (rowCount() > 0)
+        removeRows(0, rowCount());
+
+    allDataLoaded = false;
+    rowNumBase = getCurrentPage() * getRowsPerPage() + 1;
+
+    QList<QList<QStandardItem*>> rowList;
+    for (const SqlResultsRowPtr& row : rows)
+        rowList << loadRow(row);
+
+    int rowIdx = 0;
+    for (const QList<QStandardItem*>& row : rowList)
+        insertRow(rowIdx++, row);
+
+    allDataLoaded = true;
+}
+
 QList<QStandardItem*> SqlQueryModel::loadRow(SqlResultsRowPtr row)
 {
     QList<QStandardItem*> itemList;
@@ -1167,13 +1205,15 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
     }
 
     storeStep1NumbersFromExecution();
-    if (!loadData(results))
+    QList<SqlResultsRowPtr> loadedRows;
+    if (!loadData(results, loadedRows))
         return;
 
     storeStep2NumbersFromExecution();
 
     requiredDbAttaches = queryExecutor->getRequiredDbAttaches();
     reloadAvailable = true;
+    cacheLoadedPage(loadedRows);
 
     emit loadingEnded(true);
     restoreNumbersToQueryExecutor();
@@ -1197,6 +1237,8 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
         results.clear();
         detachDatabases();
     }
+
+    prefetchNextPage();
 }
 
 void SqlQueryModel::handleExecFailed(int code, QString errorMessage)
@@ -1284,9 +1326,7 @@ void SqlQueryModel::firstPage()
     if (!reloadAvailable)
         return;
 
-    queryExecutor->setSkipRowCounting(true);
-    queryExecutor->setPage(0);
-    reloadInternal();
+    changePage(0);
 }
 
 void SqlQueryModel::prevPage()
@@ -1298,9 +1338,7 @@ void SqlQueryModel::prevPage()
     if (newPage < 0)
         newPage = 0;
 
-    queryExecutor->setSkipRowCounting(true);
-    queryExecutor->setPage(newPage);
-    reloadInternal();
+    changePage(newPage);
 }
 
 void SqlQueryModel::nextPage()
@@ -1312,9 +1350,7 @@ void SqlQueryModel::nextPage()
     if ((newPage + 1) > totalPages)
         newPage = totalPages - 1;
 
-    queryExecutor->setSkipRowCounting(true);
-    queryExecutor->setPage(newPage);
-    reloadInternal();
+    changePage(newPage);
 }
 
 void SqlQueryModel::lastPage()
@@ -1329,9 +1365,7 @@ void SqlQueryModel::lastPage()
         page = 0;
     }
 
-    queryExecutor->setSkipRowCounting(true);
-    queryExecutor->setPage(page);
-    reloadInternal();
+    changePage(page);
 }
 
 void SqlQueryModel::gotoPage(int newPage)
@@ -1342,11 +1376,157 @@ void SqlQueryModel::gotoPage(int newPage)
     if (newPage < 0 || (newPage + 1) > totalPages)
         newPage = 0;
 
+    changePage(newPage);
+}
+
+void SqlQueryModel::changePage(int newPage)
+{
     queryExecutor->setSkipRowCounting(true);
+    if (loadPageFromCache(newPage))
+        return;
+
     queryExecutor->setPage(newPage);
     reloadInternal();
 }
 
+bool SqlQueryModel::isPageCacheUsable()
+{
+    // Re-executing data modifying queries (or loading their results from cache instead) would change their meaning.
+    if (!db || !db->isOpen() || explain || simpleExecutionMode || !queryExecutor->getAsyncMode())
+        return false;
+
+    if (queryExecutor->wasDataModifyingQuery() || queryExecutor->wasSchemaModified() || !requiredDbAttaches.isEmpty())
+        return false;
+
+    // Results of simple execution method have no QueryExecutor aliases and are not paged.
+    return !getResultColumnsSignature(queryExecutor).isEmpty();
+}
+
+QString SqlQueryModel::getPageCacheKey(int page) const
+{
+    return SqlQueryPageCache::makeKey(query, queryParams, sortOrder, getRowsPerPage(), page);
+}
+
+void SqlQueryModel::cacheLoadedPage(const QList<SqlResultsRowPtr>& rows)
+{
+    if (!isPageCacheUsable())
+    {
+        pageCache.clear();
+        return;
+    }
+
+    pageCache.setDataStamp(SqlQueryPageCache::readDataStamp(db));
+    pageCache.insert(getPageCacheKey(page), rows);
+}
+
+bool SqlQueryModel::loadPageFromCache(int newPage)
+{
+    if (structureOutOfDate || queryExecutor->isExecutionInProgress() || !isPageCacheUsable())
+        return false;
+
+    // Uncommitted changes are handled (with a question to the user) by the regular reloading.
+    if (getUncommittedItems().size() > 0)
+        return false;
+
+    // Any write to the database since the page was cached drops the whole cache.
+    pageCache.setDataStamp(SqlQueryPageCache::readDataStamp(db));
+
+    QList<SqlResultsRowPtr> rows;
+    if (!pageCache.get(getPageCacheKey(newPage), rows))
+        return false;
+
+    emit executionStarted();
+
+    page = newPage;
+    loadCachedData(rows);
+
+    emit loadingEnded(true);
+    restoreNumbersToQueryExecutor();
+
+    prefetchNextPage();
+    return true;
+}
+
+void SqlQueryModel::prefetchNextPage()
+{
+    if (prefetchExecutor->isExecutionInProgress() || !isPageCacheUsable())
+        return;
+
+    // Number of pages may not be counted yet, but if the current page is not full, there is no next page anyway.
+    int nextPage = page + 1;
+    if (rowCount() < getRowsPerPage() || (totalPages > -1 && nextPage >= totalPages))
+        return;
+
+    QString key = getPageCacheKey(nextPage);
+    if (pageCache.contains(key))
+        return;
+
+    prefetchKey = key;
+    prefetchDataStamp = SqlQueryPageCache::readDataStamp(db);
+    prefetchColumnsSignature = getResultColumnsSignature(queryExecutor);
+    if (prefetchDataStamp.isNull())
+        return;
+
+    prefetchExecutor->setDb(db);
+    prefetchExecutor->setQuery(query);
+    prefetchExecutor->setParams(queryParams);
+    prefetchExecutor->setResultsPerPage(getRowsPerPage());
+    prefetchExecutor->setSortOrder(sortOrder);
+    prefetchExecutor->setPage(nextPage);
+    prefetchExecutor->setQueryCountLimitForSmartMode(queryExecutor->getQueryCountLimitForSmartMode());
+    prefetchExecutor->exec();
+}
+
+QStringList SqlQueryModel::getResultColumnsSignature(QueryExecutor* executor)
+{
+    QStringList signature;
+    for (const QueryExecutor::ResultColumnPtr& resCol : executor->getResultColumns())
+    {
+        if (resCol->queryExecutorAlias.isEmpty())
+            return QStringList();
+
+        signature << resCol->queryExecutorAlias;
+    }
+
+    QStringList rowIdAliases;
+    for (const QueryExecutor::ResultRowIdColumnPtr& rowIdCol : executor->getRowIdResultColumns())
+        rowIdAliases += rowIdCol->queryExecutorAliasToColumn.keys();
+
+    rowIdAliases.sort();
+    signature += rowIdAliases;
+    return signature;
+}
+
+void SqlQueryModel::handlePrefetchFinished(SqlQueryPtr results)
+{
+    QList<SqlResultsRowPtr> rows;
+    int rowsPerPage = getRowsPerPage();
+    while (!results->isError() && results->hasNext() && rows.size() < rowsPerPage)
+        rows << results->next();
+
+    results.clear();
+    prefetchExecutor->releaseResultsAndCleanup();
+
+    // Cache only if nothing was written in the meantime and the query was transformed the same way as for the current page,
+    // so rows can be loaded using currently known columns.
+    QString stamp = SqlQueryPageCache::readDataStamp(db);
+    pageCache.setDataStamp(stamp);
+    if (stamp != prefetchDataStamp)
+        return;
+
+    QStringList signature = getResultColumnsSignature(prefetchExecutor);
+    if (signature != prefetchColumnsSignature || signature != getResultColumnsSignature(queryExecutor))
+        return;
+
+    pageCache.insert(prefetchKey, rows);
+}
+
+void SqlQueryModel::handlePrefetchFailed()
+{
+    // Prefetching is just an optimization. The page will be loaded regularly, reporting the error if it happens again.
+    prefetchKey.clear();
+}
+
 bool SqlQueryModel::canReload()
 {
     return reloadAvailable;
@@ -1398,6 +1578,7 @@ void SqlQueryModel::setDb(Db* value)
 {
     db = value;
     queryExecutor->setDb(db);
+    pageCache.clear();
 }
 
 QueryExecutor::SortList SqlQueryModel::getSortOrder() const
@@ -1634,6 +1815,11 @@ int SqlQueryModel::getDesiredColumnWidth(int colIdx)
     return columnWidths[column];
 }
 
+void SqlQueryModel::clearPageCache()
+{
+    pageCache.clear();
+}
+
 bool SqlQueryModel::isStructureOutOfDate() const
 {
     return structureOutOfDate;
@@ -1724,7 +1910,10 @@ void SqlQueryModel::handlePossibleTableModification(Db *modDb, const QString &da
     QString dbName = database.toLower() == "main" ? QString() : database;
     DbAndTable dbAndTable(modDb, dbName, objName);
     if (tablesInUse.contains(dbAndTable))
+    {
         structureOutOfDate = true;
+        pageCache.clear();
+    }
 }
 
 void SqlQueryModel::handlePossibleTableRename(Db *modDb, const QString &database, const QString &oldName, const QString &newName)
@@ -1771,6 +1960,26 @@ void SqlQueryModel::resetFilter()
     // For custom query this is not supported.
 }
 
+bool SqlQueryModel::hasSearchIndex()
+{
+    return false;
+}
+
+bool SqlQueryModel::isSearchIndexSupported()
+{
+    return false;
+}
+
+void SqlQueryModel::buildSearchIndex()
+{
+    // For custom query this is not supported.
+}
+
+void SqlQueryModel::dropSearchIndex()
+{
+    // For custom query this is not supported.
+}
+
 int SqlQueryModel::columnCount(const QModelIndex& parent) const
 {
     UNUSED(parent);
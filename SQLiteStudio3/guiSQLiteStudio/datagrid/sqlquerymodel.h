@@ -9,6 +9,7 @@
 #include "common/column.h"
 #include "guiSQLiteStudio_global.h"
 #include "sqlqueryitemdelegate.h"
+#include "sqlquerypagecache.h"
 #include "common/strhash.h"
 #include <QStandardItemModel>
 #include <QItemSelection>
@@ -27,7 +28,8 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         {
             INSERT_ROW = 0x01,
             DELETE_ROW = 0x02,
-            FILTERING = 0x04
+            FILTERING = 0x04,
+            SEARCH_INDEX = 0x08
         };
         Q_DECLARE_FLAGS(Features, Feature)
 
@@ -132,6 +134,33 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         virtual void resetFilter();
 
+        /**
+         * @brief Tells if there is a text search index for the dataset (built or being built).
+         * @return true if the index exists.
+         * Default implementation returns false.
+         */
+        virtual bool hasSearchIndex();
+
+        /**
+         * @brief Tells if the text search index can be built for the dataset.
+         * @return true if the database connection and the dataset support the index.
+         * Default implementation returns false.
+         */
+        virtual bool isSearchIndexSupported();
+
+        /**
+         * @brief Requests building of the text search index, which speeds up filtering by text.
+         * Default implementation does nothing. Working implementation (i.e. for a table)
+         * should build the index asynchronously and emit searchIndexStateChanged() when it's done.
+         */
+        virtual void buildSearchIndex();
+
+        /**
+         * @brief Requests dropping of the text search index.
+         * Default implementation does nothing.
+         */
+        virtual void dropSearchIndex();
+
         /**
          * @brief getCurrentPage Gets number of current results page
          * @param includeOneBeingLoaded If true, then also the page that is currently being loaded (but not yet done) will returned over the currently presented page.
@@ -178,6 +207,14 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void setDesiredColumnWidth(int colIdx, int width);
         int getDesiredColumnWidth(int colIdx);
 
+        /**
+         * @brief Drops all cached pages of results.
+         *
+         * Needed after writes that don't change the data stamp of the database (see SqlQueryPageCache::readDataStamp()),
+         * like incremental BLOB writes, which are not counted by total_changes().
+         */
+        void clearPageCache();
+
     protected:
         class CommitUpdateQueryBuilder : public RowIdConditionBuilder
         {
@@ -302,7 +339,15 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          * @param results Execution results from query executor.
          * @return Whether to continue execution or not.
          */
-        bool loadData(SqlQueryPtr results);
+        bool loadData(SqlQueryPtr results, QList<SqlResultsRowPtr>& loadedRows);
+
+        /**
+         * @brief Loads page of rows from the page cache into UI cells.
+         * @param rows Rows of the page.
+         *
+         * Columns are not read again, as cached pages are always of the same query as currently loaded one.
+         */
+        void loadCachedData(const QList<SqlResultsRowPtr>& rows);
 
         QList<QStandardItem*> loadRow(SqlResultsRowPtr row);
         RowId getRowIdValue(SqlResultsRowPtr row, int columnIdx);
@@ -333,6 +378,14 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         int getInsertRowIndex();
         void notifyItemEditionEnded(const QModelIndex& idx);
         int getRowsPerPage() const;
+        void changePage(int newPage);
+        bool isPageCacheUsable();
+        QString getPageCacheKey(int page) const;
+        void cacheLoadedPage(const QList<SqlResultsRowPtr>& rows);
+        bool loadPageFromCache(int newPage);
+        void prefetchNextPage();
+
+        static QStringList getResultColumnsSignature(QueryExecutor* executor);
 
         QString query;
         QHash<QString, QVariant> queryParams;
@@ -447,6 +500,23 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
 
         bool structureOutOfDate = false;
 
+        /**
+         * @brief Recently visited and prefetched pages of currently presented query.
+         */
+        SqlQueryPageCache pageCache;
+
+        /**
+         * @brief Executor used to load the next page in background, while user reads the current one.
+         *
+         * It works on the same database connection as the main executor (using asynchronous execution), because attached
+         * databases and temporary objects used by the query are visible only to that connection.
+         */
+        QueryExecutor* prefetchExecutor = nullptr;
+
+        QString prefetchKey;
+        QString prefetchDataStamp;
+        QStringList prefetchColumnsSignature;
+
         /**
          * @brief Set of existing model objects, updated for each construction and destruction.
          *
@@ -460,6 +530,8 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void handleExecFinished(SqlQueryPtr results);
         void handleExecFailed(int code, QString errorMessage);
         void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
+        void handlePrefetchFinished(SqlQueryPtr results);
+        void handlePrefetchFailed();
 
     public slots:
         void itemValueEdited(SqlQueryItem* item);
@@ -558,6 +630,13 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void committingStepFinished(int step);
         void commitFinished();
         void itemEditionEnded(SqlQueryItem* item);
+
+        /**
+         * @brief searchIndexStateChanged
+         *
+         * Emitted when the text search index was built, its building failed, or it was dropped.
+         */
+        void searchIndexStateChanged();
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(SqlQueryModel::Features)
@@ -0,0 +1,93 @@
+#include "sqlquerypagecache.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+
+SqlQueryPageCache::SqlQueryPageCache(int maxPages) :
+    pages(maxPages)
+{
+}
+
+QString SqlQueryPageCache::makeKey(const QString& query, const QHash<QString, QVariant>& params, const QueryExecutor::SortList& sortOrder,
+                                   int rowsPerPage, int page)
+{
+    QStringList paramEntries;
+    QHashIterator<QString, QVariant> it(params);
+    while (it.hasNext())
+    {
+        it.next();
+        paramEntries << it.key() + "=" + QString::number(it.value().type()) + ":" + it.value().toString();
+    }
+    paramEntries.sort();
+
+    QStringList sortEntries;
+    for (const QueryExecutor::Sort& sort : sortOrder)
+        sortEntries << QString::number(sort.column) + ":" + QString::number(static_cast<int>(sort.order));
+
+    return QString("%1\n%2\n%3\n%4\n%5").arg(rowsPerPage).arg(page).arg(sortEntries.join(","), paramEntries.join("\n"), query);
+}
+
+QString SqlQueryPageCache::readDataStamp(Db* db)
+{
+    static_qstring(dataVersionSql, "PRAGMA data_version");
+    static_qstring(totalChangesSql, "SELECT total_changes()");
+    static_qstring(schemaVersionSql, "PRAGMA schema_version");
+
+    if (!db || !db->isOpen() || db->getDialect() != Dialect::Sqlite3)
+        return QString();
+
+    QStringList parts;
+    SqlQueryPtr results;
+    for (const QString& sql : {dataVersionSql, totalChangesSql, schemaVersionSql})
+    {
+        results = db->exec(sql, Db::Flag::NO_LOCK);
+        if (results->isError())
+            return QString();
+
+        parts << results->getSingleCell().toString();
+    }
+    return parts.join(":");
+}
+
+void SqlQueryPageCache::setDataStamp(const QString& stamp)
+{
+    if (stamp == dataStamp)
+        return;
+
+    pages.clear();
+    dataStamp = stamp;
+}
+
+void SqlQueryPageCache::insert(const QString& key, const QList<SqlResultsRowPtr>& rows)
+{
+    if (dataStamp.isNull())
+        return;
+
+    Page* page = new Page;
+    page->rows = rows;
+    pages.insert(key, page);
+}
+
+bool SqlQueryPageCache::contains(const QString& key) const
+{
+    return pages.contains(key);
+}
+
+bool SqlQueryPageCache::get(const QString& key, QList<SqlResultsRowPtr>& rows)
+{
+    if (dataStamp.isNull())
+        return false;
+
+    Page* page = pages.object(key);
+    if (!page)
+        return false;
+
+    rows = page->rows;
+    return true;
+}
+
+void SqlQueryPageCache::clear()
+{
+    pages.clear();
+    dataStamp = QString();
+}
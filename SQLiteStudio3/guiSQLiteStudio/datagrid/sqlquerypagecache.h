@@ -0,0 +1,82 @@
+#ifndef SQLQUERYPAGECACHE_H
+#define SQLQUERYPAGECACHE_H
+
+#include "guiSQLiteStudio_global.h"
+#include "db/queryexecutor.h"
+#include "db/sqlresultsrow.h"
+#include <QCache>
+#include <QHash>
+#include <QVariant>
+
+class Db;
+
+/**
+ * @brief Cache of recently visited (or prefetched) pages of query results.
+ *
+ * Pages are kept with raw result rows, exactly as they were returned from QueryExecutor, so they can be loaded
+ * into SqlQueryModel again without executing the query. The key of the page consists of the query
+ * (which includes any filter applied to the data view), its parameters, sort order, number of rows per page
+ * and the page number.
+ *
+ * Each page remembers the data stamp of the database (see readDataStamp()). When the stamp changes,
+ * the database was written to and the whole cache is dropped.
+ */
+class GUI_API_EXPORT SqlQueryPageCache
+{
+    public:
+        /**
+         * @brief Creates cache.
+         * @param maxPages Maximum number of pages kept in the cache. Least recently used pages are dropped first.
+         */
+        explicit SqlQueryPageCache(int maxPages = DEFAULT_MAX_PAGES);
+
+        /**
+         * @brief Builds the key of the page.
+         */
+        static QString makeKey(const QString& query, const QHash<QString, QVariant>& params, const QueryExecutor::SortList& sortOrder,
+                               int rowsPerPage, int page);
+
+        /**
+         * @brief Reads the stamp identifying the state of the data in the database.
+         * @param db Database to read the stamp for.
+         * @return The stamp, or null string if it cannot be determined (the cache should not be used then).
+         *
+         * The stamp consists of PRAGMA data_version (changed by commits of other connections), total_changes()
+         * (changed by writes on this connection) and PRAGMA schema_version (changed by any DDL).
+         * Stamp queries don't lock the database, so they can be executed while any asynchronous query is running.
+         */
+        static QString readDataStamp(Db* db);
+
+        /**
+         * @brief Updates the data stamp.
+         * @param stamp Stamp read with readDataStamp().
+         *
+         * If the stamp is different than the one cached pages were stored with, all pages are dropped.
+         */
+        void setDataStamp(const QString& stamp);
+
+        void insert(const QString& key, const QList<SqlResultsRowPtr>& rows);
+        bool contains(const QString& key) const;
+
+        /**
+         * @brief Provides cached page.
+         * @param key Key of the page.
+         * @param rows Output list of rows.
+         * @return true if the page was in cache.
+         */
+        bool get(const QString& key, QList<SqlResultsRowPtr>& rows);
+        void clear();
+
+        static const int DEFAULT_MAX_PAGES = 8;
+
+    private:
+        struct Page
+        {
+            QList<SqlResultsRowPtr> rows;
+        };
+
+        QCache<QString, Page> pages;
+        QString dataStamp;
+};
+
+#endif // SQLQUERYPAGECACHE_H
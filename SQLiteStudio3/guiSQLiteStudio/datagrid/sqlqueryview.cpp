@@ -2,6 +2,7 @@
 #include "sqlqueryitemdelegate.h"
 #include "sqlquerymodel.h"
 #include "sqlqueryitem.h"
+#include "sqlqueryviewmimedata.h"
 #include "common/widgetcover.h"
 #include "tsvserializer.h"
 #include "iconmanager.h"
@@ -11,6 +12,7 @@
 #include "multieditor/multieditordialog.h"
 #include "uiconfig.h"
 #include "dialogs/sortdialog.h"
+#include "dialogs/columnprofiledialog.h"
 #include "services/notifymanager.h"
 #include "windows/editorwindow.h"
 #include "mainwindow.h"
@@ -82,6 +84,7 @@ void SqlQueryView::setupWidgetCover()
 {
     widgetCover = new WidgetCover(this);
     widgetCover->initWithInterruptContainer();
+    connect(widgetCover, &WidgetCover::cancelClicked, this, &SqlQueryView::abortCopySerialization);
 }
 
 void SqlQueryView::createActions()
@@ -104,6 +107,7 @@ void SqlQueryView::createActions()
     createAction(GENERATE_DELETE, "DELETE", this, SLOT(generateDelete()), this);
     createAction(SORT_DIALOG, ICONS.SORT_COLUMNS, tr("Define columns to sort by"), this, SLOT(openSortDialog()), this);
     createAction(RESET_SORTING, ICONS.SORT_RESET, tr("Remove custom sorting"), this, SLOT(resetSorting()), this);
+    createAction(COLUMN_STATISTICS, ICONS.INFO_BALLOON, tr("Show column statistics"), this, SLOT(showColumnStatistics()), this);
     createAction(INSERT_ROW, ICONS.INSERT_ROW, tr("Insert row"), this, SIGNAL(requestForRowInsert()), this);
     createAction(INSERT_MULTIPLE_ROWS, ICONS.INSERT_ROWS, tr("Insert multiple rows"), this, SIGNAL(requestForMultipleRowInsert()), this);
     createAction(DELETE_ROW, ICONS.DELETE_ROW, tr("Delete selected row"), this, SIGNAL(requestForRowDelete()), this);
@@ -208,6 +212,8 @@ void SqlQueryView::setupHeaderMenu()
     headerContextMenu = new QMenu(horizontalHeader());
     headerContextMenu->addAction(actionMap[SORT_DIALOG]);
     headerContextMenu->addAction(actionMap[RESET_SORTING]);
+    headerContextMenu->addSeparator();
+    headerContextMenu->addAction(actionMap[COLUMN_STATISTICS]);
 }
 
 QList<SqlQueryItem*> SqlQueryView::getSelectedItems()
@@ -490,11 +496,6 @@ void SqlQueryView::copy(bool withHeader)
     if (selectedItems.isEmpty())
         return;
 
-    QVariant itemValue;
-    QStringList cells;
-    QList<QStringList> rows;
-
-    QPair<QString,QList<QList<QVariant>>> theDataPair;
     QList<QList<QVariant>> theData;
     QList<QVariant> theDataRow;
 
@@ -502,13 +503,7 @@ void SqlQueryView::copy(bool withHeader)
     if (withHeader)
     {
         for (SqlQueryModelColumnPtr col : getModel()->getColumns().mid(0, groupedItems.first().size()))
-        {
             theDataRow << col->displayName;
-            cells << col->displayName;
-        }
-
-        rows << cells;
-        cells.clear();
 
         theData << theDataRow;
         theDataRow.clear();
@@ -518,37 +513,59 @@ void SqlQueryView::copy(bool withHeader)
     for (const QList<SqlQueryItem*>& itemsInRows : groupedItems)
     {
         for (SqlQueryItem* item : itemsInRows)
-        {
-            itemValue = item->getFullValue();
-            if (itemValue.userType() == QVariant::Double)
-                cells << doubleToString(itemValue);
-            else
-                cells << itemValue.toString();
-
-            theDataRow << itemValue;
-        }
-
-        rows << cells;
-        cells.clear();
+            theDataRow << item->getFullValue();
 
         theData << theDataRow;
         theDataRow.clear();
     }
 
-    QMimeData* mimeData = new QMimeData();
-    QString tsv = TsvSerializer::serialize(rows);
-    mimeData->setText(tsv);
+    // Text is produced when it's requested from the clipboard, or in advance on a worker thread for big selections
+    abortCopySerialization();
+    SqlQueryViewMimeData* mimeData = new SqlQueryViewMimeData(theData, mimeDataId);
+    qApp->clipboard()->setMimeData(mimeData);
+    if (mimeData->getCellCount() >= backgroundCopyThreshold)
+        serializeCopiedData(mimeData);
+}
+
+void SqlQueryView::serializeCopiedData(SqlQueryViewMimeData* mimeData)
+{
+    connect(mimeData, &SqlQueryViewMimeData::serializationProgress, widgetCover, &WidgetCover::setProgress);
+    connect(mimeData, &SqlQueryViewMimeData::serializationFinished, this, [this, mimeData]()
+    {
+        if (copiedData == mimeData)
+            copySerializationFinished();
+    });
 
-    QString md5 = QCryptographicHash::hash(tsv.toUtf8(), QCryptographicHash::Md5);
-    theDataPair.first = md5;
-    theDataPair.second = theData;
+    // Clipboard deletes the data once anything else is copied
+    connect(mimeData, &QObject::destroyed, this, [this, mimeData]()
+    {
+        if (copiedData == mimeData)
+            copySerializationFinished();
+    });
 
-    QByteArray serializedData;
-    QDataStream stream(&serializedData, QIODevice::WriteOnly);
-    stream << theDataPair;
-    mimeData->setData(mimeDataId, serializedData);
+    if (!mimeData->serializeInBackground())
+        return;
 
-    qApp->clipboard()->setMimeData(mimeData);
+    copiedData = mimeData;
+    widgetCover->displayProgress(100, tr("Copying to clipboard: %p%"));
+    widgetCover->setProgress(0);
+    widgetCover->show();
+}
+
+void SqlQueryView::abortCopySerialization()
+{
+    if (!copiedData)
+        return;
+
+    copiedData->abortSerialization();
+    copySerializationFinished();
+}
+
+void SqlQueryView::copySerializationFinished()
+{
+    copiedData = nullptr;
+    widgetCover->hide();
+    widgetCover->noDisplayProgress();
 }
 
 bool SqlQueryView::getSimpleBrowserMode() const
@@ -607,6 +624,12 @@ void SqlQueryView::headerContextMenuRequested(const QPoint& pos)
     if (simpleBrowserMode)
         return;
 
+    // Statistics are available for columns that come directly from a table
+    headerMenuColumn = horizontalHeader()->logicalIndexAt(pos);
+    QList<SqlQueryModelColumnPtr> columns = getModel()->getColumns();
+    bool tableColumn = headerMenuColumn >= 0 && headerMenuColumn < columns.size() && !columns[headerMenuColumn]->table.isEmpty();
+    actionMap[COLUMN_STATISTICS]->setEnabled(tableColumn && getModel()->getDb() && getModel()->getDb()->isOpen());
+
     headerContextMenu->popup(horizontalHeader()->mapToGlobal(pos));
 }
 
@@ -625,6 +648,31 @@ void SqlQueryView::openSortDialog()
     getModel()->setSortOrder(dialog.getSortOrder());
 }
 
+void SqlQueryView::showColumnStatistics()
+{
+    QList<SqlQueryModelColumnPtr> modelColumns = getModel()->getColumns();
+    if (headerMenuColumn < 0 || headerMenuColumn >= modelColumns.size())
+        return;
+
+    // All columns of the same table are profiled in a single pass
+    SqlQueryModelColumnPtr selectedColumn = modelColumns[headerMenuColumn];
+    QStringList columns;
+    for (const SqlQueryModelColumnPtr& col : modelColumns)
+    {
+        if (col->table.compare(selectedColumn->table, Qt::CaseInsensitive) == 0 &&
+            col->database.compare(selectedColumn->database, Qt::CaseInsensitive) == 0 &&
+            !columns.contains(col->column, Qt::CaseInsensitive))
+        {
+            columns << col->column;
+        }
+    }
+
+    ColumnProfileDialog* dialog = new ColumnProfileDialog(getModel()->getDb(), selectedColumn->database, selectedColumn->table, columns, this);
+    dialog->setCurrentColumn(selectedColumn->column);
+    dialog->show();
+    dialog->start();
+}
+
 void SqlQueryView::resetSorting()
 {
     getModel()->setSortOrder(QueryExecutor::SortList());
@@ -680,6 +728,14 @@ void SqlQueryView::paste()
         return;
 
     const QMimeData* mimeData = qApp->clipboard()->mimeData();
+    const SqlQueryViewMimeData* viewMimeData = qobject_cast<const SqlQueryViewMimeData*>(mimeData);
+    if (viewMimeData)
+    {
+        // Copied within this application, so values don't need to go through the text
+        paste(viewMimeData->getValues());
+        return;
+    }
+
     if (mimeData->hasFormat(mimeDataId))
     {
         QString tsv = mimeData->text();
@@ -809,6 +865,9 @@ void SqlQueryView::openValueEditor(SqlQueryItem* item)
         return;
     }
 
+    if (openValueEditorForBlob(item))
+        return;
+
     MultiEditorDialog editor(this);
     editor.setWindowTitle(tr("Edit value"));
     editor.setDataType(item->getColumn()->dataType);
@@ -826,6 +885,69 @@ void SqlQueryView::openValueEditor()
     openValueEditor(currentItem);
 }
 
+bool SqlQueryView::openValueEditorForBlob(SqlQueryItem* item)
+{
+    QIODevice* blob = openBlob(item);
+    if (!blob)
+        return false;
+
+    if (blob->size() < blobStreamingThreshold)
+    {
+        delete blob;
+        return false;
+    }
+
+    MultiEditorDialog editor(this);
+    editor.setWindowTitle(tr("Edit value"));
+    editor.setReadOnly(!blob->isWritable());
+    editor.setValueDevice(blob);
+    if (editor.exec() == QDialog::Rejected)
+    {
+        delete blob;
+        return true;
+    }
+
+    if (!editor.writeValueDevice())
+    {
+        notifyError(tr("Could not save the value in the database. Details: %1").arg(blob->errorString()));
+        delete blob;
+        return true;
+    }
+
+    // Value was modified in place, only the cell needs to show the new beginning of the value.
+    blob->seek(0);
+    item->setValue(blob->read(SqlQueryModel::getCellDataLengthLimit()), true, true);
+    delete blob;
+
+    // BLOB writes don't change the data stamp, so cached pages would keep showing the old value.
+    getModel()->clearPageCache();
+    return true;
+}
+
+QIODevice* SqlQueryView::openBlob(SqlQueryItem* item)
+{
+    if (!item->isLimitedValue() || item->isUncommitted() || item->isDeletedRow())
+        return nullptr;
+
+    if (item->getValue().type() != QVariant::ByteArray)
+        return nullptr;
+
+    SqlQueryModelColumn* col = item->getColumn();
+    if (col->table.isNull() || col->editionForbiddenReason.size() > 0)
+        return nullptr;
+
+    // Incremental BLOB access works only with tables having ROWID.
+    RowId rowId = item->getRowId();
+    if (rowId.size() != 1 || !rowId.contains("ROWID"))
+        return nullptr;
+
+    Db* db = getModel()->getDb();
+    if (!db || !db->isOpen())
+        return nullptr;
+
+    return db->openBlob(col->database, col->table, col->column, rowId["ROWID"].toLongLong(), col->canEdit());
+}
+
 int qHash(SqlQueryView::Action action)
 {
     return static_cast<int>(action);
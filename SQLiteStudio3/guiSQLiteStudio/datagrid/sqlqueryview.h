@@ -11,12 +11,14 @@
 
 class SqlQueryItemDelegate;
 class SqlQueryItem;
+class SqlQueryViewMimeData;
 class WidgetCover;
 class SqlQueryModel;
 class SqlQueryModelColumn;
 class QPushButton;
 class QProgressBar;
 class QMenu;
+class QIODevice;
 
 CFG_KEY_LIST(SqlQueryView, QObject::tr("Data grid view"),
     CFG_KEY_ENTRY(COPY,              Qt::CTRL + Qt::Key_C,              QObject::tr("Copy cell(s) contents to clipboard"))
@@ -61,7 +63,8 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
             GENERATE_SELECT,
             GENERATE_INSERT,
             GENERATE_UPDATE,
-            GENERATE_DELETE
+            GENERATE_DELETE,
+            COLUMN_STATISTICS
         };
 
         enum ToolBar
@@ -108,10 +111,28 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void addFkActionsToContextMenu(SqlQueryItem* currentItem);
         void goToReferencedRow(const QString& table, const QString& column, const QVariant& value);
         void copy(bool withHeaders);
+        void serializeCopiedData(SqlQueryViewMimeData* mimeData);
+        void copySerializationFinished();
+        bool openValueEditorForBlob(SqlQueryItem* item);
+        QIODevice* openBlob(SqlQueryItem* item);
 
         constexpr static const char* mimeDataId = "application/x-sqlitestudio-data-view-data";
         constexpr static const int minHeaderWidth = 15;
 
+        /**
+         * @brief Size of BLOB value (in bytes), from which value editor works directly on the database.
+         *
+         * Such values are not loaded into memory as a whole, but edited page by page in the hex editor.
+         */
+        constexpr static const qint64 blobStreamingThreshold = 4 * 1024 * 1024;
+
+        /**
+         * @brief Number of copied cells, from which the clipboard text is prepared in advance on a worker thread.
+         *
+         * Smaller selections are serialized when the text is requested from the clipboard.
+         */
+        constexpr static const int backgroundCopyThreshold = 100000;
+
         SqlQueryItemDelegate* itemDelegate = nullptr;
         QMenu* contextMenu = nullptr;
         QMenu* headerContextMenu = nullptr;
@@ -123,6 +144,8 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         bool simpleBrowserMode = false;
         bool ignoreColumnWidthChanges = false;
         int beforeExecutionHorizontalPosition = -1;
+        int headerMenuColumn = -1;
+        SqlQueryViewMimeData* copiedData = nullptr;
 
     private slots:
         void updateCommitRollbackActions(bool enabled);
@@ -130,6 +153,8 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void headerContextMenuRequested(const QPoint& pos);
         void openSortDialog();
         void resetSorting();
+        void showColumnStatistics();
+        void abortCopySerialization();
         void sortingUpdated(const QueryExecutor::SortList& sortOrder);
         void updateFont();
         void itemActivated(const QModelIndex& index);
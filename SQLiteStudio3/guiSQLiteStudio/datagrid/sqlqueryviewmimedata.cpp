@@ -0,0 +1,159 @@
+#include "sqlqueryviewmimedata.h"
+#include "tsvserializer.h"
+#include "common/utils.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QtConcurrent/QtConcurrentRun>
+#include <limits>
+
+SqlQueryViewMimeData::SqlQueryViewMimeData(const QList<QList<QVariant>>& values, const QString& valuesFormat) :
+    values(values), valuesFormat(valuesFormat)
+{
+    for (const QList<QVariant>& row : values)
+        cellCount += row.size();
+}
+
+SqlQueryViewMimeData::~SqlQueryViewMimeData()
+{
+    abortSerialization();
+}
+
+QStringList SqlQueryViewMimeData::formats() const
+{
+    return {TEXT_FORMAT, valuesFormat};
+}
+
+bool SqlQueryViewMimeData::hasFormat(const QString& mimeType) const
+{
+    return mimeType == TEXT_FORMAT || mimeType == valuesFormat;
+}
+
+const QList<QList<QVariant>>& SqlQueryViewMimeData::getValues() const
+{
+    return values;
+}
+
+int SqlQueryViewMimeData::getCellCount() const
+{
+    return cellCount;
+}
+
+bool SqlQueryViewMimeData::serializeInBackground()
+{
+    if (backgroundStarted || textReady)
+        return false;
+
+    abortRequested.store(0);
+    backgroundStarted = true;
+    future = QtConcurrent::run([this]()
+    {
+        QString result = serialize([this](int percent)
+        {
+            emit serializationProgress(percent);
+        });
+        emit serializationFinished();
+        return result;
+    });
+    return true;
+}
+
+void SqlQueryViewMimeData::abortSerialization()
+{
+    if (!backgroundStarted)
+        return;
+
+    abortRequested.store(1);
+    future.waitForFinished();
+    backgroundStarted = false;
+}
+
+QString SqlQueryViewMimeData::valueToString(const QVariant& value)
+{
+    if (value.userType() == QVariant::Double)
+        return doubleToString(value);
+
+    return value.toString();
+}
+
+QVariant SqlQueryViewMimeData::retrieveData(const QString& mimeType, QVariant::Type type) const
+{
+    if (mimeType == TEXT_FORMAT)
+        return getText();
+
+    if (mimeType == valuesFormat)
+        return getSerializedValues();
+
+    return QMimeData::retrieveData(mimeType, type);
+}
+
+QString SqlQueryViewMimeData::serialize(const ProgressHandler& progressHandler) const
+{
+    DsvWriter writer = TsvSerializer::createWriter();
+    int totalRows = values.size();
+    int rowIdx = 0;
+    int percent = 0;
+    int newPercent;
+    for (const QList<QVariant>& row : values)
+    {
+        if (abortRequested.load())
+            return QString();
+
+        for (const QVariant& value : row)
+            writer.appendValue(valueToString(value));
+
+        writer.finishRow();
+        rowIdx++;
+
+        // Values are converted to strings on the fly, so the output size is known only after some rows
+        if (rowIdx == SIZE_ESTIMATION_ROWS && totalRows > rowIdx)
+            writer.reserve(static_cast<int>(qMin<qint64>(qint64(writer.size()) * totalRows / rowIdx * 11 / 10, std::numeric_limits<int>::max())));
+
+        newPercent = static_cast<int>(qint64(rowIdx) * 100 / totalRows);
+        if (progressHandler && newPercent > percent)
+        {
+            percent = newPercent;
+            progressHandler(percent);
+        }
+    }
+
+    return writer.getOutput();
+}
+
+QString SqlQueryViewMimeData::getText() const
+{
+    if (textReady)
+        return text;
+
+    if (backgroundStarted)
+    {
+        // Requested before the worker has finished, so it has to be waited for
+        future.waitForFinished();
+        backgroundStarted = false;
+        if (!abortRequested.load())
+        {
+            text = future.result();
+            textReady = true;
+            return text;
+        }
+    }
+
+    abortRequested.store(0);
+    text = serialize();
+    textReady = true;
+    return text;
+}
+
+QByteArray SqlQueryViewMimeData::getSerializedValues() const
+{
+    if (!serializedValues.isNull())
+        return serializedValues;
+
+    // Checksum lets the receiver verify that values still match the text on the clipboard
+    QPair<QString,QList<QList<QVariant>>> theDataPair;
+    theDataPair.first = QCryptographicHash::hash(getText().toUtf8(), QCryptographicHash::Md5);
+    theDataPair.second = values;
+
+    QDataStream stream(&serializedValues, QIODevice::WriteOnly);
+    stream << theDataPair;
+    return serializedValues;
+}
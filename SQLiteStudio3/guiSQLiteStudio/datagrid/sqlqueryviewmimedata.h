@@ -0,0 +1,89 @@
+#ifndef SQLQUERYVIEWMIMEDATA_H
+#define SQLQUERYVIEWMIMEDATA_H
+
+#include "guiSQLiteStudio_global.h"
+#include "common/global.h"
+#include <QMimeData>
+#include <QFuture>
+#include <QAtomicInt>
+#include <QVariant>
+#include <functional>
+
+/**
+ * @brief Clipboard data of cells copied from SqlQueryView.
+ *
+ * Only cell values are kept at the moment of copying. The TSV text (and the serialized values for pasting
+ * into another application instance) is produced when it is requested from the clipboard for the first time.
+ * For big selections the text can be prepared in advance on a worker thread (see serializeInBackground()),
+ * so pasting to another application does not block the UI for long.
+ *
+ * Pasting within the same application uses values directly, without any serialization.
+ */
+class GUI_API_EXPORT SqlQueryViewMimeData : public QMimeData
+{
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Creates clipboard data.
+         * @param values Rows of cell values.
+         * @param valuesFormat MIME type under which the values are available to other application instances.
+         */
+        SqlQueryViewMimeData(const QList<QList<QVariant>>& values, const QString& valuesFormat);
+        ~SqlQueryViewMimeData();
+
+        QStringList formats() const;
+        bool hasFormat(const QString& mimeType) const;
+        const QList<QList<QVariant>>& getValues() const;
+        int getCellCount() const;
+
+        /**
+         * @brief Starts preparing the text on a worker thread.
+         *
+         * Progress is reported with serializationProgress() and serializationFinished() signals.
+         * @return true if the worker was started, false if the text is already prepared or being prepared.
+         */
+        bool serializeInBackground();
+
+        /**
+         * @brief Stops preparing the text on the worker thread.
+         *
+         * The text is then produced when it's requested from the clipboard.
+         */
+        void abortSerialization();
+
+        static QString valueToString(const QVariant& value);
+
+    protected:
+        QVariant retrieveData(const QString& mimeType, QVariant::Type type) const;
+
+    private:
+        typedef std::function<void(int)> ProgressHandler;
+
+        QString serialize(const ProgressHandler& progressHandler = nullptr) const;
+        QString getText() const;
+        QByteArray getSerializedValues() const;
+
+        static_char* TEXT_FORMAT = "text/plain";
+
+        /**
+         * @brief Number of rows after which the output size is estimated and the buffer is reserved.
+         */
+        static const int SIZE_ESTIMATION_ROWS = 100;
+
+        QList<QList<QVariant>> values;
+        QString valuesFormat;
+        int cellCount = 0;
+        mutable QAtomicInt abortRequested;
+        mutable QFuture<QString> future;
+        mutable bool backgroundStarted = false;
+        mutable QString text;
+        mutable bool textReady = false;
+        mutable QByteArray serializedValues;
+
+    signals:
+        void serializationProgress(int percent);
+        void serializationFinished();
+};
+
+#endif // SQLQUERYVIEWMIMEDATA_H
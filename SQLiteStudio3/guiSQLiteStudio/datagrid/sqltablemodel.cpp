@@ -3,6 +3,7 @@
 #include "sqlqueryitem.h"
 #include "services/notifymanager.h"
 #include "uiconfig.h"
+#include "sqltablesearchindex.h"
 #include <QDebug>
 #include <QApplication>
 #include <schemaresolver.h>
@@ -42,7 +43,7 @@ void SqlTableModel::setDatabaseAndTable(const QString& database, const QString&
 
 SqlQueryModel::Features SqlTableModel::features() const
 {
-    return INSERT_ROW|DELETE_ROW|FILTERING;
+    return INSERT_ROW|DELETE_ROW|FILTERING|SEARCH_INDEX;
 }
 
 bool SqlTableModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
@@ -147,7 +148,7 @@ bool SqlTableModel::commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow)
     return true;
 }
 
-void SqlTableModel::applyFilter(const QString& value, FilterValueProcessor valueProc)
+void SqlTableModel::applyFilter(const QString& value, FilterValueProcessor valueProc, SqlTableSearchIndex* searchIndex)
 {
     static_qstring(sql, "SELECT * FROM %1 WHERE %2");
 
@@ -157,6 +158,14 @@ void SqlTableModel::applyFilter(const QString& value, FilterValueProcessor value
         return;
     }
 
+    QString indexCondition = searchIndex ? searchIndex->getCondition(value) : QString();
+    if (!indexCondition.isNull())
+    {
+        setQuery(sql.arg(getDataSource(), indexCondition));
+        executeQuery();
+        return;
+    }
+
     Dialect dialect = db->getDialect();
     QStringList conditions;
     for (SqlQueryModelColumnPtr column : columns)
@@ -166,7 +175,7 @@ void SqlTableModel::applyFilter(const QString& value, FilterValueProcessor value
     executeQuery();
 }
 
-void SqlTableModel::applyFilter(const QStringList& values, FilterValueProcessor valueProc)
+void SqlTableModel::applyFilter(const QStringList& values, FilterValueProcessor valueProc, SqlTableSearchIndex* searchIndex)
 {
     static_qstring(sql, "SELECT * FROM %1 WHERE %2");
     if (values.isEmpty())
@@ -184,11 +193,19 @@ void SqlTableModel::applyFilter(const QStringList& values, FilterValueProcessor
 
     Dialect dialect = db->getDialect();
     QStringList conditions;
+    QString indexCondition;
     for (int i = 0, total = columns.size(); i < total; ++i)
     {
         if (values[i].isEmpty())
             continue;
 
+        indexCondition = searchIndex ? searchIndex->getCondition(values[i], i) : QString();
+        if (!indexCondition.isNull())
+        {
+            conditions << indexCondition;
+            continue;
+        }
+
         conditions << wrapObjIfNeeded(columns[i]->column, dialect)+" "+valueProc(values[i]);
     }
 
@@ -227,12 +244,12 @@ void SqlTableModel::applySqlFilter(const QString& value)
 
 void SqlTableModel::applyStringFilter(const QString& value)
 {
-    applyFilter(value, &stringFilterValueProcessor);
+    applyFilter(value, &stringFilterValueProcessor, getUsableSearchIndex());
 }
 
 void SqlTableModel::applyStringFilter(const QStringList& values)
 {
-    applyFilter(values, &stringFilterValueProcessor);
+    applyFilter(values, &stringFilterValueProcessor, getUsableSearchIndex());
 }
 
 void SqlTableModel::applyRegExpFilter(const QString& value)
@@ -252,6 +269,60 @@ void SqlTableModel::resetFilter()
     executeQuery();
 }
 
+bool SqlTableModel::hasSearchIndex()
+{
+    return SqlTableSearchIndex::getIndex(db, database, table) != nullptr;
+}
+
+bool SqlTableModel::isSearchIndexSupported()
+{
+    return !isWithOutRowIdTable && SqlTableSearchIndex::isSupported(db);
+}
+
+void SqlTableModel::buildSearchIndex()
+{
+    if (isWithOutRowIdTable)
+    {
+        notifyWarn(tr("Search index cannot be built for table %1, because it's a WITHOUT ROWID table.").arg(table));
+        emit searchIndexStateChanged();
+        return;
+    }
+
+    if (!SqlTableSearchIndex::isSupported(db))
+    {
+        notifyWarn(tr("Search index cannot be built for table %1, because the SQLite library doesn't provide FTS5 with the trigram tokenizer.").arg(table));
+        emit searchIndexStateChanged();
+        return;
+    }
+
+    SqlTableSearchIndex* searchIndex = SqlTableSearchIndex::createIndex(db, database, table, getColumnNames());
+    connect(searchIndex, SIGNAL(stateChanged()), this, SIGNAL(searchIndexStateChanged()), Qt::UniqueConnection);
+}
+
+void SqlTableModel::dropSearchIndex()
+{
+    SqlTableSearchIndex::dropIndex(db, database, table);
+    emit searchIndexStateChanged();
+}
+
+SqlTableSearchIndex* SqlTableModel::getUsableSearchIndex()
+{
+    SqlTableSearchIndex* searchIndex = SqlTableSearchIndex::getIndex(db, database, table);
+    if (!searchIndex || !searchIndex->isUsable(getColumnNames()))
+        return nullptr;
+
+    return searchIndex;
+}
+
+QStringList SqlTableModel::getColumnNames() const
+{
+    QStringList names;
+    for (const SqlQueryModelColumnPtr& column : columns)
+        names << column->column;
+
+    return names;
+}
+
 QString SqlTableModel::generateSelectQueryForItems(const QList<SqlQueryItem*>& items)
 {
     QHash<QString, QVariantList> values = toValuesGroupedByColumns(items);
@@ -4,6 +4,8 @@
 #include "guiSQLiteStudio_global.h"
 #include "sqlquerymodel.h"
 
+class SqlTableSearchIndex;
+
 class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
 {
         Q_OBJECT
@@ -21,6 +23,10 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
         void applyRegExpFilter(const QString& value);
         void applyRegExpFilter(const QStringList& values);
         void resetFilter();
+        bool hasSearchIndex();
+        bool isSearchIndexSupported();
+        void buildSearchIndex();
+        void dropSearchIndex();
         QString generateSelectQueryForItems(const QList<SqlQueryItem*>& items);
         QString generateInsertQueryForItems(const QList<SqlQueryItem*>& items);
         QString generateUpdateQueryForItems(const QList<SqlQueryItem*>& items);
@@ -50,8 +56,10 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
         static QString stringFilterValueProcessor(const QString& value);
         static QString regExpFilterValueProcessor(const QString& value);
 
-        void applyFilter(const QString& value, FilterValueProcessor valueProc);
-        void applyFilter(const QStringList& values, FilterValueProcessor valueProc);
+        void applyFilter(const QString& value, FilterValueProcessor valueProc, SqlTableSearchIndex* searchIndex = nullptr);
+        void applyFilter(const QStringList& values, FilterValueProcessor valueProc, SqlTableSearchIndex* searchIndex = nullptr);
+        SqlTableSearchIndex* getUsableSearchIndex();
+        QStringList getColumnNames() const;
         void updateColumnsAndValuesWithDefaultValues(const QList<SqlQueryModelColumnPtr>& modelColumns, QStringList& colNameList,
                                                      QStringList& sqlValues, QList<QVariant>& args);
         void updateColumnsAndValues(const QList<SqlQueryItem*>& itemsInRow, const QList<SqlQueryModelColumnPtr>& modelColumns,
@@ -0,0 +1,407 @@
+#include "sqltablesearchindex.h"
+#include "db/db.h"
+#include "common/utils_sql.h"
+#include "services/dbmanager.h"
+#include "services/notifymanager.h"
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+#include <limits>
+
+QHash<QString, SqlTableSearchIndex*> SqlTableSearchIndex::indexes;
+QHash<Db*, bool> SqlTableSearchIndex::supportedDbs;
+int SqlTableSearchIndex::nextIndexId = 1;
+
+SqlTableSearchIndex::SqlTableSearchIndex(Db* db, const QString& database, const QString& table, const QStringList& columns) :
+    db(db), database(database), table(table), columns(columns)
+{
+    indexTable = QString("sqlitestudio_search_%1").arg(nextIndexId++);
+
+    // Progress is reported every 25%
+    connect(this, &SqlTableSearchIndex::buildProgress, this, [this](int percent)
+    {
+        notifyInfo(tr("Building search index for table %1: %2%").arg(this->table).arg(percent));
+    });
+}
+
+SqlTableSearchIndex* SqlTableSearchIndex::getIndex(Db* db, const QString& database, const QString& table)
+{
+    return indexes.value(key(db, database, table));
+}
+
+SqlTableSearchIndex* SqlTableSearchIndex::createIndex(Db* db, const QString& database, const QString& table, const QStringList& columns)
+{
+    initRegistry();
+
+    QString indexKey = key(db, database, table);
+    SqlTableSearchIndex* index = indexes.value(indexKey);
+    if (index && (index->isBuilding() || index->isUsable(columns)))
+        return index;
+
+    // Outdated index has dropped itself already
+    index = indexes.take(indexKey);
+    if (index)
+        index->drop();
+
+    index = new SqlTableSearchIndex(db, database, table, columns);
+    indexes[indexKey] = index;
+    index->build();
+    return index;
+}
+
+void SqlTableSearchIndex::dropIndex(Db* db, const QString& database, const QString& table)
+{
+    SqlTableSearchIndex* index = indexes.take(key(db, database, table));
+    if (index)
+        index->drop();
+}
+
+bool SqlTableSearchIndex::isSupported(Db* db)
+{
+    static_qstring(probeSql, "CREATE VIRTUAL TABLE temp.%1 USING fts5(x, tokenize='trigram')");
+    static_qstring(dropProbeSql, "DROP TABLE temp.%1");
+
+    if (!db || !db->isOpen())
+        return false;
+
+    initRegistry();
+    if (supportedDbs.contains(db))
+        return supportedDbs[db];
+
+    // Both FTS5 and the trigram tokenizer (SQLite 3.34) are required
+    SqlQueryPtr results = db->exec(probeSql.arg(PROBE_TABLE), Db::Flag::SKIP_DROP_DETECTION);
+    bool supported = !results->isError();
+    if (supported)
+        db->exec(dropProbeSql.arg(PROBE_TABLE), Db::Flag::SKIP_DROP_DETECTION);
+    else
+        qDebug() << "Search index is not supported by database" << db->getName() << ":" << results->getErrorText();
+
+    supportedDbs[db] = supported;
+    return supported;
+}
+
+bool SqlTableSearchIndex::isBuilding() const
+{
+    return building;
+}
+
+bool SqlTableSearchIndex::isUsable(const QStringList& columns)
+{
+    if (!ready || building || columns != this->columns || !db->isOpen())
+        return false;
+
+    if (isOutdated())
+    {
+        notifyInfo(tr("Search index for table %1 was dropped, because the table was modified in a way that the index could not follow.").arg(table));
+        if (indexes.value(key(db, database, table)) == this)
+            indexes.remove(key(db, database, table));
+
+        drop();
+        return false;
+    }
+    return true;
+}
+
+bool SqlTableSearchIndex::isOutdated()
+{
+    static_qstring(checkSql, "SELECT count(*) FROM temp.sqlite_master WHERE type = 'trigger' AND name IN ('%1')");
+
+    // Triggers are dropped together with the source table
+    SqlQueryPtr results = db->exec(checkSql.arg(getTriggerNames().join("', '")));
+    if (results->isError() || results->getSingleCell().toInt() != getTriggerNames().size())
+        return true;
+
+    // Triggers don't see changes from other connections, nor rowids renumbered by VACUUM
+    qint64 currentDataVersion;
+    qint64 currentSchemaVersion;
+    if (!readVersions(currentDataVersion, currentSchemaVersion))
+        return true;
+
+    return currentDataVersion != dataVersion || currentSchemaVersion != schemaVersion;
+}
+
+QString SqlTableSearchIndex::getCondition(const QString& value, int column) const
+{
+    static_qstring(conditionTpl, "rowid IN (SELECT rowid FROM %1.%2 WHERE %2 MATCH '%3')");
+
+    // Trigrams don't handle shorter values and LIKE wildcards would not be respected
+    if (!ready || value.length() < MIN_VALUE_LENGTH || value.contains('%') || value.contains('_'))
+        return QString();
+
+    if (column >= columns.size())
+        return QString();
+
+    QString phrase = "\"" + QString(value).replace("\"", "\"\"") + "\"";
+    if (column >= 0)
+        phrase = QString("{c%1} : %2").arg(column).arg(phrase);
+
+    return conditionTpl.arg(SHADOW_DB, indexTable, escapeString(phrase));
+}
+
+void SqlTableSearchIndex::build()
+{
+    building = true;
+    notifyInfo(tr("Building search index for table %1.").arg(table));
+
+    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcherBase::finished, [this, watcher]()
+    {
+        buildFinished(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(this, &SqlTableSearchIndex::buildInThread));
+}
+
+bool SqlTableSearchIndex::buildInThread()
+{
+    static_qstring(attachSql, "ATTACH '' AS %1");
+    static_qstring(isAttachedSql, "SELECT count(*) FROM pragma_database_list WHERE name = '%1'");
+    static_qstring(createSql, "CREATE VIRTUAL TABLE %1.%2 USING fts5(%3, content='', tokenize='trigram')");
+    static_qstring(countSql, "SELECT count(*) FROM %1");
+    static_qstring(chunkEndSql, "SELECT rowid FROM %1 WHERE rowid > ? ORDER BY rowid LIMIT 1 OFFSET %2");
+    static_qstring(copySql, "INSERT INTO %1.%2 (rowid, %3) SELECT rowid, %4 FROM %5 AS src WHERE rowid > ? "
+                            "AND NOT EXISTS (SELECT 1 FROM %1.%2_docsize WHERE id = src.rowid)");
+    static_qstring(copyRangeSql, "INSERT INTO %1.%2 (rowid, %3) SELECT rowid, %4 FROM %5 AS src WHERE rowid > ? AND rowid <= ? "
+                                 "AND NOT EXISTS (SELECT 1 FROM %1.%2_docsize WHERE id = src.rowid)");
+    static_qstring(insertTrigSql, "CREATE TEMP TRIGGER %1 AFTER INSERT ON %2 BEGIN %3; END");
+    static_qstring(deleteTrigSql, "CREATE TEMP TRIGGER %1 AFTER DELETE ON %2 BEGIN %3; END");
+    static_qstring(updateTrigSql, "CREATE TEMP TRIGGER %1 AFTER UPDATE ON %2 BEGIN %3; %4; END");
+    static_qstring(trigInsertStmt, "INSERT INTO %1 (rowid, %2) VALUES (new.rowid, %3)");
+    static_qstring(trigDeleteStmt, "INSERT INTO %1 (%1, rowid, %2) SELECT 'delete', old.rowid, %3 "
+                                   "WHERE EXISTS (SELECT 1 FROM %1_docsize WHERE id = old.rowid)");
+
+    SqlQueryPtr results = db->exec(isAttachedSql.arg(SHADOW_DB));
+    if (results->isError())
+    {
+        errorText = results->getErrorText();
+        return false;
+    }
+
+    if (results->getSingleCell().toInt() == 0 && !execBuildStep(attachSql.arg(SHADOW_DB)))
+        return false;
+
+    // Any change from now on, that triggers can't see, makes the index outdated
+    if (!readVersions(dataVersion, schemaVersion))
+    {
+        cleanUp();
+        return false;
+    }
+
+    QStringList indexCols;
+    QStringList sourceCols;
+    QStringList newCols;
+    QStringList oldCols;
+    QString wrappedCol;
+    for (int i = 0, total = columns.size(); i < total; i++)
+    {
+        wrappedCol = wrapObjIfNeeded(columns[i], Dialect::Sqlite3);
+        indexCols << QString("c%1").arg(i);
+        sourceCols << wrappedCol;
+        newCols << "new." + wrappedCol;
+        oldCols << "old." + wrappedCol;
+    }
+
+    QString indexColList = indexCols.join(", ");
+    QString source = getSourceTable();
+    if (!execBuildStep(createSql.arg(SHADOW_DB, indexTable, indexColList)))
+        return false;
+
+    // Triggers are created before the copy, so rows changed in the meantime are not missed. Rows indexed by triggers
+    // are skipped by the copy, and triggers remove from the index only rows that were indexed already.
+    // Statements in triggers cannot use qualified names, but the index table name is unique across attached databases.
+    QStringList trigNames = getTriggerNames();
+    QString insertStmt = trigInsertStmt.arg(indexTable, indexColList, newCols.join(", "));
+    QString deleteStmt = trigDeleteStmt.arg(indexTable, indexColList, oldCols.join(", "));
+    if (!execBuildStep(insertTrigSql.arg(trigNames[0], source, insertStmt)) ||
+        !execBuildStep(deleteTrigSql.arg(trigNames[1], source, deleteStmt)) ||
+        !execBuildStep(updateTrigSql.arg(trigNames[2], source, deleteStmt, insertStmt)))
+    {
+        return false;
+    }
+
+    // Triggers themselves change the schema of the temp database
+    qint64 ignoredDataVersion;
+    if (database.compare("temp", Qt::CaseInsensitive) == 0 && !readVersions(ignoredDataVersion, schemaVersion))
+    {
+        cleanUp();
+        return false;
+    }
+
+    // Copying in chunks by rowid, so the progress can be reported and the database is not locked for the whole time.
+    results = db->exec(countSql.arg(source));
+    if (results->isError())
+    {
+        errorText = results->getErrorText();
+        cleanUp();
+        return false;
+    }
+
+    qint64 totalRows = results->getSingleCell().toLongLong();
+    qint64 copiedRows = 0;
+    int reportedPercent = 0;
+    int percent;
+    QVariant lastRowId = std::numeric_limits<qint64>::min();
+    QVariant chunkEnd;
+    while (true)
+    {
+        results = db->exec(chunkEndSql.arg(source).arg(CHUNK_ROWS - 1), {lastRowId});
+        if (results->isError())
+        {
+            errorText = results->getErrorText();
+            cleanUp();
+            return false;
+        }
+
+        chunkEnd = results->getSingleCell();
+        if (chunkEnd.isNull())
+        {
+            if (!execBuildStep(copySql.arg(SHADOW_DB, indexTable, indexColList, sourceCols.join(", "), source), {lastRowId}))
+                return false;
+
+            break;
+        }
+
+        if (!execBuildStep(copyRangeSql.arg(SHADOW_DB, indexTable, indexColList, sourceCols.join(", "), source), {lastRowId, chunkEnd}))
+            return false;
+
+        lastRowId = chunkEnd;
+        copiedRows += CHUNK_ROWS;
+        percent = totalRows > 0 ? static_cast<int>(copiedRows * 100 / totalRows) : 100;
+        if (percent / 25 > reportedPercent / 25 && percent < 100)
+        {
+            reportedPercent = percent;
+            emit buildProgress(percent / 25 * 25);
+        }
+    }
+
+    return true;
+}
+
+bool SqlTableSearchIndex::execBuildStep(const QString& query, const QList<QVariant>& args)
+{
+    SqlQueryPtr results = db->exec(query, args, Db::Flag::SKIP_DROP_DETECTION);
+    if (!results->isError())
+        return true;
+
+    errorText = results->getErrorText();
+    cleanUp();
+    return false;
+}
+
+bool SqlTableSearchIndex::readVersions(qint64& dataVersion, qint64& schemaVersion)
+{
+    static_qstring(dataVersionSql, "PRAGMA %1.data_version");
+    static_qstring(schemaVersionSql, "PRAGMA %1.schema_version");
+
+    QString dbName = wrapObjIfNeeded(database.isEmpty() ? "main" : database, Dialect::Sqlite3);
+    SqlQueryPtr results = db->exec(dataVersionSql.arg(dbName), Db::Flag::SKIP_DROP_DETECTION);
+    if (results->isError())
+    {
+        errorText = results->getErrorText();
+        return false;
+    }
+    dataVersion = results->getSingleCell().toLongLong();
+
+    results = db->exec(schemaVersionSql.arg(dbName), Db::Flag::SKIP_DROP_DETECTION);
+    if (results->isError())
+    {
+        errorText = results->getErrorText();
+        return false;
+    }
+    schemaVersion = results->getSingleCell().toLongLong();
+    return true;
+}
+
+void SqlTableSearchIndex::cleanUp()
+{
+    static_qstring(dropTrigSql, "DROP TRIGGER IF EXISTS temp.%1");
+    static_qstring(dropTableSql, "DROP TABLE IF EXISTS %1.%2");
+
+    if (!db->isOpen())
+        return;
+
+    for (const QString& trigName : getTriggerNames())
+        db->exec(dropTrigSql.arg(trigName), Db::Flag::SKIP_DROP_DETECTION);
+
+    db->exec(dropTableSql.arg(SHADOW_DB, indexTable), Db::Flag::SKIP_DROP_DETECTION);
+}
+
+void SqlTableSearchIndex::buildFinished(bool success)
+{
+    building = false;
+    if (dropRequested)
+    {
+        drop();
+        return;
+    }
+
+    ready = success;
+    if (success)
+        notifyInfo(tr("Search index for table %1 is ready.").arg(table));
+    else
+        notifyError(tr("Could not build search index for table %1: %2").arg(table, errorText));
+
+    if (!success && indexes.value(key(db, database, table)) == this)
+        indexes.remove(key(db, database, table));
+
+    emit stateChanged();
+    if (!success)
+        deleteLater();
+}
+
+void SqlTableSearchIndex::drop()
+{
+    ready = false;
+    if (building)
+    {
+        // Will be dropped once the build is finished
+        dropRequested = true;
+        return;
+    }
+
+    cleanUp();
+    emit stateChanged();
+    deleteLater();
+}
+
+QString SqlTableSearchIndex::getSourceTable() const
+{
+    QString dbName = database.isEmpty() ? "main" : database;
+    return wrapObjIfNeeded(dbName, Dialect::Sqlite3) + "." + wrapObjIfNeeded(table, Dialect::Sqlite3);
+}
+
+QStringList SqlTableSearchIndex::getTriggerNames() const
+{
+    return {indexTable + "_ai", indexTable + "_ad", indexTable + "_au"};
+}
+
+QString SqlTableSearchIndex::key(Db* db, const QString& database, const QString& table)
+{
+    QString dbName = database.isEmpty() ? "main" : database;
+    return QString::number(reinterpret_cast<quintptr>(db), 16) + "\n" + dbName.toLower() + "\n" + table.toLower();
+}
+
+void SqlTableSearchIndex::dropIndexes(Db* db)
+{
+    supportedDbs.remove(db);
+
+    QString prefix = QString::number(reinterpret_cast<quintptr>(db), 16) + "\n";
+    for (const QString& indexKey : indexes.keys())
+    {
+        if (indexKey.startsWith(prefix))
+            indexes.take(indexKey)->drop();
+    }
+}
+
+void SqlTableSearchIndex::initRegistry()
+{
+    static bool initialized = false;
+    if (initialized)
+        return;
+
+    // The shadow database and triggers disappear together with the connection
+    QObject::connect(DBLIST, &DbManager::dbDisconnected, &SqlTableSearchIndex::dropIndexes);
+    QObject::connect(DBLIST, &DbManager::dbAboutToBeUnloaded, &SqlTableSearchIndex::dropIndexes);
+    QObject::connect(DBLIST, static_cast<void (DbManager::*)(Db*)>(&DbManager::dbRemoved), &SqlTableSearchIndex::dropIndexes);
+    initialized = true;
+}
@@ -0,0 +1,115 @@
+#ifndef SQLTABLESEARCHINDEX_H
+#define SQLTABLESEARCHINDEX_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QObject>
+#include <QStringList>
+#include <QHash>
+
+class Db;
+
+/**
+ * @brief Text search accelerator for data filtering of a single table.
+ *
+ * The accelerator is a contentless FTS5 table with the trigram tokenizer, created in a shadow database
+ * (a temporary database attached to the connection, which disappears together with the connection).
+ * It is built on user request and then kept up to date by temporary triggers on the source table.
+ *
+ * Filtering by text uses getCondition(), which gives <tt>rowid IN (...)</tt> condition matched by the index
+ * instead of the <tt>LIKE</tt> evaluated for each column of each row. The index can be used only for values
+ * of at least 3 characters without <tt>LIKE</tt> wildcards. For other values (or when the index is not usable)
+ * the condition is null and the caller should use <tt>LIKE</tt>.
+ *
+ * Triggers see only changes made by this connection. Changes committed by other connections are detected
+ * by <tt>PRAGMA data_version</tt>, and <tt>VACUUM</tt> (which may renumber rowids) or schema changes
+ * by <tt>PRAGMA schema_version</tt>. The index is dropped when any of them is detected.
+ *
+ * Indexes are shared by all views of the same table and dropped when the database gets disconnected.
+ * Tables <tt>WITHOUT ROWID</tt> cannot be indexed. The trigram tokenizer needs SQLite 3.34 or later,
+ * see isSupported().
+ */
+class GUI_API_EXPORT SqlTableSearchIndex : public QObject
+{
+        Q_OBJECT
+
+    public:
+        static SqlTableSearchIndex* getIndex(Db* db, const QString& database, const QString& table);
+        static SqlTableSearchIndex* createIndex(Db* db, const QString& database, const QString& table, const QStringList& columns);
+        static void dropIndex(Db* db, const QString& database, const QString& table);
+
+        /**
+         * @brief Tells if the database connection can have search indexes.
+         * @param db Database to check.
+         * @return true if FTS5 with the trigram tokenizer is available for the connection.
+         *
+         * The result is checked by creating a temporary FTS5 table, once per connection.
+         */
+        static bool isSupported(Db* db);
+
+        bool isBuilding() const;
+
+        /**
+         * @brief Tells if the index can be used for filtering.
+         * @param columns Current columns of the table.
+         * @return true if the index was built for the same columns and is still up to date.
+         *
+         * If the index turns out to be outdated, it's dropped.
+         */
+        bool isUsable(const QStringList& columns);
+
+        /**
+         * @brief Provides condition for filtering by the index.
+         * @param value Text to look for.
+         * @param column Index of the column to look in, or -1 to look in all columns.
+         * @return Condition to put in the WHERE clause, or null string if the index cannot be used for the value.
+         */
+        QString getCondition(const QString& value, int column = -1) const;
+
+    private:
+        SqlTableSearchIndex(Db* db, const QString& database, const QString& table, const QStringList& columns);
+
+        void build();
+        bool buildInThread();
+        bool execBuildStep(const QString& query, const QList<QVariant>& args = QList<QVariant>());
+        bool readVersions(qint64& dataVersion, qint64& schemaVersion);
+        bool isOutdated();
+        void cleanUp();
+        void buildFinished(bool success);
+        void drop();
+        QString getSourceTable() const;
+        QStringList getTriggerNames() const;
+
+        static QString key(Db* db, const QString& database, const QString& table);
+        static void dropIndexes(Db* db);
+        static void initRegistry();
+
+        Db* db = nullptr;
+        QString database;
+        QString table;
+        QStringList columns;
+        QString indexTable;
+        QString errorText;
+        bool building = false;
+        bool ready = false;
+        bool dropRequested = false;
+
+        /**
+         * @brief Source database versions from the beginning of the build.
+         */
+        qint64 dataVersion = -1;
+        qint64 schemaVersion = -1;
+
+        static QHash<QString, SqlTableSearchIndex*> indexes;
+        static QHash<Db*, bool> supportedDbs;
+        static int nextIndexId;
+        static const int CHUNK_ROWS = 10000;
+        static const int MIN_VALUE_LENGTH = 3;
+        static const constexpr char* SHADOW_DB = "sqlitestudio_search";
+        static const constexpr char* PROBE_TABLE = "sqlitestudio_search_probe";
+
+    signals:
+        void buildProgress(int percent);
+        void stateChanged();
+};
+
+#endif // SQLTABLESEARCHINDEX_H
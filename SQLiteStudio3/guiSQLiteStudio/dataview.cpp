@@ -82,6 +82,7 @@ void DataView::initSlots()
     connect(model, SIGNAL(itemEditionEnded(SqlQueryItem*)), this, SLOT(adjustColumnWidth(SqlQueryItem*)));
     connect(gridView, SIGNAL(scrolledBy(int, int)), this, SLOT(syncFilterScrollPosition()));
     connect(gridView->horizontalHeader(), SIGNAL(sectionResized(int, int, int)), this, SLOT(resizeFilter(int, int, int)));
+    connect(model, SIGNAL(searchIndexStateChanged()), this, SLOT(updateSearchIndexAction()));
 }
 
 void DataView::initFormView()
@@ -584,6 +585,24 @@ void DataView::togglePerColumnFiltering()
     recreateFilterInputs();
 }
 
+void DataView::toggleSearchIndex()
+{
+    if (actionMap[FILTER_SEARCH_INDEX]->isChecked())
+        model->buildSearchIndex();
+    else
+        model->dropSearchIndex();
+}
+
+void DataView::updateSearchIndexAction()
+{
+    if (!actionMap.contains(FILTER_SEARCH_INDEX))
+        return;
+
+    // Hidden when the table or the database cannot have the index (i.e. SQLite without the FTS5 trigram tokenizer)
+    actionMap[FILTER_SEARCH_INDEX]->setVisible(model->isSearchIndexSupported());
+    actionMap[FILTER_SEARCH_INDEX]->setChecked(model->hasSearchIndex());
+}
+
 void DataView::updateCommitRollbackActions(bool enabled)
 {
     gridView->getAction(SqlQueryView::COMMIT)->setEnabled(enabled);
@@ -701,6 +720,7 @@ void DataView::dataLoadingEnded(bool successful)
 void DataView::executionSuccessful()
 {
     updateResultsCount(-1);
+    updateSearchIndexAction();
 }
 
 void DataView::totalRowsAndPagesAvailable()
@@ -996,6 +1016,13 @@ void DataView::createFilteringActions()
     createAction(FILTER_PER_COLUMN, tr("Show filter inputs per column", "data view"), this, SLOT(togglePerColumnFiltering()), this);
     actionMap[FILTER_PER_COLUMN]->setCheckable(true);
 
+    if (model->features().testFlag(SqlQueryModel::SEARCH_INDEX))
+    {
+        createAction(FILTER_SEARCH_INDEX, tr("Use search index for text filtering", "data view"), this, SLOT(toggleSearchIndex()), this);
+        actionMap[FILTER_SEARCH_INDEX]->setCheckable(true);
+        actionMap[FILTER_SEARCH_INDEX]->setVisible(false); // until the data is loaded, see updateSearchIndexAction()
+    }
+
     actionMap[FILTER_VALUE] = gridToolBar->addWidget(filterEdit);
     createAction(FILTER, tr("Apply filter", "data view"), this, SLOT(applyFilter()), gridToolBar);
     attachActionInMenu(FILTER, actionMap[FILTER_STRING], gridToolBar);
@@ -1003,6 +1030,9 @@ void DataView::createFilteringActions()
     attachActionInMenu(FILTER, actionMap[FILTER_SQL], gridToolBar);
     addSeparatorInMenu(FILTER, gridToolBar);
     attachActionInMenu(FILTER, actionMap[FILTER_PER_COLUMN], gridToolBar);
+    if (actionMap.contains(FILTER_SEARCH_INDEX))
+        attachActionInMenu(FILTER, actionMap[FILTER_SEARCH_INDEX], gridToolBar);
+
     gridToolBar->addSeparator();
 
     actionMap[FILTER]->setIcon(actionMap[FILTER_STRING]->icon());
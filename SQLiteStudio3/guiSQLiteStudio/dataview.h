@@ -49,6 +49,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
             FILTER_SQL,
             FILTER_REGEXP,
             FILTER_PER_COLUMN,
+            FILTER_SEARCH_INDEX,
             GRID_TOTAL_ROWS,
             SELECTIVE_COMMIT,
             SELECTIVE_ROLLBACK,
@@ -220,6 +221,8 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void syncFilterScrollPosition();
         void resizeFilter(int section, int oldSize, int newSize);
         void togglePerColumnFiltering();
+        void toggleSearchIndex();
+        void updateSearchIndexAction();
 };
 
 int qHash(DataView::ActionGroup action);
@@ -30,6 +30,7 @@
 #include "querygenerator.h"
 #include "dialogs/execfromfiledialog.h"
 #include "dialogs/fileexecerrorsdialog.h"
+#include "db/storageanalyzer.h"
 #include <QApplication>
 #include <QClipboard>
 #include <QAction>
@@ -45,6 +46,7 @@
 #include <QDir>
 #include <QFileDialog>
 #include <QtConcurrent/QtConcurrentRun>
+#include <QFutureWatcher>
 
 CFG_KEYS_DEFINE(DbTree)
 QHash<DbTreeItem::Type,QList<DbTreeItem::Type>> DbTree::allowedTypesInside;
@@ -147,6 +149,7 @@ void DbTree::createActions()
     createAction(CONVERT_DB, ICONS.CONVERT_DB, tr("Con&vert database type"), this, SLOT(convertDb()), this);
     createAction(VACUUM_DB, ICONS.VACUUM_DB, tr("Vac&uum"), this, SLOT(vacuumDb()), this);
     createAction(INTEGRITY_CHECK, ICONS.INTEGRITY_CHECK, tr("&Integrity check"), this, SLOT(integrityCheck()), this);
+    createAction(ANALYZE_STORAGE, ICONS.INFO_BALLOON, tr("Analyze &storage"), this, SLOT(analyzeStorage()), this);
     createAction(ADD_TABLE, ICONS.TABLE_ADD, tr("Create a &table"), this, SLOT(addTable()), this);
     createAction(EDIT_TABLE, ICONS.TABLE_EDIT, tr("Edit the t&able"), this, SLOT(editTable()), this);
     createAction(DEL_TABLE, ICONS.TABLE_DEL, tr("Delete the ta&ble"), this, SLOT(delTable()), this);
@@ -208,7 +211,7 @@ void DbTree::updateActionStates(const QStandardItem *item)
             if (dbTreeItem->getDb()->isOpen())
             {
                 enabled << DISCONNECT_FROM_DB << ADD_TABLE << ADD_VIEW << IMPORT_INTO_DB << EXPORT_DB << REFRESH_SCHEMA << CONVERT_DB
-                        << VACUUM_DB << INTEGRITY_CHECK;
+                        << VACUUM_DB << INTEGRITY_CHECK << ANALYZE_STORAGE;
                 isDbOpen = true;
             }
             else
@@ -416,6 +419,7 @@ void DbTree::setupActionsForMenu(DbTreeItem* currItem, QMenu* contextMenu)
                     actions += ActionEntry(CONVERT_DB);
                     actions += ActionEntry(VACUUM_DB);
                     actions += ActionEntry(INTEGRITY_CHECK);
+                    actions += ActionEntry(ANALYZE_STORAGE);
                     actions += ActionEntry(EXEC_SQL_FROM_FILE);
                     actions += ActionEntry(OPEN_DB_DIRECTORY);
                     actions += ActionEntry(_separator);
@@ -1502,6 +1506,44 @@ void DbTree::integrityCheck()
     win->execute();
 }
 
+void DbTree::analyzeStorage()
+{
+    Db* db = getSelectedDb();
+    if (!db || !db->isValid() || !db->isOpen())
+        return;
+
+    QString dbName = db->getName();
+    auto showReport = [dbName](const StorageAnalyzer::Report& report)
+    {
+        if (!report.isValid())
+        {
+            notifyError(tr("Could not analyze storage of database %1: %2").arg(dbName, report.errorMessage));
+            return;
+        }
+
+        qint64 usedPages = report.pageCount - report.freePages;
+        notifyInfo(tr("Database %1 uses %2 in %3 tables and indexes. VACUUM could reclaim up to %4. "
+                      "Sizes of tables are shown in tooltips of the database tree.")
+                   .arg(dbName, formatFileSize(usedPages * report.pageSize), QString::number(report.objects.size()),
+                        formatFileSize(report.getEstimatedVacuumGain())));
+    };
+
+    StorageAnalyzer::Report report;
+    if (STORAGE_ANALYZER->getCached(db, report))
+    {
+        showReport(report);
+        return;
+    }
+
+    QFutureWatcher<StorageAnalyzer::Report>* watcher = new QFutureWatcher<StorageAnalyzer::Report>(this);
+    connect(watcher, &QFutureWatcherBase::finished, [watcher, showReport]()
+    {
+        showReport(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(STORAGE_ANALYZER->analyzeAsync(db));
+}
+
 void DbTree::createSimilarTable()
 {
     Db* db = getSelectedDb();
@@ -63,6 +63,7 @@ class GUI_API_EXPORT DbTree : public QDockWidget, public ExtActionContainer
             CONVERT_DB,
             VACUUM_DB,
             INTEGRITY_CHECK,
+            ANALYZE_STORAGE,
             ADD_TABLE,
             EDIT_TABLE,
             DEL_TABLE,
@@ -213,6 +214,7 @@ class GUI_API_EXPORT DbTree : public QDockWidget, public ExtActionContainer
         void convertDb();
         void vacuumDb();
         void integrityCheck();
+        void analyzeStorage();
         void createSimilarTable();
         void resetAutoincrement();
         void eraseTableData();
@@ -0,0 +1,148 @@
+#include "dbtreefilterindex.h"
+#include <QStandardItem>
+#include <QSet>
+
+QList<DbTreeFilterIndex::Job> DbTreeFilterIndex::prepareJobs(const QList<QStandardItem*>& dbItems, const QString& filter)
+{
+    // Forget databases that are not in the tree anymore
+    QSet<QStandardItem*> present = dbItems.toSet();
+    for (QStandardItem* dbItem : indexes.keys())
+    {
+        if (!present.contains(dbItem))
+            indexes.remove(dbItem);
+    }
+
+    QString lowerFilter = filter.toLower();
+    QList<Job> jobs;
+    for (QStandardItem* dbItem : dbItems)
+    {
+        DbIndex& index = indexes[dbItem];
+        if (index.entries.isEmpty())
+        {
+            index.entries = buildEntries(dbItem);
+            index.hasMatch = false;
+        }
+
+        Job job;
+        job.dbItem = dbItem;
+        job.entries = index.entries;
+        if (index.hasMatch && !index.filter.isEmpty() && lowerFilter.contains(index.filter))
+        {
+            job.hasPrevious = true;
+            job.previous = index.match;
+        }
+        jobs << job;
+    }
+    return jobs;
+}
+
+bool DbTreeFilterIndex::isCurrent(const DbTreeFilterIndex::Job& job) const
+{
+    auto it = indexes.constFind(job.dbItem);
+    return it != indexes.constEnd() && it->entries.constData() == job.entries.constData();
+}
+
+const DbTreeFilterIndex::Match* DbTreeFilterIndex::getStoredMatch(QStandardItem* dbItem) const
+{
+    auto it = indexes.constFind(dbItem);
+    if (it == indexes.constEnd() || !it->hasMatch)
+        return nullptr;
+
+    return &(it->match);
+}
+
+void DbTreeFilterIndex::store(const QList<DbTreeFilterIndex::Job>& jobs, const QString& filter)
+{
+    QString lowerFilter = filter.toLower();
+    for (const Job& job : jobs)
+    {
+        if (!isCurrent(job))
+            continue;
+
+        DbIndex& index = indexes[job.dbItem];
+
+        index.filter = lowerFilter;
+        index.match = job.result;
+        index.hasMatch = true;
+    }
+}
+
+void DbTreeFilterIndex::invalidate(QStandardItem* dbItem)
+{
+    indexes.remove(dbItem);
+}
+
+void DbTreeFilterIndex::invalidateAll()
+{
+    indexes.clear();
+}
+
+void DbTreeFilterIndex::evaluate(DbTreeFilterIndex::Job& job, const QString& filter)
+{
+    int count = job.entries.size();
+    QString lowerFilter = filter.toLower();
+    if (lowerFilter.isEmpty())
+    {
+        job.result.selfMatched.fill(true, count);
+        job.result.visible.fill(true, count);
+        return;
+    }
+
+    job.result.selfMatched.fill(false, count);
+    job.result.visible.fill(false, count);
+
+    const Entry* entries = job.entries.constData();
+    bool* selfMatched = job.result.selfMatched.data();
+    if (job.hasPrevious && job.previous.selfMatched.size() == count)
+    {
+        // Filter got longer, so only names matched previously can match now.
+        const bool* previouslyMatched = job.previous.selfMatched.constData();
+        for (int i = 0; i < count; i++)
+        {
+            if (previouslyMatched[i])
+                selfMatched[i] = entries[i].name.contains(lowerFilter);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+            selfMatched[i] = entries[i].name.contains(lowerFilter);
+    }
+
+    // Parents always precede their children, so going backwards propagates visibility up to the root.
+    bool* visible = job.result.visible.data();
+    for (int i = count - 1; i >= 0; i--)
+    {
+        if (selfMatched[i])
+            visible[i] = true;
+
+        if (visible[i] && entries[i].parent >= 0)
+            visible[entries[i].parent] = true;
+    }
+}
+
+QVector<DbTreeFilterIndex::Entry> DbTreeFilterIndex::buildEntries(QStandardItem* dbItem)
+{
+    QVector<Entry> entries;
+    Entry entry;
+    entry.item = dbItem;
+    entry.name = dbItem->text().toLower();
+    entries << entry;
+    addEntries(dbItem, 0, entries);
+    return entries;
+}
+
+void DbTreeFilterIndex::addEntries(QStandardItem* parentItem, int parentEntry, QVector<Entry>& entries)
+{
+    Entry entry;
+    QStandardItem* child = nullptr;
+    for (int i = 0, total = parentItem->rowCount(); i < total; i++)
+    {
+        child = parentItem->child(i);
+        entry.item = child;
+        entry.name = child->text().toLower();
+        entry.parent = parentEntry;
+        entries << entry;
+        addEntries(child, entries.size() - 1, entries);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef DBTREEFILTERINDEX_H
+#define DBTREEFILTERINDEX_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QHash>
+#include <QVector>
+#include <QString>
+
+class QStandardItem;
+
+/**
+ * @brief Index of item names in the database tree, used by the tree filter.
+ *
+ * There is separate index for every database item. It keeps lowercase names of all items under the database
+ * in a flat list (in the tree order), so the filter doesn't have to walk through tree items. The index is built
+ * when needed and dropped (by invalidate()) whenever items of the database change.
+ *
+ * Evaluation of the filter is done by evaluate(), which touches only the index data, so it can be called
+ * from any thread. If the new filter contains the previous one (the usual case when typing),
+ * only items matched by the previous filter are checked again.
+ */
+class GUI_API_EXPORT DbTreeFilterIndex
+{
+    public:
+        struct Entry
+        {
+            QStandardItem* item = nullptr;  /**< Never dereferenced by evaluate(). */
+            QString name;                   /**< Lowercase item name. */
+            int parent = -1;                /**< Index of the parent entry, always lower than the entry's own index. */
+        };
+
+        struct Match
+        {
+            QVector<bool> selfMatched;      /**< Item's own name contains the filter. */
+            QVector<bool> visible;          /**< Item or any of its descendants is matched. */
+        };
+
+        struct Job
+        {
+            QStandardItem* dbItem = nullptr;
+            QVector<Entry> entries;
+            Match previous;
+            bool hasPrevious = false;
+            Match result;
+        };
+
+        /**
+         * @brief Prepares evaluation of the filter for given databases.
+         * @param dbItems Database items currently present in the tree.
+         * @param filter Filter to evaluate.
+         * @return Jobs to pass to evaluate().
+         *
+         * Has to be called from the GUI thread, as it builds missing indexes from the tree items.
+         */
+        QList<Job> prepareJobs(const QList<QStandardItem*>& dbItems, const QString& filter);
+
+        /**
+         * @brief Stores results of evaluated jobs, so next filter can narrow them.
+         * @param jobs Evaluated jobs.
+         * @param filter Filter that was evaluated.
+         */
+        void store(const QList<Job>& jobs, const QString& filter);
+
+        /**
+         * @brief Tells if the job was prepared from the current index of its database.
+         * @param job Job to check.
+         * @return true if the index wasn't invalidated in the meantime, so item pointers of the job are still valid.
+         */
+        bool isCurrent(const Job& job) const;
+
+        /**
+         * @brief Provides the last stored match for the database.
+         * @param dbItem Database item.
+         * @return Match stored by store(), or null if there is none.
+         */
+        const Match* getStoredMatch(QStandardItem* dbItem) const;
+
+        void invalidate(QStandardItem* dbItem);
+        void invalidateAll();
+
+        static void evaluate(Job& job, const QString& filter);
+
+    private:
+        struct DbIndex
+        {
+            QVector<Entry> entries;
+            QString filter;
+            Match match;
+            bool hasMatch = false;
+        };
+
+        static QVector<Entry> buildEntries(QStandardItem* dbItem);
+        static void addEntries(QStandardItem* parentItem, int parentEntry, QVector<Entry>& entries);
+
+        QHash<QStandardItem*, DbIndex> indexes;
+};
+
+#endif // DBTREEFILTERINDEX_H
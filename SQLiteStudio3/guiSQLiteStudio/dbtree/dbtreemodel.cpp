@@ -23,6 +23,8 @@
 #include <QCheckBox>
 #include <QWidgetAction>
 #include <QClipboard>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 const QString DbTreeModel::toolTipTableTmp = "<table>%1</table>";
 const QString DbTreeModel::toolTipHdrRowTmp = "<tr><th><img src=\"%1\"/></th><th colspan=2>%2</th></tr>";
@@ -42,6 +44,12 @@ DbTreeModel::DbTreeModel()
     dbOrganizer->setAutoDelete(false);
     connect(dbOrganizer, SIGNAL(finishedDbObjectsCopy(bool,Db*,Db*)), this, SLOT(dbObjectsCopyFinished(bool,Db*,Db*)));
     connect(dbOrganizer, SIGNAL(finishedDbObjectsMove(bool,Db*,Db*)), this, SLOT(dbObjectsMoveFinished(bool,Db*,Db*)));
+
+    // Filter index has to follow any change of items
+    connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(invalidateFilterIndex(QModelIndex)));
+    connect(this, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(invalidateFilterIndex(QModelIndex,int,int)));
+    connect(this, SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(invalidateFilterIndex(QModelIndex)));
+    connect(this, &QStandardItemModel::modelReset, [this]() {filterIndex.invalidateAll();});
 }
 
 DbTreeModel::~DbTreeModel()
@@ -128,8 +136,149 @@ QStringList DbTreeModel::getGroupFor(QStandardItem *item)
 
 void DbTreeModel::applyFilter(const QString &filter)
 {
-    applyFilter(root(), filter);
     currentFilter = filter;
+
+    QList<QStandardItem*> dbItems;
+    collectDbItems(root(), dbItems);
+    QList<DbTreeFilterIndex::Job> jobs = filterIndex.prepareJobs(dbItems, filter);
+
+    // Results of the previous call (if it's still running) are ignored, thanks to the generation.
+    int generation = ++filterGeneration;
+    QFutureWatcher<QList<DbTreeFilterIndex::Job>>* watcher = new QFutureWatcher<QList<DbTreeFilterIndex::Job>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, [this, watcher, generation, filter]()
+    {
+        if (generation == filterGeneration)
+        {
+            QList<DbTreeFilterIndex::Job> results = watcher->result();
+            applyFilterResults(results);
+            filterIndex.store(results, filter);
+        }
+
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&DbTreeModel::evaluateFilter, jobs, filter));
+}
+
+QList<DbTreeFilterIndex::Job> DbTreeModel::evaluateFilter(QList<DbTreeFilterIndex::Job> jobs, const QString& filter)
+{
+    for (DbTreeFilterIndex::Job& job : jobs)
+        DbTreeFilterIndex::evaluate(job, filter);
+
+    return jobs;
+}
+
+void DbTreeModel::applyFilterResults(const QList<DbTreeFilterIndex::Job>& jobs)
+{
+    QHash<QStandardItem*, bool> dbVisibility;
+    QModelIndex index;
+    for (const DbTreeFilterIndex::Job& job : jobs)
+    {
+        // Items of the database could be changed (or deleted) while the filter was evaluated.
+        if (!filterIndex.isCurrent(job))
+            continue;
+
+        const DbTreeFilterIndex::Match* applied = filterIndex.getStoredMatch(job.dbItem);
+        dbVisibility[job.dbItem] = job.result.visible[0];
+
+        // The database item itself (entry 0) is handled together with groups
+        for (int i = 1, total = job.entries.size(); i < total; i++)
+        {
+            if (applied && applied->visible[i] == job.result.visible[i])
+                continue;
+
+            index = job.entries[i].item->index();
+            treeView->setRowHidden(index.row(), index.parent(), !job.result.visible[i]);
+        }
+    }
+
+    applyFilterToGroups(root(), dbVisibility);
+}
+
+bool DbTreeModel::applyFilterToGroups(QStandardItem* parentItem, const QHash<QStandardItem*, bool>& dbVisibility)
+{
+    bool visibilityForParent = false;
+    DbTreeItem* item = nullptr;
+    QModelIndex index;
+    bool matched;
+    for (int i = 0; i < parentItem->rowCount(); i++)
+    {
+        item = dynamic_cast<DbTreeItem*>(parentItem->child(i));
+        if (item->getType() == DbTreeItem::Type::DB)
+        {
+            if (!dbVisibility.contains(item))
+                continue;
+
+            matched = dbVisibility[item];
+        }
+        else
+        {
+            matched = applyFilterToGroups(item, dbVisibility) || currentFilter.isEmpty() ||
+                    item->text().contains(currentFilter, Qt::CaseInsensitive);
+        }
+
+        index = item->index();
+        treeView->setRowHidden(index.row(), index.parent(), !matched);
+        if (matched)
+            visibilityForParent = true;
+    }
+    return visibilityForParent;
+}
+
+void DbTreeModel::collectDbItems(QStandardItem* parentItem, QList<QStandardItem*>& dbItems) const
+{
+    DbTreeItem* item = nullptr;
+    for (int i = 0; i < parentItem->rowCount(); i++)
+    {
+        item = dynamic_cast<DbTreeItem*>(parentItem->child(i));
+        if (item->getType() == DbTreeItem::Type::DB)
+            dbItems << item;
+        else if (item->getType() == DbTreeItem::Type::DIR)
+            collectDbItems(item, dbItems);
+    }
+}
+
+QStandardItem* DbTreeModel::findDbItemFor(QStandardItem* item) const
+{
+    DbTreeItem* dbTreeItem = nullptr;
+    for (; item; item = item->parent())
+    {
+        dbTreeItem = dynamic_cast<DbTreeItem*>(item);
+        if (dbTreeItem && dbTreeItem->getType() == DbTreeItem::Type::DB)
+            return item;
+    }
+    return nullptr;
+}
+
+void DbTreeModel::invalidateFilterIndex(const QModelIndex& parent)
+{
+    QStandardItem* dbItem = findDbItemFor(itemFromIndex(parent));
+    if (dbItem)
+        filterIndex.invalidate(dbItem);
+}
+
+void DbTreeModel::invalidateFilterIndex(const QModelIndex& parent, int first, int last)
+{
+    QStandardItem* dbItem = findDbItemFor(itemFromIndex(parent));
+    if (dbItem)
+    {
+        filterIndex.invalidate(dbItem);
+        return;
+    }
+
+    // Databases or groups are being removed
+    QStandardItem* parentItem = parent.isValid() ? itemFromIndex(parent) : root();
+    for (int i = first; i <= last; i++)
+    {
+        DbTreeItem* item = dynamic_cast<DbTreeItem*>(parentItem->child(i));
+        if (item && item->getType() == DbTreeItem::Type::DB)
+        {
+            filterIndex.invalidate(item);
+            continue;
+        }
+
+        filterIndex.invalidateAll();
+        return;
+    }
 }
 
 bool DbTreeModel::applyFilter(QStandardItem *parentItem, const QString &filter)
@@ -432,6 +581,15 @@ QString DbTreeModel::getDbToolTip(DbTreeItem* item) const
 
         if (db->isOpen())
             rows << toolTipRowTmp.arg(tr("Encoding:", "dbtree tooltip")).arg(db->getEncoding());
+
+        StorageAnalyzer::Report report;
+        if (db->isOpen() && STORAGE_ANALYZER->getCached(db, report))
+        {
+            rows << toolTipRowTmp.arg(tr("Free pages:", "dbtree tooltip"))
+                                 .arg(QString("%1 (%2)").arg(report.freePages).arg(formatFileSize(report.freePages * report.pageSize)));
+            rows << toolTipRowTmp.arg(tr("Reclaimable by VACUUM:", "dbtree tooltip"))
+                                 .arg(formatFileSize(report.getEstimatedVacuumGain()));
+        }
     }
     else
     {
@@ -478,9 +636,35 @@ QString DbTreeModel::getTableToolTip(DbTreeItem* item) const
                              .arg(tr("Triggers (%1):", "dbtree tooltip").arg(triggersCount))
                              .arg(triggers.join(", "));
 
+    StorageAnalyzer::Report report;
+    if (item->getDb()->isOpen() && STORAGE_ANALYZER->getCached(item->getDb(), report))
+        rows += getStorageToolTipRows(report, item->text());
+
     return toolTipTableTmp.arg(rows.join(""));
 }
 
+QStringList DbTreeModel::getStorageToolTipRows(const StorageAnalyzer::Report& report, const QString& table) const
+{
+    QStringList rows;
+    const StorageAnalyzer::ObjectStats* stats = report.getObject(table);
+    if (!stats)
+        return rows;
+
+    qint64 indexesSize = 0;
+    for (const StorageAnalyzer::ObjectStats& indexStats : report.objects)
+    {
+        if (indexStats.type == "index" && indexStats.table.compare(table, Qt::CaseInsensitive) == 0)
+            indexesSize += indexStats.getSize(report.pageSize);
+    }
+
+    rows << toolTipRowTmp.arg(tr("Size on disk:", "dbtree tooltip")).arg(formatFileSize(stats->getSize(report.pageSize)));
+    rows << toolTipRowTmp.arg(tr("Indexes size:", "dbtree tooltip")).arg(formatFileSize(indexesSize));
+    rows << toolTipRowTmp.arg(tr("Unused space:", "dbtree tooltip")).arg(formatFileSize(stats->unused));
+    rows << toolTipRowTmp.arg(tr("Overflow pages:", "dbtree tooltip")).arg(stats->overflowPages);
+    rows << toolTipRowTmp.arg(tr("Fragmentation:", "dbtree tooltip")).arg(QString::number(stats->fragmentation * 100, 'f', 1) + "%");
+    return rows;
+}
+
 void DbTreeModel::refreshSchema(Db* db, QStandardItem *item)
 {
     if (!db->isOpen())
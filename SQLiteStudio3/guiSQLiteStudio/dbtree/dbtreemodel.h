@@ -2,7 +2,9 @@
 #define DBTREEMODEL_H
 
 #include "db/db.h"
+#include "db/storageanalyzer.h"
 #include "dbtreeitem.h"
+#include "dbtreefilterindex.h"
 #include "services/config.h"
 #include "guiSQLiteStudio_global.h"
 #include "common/strhash.h"
@@ -65,6 +67,10 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QList<Config::DbGroupPtr> childsToConfig(QStandardItem* item);
         void restoreGroup(const Config::DbGroupPtr& group, QList<Db*>* dbList = nullptr, QStandardItem *parent = nullptr);
         bool applyFilter(QStandardItem* parentItem, const QString& filter);
+        void applyFilterResults(const QList<DbTreeFilterIndex::Job>& jobs);
+        bool applyFilterToGroups(QStandardItem* parentItem, const QHash<QStandardItem*, bool>& dbVisibility);
+        void collectDbItems(QStandardItem* parentItem, QList<QStandardItem*>& dbItems) const;
+        QStandardItem* findDbItemFor(QStandardItem* item) const;
         void refreshSchema(Db* db, QStandardItem* item);
         void collectExpandedState(QHash<QString, bool>& state, QStandardItem* parentItem = nullptr);
         QStandardItem* refreshSchemaDb(Db* db);
@@ -80,6 +86,7 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QString getToolTip(DbTreeItem *item) const;
         QString getDbToolTip(DbTreeItem *item) const;
         QString getTableToolTip(DbTreeItem *item) const;
+        QStringList getStorageToolTipRows(const StorageAnalyzer::Report& report, const QString& table) const;
         QList<DbTreeItem*> getChildsAsFlatList(QStandardItem* item) const;
         bool dropDbTreeItem(const QList<DbTreeItem*>& srcItems, DbTreeItem* dstItem, Qt::DropAction defaultAction, bool* invokeStdDropAction);
         bool dropDbObjectItem(const QList<DbTreeItem*>& srcItems, DbTreeItem* dstItem, Qt::DropAction defaultAction);
@@ -88,6 +95,7 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         bool quickAddDroppedDb(const QString& filePath);
         void moveOrCopyDbObjects(const QList<DbTreeItem*>& srcItems, DbTreeItem* dstItem, bool move, bool includeData, bool includeIndexes, bool includeTriggers);
 
+        static QList<DbTreeFilterIndex::Job> evaluateFilter(QList<DbTreeFilterIndex::Job> jobs, const QString& filter);
         static bool confirmReferencedTables(const QStringList& tables);
         static bool resolveNameConflict(QString& nameInConflict);
         static bool confirmConversion(const QList<QPair<QString, QString>>& diffs);
@@ -104,6 +112,8 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QList<Interruptable*> interruptables;
         bool ignoreDbLoadedSignal = false;
         QString currentFilter;
+        DbTreeFilterIndex filterIndex;
+        int filterGeneration = 0;
 
     private slots:
         void expanded(const QModelIndex &index);
@@ -120,6 +130,8 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         void markSchemaReloadingRequired();
         void dbObjectsMoveFinished(bool success, Db* srcDb, Db* dstDb);
         void dbObjectsCopyFinished(bool success, Db* srcDb, Db* dstDb);
+        void invalidateFilterIndex(const QModelIndex& parent);
+        void invalidateFilterIndex(const QModelIndex& parent, int first, int last);
 
     public slots:
         void loadDbList();
@@ -4,7 +4,6 @@
 #include "parser/ast/sqlitecreatetable.h"
 #include "guiSQLiteStudio_global.h"
 #include <QAbstractTableModel>
-#include <QPointer>
 
 class GUI_API_EXPORT ColumnDialogConstraintsModel : public QAbstractTableModel
 {
@@ -49,7 +48,7 @@ class GUI_API_EXPORT ColumnDialogConstraintsModel : public QAbstractTableModel
         QString getFkDetails(SqliteCreateTable::Column::Constraint* constr) const;
         QString getConstrDetails(SqliteCreateTable::Column::Constraint* constr, int tokenOffset) const;
 
-        QPointer<SqliteCreateTable::Column> column;
+        SqliteStatementGuard<SqliteCreateTable::Column> column;
 
     signals:
         void constraintsChanged();
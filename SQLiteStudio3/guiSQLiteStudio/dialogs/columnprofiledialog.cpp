@@ -0,0 +1,135 @@
+#include "columnprofiledialog.h"
+#include "ui_columnprofiledialog.h"
+#include "db/db.h"
+#include <QFutureWatcher>
+#include <QTreeWidgetItem>
+#include <QLocale>
+
+ColumnProfileDialog::ColumnProfileDialog(Db* db, const QString& database, const QString& table, const QStringList& columns, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::ColumnProfileDialog),
+    db(db),
+    database(database),
+    table(table),
+    columns(columns)
+{
+    init();
+}
+
+ColumnProfileDialog::~ColumnProfileDialog()
+{
+    delete ui;
+}
+
+void ColumnProfileDialog::setCurrentColumn(const QString& column)
+{
+    currentColumn = column;
+}
+
+void ColumnProfileDialog::start()
+{
+    ui->summaryLabel->setText(tr("Computing statistics of table %1...").arg(table));
+
+    QFutureWatcher<ColumnProfiler::Report>* watcher = new QFutureWatcher<ColumnProfiler::Report>(this);
+    connect(watcher, &QFutureWatcherBase::finished, [this, watcher]()
+    {
+        showReport(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(ColumnProfiler::profileAsync(db, database, table, columns));
+}
+
+void ColumnProfileDialog::init()
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle(tr("Column statistics: %1").arg(table));
+}
+
+void ColumnProfileDialog::showReport(const ColumnProfiler::Report& report)
+{
+    if (!report.isValid())
+    {
+        ui->summaryLabel->setText(tr("Could not compute statistics of table %1: %2").arg(table, report.errorMessage));
+        return;
+    }
+
+    QLocale locale;
+    if (report.sampled)
+    {
+        ui->summaryLabel->setText(tr("Table %1 has %2 rows. Statistics are computed from a random sample of %3 rows.")
+                                  .arg(table, locale.toString(report.totalRows), locale.toString(report.scannedRows)));
+    }
+    else
+    {
+        ui->summaryLabel->setText(tr("Table %1 has %2 rows.").arg(table, locale.toString(report.totalRows)));
+    }
+
+    QTreeWidgetItem* columnItem = nullptr;
+    QTreeWidgetItem* groupItem = nullptr;
+    QStringList types;
+    for (const ColumnProfiler::ColumnProfile& profile : report.columns)
+    {
+        columnItem = new QTreeWidgetItem(ui->profileTree, {profile.column});
+        addStat(columnItem, tr("Null values"), locale.toString(profile.nulls));
+        addStat(columnItem, tr("Distinct values (estimated)"), locale.toString(profile.distinct));
+        addStat(columnItem, tr("Minimum"), formatValue(profile.min));
+        addStat(columnItem, tr("Maximum"), formatValue(profile.max));
+
+        types = profile.types.keys();
+        types.sort();
+        groupItem = addStat(columnItem, tr("Types"), QString());
+        for (const QString& type : types)
+            addStat(groupItem, type, locale.toString(profile.types[type]));
+
+        if (profile.lengthValues > 0)
+        {
+            groupItem = addStat(columnItem, tr("Length of text and blob values"), QString());
+            addStat(groupItem, tr("Minimum"), locale.toString(profile.minLength));
+            addStat(groupItem, tr("Maximum"), locale.toString(profile.maxLength));
+            addStat(groupItem, tr("Average"), locale.toString(profile.avgLength, 'f', 1));
+        }
+
+        groupItem = addStat(columnItem, tr("Most frequent values"), QString());
+        for (const ColumnProfiler::ValueCount& valueCount : profile.topValues)
+        {
+            QString count = locale.toString(valueCount.count);
+            if (valueCount.error > 0)
+                count = tr("%1 (at least %2)").arg(count, locale.toString(valueCount.count - valueCount.error));
+
+            addStat(groupItem, formatValue(valueCount.value), count);
+        }
+
+        if (profile.column == currentColumn || report.columns.size() == 1)
+        {
+            columnItem->setExpanded(true);
+            ui->profileTree->setCurrentItem(columnItem);
+        }
+    }
+    ui->profileTree->resizeColumnToContents(0);
+}
+
+QTreeWidgetItem* ColumnProfileDialog::addStat(QTreeWidgetItem* parent, const QString& label, const QString& value)
+{
+    return new QTreeWidgetItem(parent, {label, value});
+}
+
+QString ColumnProfileDialog::formatValue(const QVariant& value)
+{
+    static const int maxLength = 100;
+
+    if (value.isNull())
+        return "NULL";
+
+    if (value.type() == QVariant::ByteArray)
+    {
+        QByteArray bytes = value.toByteArray();
+        return "X'" + QString::fromLatin1(bytes.left(maxLength / 2).toHex()).toUpper() + (bytes.size() > maxLength / 2 ? "...'" : "'");
+    }
+
+    QString text = value.toString();
+    if (text.length() > maxLength)
+        text = text.left(maxLength) + "...";
+
+    return text;
+}
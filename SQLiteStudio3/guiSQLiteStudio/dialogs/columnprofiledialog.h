@@ -0,0 +1,43 @@
+#ifndef COLUMNPROFILEDIALOG_H
+#define COLUMNPROFILEDIALOG_H
+
+#include "db/columnprofiler.h"
+#include "guiSQLiteStudio_global.h"
+#include <QDialog>
+
+namespace Ui {
+    class ColumnProfileDialog;
+}
+
+class Db;
+class QTreeWidgetItem;
+
+/**
+ * @brief Shows statistics of column values, computed by ColumnProfiler in background.
+ */
+class GUI_API_EXPORT ColumnProfileDialog : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        ColumnProfileDialog(Db* db, const QString& database, const QString& table, const QStringList& columns, QWidget *parent = 0);
+        ~ColumnProfileDialog();
+
+        void setCurrentColumn(const QString& column);
+        void start();
+
+    private:
+        void init();
+        void showReport(const ColumnProfiler::Report& report);
+        QTreeWidgetItem* addStat(QTreeWidgetItem* parent, const QString& label, const QString& value);
+        static QString formatValue(const QVariant& value);
+
+        Ui::ColumnProfileDialog *ui = nullptr;
+        Db* db = nullptr;
+        QString database;
+        QString table;
+        QStringList columns;
+        QString currentColumn;
+};
+
+#endif // COLUMNPROFILEDIALOG_H
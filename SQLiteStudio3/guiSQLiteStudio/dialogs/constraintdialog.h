@@ -5,7 +5,6 @@
 #include "db/db.h"
 #include "guiSQLiteStudio_global.h"
 #include <QDialog>
-#include <QPointer>
 
 namespace Ui {
     class ConstraintDialog;
@@ -66,8 +65,8 @@ class GUI_API_EXPORT ConstraintDialog : public QDialog
         Mode mode;
         Db* db = nullptr;
         SqliteStatement* constrStatement = nullptr;
-        QPointer<SqliteCreateTable> createTable;
-        QPointer<SqliteCreateTable::Column> columnStmt;
+        SqliteStatementGuard<SqliteCreateTable> createTable;
+        SqliteStatementGuard<SqliteCreateTable::Column> columnStmt;
         QHash<int,QWidget> panels;
         ConstraintPanel* currentPanel = nullptr;
 
@@ -39,6 +39,12 @@ void DdlPreviewDialog::setDdl(const QStringList& ddlList)
     setDdl(fixedList.join("\n"));
 }
 
+void DdlPreviewDialog::setInfo(const QString& info)
+{
+    ui->infoLabel->setText(info);
+    ui->infoLabel->setVisible(!info.isEmpty());
+}
+
 void DdlPreviewDialog::changeEvent(QEvent *e)
 {
     QDialog::changeEvent(e);
@@ -20,6 +20,7 @@ class GUI_API_EXPORT DdlPreviewDialog : public QDialog
 
         void setDdl(const QString& ddl);
         void setDdl(const QStringList& ddlList);
+        void setInfo(const QString& info);
 
     protected:
         void changeEvent(QEvent *e);
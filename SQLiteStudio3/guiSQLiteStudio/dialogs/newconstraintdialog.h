@@ -7,7 +7,6 @@
 #include "iconmanager.h"
 #include "guiSQLiteStudio_global.h"
 #include <QDialog>
-#include <QPointer>
 
 namespace Ui {
     class NewConstraintDialog;
@@ -46,8 +45,8 @@ class GUI_API_EXPORT NewConstraintDialog : public QDialog
         Db* db = nullptr;
         ConstraintDialog::Constraint predefinedConstraintType = ConstraintDialog::UNKNOWN;
         SqliteStatement* constrStatement = nullptr;
-        QPointer<SqliteCreateTable> createTable;
-        QPointer<SqliteCreateTable::Column> columnStmt;
+        SqliteStatementGuard<SqliteCreateTable> createTable;
+        SqliteStatementGuard<SqliteCreateTable::Column> columnStmt;
         ConstraintDialog* constraintDialog = nullptr;
         QHash<ConstraintDialog::Constraint, QCommandLinkButton*> modeToButton;
 
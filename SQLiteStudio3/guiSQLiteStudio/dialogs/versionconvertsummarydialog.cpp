@@ -1,5 +1,6 @@
 #include "versionconvertsummarydialog.h"
 #include "ui_versionconvertsummarydialog.h"
+#include "diff/linediff.h"
 
 VersionConvertSummaryDialog::VersionConvertSummaryDialog(QWidget *parent) :
     QDialog(parent),
@@ -10,6 +11,7 @@ VersionConvertSummaryDialog::VersionConvertSummaryDialog(QWidget *parent) :
     ui->diffTable->setLeftLabel(tr("Before"));
     ui->diffTable->setRightLabel(tr("After"));
     ui->diffTable->horizontalHeader()->setVisible(true);
+    connect(ui->tokenDiffCheck, SIGNAL(toggled(bool)), this, SLOT(updateDiffMode(bool)));
 }
 
 VersionConvertSummaryDialog::~VersionConvertSummaryDialog()
@@ -29,3 +31,8 @@ void VersionConvertSummaryDialog::showEvent(QShowEvent* e)
     ui->diffTable->updateSizes();
 
 }
+
+void VersionConvertSummaryDialog::updateDiffMode(bool tokens)
+{
+    ui->diffTable->setDiffMode(tokens ? LineDiff::Mode::TOKENS : LineDiff::Mode::LINES);
+}
@@ -23,6 +23,9 @@ class GUI_API_EXPORT VersionConvertSummaryDialog : public QDialog
 
     private:
         Ui::VersionConvertSummaryDialog *ui = nullptr;
+
+    private slots:
+        void updateDiffMode(bool tokens);
 };
 
 #endif // VERSIONCONVERTSUMMARYDIALOG_H
@@ -50,18 +50,22 @@ SOURCES +=\
     dbtree/dbtreeitem.cpp \
     dbtree/dbtree.cpp \
     dbtree/dbtreeview.cpp \
+    dbtree/dbtreefilterindex.cpp \
+    datagrid/sqltablesearchindex.cpp \
     actionentry.cpp \
     uiutils.cpp \
     dbtree/dbtreeitemdelegate.cpp \
     dbtree/dbtreeitemfactory.cpp \
     sqleditor.cpp \
     datagrid/sqlquerymodel.cpp \
+    datagrid/sqlquerypagecache.cpp \
     dblistmodel.cpp \
     mdiarea.cpp \
     statusfield.cpp \
     common/tablewidget.cpp \
     datagrid/sqlqueryitem.cpp \
     datagrid/sqlqueryview.cpp \
+    datagrid/sqlqueryviewmimedata.cpp \
     datagrid/sqlquerymodelcolumn.cpp \
     datagrid/sqlqueryitemdelegate.cpp \
     common/extlineedit.cpp \
@@ -177,6 +181,7 @@ SOURCES +=\
     dialogs/aboutdialog.cpp \
     dialogs/newversiondialog.cpp \
     dialogs/quitconfirmdialog.cpp \
+    dialogs/columnprofiledialog.cpp \
     common/datawidgetmapper.cpp \
     dialogs/languagedialog.cpp \
     common/ipvalidator.cpp \
@@ -199,18 +204,22 @@ HEADERS  += mainwindow.h \
     dbtree/dbtreeitem.h \
     dbtree/dbtree.h \
     dbtree/dbtreeview.h \
+    dbtree/dbtreefilterindex.h \
+    datagrid/sqltablesearchindex.h \
     actionentry.h \
     uiutils.h \
     dbtree/dbtreeitemdelegate.h \
     dbtree/dbtreeitemfactory.h \
     sqleditor.h \
     datagrid/sqlquerymodel.h \
+    datagrid/sqlquerypagecache.h \
     dblistmodel.h \
     mdiarea.h \
     statusfield.h \
     common/tablewidget.h \
     datagrid/sqlqueryitem.h \
     datagrid/sqlqueryview.h \
+    datagrid/sqlqueryviewmimedata.h \
     datagrid/sqlquerymodelcolumn.h \
     datagrid/sqlqueryitemdelegate.h \
     common/extlineedit.h \
@@ -331,6 +340,7 @@ HEADERS  += mainwindow.h \
     dialogs/newversiondialog.h \
     guiSQLiteStudio_global.h \
     dialogs/quitconfirmdialog.h \
+    dialogs/columnprofiledialog.h \
     common/datawidgetmapper.h \
     dialogs/languagedialog.h \
     common/ipvalidator.h \
@@ -391,6 +401,7 @@ FORMS    += mainwindow.ui \
     dialogs/aboutdialog.ui \
     dialogs/newversiondialog.ui \
     dialogs/quitconfirmdialog.ui \
+    dialogs/columnprofiledialog.ui \
     dialogs/languagedialog.ui \
     dialogs/cssdebugdialog.ui \
     dialogs/indexexprcolumndialog.ui \
@@ -318,6 +318,7 @@ void MainWindow::initMenuBar()
     dbMenu->addAction(dbTree->getAction(DbTree::CONVERT_DB));
     dbMenu->addAction(dbTree->getAction(DbTree::VACUUM_DB));
     dbMenu->addAction(dbTree->getAction(DbTree::INTEGRITY_CHECK));
+    dbMenu->addAction(dbTree->getAction(DbTree::ANALYZE_STORAGE));
     dbMenu->addSeparator();
     dbMenu->addAction(dbTree->getAction(DbTree::REFRESH_SCHEMA));
     dbMenu->addAction(dbTree->getAction(DbTree::REFRESH_SCHEMAS));
@@ -422,7 +423,13 @@ void MainWindow::saveSession(MdiWindow* currWindow)
     sessionValue["state"] = saveState();
     sessionValue["geometry"] = saveGeometry();
 
-    if (CFG_UI.General.RestoreSession.get())
+    if (CFG_UI.General.RestoreSession.get() && !pendingMdiSession.isEmpty())
+    {
+        // Closed before databases got loaded, so windows weren't restored yet. Keep them for the next time.
+        sessionValue["windowSessions"] = pendingMdiSession["windowSessions"];
+        sessionValue["activeWindowTitle"] = pendingMdiSession["activeWindowTitle"];
+    }
+    else if (CFG_UI.General.RestoreSession.get())
     {
         QList<QVariant> windowSessions;
         for (MdiWindow* window : ui->mdiArea->getWindows())
@@ -472,15 +479,15 @@ void MainWindow::restoreSession()
 
     if (CFG_UI.General.RestoreSession.get())
     {
-        if (sessionValue.contains("windowSessions"))
-            restoreWindowSessions(sessionValue["windowSessions"].toList());
-
-        if (sessionValue.contains("activeWindowTitle"))
+        // Windows need their databases, which may still be probed in background
+        if (DBLIST->isDbListLoaded())
         {
-            QString title = sessionValue["activeWindowTitle"].toString();
-            MdiWindow* window = ui->mdiArea->getWindowByTitle(title);
-            if (window)
-                ui->mdiArea->setActiveSubWindow(window);
+            restoreMdiSession(sessionValue);
+        }
+        else
+        {
+            pendingMdiSession = sessionValue;
+            connect(DBLIST, SIGNAL(dbListLoaded()), this, SLOT(restorePendingMdiSession()));
         }
     }
 
@@ -491,6 +498,28 @@ void MainWindow::restoreSession()
     updateWindowActions();
 }
 
+void MainWindow::restoreMdiSession(const QHash<QString, QVariant>& sessionValue)
+{
+    if (sessionValue.contains("windowSessions"))
+        restoreWindowSessions(sessionValue["windowSessions"].toList());
+
+    if (sessionValue.contains("activeWindowTitle"))
+    {
+        QString title = sessionValue["activeWindowTitle"].toString();
+        MdiWindow* window = ui->mdiArea->getWindowByTitle(title);
+        if (window)
+            ui->mdiArea->setActiveSubWindow(window);
+    }
+}
+
+void MainWindow::restorePendingMdiSession()
+{
+    disconnect(DBLIST, SIGNAL(dbListLoaded()), this, SLOT(restorePendingMdiSession()));
+    restoreMdiSession(pendingMdiSession);
+    pendingMdiSession.clear();
+    updateWindowActions();
+}
+
 void MainWindow::restoreWindowSessions(const QList<QVariant>& windowSessions)
 {
     if (windowSessions.size() == 0)
@@ -136,6 +136,7 @@ class GUI_API_EXPORT MainWindow : public QMainWindow, public ExtActionContainer
         void setupDefShortcuts();
         void initMenuBar();
         void saveSession(MdiWindow* currWindow);
+        void restoreMdiSession(const QHash<QString, QVariant>& sessionValue);
         void restoreWindowSessions(const QList<QVariant>& windowSessions);
         MdiWindow *restoreWindowSession(const QVariant& windowSessions);
         void closeNonSessionWindows();
@@ -160,6 +161,7 @@ class GUI_API_EXPORT MainWindow : public QMainWindow, public ExtActionContainer
         QMenu* mdiMenu = nullptr;
         FormManager* formManager = nullptr;
         QQueue<QVariant> closedWindowSessionValues;
+        QHash<QString, QVariant> pendingMdiSession;
         bool closingApp = false;
         QMenu* dbMenu = nullptr;
         QMenu* structMenu = nullptr;
@@ -213,6 +215,7 @@ class GUI_API_EXPORT MainWindow : public QMainWindow, public ExtActionContainer
         void checkForUpdates();
 #endif
         void statusFieldLinkClicked(const QString& link);
+        void restorePendingMdiSession();
 };
 
 template <class T>
@@ -1,5 +1,6 @@
 #include "multieditordialog.h"
 #include "multieditor.h"
+#include "multieditorhex.h"
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
 
@@ -46,4 +47,26 @@ void MultiEditorDialog::setDataType(const DataType& dataType)
 void MultiEditorDialog::setReadOnly(bool readOnly)
 {
     multiEditor->setReadOnly(readOnly);
+    if (deviceEditor)
+        deviceEditor->setReadOnly(readOnly);
+}
+
+void MultiEditorDialog::setValueDevice(QIODevice* device)
+{
+    if (!deviceEditor)
+    {
+        deviceEditor = new MultiEditorHex();
+        deviceEditor->setReadOnly(multiEditor->getReadOnly());
+        multiEditor->setVisible(false);
+        qobject_cast<QVBoxLayout*>(layout())->insertWidget(0, deviceEditor);
+    }
+    deviceEditor->setValueDevice(device);
+}
+
+bool MultiEditorDialog::writeValueDevice()
+{
+    if (!deviceEditor)
+        return false;
+
+    return deviceEditor->writeValueDevice();
 }
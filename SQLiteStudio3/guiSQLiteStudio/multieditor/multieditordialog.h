@@ -6,7 +6,9 @@
 #include <QDialog>
 
 class MultiEditor;
+class MultiEditorHex;
 class QDialogButtonBox;
+class QIODevice;
 
 class GUI_API_EXPORT MultiEditorDialog : public QDialog
 {
@@ -21,8 +23,19 @@ class GUI_API_EXPORT MultiEditorDialog : public QDialog
         void setDataType(const DataType& dataType);
         void setReadOnly(bool readOnly);
 
+        /**
+         * @brief Edits the value directly in the device, page by page, using the hex editor only.
+         * @param device Device with the value, usually opened with Db::openBlob().
+         *
+         * It's used for values too big to be loaded into memory at once. Other editors need the whole value,
+         * so they are not available in this mode. Call writeValueDevice() after the dialog is accepted.
+         */
+        void setValueDevice(QIODevice* device);
+        bool writeValueDevice();
+
     private:
         MultiEditor* multiEditor = nullptr;
+        MultiEditorHex* deviceEditor = nullptr;
         QDialogButtonBox* buttonBox = nullptr;
 };
 
@@ -2,6 +2,9 @@
 #include "qhexedit2/qhexedit.h"
 #include "common/unused.h"
 #include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QToolButton>
+#include <QLabel>
 
 MultiEditorHex::MultiEditorHex()
 {
@@ -9,7 +12,25 @@ MultiEditorHex::MultiEditorHex()
     hexEdit = new QHexEdit();
     layout()->addWidget(hexEdit);
 
+    pageBar = new QWidget();
+    pageBar->setLayout(new QHBoxLayout());
+    pageBar->layout()->setMargin(0);
+    prevPageBtn = new QToolButton();
+    prevPageBtn->setArrowType(Qt::LeftArrow);
+    nextPageBtn = new QToolButton();
+    nextPageBtn->setArrowType(Qt::RightArrow);
+    pageLabel = new QLabel();
+    pageBar->layout()->addWidget(prevPageBtn);
+    pageBar->layout()->addWidget(pageLabel);
+    pageBar->layout()->addWidget(nextPageBtn);
+    qobject_cast<QHBoxLayout*>(pageBar->layout())->addStretch();
+    pageBar->setVisible(false);
+    layout()->addWidget(pageBar);
+
     connect(hexEdit, SIGNAL(dataChanged()), this, SLOT(modificationChanged()));
+    connect(hexEdit, SIGNAL(pageChanged(int)), this, SLOT(updatePageBar()));
+    connect(prevPageBtn, SIGNAL(clicked()), this, SLOT(prevPage()));
+    connect(nextPageBtn, SIGNAL(clicked()), this, SLOT(nextPage()));
     setFocusProxy(hexEdit);
 }
 
@@ -42,11 +63,42 @@ QList<QWidget*> MultiEditorHex::getNoScrollWidgets()
     return QList<QWidget*>();
 }
 
+void MultiEditorHex::setValueDevice(QIODevice* device)
+{
+    hexEdit->setDataDevice(device, DEVICE_PAGE_SIZE);
+    pageBar->setVisible(device != nullptr);
+    updatePageBar();
+}
+
+bool MultiEditorHex::writeValueDevice()
+{
+    return hexEdit->writeDevice();
+}
+
 void MultiEditorHex::modificationChanged()
 {
     emit valueModified();
 }
 
+void MultiEditorHex::updatePageBar()
+{
+    int page = hexEdit->page();
+    int pages = hexEdit->pageCount();
+    pageLabel->setText(tr("Page %1 of %2").arg(page + 1).arg(pages));
+    prevPageBtn->setEnabled(page > 0);
+    nextPageBtn->setEnabled(page + 1 < pages);
+}
+
+void MultiEditorHex::prevPage()
+{
+    hexEdit->setPage(hexEdit->page() - 1);
+}
+
+void MultiEditorHex::nextPage()
+{
+    hexEdit->setPage(hexEdit->page() + 1);
+}
+
 MultiEditorWidget*MultiEditorHexPlugin::getInstance()
 {
     return new MultiEditorHex();
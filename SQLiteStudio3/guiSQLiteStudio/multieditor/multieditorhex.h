@@ -9,6 +9,9 @@
 
 class QHexEdit;
 class QBuffer;
+class QIODevice;
+class QLabel;
+class QToolButton;
 
 class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
 {
@@ -24,11 +27,36 @@ class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
 
         QList<QWidget*> getNoScrollWidgets();
 
+        /**
+         * @brief Makes the editor work directly on the value stored in a device.
+         * @param device Random access device with the value, like the one from Db::openBlob().
+         *
+         * The value is loaded and displayed page by page, so even huge values can be browsed
+         * with a constant memory usage. Size of the value cannot be changed.
+         * Modifications are written to the device only by writeValueDevice().
+         */
+        void setValueDevice(QIODevice* device);
+
+        /**
+         * @brief Writes modified pages to the device set with setValueDevice().
+         * @return true on success, or false if writing failed.
+         */
+        bool writeValueDevice();
+
     private:
+        static const int DEVICE_PAGE_SIZE = 256 * 1024;
+
         QHexEdit* hexEdit = nullptr;
+        QWidget* pageBar = nullptr;
+        QToolButton* prevPageBtn = nullptr;
+        QToolButton* nextPageBtn = nullptr;
+        QLabel* pageLabel = nullptr;
 
     private slots:
         void modificationChanged();
+        void updatePageBar();
+        void prevPage();
+        void nextPage();
 };
 
 class GUI_API_EXPORT MultiEditorHexPlugin : public BuiltInPlugin, public MultiEditorWidgetPlugin
@@ -5,6 +5,11 @@
 
 QHexEdit::QHexEdit(QWidget *parent) : QScrollArea(parent)
 {
+    _device = nullptr;
+    _pageSize = 0;
+    _page = 0;
+    _pageModified = false;
+
     qHexEdit_p = new QHexEditPrivate(this);
     setWidget(qHexEdit_p);
     setWidgetResizable(true);
@@ -13,6 +18,7 @@ QHexEdit::QHexEdit(QWidget *parent) : QScrollArea(parent)
     connect(qHexEdit_p, SIGNAL(currentSizeChanged(int)), this, SIGNAL(currentSizeChanged(int)));
     connect(qHexEdit_p, SIGNAL(dataChanged()), this, SIGNAL(dataChanged()));
     connect(qHexEdit_p, SIGNAL(overwriteModeChanged(bool)), this, SIGNAL(overwriteModeChanged(bool)));
+    connect(qHexEdit_p, SIGNAL(dataChanged()), this, SLOT(currentPageModified()));
     setFocusPolicy(Qt::NoFocus);
 }
 
@@ -111,6 +117,9 @@ int QHexEdit::cursorPosition()
 
 void QHexEdit::setData(const QByteArray &data)
 {
+    if (_device)
+        setDataDevice(nullptr);
+
     qHexEdit_p->setData(data);
 }
 
@@ -178,3 +187,95 @@ const QFont & QHexEdit::font() const
 {
     return qHexEdit_p->font();
 }
+
+void QHexEdit::setDataDevice(QIODevice *device, int pageSize)
+{
+    _device = device;
+    _pageSize = qMax(pageSize, 1);
+    _page = 0;
+    _pageModified = false;
+    _modifiedPages.clear();
+
+    qHexEdit_p->setFixedSize(_device != nullptr);
+    qHexEdit_p->setAddressOffset(0);
+    qHexEdit_p->setData(_device ? readPage(0) : QByteArray());
+}
+
+QIODevice *QHexEdit::dataDevice() const
+{
+    return _device;
+}
+
+int QHexEdit::pageCount() const
+{
+    if (!_device || _device->size() == 0)
+        return 1;
+
+    return static_cast<int>((_device->size() + _pageSize - 1) / _pageSize);
+}
+
+int QHexEdit::page() const
+{
+    return _page;
+}
+
+bool QHexEdit::isDeviceModified() const
+{
+    return _pageModified || !_modifiedPages.isEmpty();
+}
+
+bool QHexEdit::writeDevice()
+{
+    if (!_device)
+        return false;
+
+    storeCurrentPage();
+
+    QHashIterator<int, QByteArray> it(_modifiedPages);
+    while (it.hasNext())
+    {
+        it.next();
+        if (!_device->seek(static_cast<qint64>(it.key()) * _pageSize))
+            return false;
+
+        if (_device->write(it.value()) != it.value().size())
+            return false;
+    }
+    _modifiedPages.clear();
+    return true;
+}
+
+void QHexEdit::setPage(int page)
+{
+    if (!_device || page == _page || page < 0 || page >= pageCount())
+        return;
+
+    storeCurrentPage();
+    _page = page;
+    qHexEdit_p->setAddressOffset(_page * _pageSize);
+    qHexEdit_p->setData(_modifiedPages.contains(_page) ? _modifiedPages[_page] : readPage(_page));
+    emit pageChanged(_page);
+}
+
+void QHexEdit::storeCurrentPage()
+{
+    if (!_pageModified)
+        return;
+
+    _modifiedPages[_page] = qHexEdit_p->data();
+    _pageModified = false;
+}
+
+QByteArray QHexEdit::readPage(int page)
+{
+    if (!_device->seek(static_cast<qint64>(page) * _pageSize))
+        return QByteArray();
+
+    return _device->read(_pageSize);
+}
+
+void QHexEdit::currentPageModified()
+{
+    if (_device)
+        _pageModified = true;
+}
@@ -36,7 +36,9 @@ and lastIndexOf(). The replace() function is to change located subdata. This
 
 This widget can only handle small amounts of data. The size has to be below 10
 megabytes, otherwise the scroll sliders ard not shown and you can't scroll any
-more.
+more. Bigger data can be edited page by page from a random access device
+(setDataDevice()). Only the current page is kept in memory, together with pages
+that were modified. The size of the device data cannot be changed.
 */
 class GUI_API_EXPORT QHexEdit : public QScrollArea
 {
@@ -152,6 +154,36 @@ public:
     */
     QString selectionToReadableString();
 
+    /*! Sets a random access device as a source of data.
+    \param device Device opened for reading (and writing, unless the editor is read-only),
+    or null to stop using the device.
+    \param pageSize Amount of bytes loaded into the editor at once.
+    The editor shows the first page and works in fixed size overwrite mode. Modified pages are
+    kept in memory until writeDevice() is called. The device is not owned by the editor.
+    */
+    void setDataDevice(QIODevice* device, int pageSize = 65536);
+
+    /*! Returns the device set with setDataDevice(), or null if the editor works with data().
+    */
+    QIODevice* dataDevice() const;
+
+    /*! Returns amount of pages of the device data, or 1 if there's no device.
+    */
+    int pageCount() const;
+
+    /*! Returns index of the page currently shown from the device.
+    */
+    int page() const;
+
+    /*! Returns true if any page of the device data was modified and not written yet.
+    */
+    bool isDeviceModified() const;
+
+    /*! Writes modified pages back to the device.
+    \return true on success, false if the device did not accept all data.
+    */
+    bool writeDevice();
+
     /*! \cond docNever */
     void setAddressOffset(int offset);
     int addressOffset();
@@ -174,6 +206,11 @@ public:
     /*! \endcond docNever */
 
 public slots:
+    /*! Shows another page of the device data. The undo/redo history is cleared.
+      \param page Index of the page, from 0 to pageCount() - 1.
+      */
+    void setPage(int page);
+
     /*! Redoes the last operation. If there is no operation to redo, i.e.
       there is no redo step in the undo/redo history, nothing happens.
       */
@@ -218,12 +255,26 @@ signals:
     /*! The signal is emited every time, the overwrite mode is changed. */
     void overwriteModeChanged(bool state);
 
+    /*! The signal is emited every time, another page of the device data is shown. */
+    void pageChanged(int page);
+
 private:
     /*! \cond docNever */
+    void storeCurrentPage();
+    QByteArray readPage(int page);
+
     QHexEditPrivate *qHexEdit_p;
     QHBoxLayout *layout;
     QScrollArea *scrollArea;
+    QIODevice *_device;
+    int _pageSize;
+    int _page;
+    bool _pageModified;
+    QHash<int, QByteArray> _modifiedPages;
     /*! \endcond docNever */
+
+private slots:
+    void currentPageModified();
 };
 
 #endif
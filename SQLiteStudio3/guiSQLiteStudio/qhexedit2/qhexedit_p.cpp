@@ -19,6 +19,7 @@ QHexEditPrivate::QHexEditPrivate(QScrollArea *parent) : QWidget(parent)
     setAddressArea(true);
     setAsciiArea(true);
     setHighlighting(true);
+    _fixedSize = false;
     setOverwriteMode(true);
     setReadOnly(false);
     setAddressAreaColor(QColor(0xd4, 0xd4, 0xd4, 0xff));
@@ -126,6 +127,13 @@ int QHexEditPrivate::indexOf(const QByteArray & ba, int from)
 
 void QHexEditPrivate::insert(int index, const QByteArray & ba)
 {
+    if (_fixedSize && index + ba.length() > _xData.size())
+    {
+        // Overwriting beyond the end would grow the data
+        insert(index, ba.left(_xData.size() - index));
+        return;
+    }
+
     if (ba.length() > 0)
     {
         if (_overwriteMode)
@@ -264,7 +272,7 @@ void QHexEditPrivate::setHighlighting(bool mode)
 
 void QHexEditPrivate::setOverwriteMode(bool overwriteMode)
 {
-    _overwriteMode = overwriteMode;
+    _overwriteMode = overwriteMode || _fixedSize;
 }
 
 bool QHexEditPrivate::overwriteMode()
@@ -272,6 +280,22 @@ bool QHexEditPrivate::overwriteMode()
     return _overwriteMode;
 }
 
+void QHexEditPrivate::setFixedSize(bool fixedSize)
+{
+    _fixedSize = fixedSize;
+    if (_fixedSize && !_overwriteMode)
+    {
+        _overwriteMode = true;
+        setCursorPos(_cursorPosition);
+        emit overwriteModeChanged(_overwriteMode);
+    }
+}
+
+bool QHexEditPrivate::isFixedSize()
+{
+    return _fixedSize;
+}
+
 void QHexEditPrivate::redo()
 {
     _undoStack->redo();
@@ -569,7 +593,7 @@ if (!_readOnly)
     }
 
     // Switch between insert/overwrite mode
-    if ((event->key() == Qt::Key_Insert) && (event->modifiers() == Qt::NoModifier))
+    if ((event->key() == Qt::Key_Insert) && (event->modifiers() == Qt::NoModifier) && !_fixedSize)
     {
         _overwriteMode = !_overwriteMode;
         setCursorPos(_cursorPosition);
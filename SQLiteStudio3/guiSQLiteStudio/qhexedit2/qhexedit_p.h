@@ -34,6 +34,9 @@ public:
     void setOverwriteMode(bool overwriteMode);
     bool overwriteMode();
 
+    void setFixedSize(bool fixedSize);
+    bool isFixedSize();
+
     void setReadOnly(bool readOnly);
     bool isReadOnly();
 
@@ -109,6 +112,7 @@ private:
     bool _asciiArea;                        // medium area
     bool _highlighting;                     // highlighting of changed bytes
     bool _overwriteMode;
+    bool _fixedSize;                        // true: size of data cannot change, implies overwrite mode
     bool _readOnly;                         // true: the user can only look and navigate
 
     int _charWidth, _charHeight;            // char dimensions (dpendend on font)
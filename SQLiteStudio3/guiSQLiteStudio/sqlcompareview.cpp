@@ -1,9 +1,11 @@
 #include "sqlcompareview.h"
 #include "sqlview.h"
 #include "common/utils.h"
-#include "diff/diff_match_patch.h"
 #include "sqlitesyntaxhighlighter.h"
 #include <QHeaderView>
+#include <QScrollBar>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
 #include <QDebug>
 
 SqlCompareView::SqlCompareView(QWidget *parent) :
@@ -15,11 +17,15 @@ SqlCompareView::SqlCompareView(QWidget *parent) :
     horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
     horizontalHeader()->setVisible(false);
 //    verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-    diff = new diff_match_patch;
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, [this]()
+    {
+        highlightVisibleRows();
+    });
 }
 
 void SqlCompareView::setSides(const QList<QPair<QString, QString>>& data)
 {
+    sides = data;
     setRowCount(data.size());
 
     int row = 0;
@@ -37,12 +43,11 @@ void SqlCompareView::setSides(const QList<QPair<QString, QString>>& data)
         rightView->setPlainText(rowData.second);
         setCellWidget(row, 1, rightView);
 
-        setupHighlighting(rowData.first, rowData.second, leftView, rightView);
-
         row++;
     }
     updateLabels();
     updateSizes();
+    computeDiffs(data);
 }
 
 void SqlCompareView::setLeftLabel(const QString& label)
@@ -55,6 +60,20 @@ void SqlCompareView::setRightLabel(const QString& label)
     rightLabel = label;
 }
 
+void SqlCompareView::setDiffMode(LineDiff::Mode mode)
+{
+    if (lineDiff.getMode() == mode)
+        return;
+
+    lineDiff.setMode(mode);
+    if (sides.isEmpty())
+        return;
+
+    // Views are filled again, to get rid of the highlighting made in the previous mode
+    QList<QPair<QString,QString>> data = sides;
+    setSides(data);
+}
+
 void SqlCompareView::updateSizes()
 {
     if (rowCount() == 0 || !isVisible())
@@ -96,6 +115,7 @@ void SqlCompareView::updateSizes()
         rightView->setFixedSize(rightSize);
     }
     verticalHeader()->resizeSections(QHeaderView::ResizeToContents);
+    highlightVisibleRows();
 }
 
 void SqlCompareView::updateLabels()
@@ -103,28 +123,77 @@ void SqlCompareView::updateLabels()
     setHorizontalHeaderLabels({leftLabel, rightLabel});
 }
 
-void SqlCompareView::setupHighlighting(const QString& left, const QString& right, SqlView* leftView, SqlView* rightView)
+void SqlCompareView::computeDiffs(const QList<QPair<QString, QString>>& data)
 {
-    QList<Diff> diffs = diff->diff_main(left, right);
-    int leftPos = 0;
-    int lgt = 0;
-    for (const Diff& d : diffs)
+    rowDiffs.clear();
+    rowHighlighted.fill(false, data.size());
+
+    // Results of the previous call (if it's still running) are ignored, thanks to the generation.
+    int generation = ++diffGeneration;
+    QFutureWatcher<QList<LineDiff::Result>>* watcher = new QFutureWatcher<QList<LineDiff::Result>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, [this, watcher, generation]()
     {
-        lgt = d.text.length();
-        switch (d.operation)
-        {
-            case DELETE:
-                leftView->setTextBackgroundColor(leftPos, leftPos + lgt - 1, Qt::red);
-                leftPos += lgt;
-                break;
-            case EQUAL:
-                leftPos += lgt;
-                break;
-            case INSERT:
-                rightView->setTextBackgroundColor(leftPos, leftPos + lgt - 1, Qt::green);
-                break;
-        }
-    }
+        if (generation == diffGeneration)
+            applyDiffs(watcher->result());
+
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&SqlCompareView::diffAll, data, lineDiff));
+}
+
+QList<LineDiff::Result> SqlCompareView::diffAll(const QList<QPair<QString, QString>>& data, const LineDiff& lineDiff)
+{
+    QList<LineDiff::Result> results;
+    for (const QPair<QString, QString>& rowData : data)
+        results << lineDiff.diff(rowData.first, rowData.second);
+
+    return results;
+}
+
+void SqlCompareView::applyDiffs(const QList<LineDiff::Result>& results)
+{
+    if (results.size() != rowCount())
+        return;
+
+    rowDiffs = results;
+    highlightVisibleRows();
+}
+
+void SqlCompareView::highlightVisibleRows()
+{
+    if (rowDiffs.isEmpty() || !isVisible())
+        return;
+
+    int firstRow = rowAt(0);
+    int lastRow = rowAt(viewport()->height() - 1);
+    if (firstRow < 0)
+        firstRow = 0;
+
+    if (lastRow < 0)
+        lastRow = rowCount() - 1;
+
+    for (int row = firstRow; row <= lastRow; row++)
+        highlightRow(row);
+}
+
+void SqlCompareView::highlightRow(int row)
+{
+    if (rowHighlighted[row])
+        return;
+
+    SqlView* leftView = dynamic_cast<SqlView*>(cellWidget(row, 0));
+    SqlView* rightView = dynamic_cast<SqlView*>(cellWidget(row, 1));
+    if (!leftView || !rightView)
+        return;
+
+    const LineDiff::Result& result = rowDiffs[row];
+    for (const LineDiff::Range& range : result.deleted)
+        leftView->setTextBackgroundColor(range.start, range.start + range.length - 1, Qt::red);
+
+    for (const LineDiff::Range& range : result.inserted)
+        rightView->setTextBackgroundColor(range.start, range.start + range.length - 1, Qt::green);
+
+    rowHighlighted[row] = true;
 }
 
 void SqlCompareView::resizeEvent(QResizeEvent* e)
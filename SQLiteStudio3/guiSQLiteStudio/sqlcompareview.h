@@ -2,12 +2,20 @@
 #define SQLCOMPAREVIEW_H
 
 #include "guiSQLiteStudio_global.h"
+#include "diff/linediff.h"
 #include <QTableWidget>
+#include <QVector>
 
 class SqlView;
-class diff_match_patch;
 class SqliteSyntaxHighlighter;
 
+/**
+ * @brief Side by side view of SQL pairs, with differences highlighted.
+ *
+ * Differences are computed with LineDiff in a background thread, so the view is shown immediately,
+ * even for thousands of compared objects. Highlighting is applied only to rows that get visible,
+ * as the user scrolls the view.
+ */
 class GUI_API_EXPORT SqlCompareView : public QTableWidget
 {
     public:
@@ -16,6 +24,13 @@ class GUI_API_EXPORT SqlCompareView : public QTableWidget
         void setSides(const QList<QPair<QString,QString>>& data);
         void setLeftLabel(const QString& label);
         void setRightLabel(const QString& label);
+        /**
+         * @brief Changes how differences are found.
+         * @param mode Whole lines (the default), or single SQL tokens.
+         *
+         * If sides are already set, they are compared again, so the highlighting follows the new mode.
+         */
+        void setDiffMode(LineDiff::Mode mode);
         void updateSizes();
 
     protected:
@@ -24,11 +39,20 @@ class GUI_API_EXPORT SqlCompareView : public QTableWidget
 
     private:
         void updateLabels();
-        void setupHighlighting(const QString& left, const QString& right, SqlView* leftView, SqlView* rightView);
+        void computeDiffs(const QList<QPair<QString,QString>>& data);
+        void applyDiffs(const QList<LineDiff::Result>& results);
+        void highlightVisibleRows();
+        void highlightRow(int row);
+
+        static QList<LineDiff::Result> diffAll(const QList<QPair<QString,QString>>& data, const LineDiff& lineDiff);
 
         QString leftLabel;
         QString rightLabel;
-        diff_match_patch* diff = nullptr;
+        QList<QPair<QString,QString>> sides;
+        LineDiff lineDiff;
+        QList<LineDiff::Result> rowDiffs;
+        QVector<bool> rowHighlighted;
+        int diffGeneration = 0;
 };
 
 #endif // SQLCOMPAREVIEW_H
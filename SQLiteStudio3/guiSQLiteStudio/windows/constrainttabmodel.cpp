@@ -161,7 +161,7 @@ QVariant ConstraintTabModel::headerData(int section, Qt::Orientation orientation
     return QVariant();
 }
 
-void ConstraintTabModel::setCreateTable(const QPointer<SqliteCreateTable>& value)
+void ConstraintTabModel::setCreateTable(const SqliteStatementGuard<SqliteCreateTable>& value)
 {
     beginResetModel();
     createTable = value;
@@ -4,7 +4,6 @@
 #include "parser/ast/sqlitecreatetable.h"
 #include "guiSQLiteStudio_global.h"
 #include <QAbstractTableModel>
-#include <QPointer>
 
 class GUI_API_EXPORT ConstraintTabModel : public QAbstractTableModel
 {
@@ -19,7 +18,7 @@ class GUI_API_EXPORT ConstraintTabModel : public QAbstractTableModel
         QVariant data(SqliteCreateTable::Column::Constraint* constr, int column, int role) const;
         QVariant headerData(int section, Qt::Orientation orientation, int role) const;
 
-        void setCreateTable(const QPointer<SqliteCreateTable>& value);
+        void setCreateTable(const SqliteStatementGuard<SqliteCreateTable>& value);
 
     private:
         enum class Columns
@@ -58,7 +57,7 @@ class GUI_API_EXPORT ConstraintTabModel : public QAbstractTableModel
         QString getConstrDetails(SqliteCreateTable::Column::Constraint* constr, int tokenOffset) const;
         QString getConstrDetails(const TokenList& constrTokens, int tokenOffset) const;
 
-        QPointer<SqliteCreateTable> createTable;
+        SqliteStatementGuard<SqliteCreateTable> createTable;
 
     signals:
 
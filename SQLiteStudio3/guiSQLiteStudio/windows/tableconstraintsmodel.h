@@ -4,7 +4,6 @@
 #include "parser/ast/sqlitecreatetable.h"
 #include "guiSQLiteStudio_global.h"
 #include <QAbstractTableModel>
-#include <QPointer>
 
 class GUI_API_EXPORT TableConstraintsModel : public QAbstractTableModel
 {
@@ -57,7 +56,7 @@ class GUI_API_EXPORT TableConstraintsModel : public QAbstractTableModel
 
         static const constexpr char* mimeType = "application/x-sqlitestudio-tablestructureconstraintmodel-row-index";
 
-        QPointer<SqliteCreateTable> createTable;
+        SqliteStatementGuard<SqliteCreateTable> createTable;
         bool modified = false;
 
     public slots:
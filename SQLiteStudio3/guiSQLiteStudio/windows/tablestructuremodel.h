@@ -4,7 +4,6 @@
 #include "parser/ast/sqlitecreatetable.h"
 #include "guiSQLiteStudio_global.h"
 #include <QAbstractTableModel>
-#include <QPointer>
 
 class GUI_API_EXPORT TableStructureModel : public QAbstractTableModel
 {
@@ -76,7 +75,7 @@ class GUI_API_EXPORT TableStructureModel : public QAbstractTableModel
 
         static const constexpr char* mimeType = "application/x-sqlitestudio-tablestructuremodel-row-index";
 
-        QPointer<SqliteCreateTable> createTable;
+        SqliteStatementGuard<SqliteCreateTable> createTable;
         bool modified = false;
 
     signals:
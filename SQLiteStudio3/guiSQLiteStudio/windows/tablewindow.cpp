@@ -360,6 +360,14 @@ void TableWindow::executeStructureChanges()
     {
         DdlPreviewDialog dialog(db, this);
         dialog.setDdl(sqls);
+        if (existingTable && tableModifier)
+        {
+            if (tableModifier->isNativeAlter())
+                dialog.setInfo(tr("The table will be modified in place, using ALTER TABLE statements.", "table window"));
+            else
+                dialog.setInfo(tr("The table will be recreated and all its data will be copied to the new table.", "table window"));
+        }
+
         if (dialog.exec() != QDialog::Accepted)
             return;
     }
@@ -17,6 +17,9 @@
 #include <QStringList>
 #include <QLibrary>
 #include <QString>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonDocument>
 
 #if defined(Q_OS_WIN32)
 #include "readline.h"
@@ -74,22 +77,7 @@ void CLI::start()
     connect(thread, &QThread::finished, this, &CLI::done);
     this->moveToThread(thread);
 
-    if (!getCurrentDb()) // it could be set by openDbFile() from main().
-    {
-        Db* db = DBLIST->getByName(CFG_CLI.Console.DefaultDatabase.get());
-        if (db)
-        {
-            setCurrentDb(db);
-        }
-        else
-        {
-            QList<Db*> dbList = DBLIST->getDbList();
-            if (dbList.size() > 0)
-                setCurrentDb(dbList[0]);
-            else
-                setCurrentDb(nullptr);
-        }
-    }
+    selectDefaultDb();
 
     qOut << QString("\n%1 (%2)\n------------------------\n\n").arg(QCoreApplication::applicationName()).arg(QCoreApplication::applicationVersion());
     qOut.flush();
@@ -106,6 +94,180 @@ void CLI::start()
     thread->start();
 }
 
+int CLI::runBatch(const QString& inputPath, bool stopOnError, bool printStats)
+{
+    batchMode = true;
+    CliCommandFactory::init();
+    selectDefaultDb();
+
+    QFile file;
+    QTextStream fileStream;
+    QTextStream* input = &qIn;
+    if (inputPath != "-")
+    {
+        file.setFileName(inputPath);
+        if (!file.open(QIODevice::ReadOnly|QIODevice::Text))
+        {
+            printError(tr("Could not open file %1 for reading: %2").arg(inputPath, file.errorString()));
+            qOut.flush();
+            return BATCH_INPUT_ERROR;
+        }
+        fileStream.setDevice(&file);
+        input = &fileStream;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString prefix = CFG_CLI.Console.CommandPrefixChar.get();
+    QString statement;
+    QString inputLine;
+    int lineNumber = 0;
+    int statementLine = 0;
+    int executed = 0;
+    int failed = 0;
+    bool stopped = false;
+    while (!doExit && !stopped)
+    {
+        bool atEnd = input->atEnd();
+        if (!atEnd)
+        {
+            inputLine = input->readLine();
+            lineNumber++;
+            if (statement.isEmpty())
+            {
+                // Empty lines and comments between statements are not worth executing.
+                if (inputLine.trimmed().isEmpty() || inputLine.trimmed().startsWith("--"))
+                    continue;
+
+                statementLine = lineNumber;
+                statement = inputLine.trimmed().startsWith(prefix) ? inputLine.trimmed() : inputLine;
+            }
+            else
+            {
+                statement += "\n" + inputLine;
+            }
+
+            if (!isComplete(statement))
+                continue;
+        }
+
+        // The last statement is executed even if it wasn't terminated, the same way as the sqlite3 shell does it.
+        if (!statement.trimmed().isEmpty())
+        {
+            executed++;
+            if (!executeBatchStatement(statement, statementLine, printStats))
+            {
+                failed++;
+                stopped = stopOnError;
+            }
+            statement.clear();
+        }
+
+        if (atEnd)
+            break;
+    }
+
+    qOut.flush();
+    if (printStats)
+    {
+        QJsonObject stats;
+        stats["event"] = "summary";
+        stats["statements"] = executed;
+        stats["failed"] = failed;
+        stats["stopped"] = stopped;
+        stats["elapsedMs"] = timer.nsecsElapsed() / 1000000.0;
+        printBatchStats(stats);
+    }
+
+    return (failed > 0) ? BATCH_FAILED : BATCH_OK;
+}
+
+bool CLI::isBatchMode() const
+{
+    return batchMode;
+}
+
+void CLI::selectDefaultDb()
+{
+    if (getCurrentDb()) // it could be set by openDbFile() from main().
+        return;
+
+    Db* db = DBLIST->getByName(CFG_CLI.Console.DefaultDatabase.get());
+    if (db)
+    {
+        setCurrentDb(db);
+    }
+    else
+    {
+        QList<Db*> dbList = DBLIST->getDbList();
+        if (dbList.size() > 0)
+            setCurrentDb(dbList[0]);
+        else
+            setCurrentDb(nullptr);
+    }
+}
+
+bool CLI::executeBatchStatement(const QString& statement, int lineNumber, bool printStats)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QString cmd = "query";
+    QStringList cmdArgs;
+    if (statement.startsWith(CFG_CLI.Console.CommandPrefixChar.get()))
+    {
+        cmdArgs = tokenizeArgs(statement.mid(1));
+        cmd = cmdArgs.isEmpty() ? QString() : cmdArgs.takeAt(0);
+    }
+    else
+    {
+        cmdArgs << statement;
+    }
+
+    bool result = false;
+    CliCommand* cliCommand = CliCommandFactory::getCommand(cmd);
+    if (cliCommand)
+    {
+        cliCommand->setup(this);
+        if (cliCommand->parseArgs(cmdArgs))
+        {
+            // All commands are executed synchronously in the batch mode, including queries (see CliCommandSql).
+            cliCommand->execute();
+            result = !cliCommand->isFailed();
+        }
+        delete cliCommand;
+    }
+    else
+    {
+        println(tr("No such command: %1").arg(cmd));
+    }
+
+    // There is no event loop in the batch mode, so objects scheduled for deletion would pile up otherwise.
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    if (printStats)
+    {
+        qOut.flush();
+
+        QJsonObject stats;
+        stats["event"] = "statement";
+        stats["line"] = lineNumber;
+        stats["command"] = cmd;
+        stats["status"] = result ? "ok" : "failed";
+        stats["elapsedMs"] = timer.nsecsElapsed() / 1000000.0;
+        printBatchStats(stats);
+    }
+
+    return result;
+}
+
+void CLI::printBatchStats(const QJsonObject& stats)
+{
+    qErr << QString::fromUtf8(QJsonDocument(stats).toJson(QJsonDocument::Compact)) << "\n";
+    qErr.flush();
+}
+
 void CLI::setCurrentDb(Db* db)
 {
     currentDb = db;
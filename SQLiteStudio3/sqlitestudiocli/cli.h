@@ -9,6 +9,7 @@
 
 class QThread;
 class QFile;
+class QJsonObject;
 class DbManager;
 class CliCommand;
 
@@ -23,6 +24,19 @@ class CLI : public QObject
         static void dispose();
 
         void start();
+
+        /**
+         * @brief Executes commands and SQL queries from the file, without any interaction with the user.
+         * @param inputPath File to read from, or "-" for the standard input.
+         * @param stopOnError If true, execution stops at the first failed command or query.
+         * @param printStats If true, a JSON line with timing of each statement, and a summary at the end, are printed to the standard error.
+         * @return Exit code for the application, one of BatchExitCode values.
+         *
+         * Statements are executed one by one, in the calling thread, as soon as they are complete.
+         * The input is never loaded into memory entirely.
+         */
+        int runBatch(const QString& inputPath, bool stopOnError, bool printStats);
+        bool isBatchMode() const;
         void setCurrentDb(Db* db);
         Db* getCurrentDb() const;
         void exit();
@@ -30,9 +44,19 @@ class CLI : public QObject
         QString getLine() const;
         void applyHistoryLimit();
 
+        enum BatchExitCode
+        {
+            BATCH_OK = 0,
+            BATCH_FAILED = 1,
+            BATCH_INPUT_ERROR = 2
+        };
+
     private:
         explicit CLI(QObject* parent = nullptr);
 
+        void selectDefaultDb();
+        bool executeBatchStatement(const QString& statement, int lineNumber, bool printStats);
+        void printBatchStats(const QJsonObject& stats);
         void waitForExecution();
         bool isComplete(const QString& contents) const;
         void loadHistory();
@@ -47,6 +71,7 @@ class CLI : public QObject
         Db* currentDb = nullptr;
         bool executionFinished = false;
         bool doExit = false;
+        bool batchMode = false;
         QString line;
 
     private slots:
@@ -14,6 +14,15 @@ CliResultsDisplay::Mode CliResultsDisplay::mode(const QString& mode)
     if (mode == "COLUMNS")
         return COLUMNS;
 
+    if (mode == "TSV")
+        return TSV;
+
+    if (mode == "CSV")
+        return CSV;
+
+    if (mode == "JSONL")
+        return JSONL;
+
     return CLASSIC;
 }
 
@@ -29,6 +38,12 @@ QString CliResultsDisplay::mode(CliResultsDisplay::Mode mode)
             return "CLASSIC";
         case COLUMNS:
             return "COLUMNS";
+        case TSV:
+            return "TSV";
+        case CSV:
+            return "CSV";
+        case JSONL:
+            return "JSONL";
     }
     return "CLASSIC";
 }
@@ -10,7 +10,10 @@ namespace CliResultsDisplay
         CLASSIC = 0,
         FIXED = 1,
         ROW = 2,
-        COLUMNS = 3
+        COLUMNS = 3,
+        TSV = 4,
+        CSV = 5,
+        JSONL = 6
     };
 
     Mode mode(const QString& mode);
@@ -30,6 +30,16 @@ bool CliCommand::isAsyncExecution() const
     return false;
 }
 
+bool CliCommand::isFailed() const
+{
+    return failed;
+}
+
+void CliCommand::setFailed()
+{
+    failed = true;
+}
+
 bool CliCommand::parseArgs(const QStringList& args)
 {
     bool res = syntax.parse(args);
@@ -42,6 +42,14 @@ class CliCommand : public QObject
 
         virtual bool isAsyncExecution() const;
 
+        /**
+         * @brief Tells if the last execution of the command has failed.
+         * @return true if the command reported failure with setFailed().
+         *
+         * It's used by the batch mode to decide about the exit code.
+         */
+        bool isFailed() const;
+
         virtual void defineSyntax() = 0;
 
         QStringList aliases() const;
@@ -74,6 +82,7 @@ class CliCommand : public QObject
         static QString cmdName(const QString& cmd);
 
         void printUsage();
+        void setFailed();
         QString getFilterAndFixDir(QDir& dir, const QString& path);
         QStringList getCompletionDbNames();
         QStringList getCompletionTables();
@@ -89,6 +98,7 @@ class CliCommand : public QObject
 
         CLI* cli = nullptr;
         CliCommandSyntax syntax;
+        bool failed = false;
 
     signals:
         void execComplete();
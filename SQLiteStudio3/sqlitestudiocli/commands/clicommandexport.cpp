@@ -0,0 +1,148 @@
+#include "clicommandexport.h"
+#include "cli.h"
+#include "services/exportmanager.h"
+#include "schemaresolver.h"
+#include "common/utils.h"
+
+void CliCommandExport::execute()
+{
+    if (!cli->getCurrentDb())
+    {
+        println(tr("No working database is set.\n"
+                   "Call %1 command to set working database.\n"
+                   "Call %2 to see list of all databases.")
+                .arg(cmdName("use")).arg(cmdName("dblist")));
+
+        setFailed();
+        return;
+    }
+
+    Db* db = cli->getCurrentDb();
+    if (!db || !db->isOpen())
+    {
+        println(tr("Database is not open."));
+        setFailed();
+        return;
+    }
+
+    QString format;
+    for (const QString& availableFormat : EXPORT_MANAGER->getAvailableFormats())
+    {
+        if (availableFormat.compare(syntax.getArgument(FORMAT), Qt::CaseInsensitive) == 0)
+            format = availableFormat;
+    }
+
+    if (format.isNull())
+    {
+        println(tr("Export format '%1' is not supported. Supported formats are: %2.").arg(syntax.getArgument(FORMAT))
+                .arg(EXPORT_MANAGER->getAvailableFormats().join(", ")));
+        setFailed();
+        return;
+    }
+
+    QString mode = syntax.getArgument(MODE);
+    QString object = syntax.getArgument(OBJECT);
+    if (object.isEmpty() && mode != "database")
+    {
+        println(tr("Missing %1 to export.").arg(mode));
+        printUsage();
+        setFailed();
+        return;
+    }
+
+    ExportManager::StandardExportConfig config;
+    config.codec = syntax.isOptionSet(CODEC) ? syntax.getOptionValue(CODEC) : defaultCodecName();
+    config.outputFileName = syntax.getArgument(FILE_PATH);
+
+    // Export is done synchronously, in this thread, so it's finished (and failures reported) when export*() methods return.
+    connect(EXPORT_MANAGER, SIGNAL(exportFailed()), this, SLOT(exportFailed()));
+    EXPORT_MANAGER->configure(format, config);
+    if (mode == "query")
+    {
+        EXPORT_MANAGER->exportQueryResults(db, object, false);
+    }
+    else if (mode == "table")
+    {
+        EXPORT_MANAGER->exportTable(db, "main", object, false);
+    }
+    else
+    {
+        QStringList objects;
+        if (object.isEmpty())
+        {
+            objects = getAllObjects(db);
+        }
+        else
+        {
+            for (const QString& name : object.split(",", QString::SkipEmptyParts))
+                objects << name.trimmed();
+        }
+
+        EXPORT_MANAGER->exportDatabase(db, objects, false);
+    }
+    disconnect(EXPORT_MANAGER, SIGNAL(exportFailed()), this, SLOT(exportFailed()));
+}
+
+QString CliCommandExport::shortHelp() const
+{
+    return tr("exports table, query results or database to a file");
+}
+
+QString CliCommandExport::fullHelp() const
+{
+    return tr(
+                "Exports data from the current working database (see help for %1 for details) into the <file>, "
+                "using the given export <format>. The <format> is one of formats provided by export plugins (like CSV, SQL, JSON, etc.).\n"
+                "The third argument tells what to export:\n"
+                "- table    - the table with the <name> given as the last argument,\n"
+                "- query    - results of the <sql> query given as the last argument (put the query in quotes),\n"
+                "- database - all objects from the database, or only objects listed in the last argument (separated with commas).\n"
+                "\n"
+                "The -c option sets the text encoding of the output file. By default the system encoding is used.\n"
+                "Other export settings (specific to the format) are the same as used recently in the export dialog of the SQLiteStudio.\n"
+                "\n"
+                "The export is done before the command finishes, so it's safe to use it in the batch mode."
+             ).arg(cmdName("use"));
+}
+
+void CliCommandExport::defineSyntax()
+{
+    syntax.setName("export");
+    syntax.addOptionWithArg(CODEC, "c", "codec", tr("codec", "CLI command syntax"));
+    syntax.addArgument(FORMAT, tr("format", "CLI command syntax"));
+    syntax.addArgument(FILE_PATH, tr("file", "CLI command syntax"));
+    syntax.addStrictArgument(MODE, {"table", "query", "database"});
+    syntax.addAlternatedArgument(OBJECT, {tr("name", "CLI command syntax"), tr("sql", "CLI command syntax"), tr("objects", "CLI command syntax")}, false);
+}
+
+QStringList CliCommandExport::getCompletionValuesFor(int id, const QString& partialValue)
+{
+    switch (id)
+    {
+        case FORMAT:
+            return EXPORT_MANAGER->getAvailableFormats();
+        case OBJECT:
+            return getCompletionTables();
+        default:
+            break;
+    }
+    return CliCommand::getCompletionValuesFor(id, partialValue);
+}
+
+QStringList CliCommandExport::getAllObjects(Db* db)
+{
+    SchemaResolver resolver(db);
+    resolver.setIgnoreSystemObjects(true);
+
+    QStringList objects;
+    objects += resolver.getTables();
+    objects += resolver.getIndexes();
+    objects += resolver.getTriggers();
+    objects += resolver.getViews();
+    return objects;
+}
+
+void CliCommandExport::exportFailed()
+{
+    setFailed();
+}
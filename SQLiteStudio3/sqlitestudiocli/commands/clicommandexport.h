@@ -0,0 +1,36 @@
+#ifndef CLICOMMANDEXPORT_H
+#define CLICOMMANDEXPORT_H
+
+#include "clicommand.h"
+
+class Db;
+
+class CliCommandExport : public CliCommand
+{
+        Q_OBJECT
+
+    public:
+        void execute();
+        QString shortHelp() const;
+        QString fullHelp() const;
+        void defineSyntax();
+
+    protected:
+        QStringList getCompletionValuesFor(int id, const QString& partialValue);
+
+    private:
+        enum ArgIds
+        {
+            CODEC,
+            FORMAT,
+            MODE,
+            OBJECT
+        };
+
+        QStringList getAllObjects(Db* db);
+
+    private slots:
+        void exportFailed();
+};
+
+#endif // CLICOMMANDEXPORT_H
@@ -10,6 +10,7 @@
 #include "clicommandsql.h"
 #include "clicommandhelp.h"
 #include "clicommandtables.h"
+#include "clicommandstorage.h"
 #include "clicommandmode.h"
 #include "clicommandnullvalue.h"
 #include "clicommandhistory.h"
@@ -18,6 +19,8 @@
 #include "clicommandcd.h"
 #include "clicommandtree.h"
 #include "clicommanddesc.h"
+#include "clicommandimport.h"
+#include "clicommandexport.h"
 #include <QDebug>
 
 QHash<QString,CliCommandFactory::CliCommandCreatorFunc> CliCommandFactory::mapping;
@@ -36,6 +39,7 @@ void CliCommandFactory::init()
     REGISTER_CMD(CliCommandSql);
     REGISTER_CMD(CliCommandHelp);
     REGISTER_CMD(CliCommandTables);
+    REGISTER_CMD(CliCommandStorage);
     REGISTER_CMD(CliCommandMode);
     REGISTER_CMD(CliCommandNullValue);
     REGISTER_CMD(CliCommandHistory);
@@ -44,6 +48,8 @@ void CliCommandFactory::init()
     REGISTER_CMD(CliCommandCd);
     REGISTER_CMD(CliCommandTree);
     REGISTER_CMD(CliCommandDesc);
+    REGISTER_CMD(CliCommandImport);
+    REGISTER_CMD(CliCommandExport);
 }
 
 CliCommand *CliCommandFactory::getCommand(const QString &cmdName)
@@ -0,0 +1,105 @@
+#include "clicommandimport.h"
+#include "cli.h"
+#include "services/importmanager.h"
+#include "sqlitestudio.h"
+#include "common/utils.h"
+#include <QFile>
+
+void CliCommandImport::execute()
+{
+    if (!cli->getCurrentDb())
+    {
+        println(tr("No working database is set.\n"
+                   "Call %1 command to set working database.\n"
+                   "Call %2 to see list of all databases.")
+                .arg(cmdName("use")).arg(cmdName("dblist")));
+
+        setFailed();
+        return;
+    }
+
+    Db* db = cli->getCurrentDb();
+    if (!db || !db->isOpen())
+    {
+        println(tr("Database is not open."));
+        setFailed();
+        return;
+    }
+
+    QString format;
+    for (const QString& dataSourceType : IMPORT_MANAGER->getImportDataSourceTypes())
+    {
+        if (dataSourceType.compare(syntax.getArgument(FORMAT), Qt::CaseInsensitive) == 0)
+            format = dataSourceType;
+    }
+
+    if (format.isNull())
+    {
+        println(tr("Import format '%1' is not supported. Supported formats are: %2.").arg(syntax.getArgument(FORMAT))
+                .arg(IMPORT_MANAGER->getImportDataSourceTypes().join(", ")));
+        setFailed();
+        return;
+    }
+
+    QString file = syntax.getArgument(FILE_PATH);
+    if (!QFile::exists(file))
+    {
+        println(tr("File %1 doesn't exist.").arg(file));
+        setFailed();
+        return;
+    }
+
+    ImportManager::StandardImportConfig config;
+    config.codec = syntax.isOptionSet(CODEC) ? syntax.getOptionValue(CODEC) : defaultCodecName();
+    config.inputFileName = file;
+    config.ignoreErrors = syntax.isOptionSet(IGNORE_ERRORS);
+
+    // Import is done synchronously, in this thread, so it's finished (and failures reported) when importToTable() returns.
+    connect(IMPORT_MANAGER, SIGNAL(importFailed()), this, SLOT(importFailed()));
+    IMPORT_MANAGER->configure(format, config);
+    IMPORT_MANAGER->importToTable(db, syntax.getArgument(TABLE), false);
+    disconnect(IMPORT_MANAGER, SIGNAL(importFailed()), this, SLOT(importFailed()));
+}
+
+QString CliCommandImport::shortHelp() const
+{
+    return tr("imports data from a file into a table");
+}
+
+QString CliCommandImport::fullHelp() const
+{
+    return tr(
+                "Imports data from the <file> into the <table> of the current working database (see help for %1 for details), "
+                "using the given import <format>. The <format> is one of formats provided by import plugins (like CSV, RegExp, etc.). "
+                "If the table doesn't exist, it's created with columns provided by the import plugin.\n"
+                "\n"
+                "The -c option sets the text encoding of the input file. By default the system encoding is used.\n"
+                "The -i option makes the import skip rows that could not be inserted, instead of failing the whole import.\n"
+                "Other import settings (specific to the format) are the same as used recently in the import dialog of the SQLiteStudio.\n"
+                "\n"
+                "The import is done before the command finishes, so it's safe to use it in the batch mode."
+             ).arg(cmdName("use"));
+}
+
+void CliCommandImport::defineSyntax()
+{
+    syntax.setName("import");
+    syntax.addOptionWithArg(CODEC, "c", "codec", tr("codec", "CLI command syntax"));
+    syntax.addOption(IGNORE_ERRORS, "i", "ignore-errors");
+    syntax.addArgument(FORMAT, tr("format", "CLI command syntax"));
+    syntax.addArgument(FILE_PATH, tr("file", "CLI command syntax"));
+    syntax.addArgument(TABLE, tr("table", "CLI command syntax"));
+}
+
+QStringList CliCommandImport::getCompletionValuesFor(int id, const QString& partialValue)
+{
+    if (id == FORMAT)
+        return IMPORT_MANAGER->getImportDataSourceTypes();
+
+    return CliCommand::getCompletionValuesFor(id, partialValue);
+}
+
+void CliCommandImport::importFailed()
+{
+    setFailed();
+}
@@ -0,0 +1,31 @@
+#ifndef CLICOMMANDIMPORT_H
+#define CLICOMMANDIMPORT_H
+
+#include "clicommand.h"
+
+class CliCommandImport : public CliCommand
+{
+        Q_OBJECT
+
+    public:
+        void execute();
+        QString shortHelp() const;
+        QString fullHelp() const;
+        void defineSyntax();
+
+    protected:
+        QStringList getCompletionValuesFor(int id, const QString& partialValue);
+
+    private:
+        enum ArgIds
+        {
+            CODEC,
+            IGNORE_ERRORS,
+            FORMAT
+        };
+
+    private slots:
+        void importFailed();
+};
+
+#endif // CLICOMMANDIMPORT_H
@@ -1,6 +1,7 @@
 #include "clicommandmode.h"
 #include "common/unused.h"
 #include "cli_config.h"
+#include "clicommandsql.h"
 
 void CliCommandMode::execute()
 {
@@ -34,8 +35,11 @@ QString CliCommandMode::fullHelp() const
                 "Supported modes are:\n"
                 "- CLASSIC - columns are separated by a comma, not aligned,\n"
                 "- FIXED   - columns have equal and fixed width, they always fit into terminal window width, but the data in columns can be cut off,\n"
-                "- COLUMNS - like FIXED, but smarter (do not use with huge result sets, see details below),\n"
-                "- ROW     - each column from the row is displayed in new line, so the full data is displayed.\n"
+                "- COLUMNS - like FIXED, but smarter (see details below),\n"
+                "- ROW     - each column from the row is displayed in new line, so the full data is displayed,\n"
+                "- TSV     - tab separated values, with a header line, for feeding other tools,\n"
+                "- CSV     - comma separated values, with a header line, for feeding other tools,\n"
+                "- JSONL   - one JSON object per row (JSON lines), for feeding other tools.\n"
                 "\n"
                 "The CLASSIC mode is recommended if you want to see all the data, but you don't want to waste lines for each column. "
                 "Each row will display full data for every column, but this also means, that columns will not be aligned to each other in next rows. "
@@ -49,17 +53,23 @@ QString CliCommandMode::fullHelp() const
                 "The COLUMNS mode is similar to FIXED mode, except it tries to be smart and make columns with shorter values more thin, "
                 "while columns with longer values get more space. First to shrink are columns with longest headers (so the header names are to be "
                 "cut off as first), then columns with the longest values are shrinked, up to the moment when all columns fit into terminal window.\n"
-                "ATTENTION! The COLUMNS mode reads all the results from the query at once in order to evaluate column widhts, therefore it is dangerous "
-                "to use this mode when working with huge result sets. Keep in mind that this mode will load entire result set into memory.\n"
+                "Column widths are evaluated from the first %1 rows only, so values in further rows might be cut off more than necessary.\n"
                 "\n"
                 "The ROW mode is recommended if you need to see whole values and you don't expect many rows to be displayed, because this mode "
                 "displays a line of output per each column, so you'll get 10 lines for single row with 10 columns, then if you have 10 of such rows, "
-                "you will get 100 lines of output (+1 extra line per each row, to separate rows from each other)."
-                );
+                "you will get 100 lines of output (+1 extra line per each row, to separate rows from each other).\n"
+                "\n"
+                "The TSV, CSV and JSONL modes are recommended when the output is passed to other programs. "
+                "Values are printed in full and nothing depends on the terminal window. In TSV mode tabs, new lines and backslashes "
+                "in values are escaped with a backslash. In CSV mode values are quoted when necessary. In JSONL mode NULL is printed as null, "
+                "numbers as numbers and BLOBs as base64 encoded strings.\n"
+                "\n"
+                "In every mode the rows are printed as they are read from the database, so even huge result sets can be displayed."
+                ).arg(CliCommandSql::COLUMNS_LOOKAHEAD_ROWS);
 }
 
 void CliCommandMode::defineSyntax()
 {
     syntax.setName("mode");
-    syntax.addStrictArgument(MODE, {"classic", "fixed", "columns", "row"}, false);
+    syntax.addStrictArgument(MODE, {"classic", "fixed", "columns", "row", "tsv", "csv", "jsonl"}, false);
 }
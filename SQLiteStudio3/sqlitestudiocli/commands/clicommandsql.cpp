@@ -8,8 +8,10 @@
 #include "common/unused.h"
 #include "cli_config.h"
 #include "cliutils.h"
+#include "common/exportoutputbuffer.h"
 #include <QList>
 #include <QDebug>
+#include <qnumeric.h>
 
 void CliCommandSql::execute()
 {
@@ -20,6 +22,7 @@ void CliCommandSql::execute()
                    "Call %2 to see list of all databases.")
                 .arg(cmdName("use")).arg(cmdName("dblist")));
 
+        setFailed();
         return;
     }
 
@@ -27,11 +30,26 @@ void CliCommandSql::execute()
     if (!db || !db->isOpen())
     {
         println(tr("Database is not open."));
+        setFailed();
         return;
     }
 
-    // Executor deletes itself later when called with lambda.
+    // Executor deletes itself later when called with lambda (unless it's the batch mode, see below).
     QueryExecutor *executor = new QueryExecutor(db, syntax.getArgument(STRING));
+
+    // Rows are printed as they come. Nothing is paged, so neither counting nor ROWID columns are useful here.
+    executor->setSkipRowCounting(true);
+    executor->setNoMetaColumns(true);
+
+    // In the batch mode there is no event loop running, so the query is executed in this thread
+    // and it's all done (including printing results) once the exec() returns.
+    bool batchMode = cli->isBatchMode();
+    if (batchMode)
+    {
+        executor->setAsyncMode(false);
+        executor->setAutoDelete(false);
+    }
+
     connect(executor, SIGNAL(executionFinished(SqlQueryPtr)), this, SIGNAL(execComplete()));
     connect(executor, SIGNAL(executionFailed(int,QString)), this, SLOT(executionFailed(int,QString)));
     connect(executor, SIGNAL(executionFailed(int,QString)), this, SIGNAL(execComplete()));
@@ -52,11 +70,21 @@ void CliCommandSql::execute()
             case CliResultsDisplay::ROW:
                 printResultsRowByRow(executor, results);
                 break;
+            case CliResultsDisplay::TSV:
+            case CliResultsDisplay::CSV:
+                printResultsSeparated(executor, results, CFG_CLI.Console.ResultsDisplayMode.get());
+                break;
+            case CliResultsDisplay::JSONL:
+                printResultsJsonLines(executor, results);
+                break;
             default:
                 printResultsClassic(executor, results);
                 break;
         }
     });
+
+    if (batchMode)
+        delete executor;
 }
 
 QString CliCommandSql::shortHelp() const
@@ -177,8 +205,10 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
         return;
     }
 
-    // Preload data (we will calculate column widths basing on real values)
-    QList<SqlResultsRowPtr> allRows = results->getAll();
+    // Preload first rows only (we will calculate column widths basing on real values), the rest is streamed
+    QList<SqlResultsRowPtr> lookAheadRows;
+    while (lookAheadRows.size() < COLUMNS_LOOKAHEAD_ROWS && results->hasNext())
+        lookAheadRows << results->next();
 
     // Get widths of each column in every data row, remember the longest ones
     QList<SortedColumnWidth*> columnWidths;
@@ -192,7 +222,7 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
     }
 
     int dataLength;
-    for (const SqlResultsRowPtr& row : allRows)
+    for (const SqlResultsRowPtr& row : lookAheadRows)
     {
         for (int i = 0; i < resultColumnsCount; i++)
         {
@@ -228,9 +258,13 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
 
     printColumnHeader(finalWidths, headerNames);
 
-    for (SqlResultsRowPtr row : allRows)
+    for (SqlResultsRowPtr row : lookAheadRows)
         printColumnDataRow(finalWidths, row, resultColumnsCount);
 
+    lookAheadRows.clear();
+    while (results->hasNext())
+        printColumnDataRow(finalWidths, results->next(), resultColumnsCount);
+
     qOut.flush();
 }
 
@@ -272,6 +306,66 @@ void CliCommandSql::printResultsRowByRow(QueryExecutor* executor, SqlQueryPtr re
     qOut.flush();
 }
 
+void CliCommandSql::printResultsSeparated(QueryExecutor* executor, SqlQueryPtr results, CliResultsDisplay::Mode mode)
+{
+    static const QString tsvSeparator = QStringLiteral("\t");
+    static const QString csvSeparator = QStringLiteral(",");
+    static const QString rowSeparator = QStringLiteral("\n");
+
+    bool tsv = (mode == CliResultsDisplay::TSV);
+    const QString& separator = tsv ? tsvSeparator : csvSeparator;
+    int resultColumnCount = executor->getResultColumns().size();
+
+    // Columns
+    QStringList line;
+    for (const QueryExecutor::ResultColumnPtr& resCol : executor->getResultColumns())
+    {
+        if (tsv)
+            line << getTsvValueString(resCol->displayName);
+        else
+            line << ExportOutputBuffer::escapeCsv(resCol->displayName, separator, rowSeparator);
+    }
+
+    qOut << line.join(separator) << rowSeparator;
+
+    // Data
+    while (results->hasNext())
+    {
+        line.clear();
+        for (const QVariant& value : results->next()->valueList().mid(0, resultColumnCount))
+        {
+            if (tsv)
+                line << getTsvValueString(value);
+            else
+                line << ExportOutputBuffer::escapeCsv(getValueString(value), separator, rowSeparator);
+        }
+
+        qOut << line.join(separator) << rowSeparator;
+    }
+    qOut.flush();
+}
+
+void CliCommandSql::printResultsJsonLines(QueryExecutor* executor, SqlQueryPtr results)
+{
+    QStringList keys;
+    for (const QueryExecutor::ResultColumnPtr& resCol : executor->getResultColumns())
+        keys << ExportOutputBuffer::escapeJson(resCol->displayName) + ":";
+
+    int resultColumnCount = keys.size();
+    QStringList line;
+    int i;
+    while (results->hasNext())
+    {
+        line.clear();
+        i = 0;
+        for (const QVariant& value : results->next()->valueList().mid(0, resultColumnCount))
+            line << keys[i++] + getJsonValueString(value);
+
+        qOut << "{" << line.join(",") << "}\n";
+    }
+    qOut.flush();
+}
+
 void CliCommandSql::shrinkColumns(QList<CliCommandSql::SortedColumnWidth*>& columnWidths, int termCols, int resultColumnsCount, int totalWidth)
 {
     // This implements quite a smart shrinking algorithm:
@@ -397,9 +491,47 @@ QString CliCommandSql::getValueString(const QVariant& value)
     return CFG_CLI.Console.NullValue.get();
 }
 
+QString CliCommandSql::getTsvValueString(const QVariant& value)
+{
+    QString str = getValueString(value);
+    if (!str.contains('\\') && !str.contains('\t') && !str.contains('\n') && !str.contains('\r'))
+        return str;
+
+    return str.replace("\\", "\\\\").replace("\t", "\\t").replace("\n", "\\n").replace("\r", "\\r");
+}
+
+QString CliCommandSql::getJsonValueString(const QVariant& value)
+{
+    if (!value.isValid() || value.isNull())
+        return "null";
+
+    switch (value.type())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+            return value.toString();
+        case QVariant::Double:
+        {
+            double number = value.toDouble();
+            if (qIsFinite(number))
+                return QString::number(number, 'g', 17);
+
+            break;
+        }
+        case QVariant::ByteArray:
+            return ExportOutputBuffer::escapeJson(QString::fromLatin1(value.toByteArray().toBase64()));
+        default:
+            break;
+    }
+    return ExportOutputBuffer::escapeJson(value.toString());
+}
+
 void CliCommandSql::executionFailed(int code, const QString& msg)
 {
     UNUSED(code);
+    setFailed();
     qOut << tr("Query execution error: %1").arg(msg) << "\n\n";
     qOut.flush();
 }
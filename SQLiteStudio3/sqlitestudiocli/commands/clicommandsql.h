@@ -2,6 +2,7 @@
 #define CLICOMMANDSQL_H
 
 #include "clicommand.h"
+#include "cli_config.h"
 #include "db/sqlquery.h"
 
 class QueryExecutor;
@@ -17,6 +18,13 @@ class CliCommandSql : public CliCommand
         bool isAsyncExecution() const;
         void defineSyntax();
 
+        /**
+         * @brief Number of rows used to evaluate column widths in COLUMNS mode.
+         *
+         * Only this many rows are kept in memory at once, no matter how many rows the query returns.
+         */
+        static const int COLUMNS_LOOKAHEAD_ROWS = 1000;
+
     private:
         class SortedColumnWidth
         {
@@ -53,11 +61,15 @@ class CliCommandSql : public CliCommand
         void printResultsFixed(QueryExecutor *executor, SqlQueryPtr results);
         void printResultsColumns(QueryExecutor *executor, SqlQueryPtr results);
         void printResultsRowByRow(QueryExecutor *executor, SqlQueryPtr results);
+        void printResultsSeparated(QueryExecutor *executor, SqlQueryPtr results, CliResultsDisplay::Mode mode);
+        void printResultsJsonLines(QueryExecutor *executor, SqlQueryPtr results);
         void shrinkColumns(QList<SortedColumnWidth*>& columnWidths, int termCols, int resultColumnsCount, int totalWidth);
         void printColumnHeader(const QList<int>& widths, const QStringList& columns);
         void printColumnDataRow(const QList<int>& widths, const SqlResultsRowPtr& row, int rowIdCount);
 
         QString getValueString(const QVariant& value);
+        QString getTsvValueString(const QVariant& value);
+        QString getJsonValueString(const QVariant& value);
 
     private slots:
         void executionFailed(int code, const QString& msg);
@@ -0,0 +1,102 @@
+#include "clicommandstorage.h"
+#include "cli.h"
+#include "services/dbmanager.h"
+#include "db/storageanalyzer.h"
+#include "common/utils.h"
+
+void CliCommandStorage::execute()
+{
+    Db* db = nullptr;
+    if (syntax.isArgumentSet(DB_NAME))
+    {
+        db = DBLIST->getByName(syntax.getArgument(DB_NAME));
+        if (!db)
+        {
+            println(tr("No such database: %1. Use %2 to see list of known databases.").arg(syntax.getArgument(DB_NAME), cmdName("dblist")));
+            return;
+        }
+    }
+    else if (cli->getCurrentDb())
+    {
+        db = cli->getCurrentDb();
+    }
+    else
+    {
+        println(tr("Cannot call %1 when no database is set to be current. Specify current database with %2 command or pass database name to %3.")
+                .arg(cmdName("storage")).arg(cmdName("use")).arg(cmdName("storage")));
+        return;
+    }
+
+    if (!db->isOpen())
+    {
+        println(tr("Database %1 is closed.").arg(db->getName()));
+        return;
+    }
+
+    StorageAnalyzer::Report report;
+    if (!STORAGE_ANALYZER->getCached(db, report))
+        report = STORAGE_ANALYZER->analyze(db);
+
+    if (!report.isValid())
+    {
+        println(tr("Could not analyze storage of database %1: %2").arg(db->getName(), report.errorMessage));
+        return;
+    }
+
+    QStringList names = {tr("Name")};
+    for (const StorageAnalyzer::ObjectStats& stats : report.objects)
+        names << stats.name;
+
+    int nameWidth = longest(names).length();
+    QString sizeHeader = tr("Size");
+    QString pagesHeader = tr("Pages");
+    QString unusedHeader = tr("Unused");
+    QString fragHeader = tr("Fragmentation");
+    int sizeWidth = qMax(sizeHeader.length(), 10);
+    int pagesWidth = qMax(pagesHeader.length(), 8);
+    int unusedWidth = qMax(unusedHeader.length(), 10);
+
+    println();
+    println(pad(tr("Name"), nameWidth, ' ') + " " + pad(tr("Type"), 6, ' ') + " " + pad(sizeHeader, sizeWidth, ' ') + " " +
+            pad(pagesHeader, pagesWidth, ' ') + " " + pad(unusedHeader, unusedWidth, ' ') + " " + fragHeader);
+    println(pad("", nameWidth + 6 + sizeWidth + pagesWidth + unusedWidth + fragHeader.length() + 5, '-'));
+
+    for (const StorageAnalyzer::ObjectStats& stats : report.objects)
+    {
+        println(pad(stats.name, nameWidth, ' ') + " " +
+                pad(stats.type, 6, ' ') + " " +
+                pad(formatFileSize(stats.getSize(report.pageSize)), sizeWidth, ' ') + " " +
+                pad(QString::number(stats.pages), pagesWidth, ' ') + " " +
+                pad(formatFileSize(stats.unused), unusedWidth, ' ') + " " +
+                QString::number(stats.fragmentation * 100, 'f', 1) + "%");
+    }
+
+    println();
+    println(tr("Page size: %1, pages: %2, free pages: %3").arg(report.pageSize).arg(report.pageCount).arg(report.freePages));
+    println(tr("Space reclaimable by VACUUM: up to %1").arg(formatFileSize(report.getEstimatedVacuumGain())));
+    if (report.approximate)
+        println(tr("The database has uncheckpointed changes in its WAL file, so the report is approximate."));
+
+    println();
+}
+
+QString CliCommandStorage::shortHelp() const
+{
+    return tr("prints space used by tables and indexes of the database");
+}
+
+QString CliCommandStorage::fullHelp() const
+{
+    return tr(
+                "Analyzes storage of given <database> or of the current working database and prints size, number of pages, "
+                "unused space and fragmentation of every table and index, largest first. "
+                "Note, that the <database> should be the name of the registered database (see %1). "
+                "Results are remembered until the database file is modified, so calling the command again is instant."
+                ).arg(cmdName("use"));
+}
+
+void CliCommandStorage::defineSyntax()
+{
+    syntax.setName("storage");
+    syntax.addArgument(DB_NAME, tr("database", "CLI command syntax"), false);
+}
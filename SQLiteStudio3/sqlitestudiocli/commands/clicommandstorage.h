@@ -0,0 +1,17 @@
+#ifndef CLICOMMANDSTORAGE_H
+#define CLICOMMANDSTORAGE_H
+
+#include "clicommand.h"
+
+class CliCommandStorage : public CliCommand
+{
+        Q_OBJECT
+
+    public:
+        void execute();
+        QString shortHelp() const;
+        QString fullHelp() const;
+        void defineSyntax();
+};
+
+#endif // CLICOMMANDSTORAGE_H
@@ -15,6 +15,9 @@
 #include <QCommandLineOption>
 
 bool listPlugins = false;
+QString batchInput;
+bool batchStopOnError = true;
+bool batchStats = false;
 
 QString cliHandleCmdLineArgs()
 {
@@ -26,9 +29,17 @@ QString cliHandleCmdLineArgs()
     QCommandLineOption debugOption({"d", "debug"}, QObject::tr("Enables debug messages on standard error output."));
     QCommandLineOption lemonDebugOption("debug-lemon", QObject::tr("Enables Lemon parser debug messages for SQL code assistant."));
     QCommandLineOption listPluginsOption("list-plugins", QObject::tr("Lists plugins installed in the SQLiteStudio and quits."));
+    QCommandLineOption batchOption({"b", "batch"}, QObject::tr("Executes commands and SQL queries from the file (or from the standard input, if the file is '-') "
+                                                               "without any interaction and quits. Exit code is 0 if everything succeeded, 1 if any of statements failed, "
+                                                               "or 2 if the file could not be read."), QObject::tr("file"));
+    QCommandLineOption continueOnErrorOption("continue-on-error", QObject::tr("In the batch mode, continues with next statements after a statement has failed."));
+    QCommandLineOption statsOption("stats", QObject::tr("In the batch mode, prints execution time of each statement and a summary to the standard error output, as JSON lines."));
     parser.addOption(debugOption);
     parser.addOption(lemonDebugOption);
     parser.addOption(listPluginsOption);
+    parser.addOption(batchOption);
+    parser.addOption(continueOnErrorOption);
+    parser.addOption(statsOption);
 
     parser.addPositionalArgument(QObject::tr("file"), QObject::tr("Database file to open"));
 
@@ -40,6 +51,12 @@ QString cliHandleCmdLineArgs()
     if (parser.isSet(listPluginsOption))
         listPlugins = true;
 
+    if (parser.isSet(batchOption))
+        batchInput = parser.value(batchOption);
+
+    batchStopOnError = !parser.isSet(continueOnErrorOption);
+    batchStats = parser.isSet(statsOption);
+
     CompletionHelper::enableLemonDebug = parser.isSet(lemonDebugOption);
 
     QStringList args = parser.positionalArguments();
@@ -82,6 +99,13 @@ int main(int argc, char *argv[])
     if (!dbToOpen.isEmpty())
         CLI::getInstance()->openDbFile(dbToOpen);
 
+    if (!batchInput.isNull())
+    {
+        int res = CLI::getInstance()->runBatch(batchInput, batchStopOnError, batchStats);
+        CLI::dispose();
+        return res;
+    }
+
     CLI::getInstance()->start();
     int res = a.exec();
     CLI::dispose();
@@ -60,6 +60,7 @@ SOURCES += main.cpp \
     commands/clicommandhelp.cpp \
     cliutils.cpp \
     commands/clicommandtables.cpp \
+    commands/clicommandstorage.cpp \
     climsghandler.cpp \
     commands/clicommandmode.cpp \
     commands/clicommandnullvalue.cpp \
@@ -70,7 +71,9 @@ SOURCES += main.cpp \
     clicommandsyntax.cpp \
     commands/clicommandtree.cpp \
     clicompleter.cpp \
-    commands/clicommanddesc.cpp
+    commands/clicommanddesc.cpp \
+    commands/clicommandimport.cpp \
+    commands/clicommandexport.cpp
 
 LIBS += -lcoreSQLiteStudio
 
@@ -100,6 +103,7 @@ HEADERS += \
     commands/clicommandhelp.h \
     cliutils.h \
     commands/clicommandtables.h \
+    commands/clicommandstorage.h \
     climsghandler.h \
     commands/clicommandmode.h \
     commands/clicommandnullvalue.h \
@@ -110,7 +114,9 @@ HEADERS += \
     clicommandsyntax.h \
     commands/clicommandtree.h \
     clicompleter.h \
-    commands/clicommanddesc.h
+    commands/clicommanddesc.h \
+    commands/clicommandimport.h \
+    commands/clicommandexport.h
 
 unix: {
     target.path = $$BINDIR